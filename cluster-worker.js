@@ -0,0 +1,135 @@
+/**
+ * Cluster worker for the main server (CLUSTER_WORKERS > 1, see services/cluster.js)
+ * Serves the journey-simulation hot path on the shared public port with the
+ * same middleware server.js runs it behind, and streams every other request,
+ * websocket upgrades included, to the owner process without parsing it.
+ */
+
+import express from 'express';
+import http from 'http';
+import net from 'net';
+import cors from 'cors';
+import compression from 'compression';
+import morgan from 'morgan';
+import { injectDynatraceMetadata, injectErrorMetadata } from './middleware/dynatrace-metadata.js';
+import { requestContext } from './middleware/request-context.js';
+import journeySimulationRouter, { CLUSTER_WORKER_ROUTES } from './routes/journey-simulation.js';
+import { OWNER_PORT, callOwner, notifyOwner, onBroadcast } from './services/cluster.js';
+
+const portOffset = parseInt(process.env.PORT_OFFSET || '0');
+const PORT = parseInt(process.env.PORT || '8080') + portOffset;
+const HOT_PREFIX = '/api/journey-simulation';
+
+// Owner globals the hot path reads or calls
+global.featureFlags = await callOwner('featureFlags');
+onBroadcast('featureFlags', flags => { global.featureFlags = flags; });
+global.recordTraceValidation = (stepName, headers, response) => notifyOwner('recordTraceValidation', stepName, {
+  traceparent: headers.traceparent,
+  tracestate: headers.tracestate,
+  'x-dynatrace-trace-id': headers['x-dynatrace-trace-id'],
+  'x-correlation-id': headers['x-correlation-id']
+}, { httpStatus: response?.httpStatus, traceparent: response?.traceparent });
+global.startContinuousJourneyGenerator = () => notifyOwner('startContinuousJourneyGenerator');
+
+const app = express();
+app.set('trust proxy', true);
+app.use(cors());
+app.use(compression());
+app.use(morgan('dev'));
+app.use(express.json({ limit: '10mb' }));
+app.use(express.urlencoded({ limit: '10mb', extended: true }));
+app.use(injectDynatraceMetadata);
+app.use(requestContext());
+app.use(HOT_PREFIX, journeySimulationRouter);
+app.use((err, req, res, next) => {
+  console.error('Server error:', err);
+  const errorMetadata = injectErrorMetadata(err, req, res);
+  res.status(500).json({
+    error: 'Internal Server Error',
+    message: err.message,
+    timestamp: new Date().toISOString(),
+    correlationId: req.correlationId,
+    metadata: errorMetadata
+  });
+});
+
+function isHotPath(req) {
+  if (req.method !== 'POST' && req.method !== 'OPTIONS') return false;
+  const pathname = req.url.split('?', 1)[0];
+  return pathname.startsWith(`${HOT_PREFIX}/`) && CLUSTER_WORKER_ROUTES.has(pathname.slice(HOT_PREFIX.length));
+}
+
+// ============ OWNER PROXY ============
+const ownerAgent = new http.Agent({ keepAlive: true, maxSockets: 256 });
+const HOP_BY_HOP = new Set(['connection', 'keep-alive', 'proxy-connection', 'upgrade']);
+
+function forwardedFor(req) {
+  const prior = req.headers['x-forwarded-for'];
+  return prior ? `${prior}, ${req.socket.remoteAddress}` : req.socket.remoteAddress;
+}
+
+function withoutHopByHop(headers) {
+  const out = {};
+  for (const [name, value] of Object.entries(headers)) {
+    if (!HOP_BY_HOP.has(name)) out[name] = value;
+  }
+  return out;
+}
+
+function proxyToOwner(req, res) {
+  const upstream = http.request({
+    host: '127.0.0.1',
+    port: OWNER_PORT,
+    method: req.method,
+    path: req.url,
+    agent: ownerAgent,
+    headers: {
+      ...withoutHopByHop(req.headers),
+      'x-forwarded-for': forwardedFor(req),
+      'x-forwarded-proto': req.headers['x-forwarded-proto'] || 'http'
+    }
+  }, ownerRes => {
+    res.writeHead(ownerRes.statusCode, ownerRes.statusMessage, withoutHopByHop(ownerRes.headers));
+    ownerRes.pipe(res);
+  });
+  upstream.on('error', err => {
+    if (res.headersSent) return res.destroy();
+    res.writeHead(502, { 'content-type': 'application/json' });
+    res.end(JSON.stringify({ error: 'Bad Gateway', message: `Main server owner unavailable: ${err.message}` }));
+  });
+  // Long polls and streams end upstream when the client goes away
+  res.on('close', () => {
+    if (!res.writableFinished) upstream.destroy();
+  });
+  req.pipe(upstream);
+}
+
+function proxyUpgrade(req, socket, head) {
+  const upstream = net.connect(OWNER_PORT, '127.0.0.1', () => {
+    const lines = [`${req.method} ${req.url} HTTP/${req.httpVersion}`];
+    for (let i = 0; i < req.rawHeaders.length; i += 2) {
+      if (req.rawHeaders[i].toLowerCase() !== 'x-forwarded-for') lines.push(`${req.rawHeaders[i]}: ${req.rawHeaders[i + 1]}`);
+    }
+    lines.push(`X-Forwarded-For: ${forwardedFor(req)}`);
+    upstream.write(`${lines.join('\r\n')}\r\n\r\n`);
+    if (head.length) upstream.write(head);
+    upstream.pipe(socket);
+    socket.pipe(upstream);
+  });
+  upstream.on('error', () => socket.destroy());
+  socket.on('error', () => upstream.destroy());
+}
+// ============ END OWNER PROXY ============
+
+const server = http.createServer((req, res) => (isHotPath(req) ? app(req, res) : proxyToOwner(req, res)));
+server.on('upgrade', proxyUpgrade);
+server.listen(PORT, () => {
+  console.log(`[cluster] 🧵 Worker ${process.pid} serving the journey-simulation hot path on port ${PORT}`);
+});
+
+// Without the owner there is nothing to proxy to or ask
+process.on('disconnect', () => process.exit(0));
+process.on('SIGTERM', () => {
+  server.close(() => process.exit(0));
+  setTimeout(() => process.exit(0), 5000).unref();
+});
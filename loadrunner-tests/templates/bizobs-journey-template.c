@@ -9,42 +9,337 @@
  * Generated by BizObs Business Observability Generator
  */
 
+#include <stdarg.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
 #include "web_api.h"
 #include "lrun.h"
 
 // Global variables for Dynatrace tagging
-char LSN[256] = "{{SCRIPT_NAME}}";          // Load Script Name
-char LTN[256] = "{{TEST_NAME}}";            // Load Test Name  
+char LSN[] = "{{SCRIPT_NAME}}";             // Load Script Name
+char LTN[] = "{{TEST_NAME}}";               // Load Test Name  
 char TSN[256] = "{{STEP_NAME}}";            // Test Step Name (changes per step)
-char dt_header[1024];                       // Dynatrace header buffer
-char company_name[128] = "{{COMPANY_NAME}}";
-char base_url[256] = "{{BASE_URL}}";
+char company_name[] = "{{COMPANY_NAME}}";
+char base_url[] = "{{BASE_URL}}";
 
 // Journey configuration
 int journey_steps = {{STEP_COUNT}};
-int think_time_ms = {{THINK_TIME}};
+int think_time_ms = {{THINK_TIME}};             // mean per step in ms, -1 = the step's estimated minutes
+int think_distribution = {{THINK_DISTRIBUTION}};   // 0 fixed, 1 exponential, 2 lognormal
+double time_compression = {{TIME_COMPRESSION}};   // real seconds per test second
 int error_simulation = {{ERROR_SIMULATION}};
+int connection_reuse = {{CONNECTION_REUSE}};   // 1: one keep-alive connection per VU
 
-// Performance counters
+// Performance counters (last step's duration in seconds and LR_PASS/LR_FAIL)
 double response_time;
 int transaction_status;
 
+// Per-VU bump arena: URLs, transaction names and bodies an iteration formats
+// are carved from it, sized by a measuring snprintf, and released together by
+// arena_reset() at the end of Action(). A chunk that runs out chains a bigger
+// one; the reset folds the chain into one chunk of the largest iteration, so
+// memory per VU follows the real journey and long fields never overrun.
+#define ARENA_INITIAL 4096
+typedef struct arena_chunk {
+    struct arena_chunk* prev;
+    int size;
+    int used;
+} arena_chunk;
+arena_chunk* arena_top;
+int arena_iter_bytes;                       // handed out since the last reset
+int arena_high_water;                       // largest iteration so far
+
+arena_chunk* arena_chunk_new(int size, arena_chunk* prev)
+{
+    arena_chunk* c = (arena_chunk*)malloc(sizeof(arena_chunk) + size);
+    if (c == NULL) {
+        lr_error_message("Request arena: cannot allocate %d bytes", size);
+        lr_exit(LR_EXIT_VUSER, LR_FAIL);
+    }
+    c->prev = prev;
+    c->size = size;
+    c->used = 0;
+    return c;
+}
+
+char* arena_alloc(int n)
+{
+    char* p;
+    n = (n + 7) & ~7;
+    if (arena_top == NULL || arena_top->size - arena_top->used < n) {
+        int size = arena_top != NULL ? arena_top->size * 2 : ARENA_INITIAL;
+        if (size < n) size = (n + 1023) & ~1023;
+        arena_top = arena_chunk_new(size, arena_top);
+    }
+    p = (char*)(arena_top + 1) + arena_top->used;
+    arena_top->used += n;
+    arena_iter_bytes += n;
+    return p;
+}
+
+char* arena_printf(const char* fmt, ...)
+{
+    va_list args;
+    char* p;
+    int n;
+    va_start(args, fmt);
+    n = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+    p = arena_alloc(n + 1);
+    va_start(args, fmt);
+    vsnprintf(p, n + 1, fmt, args);
+    va_end(args);
+    return p;
+}
+
+void arena_free_chain(void)
+{
+    while (arena_top != NULL) {
+        arena_chunk* prev = arena_top->prev;
+        free(arena_top);
+        arena_top = prev;
+    }
+}
+
+void arena_reset(void)
+{
+    if (arena_iter_bytes > arena_high_water) arena_high_water = arena_iter_bytes;
+    if (arena_top != NULL && arena_top->prev != NULL) {
+        arena_free_chain();
+        arena_top = arena_chunk_new((arena_high_water + 1023) & ~1023, NULL);
+    }
+    if (arena_top != NULL) arena_top->used = 0;
+    arena_iter_bytes = 0;
+}
+
+// Dynatrace header: "VU: n; SI: s; LSN: x; LTN: y; " is measured and formatted
+// once per VU in vuser_init(); each step only copies its "TSN: <step>" suffix
+// after it.
+#define DT_STEP_START {{STEP_COUNT}}
+#define DT_STEP_COMPLETE ({{STEP_COUNT}} + 1)
+char* dt_header;                            // per-VU header buffer, prefix + longest suffix
+int dt_tsn_offset;                          // end of the VU-constant prefix
+
+static const char* const dt_step_suffix[] = {
+{{DT_STEP_SUFFIXES}}
+    "TSN: Journey_Start",
+    "TSN: Journey_Complete"
+};
+static const int dt_step_suffix_len[] = { {{DT_STEP_SUFFIX_LENGTHS}} 18, 21 };
+
+void dt_set_step(int step)
+{
+    memcpy(dt_header + dt_tsn_offset, dt_step_suffix[step], dt_step_suffix_len[step] + 1);
+}
+
+// Per-step latency histograms (HdrHistogram layout, 1 ms units): bucket b
+// holds 128 sub-buckets of 2^b ms, so values stay within 1% in 8 KB per step.
+// A step slower than the pacing interval is backfilled for the iterations it
+// held up (coordinated omission); vuser_end() reports p50/p99/p99.9 per TSN.
+#define LAT_HALF 128
+#define LAT_COUNTS (16 * LAT_HALF)
+#define LAT_MAX_MS 3600000
+#define LAT_EXPECTED_INTERVAL_MS {{JOURNEY_INTERVAL_MS}}
+unsigned int lat_counts[{{STEP_COUNT}}][LAT_COUNTS];
+unsigned int lat_total[{{STEP_COUNT}}];
+int lat_max[{{STEP_COUNT}}];
+
+void lat_record_value(int step, int ms)
+{
+    int bucket = 0;
+    if (ms < 0) ms = 0;
+    if (ms > LAT_MAX_MS) ms = LAT_MAX_MS;
+    while ((ms >> bucket) >= 2 * LAT_HALF) bucket++;
+    lat_counts[step][bucket * LAT_HALF + (ms >> bucket)]++;
+    lat_total[step]++;
+    if (ms > lat_max[step]) lat_max[step] = ms;
+}
+
+void lat_record(int step, double seconds)
+{
+    int ms = (int)(seconds * 1000.0 + 0.5);
+    int missing;
+    lat_record_value(step, ms);
+    if (LAT_EXPECTED_INTERVAL_MS <= 0) return;
+    for (missing = ms - LAT_EXPECTED_INTERVAL_MS; missing >= LAT_EXPECTED_INTERVAL_MS; missing -= LAT_EXPECTED_INTERVAL_MS)
+        lat_record_value(step, missing);
+}
+
+// Results store: one 24-byte record per transaction appended to results_path,
+// same layout as the native engine (native/loadgen/src/results_store.h), "" =
+// off. The stream buffer is a whole number of records, so the VUs sharing
+// the file always append whole records. TSN id: the step index, then
+// journey_steps for Journey_Complete.
+#define RESULTS_RECORD_BYTES 24
+char results_path[] = "{{RESULTS_FILE}}";
+FILE* results_file;
+char results_buffer[RESULTS_RECORD_BYTES * 170];
+
+void results_put(unsigned char* p, unsigned int v, int bytes)
+{
+    int i;
+    for (i = 0; i < bytes; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+void results_append(int tsn, int status, double seconds)
+{
+    unsigned char rec[RESULTS_RECORD_BYTES];
+    double now_us = (double)time(NULL) * 1000000.0;
+    double us = seconds * 1000000.0;
+    if (results_file == NULL) return;
+    results_put(rec, (unsigned int)fmod(now_us, 4294967296.0), 4);
+    results_put(rec + 4, (unsigned int)(now_us / 4294967296.0), 4);
+    results_put(rec + 8, (unsigned int)lr_get_vuser_id(), 4);
+    results_put(rec + 12, (unsigned int)lr_get_iteration_number(), 4);
+    results_put(rec + 16, (unsigned int)tsn, 2);
+    rec[18] = status == LR_PASS ? 0 : 1;
+    rec[19] = 0;
+    results_put(rec + 20, us >= 4294967295.0 ? 0xffffffffu : (unsigned int)us, 4);
+    fwrite(rec, 1, RESULTS_RECORD_BYTES, results_file);
+}
+
+// Seeded error schedule (same hash as the native engine's ErrorSchedule):
+// step s of iteration i fails when err_mix(vu seed ^ err_mix(i * K + s)) %
+// 10000 < ERR_RATE_BP. The failing step names go out as x-error-schedule and
+// the step service fails them inline; the script only books what it answered.
+#define ERR_RATE_BP {{ERROR_RATE_BP}}           // error_simulation.error_rate * 100
+#define ERR_SEED {{ERROR_SEED}}u
+char* err_schedule;                         // this iteration's failing steps (arena), "" = none
+unsigned int err_vu_seed;
+
+unsigned int err_mix(unsigned int x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+void err_plan_iteration(int iteration)
+{
+    int step, len = 0, size = 1;
+    for (step = 0; step < journey_steps; step++) size += dt_step_suffix_len[step] - 5 + 1;
+    err_schedule = arena_alloc(size);
+    err_schedule[0] = '\0';
+    if (!error_simulation || ERR_RATE_BP <= 0) return;
+    for (step = 0; step < journey_steps; step++) {
+        if (err_mix(err_vu_seed ^ err_mix((unsigned int)iteration * 0x85ebca6bu + (unsigned int)step)) % 10000 >= ERR_RATE_BP) continue;
+        len += sprintf(err_schedule + len, "%s%s", len ? "," : "", dt_step_suffix[step] + 5);
+    }
+}
+
+// Think time (same model as the native engine's ThinkTime): the mean is
+// think_time_ms or the step's estimated minutes, divided by time_compression,
+// drawn fixed / exponential / lognormal (sigma 0.5) at millisecond resolution
+// and capped at 10x the mean. The stream is seeded from err_vu_seed.
+#define THINK_SIGMA 0.5
+#define THINK_MAX_FACTOR 10.0
+unsigned int think_rng;
+
+double think_uniform()
+{
+    think_rng ^= think_rng << 13;
+    think_rng ^= think_rng >> 17;
+    think_rng ^= think_rng << 5;
+    return ((think_rng >> 8) + 0.5) / 16777216.0;
+}
+
+// Seconds for lr_think_time(), which takes fractions
+double think_time_sample(int estimated_minutes)
+{
+    double mean = (think_time_ms >= 0 ? think_time_ms : (estimated_minutes > 0 ? estimated_minutes : 5) * 60000.0) / time_compression;
+    double ms = mean;
+    if (mean > 0 && think_distribution == 1) {
+        ms = -mean * log(think_uniform());
+    } else if (mean > 0 && think_distribution == 2) {
+        double z = sqrt(-2 * log(think_uniform())) * cos(6.283185307179586 * think_uniform());
+        ms = exp(log(mean) - THINK_SIGMA * THINK_SIGMA / 2 + THINK_SIGMA * z);
+    }
+    if (ms > mean * THINK_MAX_FACTOR) ms = mean * THINK_MAX_FACTOR;
+    return (double)(long)(ms + 0.5) / 1000.0;
+}
+
+int lat_percentile(int step, double percentile)
+{
+    unsigned int target = (unsigned int)(percentile / 100.0 * lat_total[step] + 0.999999);
+    unsigned int seen = 0;
+    int i, bucket, value;
+    if (target == 0) target = 1;
+    for (i = 0; i < LAT_COUNTS; i++) {
+        seen += lat_counts[step][i];
+        if (seen >= target) {
+            bucket = i / LAT_HALF - 1;
+            value = i % LAT_HALF + LAT_HALF;
+            if (bucket < 0) { bucket = 0; value -= LAT_HALF; }
+            value = (value << bucket) + (1 << bucket) - 1;
+            return value < lat_max[step] ? value : lat_max[step];
+        }
+    }
+    return lat_max[step];
+}
+
+vuser_init()
+{
+    int step, suffix_max = 0;
+    for (step = 0; step <= DT_STEP_COMPLETE; step++)
+        if (dt_step_suffix_len[step] > suffix_max) suffix_max = dt_step_suffix_len[step];
+    dt_tsn_offset = snprintf(NULL, 0, "VU: %d; SI: %s; LSN: %s; LTN: %s; ",
+                             lr_get_vuser_id(), lr_get_session_id(), LSN, LTN);
+    dt_header = (char*)malloc(dt_tsn_offset + suffix_max + 1);
+    snprintf(dt_header, dt_tsn_offset + 1, "VU: %d; SI: %s; LSN: %s; LTN: %s; ",
+             lr_get_vuser_id(), lr_get_session_id(), LSN, LTN);
+    err_vu_seed = err_mix(ERR_SEED ^ ((unsigned int)lr_get_vuser_id() * 0x9e3779b9u));
+    think_rng = err_mix(err_vu_seed ^ 0x5bd1e995u) | 1;
+    if (results_path[0]) {
+        results_file = fopen(results_path, "ab");
+        if (results_file != NULL) setvbuf(results_file, results_buffer, _IOFBF, sizeof results_buffer);
+        else lr_error_message("Cannot open results file %s", results_path);
+    }
+    
+    // VU-constant headers go out once as auto headers; steps only add their own
+    if (connection_reuse) {
+        web_set_sockets_option("MAX_CONNECTIONS_PER_HOST", "1");
+        web_add_auto_header("Connection", "keep-alive");
+        web_add_auto_header("X-LoadRunner-Company", company_name);
+    }
+    return 0;
+}
+
+vuser_end()
+{
+    int step;
+    // Step names are the TSN suffixes without their "TSN: " prefix
+    for (step = 0; step < journey_steps; step++) {
+        if (lat_total[step] == 0) continue;
+        lr_user_data_point(arena_printf("p50_%s", dt_step_suffix[step] + 5), lat_percentile(step, 50));
+        lr_user_data_point(arena_printf("p99_%s", dt_step_suffix[step] + 5), lat_percentile(step, 99));
+        lr_user_data_point(arena_printf("p99.9_%s", dt_step_suffix[step] + 5), lat_percentile(step, 99.9));
+    }
+    if (results_file != NULL) fclose(results_file);
+    lr_output_message("Request arena: %d bytes at the largest iteration", arena_high_water);
+    arena_free_chain();
+    free(dt_header);
+    return 0;
+}
+
 Action()
 {
-    char step_name[256];
-    char endpoint_url[512];
-    char request_body[2048];
-    int step_duration;
+    char* request_body;
     
     // Initialize test execution
     lr_start_transaction("Journey_Initialization");
+    err_plan_iteration(lr_get_iteration_number());
     
     // Set Dynatrace headers for load test identification
-    sprintf(dt_header, "VU: %d; SI: %s; TSN: Journey_Start; LSN: %s; LTN: %s", 
-            lr_get_vuser_id(), lr_get_session_id(), LSN, LTN);
+    dt_set_step(DT_STEP_START);
     
     web_add_header("X-dynaTrace", dt_header);
-    web_add_header("X-LoadRunner-Company", company_name);
+    if (!connection_reuse) {
+        web_add_header("X-LoadRunner-Company", company_name);
+    }
     
     lr_end_transaction("Journey_Initialization", LR_PASS);
     
@@ -54,12 +349,11 @@ Action()
     // Final transaction summary
     lr_start_transaction("Journey_Complete");
     
-    sprintf(dt_header, "VU: %d; SI: %s; TSN: Journey_Complete; LSN: %s; LTN: %s", 
-            lr_get_vuser_id(), lr_get_session_id(), LSN, LTN);
+    dt_set_step(DT_STEP_COMPLETE);
     web_add_header("X-dynaTrace", dt_header);
     
     // Send journey completion event
-    sprintf(request_body, 
+    request_body = arena_printf(
         "{"
         "\"eventType\": \"JOURNEY_COMPLETE\","
         "\"companyName\": \"%s\","
@@ -72,6 +366,7 @@ Action()
         "}",
         company_name, LTN, LSN, lr_get_vuser_id(), lr_get_session_id(), journey_steps
     );
+    lr_save_string(request_body, "request_body");
     
     web_custom_request("Journey_Summary",
         "URL={base_url}/api/journey-complete",
@@ -84,32 +379,34 @@ Action()
         "Body={request_body}",
         LAST);
     
+    results_append(journey_steps, LR_PASS, lr_get_transaction_duration("Journey_Complete"));
     lr_end_transaction("Journey_Complete", LR_PASS);
     
+    arena_reset();
     return 0;
 }
 
-// Individual step template function
-int execute_journey_step(char* step_name, char* endpoint, char* method, char* body, int duration)
+// Individual step template function; step_index selects the TSN suffix
+int execute_journey_step(int step_index, char* step_name, char* endpoint, char* method, char* body, int duration)
 {
-    char transaction_name[256];
-    char full_url[512];
-    
     // Create transaction name
-    sprintf(transaction_name, "Step_%s", step_name);
+    char* transaction_name = arena_printf("Step_%s", step_name);
     
     lr_start_transaction(transaction_name);
     
     // Update TSN for this specific step
-    sprintf(dt_header, "VU: %d; SI: %s; TSN: %s; LSN: %s; LTN: %s", 
-            lr_get_vuser_id(), lr_get_session_id(), step_name, LSN, LTN);
+    dt_set_step(step_index);
     
     web_add_header("X-dynaTrace", dt_header);
     web_add_header("X-LoadRunner-Step", step_name);
     web_add_header("X-LoadRunner-Duration", lr_eval_string("{duration}"));
+    if (err_schedule[0]) web_add_header("x-error-schedule", err_schedule);
+    lr_save_string("", "step_status");
+    web_reg_save_param_ex("ParamName=step_status", "LB=\"stepStatus\":\"", "RB=\"", "Ordinal=1", "NotFound=Warning", SEARCH_FILTERS, "Scope=Body", LAST);
     
     // Build full URL
-    sprintf(full_url, "%s%s", base_url, endpoint);
+    lr_save_string(arena_printf("%s%s", base_url, endpoint), "full_url");
+    lr_save_string(body, "body");
     
     // Execute the request based on method
     if (strcmp(method, "POST") == 0) {
@@ -126,37 +423,20 @@ int execute_journey_step(char* step_name, char* endpoint, char* method, char* bo
     } else {
         web_url(step_name, "URL={full_url}", "Resource=0", "RecContentType=text/html", "Referer=", "Snapshot=t1.inf", "Mode=HTTP", LAST);
     }
+    response_time = lr_get_transaction_duration(transaction_name);
+    lat_record(step_index, response_time);
     
-    // Think time based on step duration
-    lr_think_time(duration);
-    
-    // Check for errors if error simulation is enabled
-    if (error_simulation && (rand() % 100) < 5) {  // 5% error rate
-        lr_end_transaction(transaction_name, LR_FAIL);
-        lr_error_message("Simulated error in step: %s", step_name);
-        return LR_FAIL;
+    // The service decided the outcome (x-error-schedule or feature flags)
+    if (web_get_int_property(HTTP_INFO_RETURN_CODE) >= 400 || strcmp(lr_eval_string("{step_status}"), "failed") == 0) {
+        transaction_status = LR_FAIL;
+        lr_error_message("Step %s failed: HTTP %d", step_name, web_get_int_property(HTTP_INFO_RETURN_CODE));
+    } else {
+        transaction_status = LR_PASS;
     }
+    results_append(step_index, transaction_status, response_time);
+    lr_end_transaction(transaction_name, transaction_status);
     
-    lr_end_transaction(transaction_name, LR_PASS);
-    return LR_PASS;
-}
-
-// Error handling function
-int handle_step_error(char* step_name, int error_code)
-{
-    char error_transaction[256];
-    sprintf(error_transaction, "Error_%s", step_name);
-    
-    lr_start_transaction(error_transaction);
-    
-    // Update headers for error tracking
-    sprintf(dt_header, "VU: %d; SI: %s; TSN: Error_%s; LSN: %s; LTN: %s; ErrorCode: %d", 
-            lr_get_vuser_id(), lr_get_session_id(), step_name, LSN, LTN, error_code);
-    
-    web_add_header("X-dynaTrace", dt_header);
-    web_add_header("X-LoadRunner-Error", "true");
-    
-    lr_end_transaction(error_transaction, LR_FAIL);
-    
-    return 0;
+    // Think time around the step's estimated duration (minutes), outside the step's transaction
+    lr_think_time(think_time_sample(duration));
+    return transaction_status;
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+/**
+ * Request Context Middleware
+ * Correlation id, tracing headers to propagate and a frontend host label on
+ * every request; shared by the main server and its cluster workers
+ */
+
+import { v4 as uuidv4 } from 'uuid';
+
+// Frontend host label (avoid showing raw 'localhost')
+function hostToLabel(host) {
+  if (!host) return 'Unknown Host';
+  if (process.env.APP_DOMAIN_LABEL) return process.env.APP_DOMAIN_LABEL;
+  if (host.includes('localhost') || host.startsWith('127.')) return 'Local Dev';
+  return host;
+}
+
+/**
+ * Attach helpful request context and distributed tracing; `io` is exposed
+ * as req.io where the process has Socket.IO
+ */
+export function requestContext(io = null) {
+  return (req, res, next) => {
+    const cid = req.headers['x-correlation-id'] || uuidv4();
+    req.correlationId = cid;
+    res.setHeader('x-correlation-id', cid);
+
+    // Extract and preserve all Dynatrace tracing headers for propagation
+    req.tracingHeaders = {};
+    const headerKeys = Object.keys(req.headers || {});
+    for (const key of headerKeys) {
+      const lowerKey = key.toLowerCase();
+      // Capture Dynatrace, W3C Trace Context, and other distributed tracing headers
+      if (lowerKey.startsWith('x-dynatrace') ||
+          lowerKey.startsWith('traceparent') ||
+          lowerKey.startsWith('tracestate') ||
+          lowerKey.startsWith('x-trace') ||
+          lowerKey.startsWith('x-request-id') ||
+          lowerKey.startsWith('x-correlation-id') ||
+          lowerKey.startsWith('x-span-id') ||
+          lowerKey.startsWith('dt-') ||
+          lowerKey.startsWith('uber-trace-id')) {
+        req.tracingHeaders[key] = req.headers[key];
+      }
+    }
+
+    const host = req.headers['x-forwarded-host'] || req.headers.host || '';
+    req.frontendHostLabel = hostToLabel(host);
+    res.setHeader('X-App-Domain-Label', req.frontendHostLabel);
+
+    // Expose Socket.IO on request for route handlers
+    if (io) req.io = io;
+    next();
+  };
+}
@@ -0,0 +1,81 @@
+#include "arena.h"
+
+#include <cstring>
+
+namespace bizobs::loadgen {
+
+namespace {
+
+constexpr size_t kRound = 1024;
+
+size_t roundUp(size_t n) { return (n + kRound - 1) / kRound * kRound; }
+
+} // namespace
+
+Arena::Arena(size_t initialBytes) {
+    addChunk(roundUp(initialBytes ? initialBytes : kRound));
+}
+
+void Arena::addChunk(size_t size) {
+    chunks_.push_back(Chunk{std::unique_ptr<char[]>(new char[size]), size});
+}
+
+void Arena::grow(size_t need) {
+    // Carry the open block over so it stays contiguous; earlier blocks keep
+    // living in their chunk until reset()
+    const size_t openLen = used_ - open_;
+    const Chunk& cur = chunks_.back();
+    size_t size = cur.size * 2;
+    if (size < openLen + need) size = roundUp(openLen + need);
+    const char* from = cur.data.get() + open_;
+    addChunk(size);
+    std::memcpy(chunks_.back().data.get(), from, openLen);
+    open_ = 0;
+    used_ = openLen;
+}
+
+char* Arena::alloc(size_t n) {
+    // Never split an open block: hand out memory after it is taken
+    if (used_ != open_) take();
+    if (chunks_.back().size - used_ < n) grow(n);
+    char* p = chunks_.back().data.get() + used_;
+    used_ += n;
+    open_ = used_;
+    iterBytes_ += n;
+    return p;
+}
+
+void Arena::reserve(size_t n) {
+    if (chunks_.back().size - used_ < n) grow(n);
+}
+
+Arena& Arena::operator+=(std::string_view s) {
+    reserve(s.size());
+    std::memcpy(chunks_.back().data.get() + used_, s.data(), s.size());
+    used_ += s.size();
+    iterBytes_ += s.size();
+    return *this;
+}
+
+std::string_view Arena::take() {
+    std::string_view block(chunks_.back().data.get() + open_, used_ - open_);
+    open_ = used_;
+    return block;
+}
+
+void Arena::reset() {
+    if (iterBytes_ > highWater_) highWater_ = iterBytes_;
+    if (chunks_.size() > 1) {
+        chunks_.clear();
+        addChunk(roundUp(highWater_));
+    }
+    used_ = open_ = iterBytes_ = 0;
+}
+
+size_t Arena::capacity() const {
+    size_t n = 0;
+    for (const Chunk& c : chunks_) n += c.size;
+    return n;
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,60 @@
+/*
+ * Per-VU bump arena for request assembly.
+ *
+ * Everything a VU formats during one iteration (headers, rendered bodies) is
+ * carved from the arena and released at once by reset() before the next
+ * iteration. When the current chunk runs out a bigger one is chained, so a
+ * large journey never overruns anything; reset() then folds the chunks into
+ * one sized to the largest iteration seen. Steady state is a single buffer
+ * per VU that matches the real journey size, not a worst-case guess.
+ *
+ * Same policy as arena_alloc() / arena_reset() in the generated LoadRunner
+ * script.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+class Arena {
+public:
+    explicit Arena(size_t initialBytes = 2048);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Fixed-size block, valid until reset().
+    char* alloc(size_t n);
+
+    // Open block: bytes appended since the last take() stay contiguous, moving
+    // to a bigger chunk if they outgrow the current one.
+    void reserve(size_t n);
+    Arena& operator+=(std::string_view s);
+    Arena& operator+=(char c) { return *this += std::string_view(&c, 1); }
+    // Closes the open block and returns it; valid until reset().
+    std::string_view take();
+
+    void reset();
+
+    size_t capacity() const; // bytes currently held
+    size_t highWater() const { return highWater_; }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+    std::vector<Chunk> chunks_;
+    size_t used_ = 0;      // bytes used in chunks_.back(), open block included
+    size_t open_ = 0;      // start of the open block in chunks_.back()
+    size_t iterBytes_ = 0; // bytes handed out since reset()
+    size_t highWater_ = 0;
+
+    void addChunk(size_t size);
+    void grow(size_t need);
+};
+
+} // namespace bizobs::loadgen
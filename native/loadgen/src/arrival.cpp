@@ -0,0 +1,45 @@
+#include "arrival.h"
+
+#include <cmath>
+
+namespace bizobs::loadgen {
+
+ArrivalSchedule::ArrivalSchedule(double ratePerSec, double rampUpSec, double durationSec, double rampDownSec) {
+    if (ratePerSec <= 0) return;
+    double t = 0, cum = 0;
+    auto add = [&](double len, double r0, double r1) {
+        if (len <= 0) return;
+        const double n = (r0 + r1) / 2 * len;
+        segments_.push_back(Segment{t, t + len, r0, r1, cum, cum + n});
+        t += len;
+        cum += n;
+    };
+    add(rampUpSec, 0, ratePerSec);
+    add(durationSec, ratePerSec, ratePerSec);
+    add(rampDownSec, ratePerSec, 0);
+}
+
+double ArrivalSchedule::arrivalSec(uint64_t k) const {
+    // Arrival k is due once k + 1 journeys' worth of rate has accumulated
+    const double target = static_cast<double>(k) + 1;
+    for (const Segment& s : segments_) {
+        if (target > s.cumEnd) continue;
+        const double need = target - s.cumStart;
+        const double len = s.end - s.start;
+        const double slope = (s.r1 - s.r0) / len;
+        // Solve r0 * x + slope / 2 * x^2 = need for x in [0, len]
+        double x;
+        if (std::fabs(slope) < 1e-12) {
+            x = need / s.r0;
+        } else {
+            const double disc = s.r0 * s.r0 + 2 * slope * need;
+            x = (std::sqrt(disc > 0 ? disc : 0) - s.r0) / slope;
+        }
+        if (x < 0) x = 0;
+        if (x > len) x = len;
+        return s.start + x;
+    }
+    return -1;
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,40 @@
+/*
+ * Open-model arrival schedule: journeys start on a target journeys/sec curve,
+ * independent of how long earlier journeys take.
+ *
+ * The curve is the scenario's own shape - linear ramp from 0 to the target
+ * rate over ramp_up_time, plateau for duration, linear ramp back to 0 over
+ * ramp_down_time - so a 60 s ramp to 300/s in spike-test.json is a spike and
+ * a 1200 s ramp in stress-test.json is a slow climb.
+ *
+ * Arrival k is placed where the integral of the rate reaches k, which spaces
+ * arrivals evenly at any instantaneous rate and makes runs reproducible.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+class ArrivalSchedule {
+public:
+    ArrivalSchedule(double ratePerSec, double rampUpSec, double durationSec, double rampDownSec);
+
+    // Offset of arrival `k` (0-based) from the start of the run, or a
+    // negative value once the curve has no k-th arrival left.
+    double arrivalSec(uint64_t k) const;
+    double endSec() const { return segments_.empty() ? 0 : segments_.back().end; }
+    // Journeys the whole curve offers.
+    double totalArrivals() const { return segments_.empty() ? 0 : segments_.back().cumEnd; }
+
+private:
+    struct Segment {
+        double start, end;     // seconds
+        double r0, r1;         // rate at start / end
+        double cumStart, cumEnd;
+    };
+    std::vector<Segment> segments_;
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,244 @@
+/*
+ * bizobs-loadgen-bench - microbenchmarks for the per-step hot path.
+ *
+ * What a VU does between two requests, without the network:
+ *
+ *   headers  request line + common headers, as VUser::appendCommonHeaders
+ *            and sendStep() append them (X-dynaTrace patched per step)
+ *   body     a step body rendered from the compiled template into the arena
+ *   chained  the whole-journey body rendered the same way
+ *   record   TxStats::record() plus one ResultStore::append() to a temp file
+ *
+ * Built with -DBIZOBS_LOADGEN_BENCH=ON; runs against the same pinned journey
+ * as the scenario benchmark (scripts/benchmark.js --micro compares the --json
+ * output with loadrunner-tests/baselines/micro.json):
+ *
+ *   bizobs-loadgen-bench --config loadrunner-tests/BT/test-config.json --json
+ */
+#include "arena.h"
+#include "body_template.h"
+#include "journey.h"
+#include "json.h"
+#include "results_store.h"
+#include "stats.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace bizobs::loadgen;
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr,
+        "Usage: bizobs-loadgen-bench --config <test-config.json> [options]\n"
+        "\n"
+        "  --ops <n>                  operations per round (default 200000)\n"
+        "  --rounds <n>               timed rounds per benchmark, fastest reported (default 5)\n"
+        "  --error-simulation <0|1>   compile bodies with the error-simulation fields\n"
+        "  --json                     print one JSON object instead of a table\n");
+}
+
+struct Result {
+    const char* name;
+    double nsPerOp;
+    double bytesPerOp;
+};
+
+// Keeps the optimiser from dropping work whose output is never read
+volatile size_t g_sink = 0;
+
+int g_rounds = 5;
+
+// Best of g_rounds: scheduler noise only ever adds time
+template <class F>
+Result measure(const char* name, long ops, F&& op) {
+    for (long i = 0; i < ops / 10; ++i) g_sink += op(i); // warm caches and arena sizes
+    double best = 0;
+    size_t bytes = 0;
+    for (int r = 0; r < g_rounds; ++r) {
+        bytes = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (long i = 0; i < ops; ++i) bytes += op(i);
+        const auto t1 = std::chrono::steady_clock::now();
+        g_sink += bytes;
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        if (r == 0 || ns < best) best = ns;
+    }
+    return {name, best / static_cast<double>(ops), static_cast<double>(bytes) / static_cast<double>(ops)};
+}
+
+// Per-iteration slot values shaped like VUser::beginIteration()'s
+SlotValues benchSlots(const std::string& ltn, const std::string& lsn) {
+    SlotValues slots;
+    const std::string cid = "LR_" + ltn + "_17_42_1760400000";
+    slots[static_cast<size_t>(Slot::CorrelationId)] = cid;
+    slots[static_cast<size_t>(Slot::CustomerId)] = "customer_17_42_0000";
+    slots[static_cast<size_t>(Slot::SessionId)] = "session_" + lsn + "_17_42";
+    slots[static_cast<size_t>(Slot::TraceId)] = "trace_" + cid + "_1760400000";
+    slots[static_cast<size_t>(Slot::CustomerName)] = "Alex Morgan";
+    slots[static_cast<size_t>(Slot::CustomerEmail)] = "alex.morgan@example.com";
+    slots[static_cast<size_t>(Slot::CustomerSegment)] = "premium";
+    slots[static_cast<size_t>(Slot::CompletionTime)] = "2025-11-21T00:00:00Z";
+    return slots;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string configPath;
+    long ops = 200000;
+    bool errorSimulation = false;
+    bool asJson = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!std::strcmp(arg, "--help") || !std::strcmp(arg, "-h")) {
+            usage();
+            return 0;
+        }
+        if (!std::strcmp(arg, "--json")) {
+            asJson = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "[bizobs-loadgen] ❌ Missing value for %s\n", arg);
+            usage();
+            return 2;
+        }
+        const char* val = argv[++i];
+        if (!std::strcmp(arg, "--config")) configPath = val;
+        else if (!std::strcmp(arg, "--ops")) ops = std::atol(val);
+        else if (!std::strcmp(arg, "--rounds")) g_rounds = std::atoi(val);
+        else if (!std::strcmp(arg, "--error-simulation")) errorSimulation = std::atoi(val) != 0;
+        else {
+            std::fprintf(stderr, "[bizobs-loadgen] ❌ Unknown option %s\n", arg);
+            usage();
+            return 2;
+        }
+    }
+    if (configPath.empty() || ops <= 0 || g_rounds <= 0) {
+        usage();
+        return 2;
+    }
+
+    try {
+        const Journey journey = loadJourney(configPath);
+        if (journey.steps.empty()) throw std::runtime_error(configPath + " has no steps");
+        const size_t steps = journey.steps.size();
+        const std::string lsn = defaultLsn(journey), ltn = defaultLtn(journey);
+        const JourneyBodies bodies = compileJourneyBodies(journey, errorSimulation);
+        const SlotValues slots = benchSlots(ltn, lsn);
+        const std::string& cid = slots[static_cast<size_t>(Slot::CorrelationId)];
+
+        std::vector<std::string> dtStepSuffix;
+        for (const auto& s : journey.steps) dtStepSuffix.push_back("TSN=" + s.name);
+        std::string dtHeader = "LSN=" + lsn + ";LTN=" + ltn + ";VU=17;SI=NativeEngine;PC=BizObs-Demo;AN=" +
+                               journey.companyName + ";CID=" + cid + ";";
+        const size_t dtTsnOffset = dtHeader.size();
+
+        Arena arena;
+        std::vector<Result> results;
+
+        results.push_back(measure("headers", ops, [&](long i) {
+            const size_t step = static_cast<size_t>(i) % steps;
+            const JourneyStep& s = journey.steps[step];
+            if (step == 0) arena.reset();
+            dtHeader.resize(dtTsnOffset);
+            dtHeader += dtStepSuffix[step];
+            Arena& req = arena;
+            req.reserve(768);
+            req += "POST /api/journey-simulation/simulate-journey HTTP/1.1\r\nHost: localhost:8080";
+            req += "\r\nContent-Type: application/json\r\nUser-Agent: LoadRunner-BizObs-Agent/1.0\r\nConnection: ";
+            req += "close";
+            req += "\r\nx-loadrunner-test: true\r\nX-dynaTrace: ";
+            req += dtHeader;
+            req += "\r\nx-correlation-id: ";
+            req += cid;
+            req += "\r\nx-customer-id: ";
+            req += slots[static_cast<size_t>(Slot::CustomerId)];
+            req += "\r\nx-session-id: ";
+            req += slots[static_cast<size_t>(Slot::SessionId)];
+            req += "\r\nx-trace-id: ";
+            req += slots[static_cast<size_t>(Slot::TraceId)];
+            req += "\r\nx-test-iteration: ";
+            req += std::to_string(42);
+            req += "\r\nContent-Length: ";
+            req += std::to_string(bodies.steps[step].renderedSize(slots));
+            req += "\r\nx-step-name: ";
+            req += s.name;
+            req += "\r\nx-service-name: ";
+            req += s.serviceName;
+            req += "\r\nx-customer-segment: premium\r\nx-traffic-source: organic_search\r\n\r\n";
+            return req.take().size();
+        }));
+
+        results.push_back(measure("body", ops, [&](long i) {
+            const size_t step = static_cast<size_t>(i) % steps;
+            if (step == 0) arena.reset();
+            const BodyTemplate& body = bodies.steps[step];
+            arena.reserve(body.renderedSize(slots));
+            body.render(arena, slots);
+            return arena.take().size();
+        }));
+
+        results.push_back(measure("chained", ops / static_cast<long>(steps) + 1, [&](long) {
+            arena.reset();
+            arena.reserve(bodies.journey.renderedSize(slots));
+            bodies.journey.render(arena, slots);
+            return arena.take().size();
+        }));
+
+        // Record into the real store, buffered writes and all; the file goes
+        // away with the run
+        char resultsPath[] = "/tmp/bizobs-loadgen-bench-XXXXXX";
+        const int fd = mkstemp(resultsPath);
+        if (fd < 0) throw std::runtime_error("Cannot create a temporary results file");
+        close(fd);
+        {
+            ResultStore store(resultsPath);
+            StatsTable stats;
+            for (const auto& s : journey.steps) stats.add(s.name);
+            results.push_back(measure("record", ops, [&](long i) {
+                const size_t step = static_cast<size_t>(i) % steps;
+                const uint64_t serviceUs = 800 + static_cast<uint64_t>(i % 4096) * 13;
+                stats[step].record(true, serviceUs, serviceUs + 150);
+                store.append(17, static_cast<int>(i / static_cast<long>(steps)), step, true, serviceUs);
+                return ResultStore::kRecordBytes;
+            }));
+        }
+        unlink(resultsPath);
+
+        if (asJson) {
+            std::string out = "{\"engine\":\"bizobs-loadgen-bench\",\"companyName\":\"";
+            json::appendEscaped(out, journey.companyName);
+            char buf[160];
+            std::snprintf(buf, sizeof buf, "\",\"steps\":%zu,\"ops\":%ld,\"benchmarks\":{", steps, ops);
+            out += buf;
+            for (size_t i = 0; i < results.size(); ++i) {
+                std::snprintf(buf, sizeof buf, "%s\"%s\":{\"nsPerOp\":%.2f,\"bytesPerOp\":%.1f}",
+                              i ? "," : "", results[i].name, results[i].nsPerOp, results[i].bytesPerOp);
+                out += buf;
+            }
+            out += "}}\n";
+            std::fputs(out.c_str(), stdout);
+        } else {
+            std::printf("[bizobs-loadgen] %s, %zu steps, %ld ops\n", journey.companyName.c_str(), steps, ops);
+            std::printf("%-10s %12s %12s %10s\n", "benchmark", "ns/op", "bytes/op", "MB/s");
+            for (const Result& r : results)
+                std::printf("%-10s %12.1f %12.1f %10.1f\n", r.name, r.nsPerOp, r.bytesPerOp,
+                            r.nsPerOp > 0 ? r.bytesPerOp / r.nsPerOp * 1000.0 : 0.0);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "[bizobs-loadgen] ❌ %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,167 @@
+#include "body_template.h"
+
+#include "json.h"
+
+#include <stdexcept>
+
+namespace bizobs::loadgen {
+
+namespace {
+
+constexpr std::string_view kSlotNames[kSlotCount] = {
+    "correlation_id", "customer_id",   "session_id",       "trace_id",
+    "customer_name",  "customer_email", "customer_segment", "completion_time",
+};
+
+// Slot index for `name`, or kSlotCount when it is not a slot.
+size_t slotIndex(std::string_view name) {
+    for (size_t i = 0; i < kSlotCount; ++i)
+        if (kSlotNames[i] == name) return i;
+    return kSlotCount;
+}
+
+void appendStepObject(std::string& out, const JourneyStep& s, size_t index) {
+    out += "{\"stepNumber\":";
+    out += std::to_string(index + 1);
+    out += ",\"stepName\":\"";
+    json::appendEscaped(out, s.name);
+    out += "\",\"serviceName\":\"";
+    json::appendEscaped(out, s.serviceName);
+    out += "\",\"description\":\"";
+    json::appendEscaped(out, s.description);
+    out += "\",\"estimatedDuration\":";
+    json::appendNumber(out, s.estimatedDuration);
+    out += ",\"substeps\":";
+    out += s.substepsJson;
+    out += '}';
+}
+
+// The simulate-journey envelope around `steps` (indices into journey.steps),
+// field for field what compileJourneyBodies() builds on the generator side
+std::string envelope(const Journey& j, bool errorSimulation, size_t first, size_t last) {
+    std::string out;
+    out += "{\"journeyId\":\"{correlation_id}\",\"customerId\":\"{customer_id}\","
+           "\"sessionId\":\"{session_id}\",\"traceId\":\"{trace_id}\","
+           "\"chained\":true,\"thinkTimeMs\":250,\"errorSimulationEnabled\":";
+    out += errorSimulation ? "true" : "false";
+    out += ",\"journey\":{\"journeyId\":\"{correlation_id}\",\"companyName\":\"";
+    json::appendEscaped(out, j.companyName);
+    out += "\",\"domain\":\"";
+    json::appendEscaped(out, j.domain);
+    out += "\",\"steps\":[";
+    for (size_t i = first; i < last; ++i) {
+        if (i != first) out += ',';
+        appendStepObject(out, j.steps[i], i);
+    }
+    out += "],\"additionalFields\":";
+    out += j.additionalFieldsJson;
+    out += ",\"customerProfile\":{\"name\":\"{customer_name}\",\"email\":\"{customer_email}\","
+           "\"segment\":\"{customer_segment}\",\"userId\":\"{customer_id}\","
+           "\"deviceType\":\"desktop\",\"location\":\"US-East\"}}}";
+    return out;
+}
+
+} // namespace
+
+BodyTemplate BodyTemplate::compile(std::string_view json) {
+    BodyTemplate t;
+    std::string text;
+    size_t pos = 0;
+    while (pos < json.size()) {
+        const size_t open = json.find('{', pos);
+        if (open == std::string_view::npos) break;
+        const size_t close = json.find('}', open + 1);
+        const size_t slot = close == std::string_view::npos
+                                ? kSlotCount
+                                : slotIndex(json.substr(open + 1, close - open - 1));
+        if (slot == kSlotCount) {
+            text.append(json.substr(pos, open + 1 - pos));
+            pos = open + 1;
+            continue;
+        }
+        text.append(json.substr(pos, open - pos));
+        t.staticBytes_ += text.size();
+        t.text_.push_back(std::move(text));
+        text.clear();
+        t.slots_.push_back(static_cast<Slot>(slot));
+        pos = close + 1;
+    }
+    text.append(json.substr(pos));
+    t.staticBytes_ += text.size();
+    t.text_.push_back(std::move(text));
+    return t;
+}
+
+BodyTemplate BodyTemplate::fromJson(const json::Value& v) {
+    const json::Value* segments = v.get("segments");
+    const json::Value* slots = v.get("slots");
+    if (!segments || !segments->isArray() || !slots || !slots->isArray() ||
+        segments->items().size() != slots->items().size() + 1)
+        throw std::runtime_error("body template needs segments[n + 1] and slots[n]");
+
+    BodyTemplate t;
+    for (const json::Value& seg : segments->items()) {
+        t.text_.push_back(seg.asString());
+        t.staticBytes_ += t.text_.back().size();
+    }
+    for (const json::Value& name : slots->items()) {
+        const size_t slot = slotIndex(name.asString());
+        if (slot == kSlotCount) throw std::runtime_error("unknown body slot " + name.asString());
+        t.slots_.push_back(static_cast<Slot>(slot));
+    }
+    return t;
+}
+
+size_t BodyTemplate::renderedSize(const SlotValues& values) const {
+    size_t n = staticBytes_;
+    for (Slot s : slots_) n += values[static_cast<size_t>(s)].size();
+    return n;
+}
+
+JourneyBodies compileJourneyBodies(const Journey& journey, bool errorSimulation) {
+    JourneyBodies b;
+    const size_t n = journey.steps.size();
+    b.steps.reserve(n);
+    for (size_t i = 0; i < n; ++i) b.steps.push_back(BodyTemplate::compile(envelope(journey, errorSimulation, i, i + 1)));
+    b.journey = BodyTemplate::compile(envelope(journey, errorSimulation, 0, n));
+
+    std::string completion = "{\"eventType\":\"journey_completed\",\"correlationId\":\"{correlation_id}\","
+                             "\"customerId\":\"{customer_id}\",\"companyName\":\"";
+    json::appendEscaped(completion, journey.companyName);
+    completion += "\",\"customerName\":\"{customer_name}\",\"customerSegment\":\"{customer_segment}\","
+                  "\"totalSteps\":";
+    completion += std::to_string(n);
+    completion += ",\"loadTest\":true,\"completionTime\":\"{completion_time}\"}";
+    b.completion = BodyTemplate::compile(completion);
+    return b;
+}
+
+JourneyBodies loadJourneyBodies(const std::string& path, size_t stepCount) {
+    json::Value root;
+    try {
+        root = json::Value::parse(readFile(path));
+    } catch (const json::ParseError& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+
+    const json::Value* steps = root.get("steps");
+    const json::Value* journey = root.get("journey");
+    const json::Value* completion = root.get("completion");
+    if (!steps || !steps->isArray() || !journey || !completion)
+        throw std::runtime_error(path + ": expected steps, journey and completion bodies");
+    if (steps->items().size() != stepCount)
+        throw std::runtime_error(path + ": " + std::to_string(steps->items().size()) +
+                                 " step bodies for a " + std::to_string(stepCount) + "-step journey");
+
+    JourneyBodies b;
+    try {
+        for (const json::Value& s : steps->items()) b.steps.push_back(BodyTemplate::fromJson(s));
+        b.journey = BodyTemplate::fromJson(*journey);
+        b.completion = BodyTemplate::fromJson(*completion);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+    return b;
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,79 @@
+/*
+ * Compiled request bodies: static JSON segments interleaved with per-VU slots.
+ *
+ * Same layout as the body tables generateLoadRunnerScript() emits and the
+ * body-templates.json it writes next to the script:
+ *
+ *   text[0] slot[0] text[1] ... slot[n-1] text[n]
+ *
+ * Bodies are compiled once per run; a request only appends segments and the
+ * VU's current slot values. Slot values are copied raw, so they must already
+ * be JSON-escaped (VUser escapes the customer profile once at start).
+ */
+#pragma once
+
+#include "journey.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+namespace json { class Value; }
+
+// Order matches BODY_SLOTS in routes/loadrunner-integration.js
+enum class Slot : uint8_t {
+    CorrelationId,
+    CustomerId,
+    SessionId,
+    TraceId,
+    CustomerName,
+    CustomerEmail,
+    CustomerSegment,
+    CompletionTime,
+    Count
+};
+constexpr size_t kSlotCount = static_cast<size_t>(Slot::Count);
+using SlotValues = std::array<std::string, kSlotCount>;
+
+class BodyTemplate {
+public:
+    // Split a JSON document on {correlation_id}-style slot placeholders.
+    static BodyTemplate compile(std::string_view json);
+    // One entry of body-templates.json: {"segments": [...], "slots": [...]}.
+    static BodyTemplate fromJson(const json::Value& v);
+
+    bool empty() const { return text_.empty(); }
+    size_t renderedSize(const SlotValues& values) const;
+    // Appends to anything with += (std::string, Arena).
+    template <class Out>
+    void render(Out& out, const SlotValues& values) const {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            out += text_[i];
+            out += values[static_cast<size_t>(slots_[i])];
+        }
+        out += text_.back();
+    }
+
+private:
+    std::vector<std::string> text_;
+    std::vector<Slot> slots_;
+    size_t staticBytes_ = 0;
+};
+
+struct JourneyBodies {
+    std::vector<BodyTemplate> steps; // one-step simulate-journey body per step
+    BodyTemplate journey;            // chained body carrying every step
+    BodyTemplate completion;         // journey_completed event
+};
+
+// Build the bodies from the journey itself.
+JourneyBodies compileJourneyBodies(const Journey& journey, bool errorSimulation);
+// Load the generator's body-templates.json; throws std::runtime_error if it
+// does not match the journey's step count.
+JourneyBodies loadJourneyBodies(const std::string& path, size_t stepCount);
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,182 @@
+#include "capacity_search.h"
+
+#include "json.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace bizobs::loadgen {
+
+namespace {
+
+constexpr double kMinRate = 0.01; // journeys/sec; backing off below this gives up
+
+std::string format(const char* fmt, const std::string& name, double value, double limit) {
+    char buf[256];
+    std::snprintf(buf, sizeof buf, fmt, name.c_str(), value, limit);
+    return buf;
+}
+
+} // namespace
+
+CapacitySearch::CapacitySearch(const CapacitySearchConfig& cfg, double thresholdMs, double errorThresholdPct,
+                               double fallbackRate)
+    : cfg_(cfg), thresholdMs_(thresholdMs), errorThresholdPct_(errorThresholdPct) {
+    if (thresholdMs_ <= 0 && errorThresholdPct_ <= 0)
+        throw std::runtime_error("capacity search needs monitoring.response_time_threshold or error_rate_threshold");
+    if (cfg_.stepSec <= 0) cfg_.stepSec = 30;
+    if (cfg_.growth <= 1) cfg_.growth = 2;
+    if (cfg_.precision <= 0) cfg_.precision = 0.05;
+    if (cfg_.maxSteps < 1) cfg_.maxSteps = 1;
+    rate_ = cfg_.startRate > 0 ? cfg_.startRate : std::max(1.0, fallbackRate / 4);
+    if (cfg_.maxRate > 0 && rate_ > cfg_.maxRate) rate_ = cfg_.maxRate;
+}
+
+CapacitySearch::Verdict& CapacitySearch::verdictFor(const std::string& name) {
+    for (Verdict& v : verdicts_)
+        if (v.name == name) return v;
+    verdicts_.push_back(Verdict{name, 0, 0, {}});
+    return verdicts_.back();
+}
+
+bool CapacitySearch::finishStep(const std::vector<WindowSample>& window, size_t queued) {
+    StepRecord step{rate_, true, {}, 0, 0, 0, queued};
+    for (const WindowSample& s : window) {
+        if (s.count == 0) continue;
+        step.requests += s.count;
+        const double errorPct = 100.0 * static_cast<double>(s.fail) / static_cast<double>(s.count);
+        step.worstP99Ms = std::max(step.worstP99Ms, s.p99Ms);
+        step.worstErrorPct = std::max(step.worstErrorPct, errorPct);
+
+        std::string reason;
+        if (thresholdMs_ > 0 && s.p99Ms > thresholdMs_)
+            reason = format("%s p99 %.0f ms > %.0f ms", *s.name, s.p99Ms, thresholdMs_);
+        else if (errorThresholdPct_ > 0 && errorPct > errorThresholdPct_)
+            reason = format("%s errors %.1f%% > %.1f%%", *s.name, errorPct, errorThresholdPct_);
+
+        Verdict& v = verdictFor(*s.name);
+        if (reason.empty()) {
+            v.heldUpTo = std::max(v.heldUpTo, rate_);
+            continue;
+        }
+        if (v.brokeAt == 0 || rate_ < v.brokeAt) {
+            v.brokeAt = rate_;
+            v.reason = reason;
+        }
+        if (step.held) {
+            step.held = false;
+            step.reason = reason;
+        }
+    }
+    // A backlog means the offered rate was not absorbed, whatever the
+    // requests that did run looked like
+    if (step.held && static_cast<double>(queued) > std::max(1.0, rate_)) {
+        char buf[96];
+        std::snprintf(buf, sizeof buf, "%zu arrivals queued for a free VU", queued);
+        step.held = false;
+        step.reason = buf;
+    }
+    if (step.held && step.requests == 0) {
+        step.held = false;
+        step.reason = "no requests completed (step_time shorter than a journey?)";
+    }
+
+    if (step.held) held_ = std::max(held_, rate_);
+    else if (failed_ == 0 || rate_ < failed_) failed_ = rate_;
+    history_.push_back(step);
+    advance();
+    return step.held;
+}
+
+void CapacitySearch::advance() {
+    if (static_cast<int>(history_.size()) >= cfg_.maxSteps) {
+        done_ = true;
+        return;
+    }
+    // Still climbing: nothing has failed yet
+    if (failed_ == 0) {
+        double next = rate_ * cfg_.growth;
+        if (cfg_.maxRate > 0 && next > cfg_.maxRate) {
+            if (held_ >= cfg_.maxRate) {
+                done_ = true;
+                return;
+            }
+            next = cfg_.maxRate;
+        }
+        rate_ = next;
+        return;
+    }
+    // The first rate already failed: back off until one holds
+    if (held_ == 0) {
+        rate_ = failed_ / cfg_.growth;
+        if (rate_ < kMinRate) done_ = true;
+        return;
+    }
+    if (failed_ <= held_ * (1 + cfg_.precision)) {
+        done_ = true;
+        return;
+    }
+    rate_ = (held_ + failed_) / 2;
+}
+
+const CapacitySearch::Verdict* CapacitySearch::bottleneck() const {
+    const Verdict* worst = nullptr;
+    for (const Verdict& v : verdicts_)
+        if (v.brokeAt > 0 && (!worst || v.brokeAt < worst->brokeAt)) worst = &v;
+    return worst;
+}
+
+void CapacitySearch::appendJson(std::string& out) const {
+    char buf[256];
+    std::snprintf(buf, sizeof buf, "\"capacitySearch\":{\"maxSustainableRate\":%.3f,\"lowestFailedRate\":%.3f,"
+                  "\"thresholds\":{\"p99Ms\":%.1f,\"errorRatePct\":%.2f},\"stepSec\":%.1f,\"bottleneck\":",
+                  held_, failed_, thresholdMs_, errorThresholdPct_, cfg_.stepSec);
+    out += buf;
+    if (const Verdict* b = bottleneck()) {
+        out += '"';
+        json::appendEscaped(out, b->name);
+        out += '"';
+    } else {
+        out += "null";
+    }
+    out += ",\"steps\":[";
+    for (size_t i = 0; i < history_.size(); ++i) {
+        const StepRecord& s = history_[i];
+        std::snprintf(buf, sizeof buf, "%s{\"rate\":%.3f,\"held\":%s,\"requests\":%llu,\"worstP99Ms\":%.1f,"
+                      "\"worstErrorPct\":%.2f,\"queued\":%zu,\"reason\":\"",
+                      i ? "," : "", s.rate, s.held ? "true" : "false", static_cast<unsigned long long>(s.requests),
+                      s.worstP99Ms, s.worstErrorPct, s.queued);
+        out += buf;
+        json::appendEscaped(out, s.reason);
+        out += "\"}";
+    }
+    out += "],\"transactions\":[";
+    for (size_t i = 0; i < verdicts_.size(); ++i) {
+        const Verdict& v = verdicts_[i];
+        out += i ? ",{\"name\":\"" : "{\"name\":\"";
+        json::appendEscaped(out, v.name);
+        std::snprintf(buf, sizeof buf, "\",\"heldUpTo\":%.3f,\"brokeAt\":%.3f,\"reason\":\"", v.heldUpTo, v.brokeAt);
+        out += buf;
+        json::appendEscaped(out, v.reason);
+        out += "\"}";
+    }
+    out += "]},";
+}
+
+void CapacitySearch::printReport() const {
+    if (held_ > 0)
+        std::printf("[bizobs-loadgen] 📐 Capacity: %.2f journeys/s held", held_);
+    else
+        std::printf("[bizobs-loadgen] 📐 Capacity: no rate held");
+    if (failed_ > 0) std::printf(", failed at %.2f", failed_);
+    std::printf(" (%zu steps)", history_.size());
+    if (const Verdict* b = bottleneck()) std::printf("; bottleneck %s", b->reason.c_str());
+    std::printf("\n");
+    for (const Verdict& v : verdicts_) {
+        std::printf("[bizobs-loadgen] CAP %-32s held_up_to=%.2f broke_at=%.2f%s%s\n", v.name.c_str(), v.heldUpTo,
+                    v.brokeAt, v.reason.empty() ? "" : " ", v.reason.c_str());
+    }
+}
+
+} // namespace bizobs::loadgen
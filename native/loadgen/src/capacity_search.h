@@ -0,0 +1,90 @@
+/*
+ * Capacity search: the highest open-model arrival rate a journey holds
+ * steady under the scenario's monitoring thresholds.
+ *
+ * The engine offers a constant rate for step_time seconds per step; the
+ * first fifth settles and the rest is measured. A step holds when every
+ * request transaction (TSNs and Journey_Complete) keeps its p99 latency -
+ * counted from the intended start, so queueing shows - within
+ * response_time_threshold and its error rate within error_rate_threshold,
+ * and fewer than a second's worth of arrivals are still queued at the end.
+ * Rates grow by `growth` while steps hold, then bisect between the highest
+ * held and the lowest failed rate until they are `precision` apart.
+ *
+ * Each transaction is also judged on its own, so the report gives the rate
+ * every TSN held up to and names the bottleneck: the one that broke at the
+ * lowest rate.
+ */
+#pragma once
+
+#include "journey.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+// One transaction over a measured window
+struct WindowSample {
+    const std::string* name;
+    uint64_t count;
+    uint64_t fail;
+    double p99Ms;
+};
+
+class CapacitySearch {
+public:
+    // `fallbackRate` (the scenario's target) seeds the first step when the
+    // config has no start_rate. Throws std::runtime_error without thresholds.
+    CapacitySearch(const CapacitySearchConfig& cfg, double thresholdMs, double errorThresholdPct, double fallbackRate);
+
+    double rate() const { return rate_; }
+    bool done() const { return done_; }
+    size_t steps() const { return history_.size(); }
+    double heldRate() const { return held_; }
+    double stepSec() const { return cfg_.stepSec; }
+    double cooldownSec() const { return cfg_.cooldownSec; }
+
+    // Judges the window just measured at rate(), returns whether it held and
+    // moves rate() to the next step (or sets done()).
+    bool finishStep(const std::vector<WindowSample>& window, size_t queued);
+
+    const std::string& lastReason() const { return history_.back().reason; }
+    // "capacitySearch":{...}, for engine_summary.json
+    void appendJson(std::string& out) const;
+    void printReport() const;
+
+private:
+    struct StepRecord {
+        double rate;
+        bool held;
+        std::string reason;
+        uint64_t requests;
+        double worstP99Ms;
+        double worstErrorPct;
+        size_t queued;
+    };
+    struct Verdict {
+        std::string name;
+        double heldUpTo = 0;  // highest rate it held at
+        double brokeAt = 0;   // lowest rate it failed at, 0 = never
+        std::string reason;   // why it failed at brokeAt
+    };
+
+    CapacitySearchConfig cfg_;
+    double thresholdMs_;
+    double errorThresholdPct_;
+    double rate_;
+    double held_ = 0;    // highest rate that held
+    double failed_ = 0;  // lowest rate that failed, 0 = none yet
+    bool done_ = false;
+    std::vector<StepRecord> history_;
+    std::vector<Verdict> verdicts_;
+
+    Verdict& verdictFor(const std::string& name);
+    const Verdict* bottleneck() const;
+    void advance();
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,60 @@
+#include "customer_pool.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bizobs::loadgen {
+
+namespace {
+
+constexpr std::string_view kHeader = "customer_name,customer_email,customer_segment,traffic_source,";
+
+} // namespace
+
+CustomerPool::CustomerPool(const std::string& path) {
+    if (path.empty()) return;
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(errno));
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+    if (bytes_ < 2 * kRecordBytes || bytes_ % kRecordBytes != 0) {
+        close(fd);
+        throw std::runtime_error(path + " is not a customer pool (size " + std::to_string(bytes_) + ")");
+    }
+    void* p = mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file
+    if (p == MAP_FAILED) throw std::runtime_error("Cannot map " + path + ": " + std::strerror(errno));
+    data_ = static_cast<const char*>(p);
+    if (std::string_view(data_, kHeader.size()) != kHeader) {
+        munmap(p, bytes_);
+        data_ = nullptr;
+        throw std::runtime_error(path + " has no customer pool header");
+    }
+    count_ = bytes_ / kRecordBytes - 1;
+}
+
+CustomerPool::~CustomerPool() {
+    if (data_) munmap(const_cast<char*>(data_), bytes_);
+}
+
+PooledCustomer CustomerPool::at(size_t index) const {
+    std::string_view row(data_ + (index % count_ + 1) * kRecordBytes, kRecordBytes);
+    std::string_view fields[4];
+    for (std::string_view& f : fields) {
+        const size_t comma = row.find(',');
+        f = row.substr(0, comma);
+        row.remove_prefix(comma == std::string_view::npos ? row.size() : comma + 1);
+    }
+    return {fields[0], fields[1], fields[2], fields[3]};
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,51 @@
+/*
+ * Shared customer pool: customers.dat mapped read-only.
+ *
+ * Same file services/customer-pool.js generates and the generated script and
+ * load simulator read: a comma-separated table with a header row, every row
+ * padded to kRecordBytes, so customer i is at (i + 1) * kRecordBytes:
+ *
+ *   customer_name,customer_email,customer_segment,traffic_source,location,loyalty_tier,pad
+ *
+ * Every VU reads the same pages, so 100k customers cost one page-cache copy
+ * per host, not per VU. Values are JSON-safe by construction and are handed
+ * out as views into the mapping, valid while the pool lives.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace bizobs::loadgen {
+
+struct PooledCustomer {
+    std::string_view name;
+    std::string_view email;
+    std::string_view segment;
+    std::string_view trafficSource;
+};
+
+class CustomerPool {
+public:
+    static constexpr size_t kRecordBytes = 128;
+
+    // Empty path: disabled, size() is 0. Throws std::runtime_error if the
+    // file cannot be mapped or is not a pool.
+    explicit CustomerPool(const std::string& path);
+    ~CustomerPool();
+    CustomerPool(const CustomerPool&) = delete;
+    CustomerPool& operator=(const CustomerPool&) = delete;
+
+    bool enabled() const { return count_ > 0; }
+    size_t size() const { return count_; }
+    // Customer `index` modulo the pool size.
+    PooledCustomer at(size_t index) const;
+
+private:
+    const char* data_ = nullptr;
+    size_t bytes_ = 0;
+    size_t count_ = 0;
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,39 @@
+/*
+ * Built-in demo customer profiles, used when the engine runs without a
+ * --customers pool (customer_pool.h): each VU keeps one for the whole run.
+ */
+#pragma once
+
+namespace bizobs::loadgen {
+
+struct CustomerProfile {
+    const char* name;
+    const char* email;
+    const char* segment;
+};
+
+inline constexpr CustomerProfile kCustomers[] = {
+    {"Sarah Johnson", "sarah.johnson@email.com", "Premium"},
+    {"Michael Chen", "michael.chen@email.com", "Standard"},
+    {"Emma Rodriguez", "emma.rodriguez@email.com", "Budget"},
+    {"David Kim", "david.kim@email.com", "Enterprise"},
+    {"Ashley Thompson", "ashley.thompson@email.com", "SMB"},
+    {"Robert Martinez", "robert.martinez@email.com", "Startup"},
+    {"Jennifer Lee", "jennifer.lee@email.com", "Premium"},
+    {"Christopher Brown", "christopher.brown@email.com", "Standard"},
+    {"Amanda Wilson", "amanda.wilson@email.com", "Budget"},
+    {"Joshua Garcia", "joshua.garcia@email.com", "Enterprise"},
+    {"Melissa Davis", "melissa.davis@email.com", "Premium"},
+    {"Andrew Miller", "andrew.miller@email.com", "Standard"},
+    {"Jessica Anderson", "jessica.anderson@email.com", "SMB"},
+    {"Kevin Taylor", "kevin.taylor@email.com", "Startup"},
+    {"Lauren Thomas", "lauren.thomas@email.com", "Premium"},
+    {"Brian Jackson", "brian.jackson@email.com", "Standard"},
+};
+
+inline constexpr const char* kTrafficSources[] = {
+    "Google_Ads", "Facebook_Campaign", "Email_Newsletter", "Direct_Traffic",
+    "Referral_Partner", "Organic_Search", "Social_Media", "Content_Marketing",
+};
+
+} // namespace bizobs::loadgen
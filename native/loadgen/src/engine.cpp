@@ -0,0 +1,544 @@
+#include "engine.h"
+
+#include "json.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+namespace bizobs::loadgen {
+
+namespace {
+
+uint64_t secToNs(double s) {
+    return s <= 0 ? 0 : static_cast<uint64_t>(s * 1e9);
+}
+
+// One socket per VU plus headroom; the default soft limit of 1024 is the
+// first thing a 600+ VU run trips over.
+void raiseFdLimit(int vusers) {
+    rlimit rl{};
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0) return;
+    rlim_t want = static_cast<rlim_t>(vusers) + 64;
+    if (rl.rlim_cur >= want) return;
+    rl.rlim_cur = rl.rlim_max == RLIM_INFINITY || rl.rlim_max >= want ? want : rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+}
+
+double arrivalRate(const Scenario& sc) {
+    return sc.arrivalRate > 0 ? sc.arrivalRate : sc.throughputTarget;
+}
+
+double usToMs(uint64_t us) {
+    return static_cast<double>(us) / 1000.0;
+}
+
+// {"p50":..,"p90":..,"p99":..,"p999":..,"max":..} in milliseconds
+void appendPercentiles(std::string& out, const HdrHistogram& h) {
+    char buf[160];
+    std::snprintf(buf, sizeof buf, "{\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f}",
+                  usToMs(h.valueAtPercentile(50)), usToMs(h.valueAtPercentile(90)),
+                  usToMs(h.valueAtPercentile(99)), usToMs(h.valueAtPercentile(99.9)), usToMs(h.max()));
+    out += buf;
+}
+
+} // namespace
+
+Engine::Engine(Journey journey, Scenario scenario, EngineOptions opts)
+    : journey_(std::move(journey)), scenario_(std::move(scenario)), opts_(std::move(opts)),
+      endpoint_(resolveEndpoint(opts_.baseUrl)),
+      seed_(opts_.seed ? opts_.seed : static_cast<uint64_t>(std::time(nullptr)) * 2654435761ull),
+      errors_(seed_, scenario_.errorSimulation, scenario_.errorRatePct),
+      think_(journey_, scenario_),
+      arrivals_(arrivalRate(scenario_), scenario_.rampUpSec, scenario_.durationSec, scenario_.rampDownSec),
+      results_(opts_.resultsFile), customers_(opts_.customersPath) {
+    if (scenario_.vusers < 1) scenario_.vusers = 1;
+    if (scenario_.capacitySearch.enabled) {
+        scenario_.openModel = true;
+        search_.emplace(scenario_.capacitySearch, scenario_.responseTimeThresholdMs,
+                        scenario_.errorRateThresholdPct, arrivalRate(scenario_));
+    }
+    if (scenario_.openModel && !search_ && arrivalRate(scenario_) <= 0)
+        throw std::runtime_error("open arrival model needs arrival_rate or monitoring.throughput_target");
+    lsn_ = scenario_.lsn.empty() ? defaultLsn(journey_) : scenario_.lsn;
+    ltn_ = scenario_.ltn.empty() ? defaultLtn(journey_) : scenario_.ltn;
+    simulatePath_ = endpoint_.pathPrefix + "/api/journey-simulation/simulate-journey";
+
+    for (const auto& s : journey_.steps) dtStepSuffix_.push_back("TSN=" + s.name);
+    dtStepSuffix_.push_back("TSN=Journey_Completion");
+    dtStepSuffix_.push_back("TSN=Full_Customer_Journey");
+    bodies_ = opts_.bodyTemplatesPath.empty()
+                  ? compileJourneyBodies(journey_, scenario_.errorSimulation)
+                  : loadJourneyBodies(opts_.bodyTemplatesPath, journey_.steps.size());
+
+    stepTx0_ = stats_.all().size();
+    for (const auto& s : journey_.steps) stats_.add(s.name);
+    completeTx_ = stats_.add("Journey_Complete");
+    journeyTx_ = stats_.add("Full_Customer_Journey");
+    if (search_) window_.resize(stats_.all().size());
+
+    if (opts_.vuTotal < opts_.vuOffset + scenario_.vusers) opts_.vuTotal = opts_.vuOffset + scenario_.vusers;
+    raiseFdLimit(scenario_.vusers);
+    vus_.reserve(static_cast<size_t>(scenario_.vusers));
+    for (int i = 0; i < scenario_.vusers; ++i) vus_.push_back(std::make_unique<VUser>(*this, opts_.vuOffset + i + 1));
+    if (scenario_.openModel) {
+        // Popped from the back, so VU 1 takes the first arrival
+        for (auto it = vus_.rbegin(); it != vus_.rend(); ++it) freeVus_.push_back(it->get());
+    }
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    signalFd_ = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signalFd_ < 0) throw std::runtime_error(std::string("signalfd: ") + std::strerror(errno));
+    loop_.add(signalFd_, EPOLLIN, this);
+}
+
+Engine::~Engine() {
+    vus_.clear(); // close sockets while the loop still exists
+    if (signalFd_ >= 0) close(signalFd_);
+}
+
+double Engine::meanThinkMs() const {
+    double sum = 0;
+    for (size_t i = 0; i < journey_.steps.size(); ++i) sum += think_.meanMs(i);
+    return journey_.steps.empty() ? 0 : sum / static_cast<double>(journey_.steps.size());
+}
+
+uint64_t Engine::pacingNs() const {
+    return secToNs(scenario_.journeyIntervalSec);
+}
+
+void Engine::recordStep(const VUser& vu, size_t step, bool ok, uint64_t serviceNs, uint64_t latencyNs) {
+    stats_[stepTx0_ + step].record(ok, serviceNs / 1000, latencyNs / 1000);
+    if (!window_.empty()) recordWindow(stepTx0_ + step, ok, std::max(serviceNs, latencyNs));
+    results_.append(vu.id(), vu.iteration(), step, ok, serviceNs / 1000);
+}
+
+void Engine::recordJourney(const VUser& vu, bool completionOk, bool journeyOk, uint64_t completionServiceNs,
+                           uint64_t completionLatencyNs, uint64_t journeyServiceNs, uint64_t journeyLatencyNs) {
+    stats_[completeTx_].record(completionOk, completionServiceNs / 1000, completionLatencyNs / 1000);
+    stats_[journeyTx_].record(journeyOk, journeyServiceNs / 1000, journeyLatencyNs / 1000);
+    if (!window_.empty()) recordWindow(completeTx_, completionOk, std::max(completionServiceNs, completionLatencyNs));
+    const size_t steps = journey_.steps.size();
+    results_.append(vu.id(), vu.iteration(), steps, completionOk, completionServiceNs / 1000);
+    results_.append(vu.id(), vu.iteration(), steps + 1, journeyOk, journeyServiceNs / 1000);
+}
+
+void Engine::vuFinished() {
+    if (++finishedVus_ == static_cast<int>(vus_.size())) loop_.stop();
+}
+
+void Engine::vuAvailable(VUser& vu) {
+    if (!pending_.empty()) {
+        const uint64_t scheduled = pending_.front();
+        pending_.pop_front();
+        vu.startJourney(scheduled);
+        return;
+    }
+    freeVus_.push_back(&vu);
+    if (freeVus_.size() < vus_.size()) return;
+    if (arrivalsDone_) {
+        loop_.stop();
+    } else if (searchDraining_) {
+        searchDraining_ = false;
+        loop_.schedule(nowNs() + secToNs(search_->cooldownSec()), this, token(kSearchResume, searchStep_));
+    }
+}
+
+void Engine::finishArrivals() {
+    arrivalsDone_ = true;
+    if (freeVus_.size() == vus_.size()) loop_.stop();
+}
+
+void Engine::scheduleNextArrival() {
+    if (search_) {
+        // Evenly spaced from the step's start, so timer lateness never drifts the rate
+        nextArrivalNs_ = stepStartNs_ + static_cast<uint64_t>(static_cast<double>(stepArrivals_) * 1e9 / search_->rate());
+        loop_.schedule(nextArrivalNs_, this, token(kArrival, searchStep_));
+        return;
+    }
+    const double at = arrivals_.arrivalSec(nextArrival_);
+    if (at < 0) {
+        finishArrivals();
+        return;
+    }
+    nextArrivalNs_ = t0_ + secToNs(at);
+    loop_.schedule(nextArrivalNs_, this, token(kArrival, 0));
+}
+
+void Engine::onArrival() {
+    const uint64_t scheduled = nextArrivalNs_;
+    ++nextArrival_;
+    ++stepArrivals_;
+    ++arrivalsOffered_;
+    if (!freeVus_.empty()) {
+        VUser* vu = freeVus_.back();
+        freeVus_.pop_back();
+        vu->startJourney(scheduled);
+    } else {
+        pending_.push_back(scheduled);
+        ++arrivalsQueued_;
+    }
+    scheduleNextArrival();
+}
+
+void Engine::recordWindow(size_t tx, bool ok, uint64_t latencyNs) {
+    WindowTx& w = window_[tx];
+    ++w.count;
+    if (!ok) ++w.fail;
+    w.latency.record(latencyNs / 1000);
+}
+
+void Engine::beginSearchStep() {
+    ++searchStep_;
+    stepStartNs_ = nowNs();
+    stepArrivals_ = 0;
+    const uint64_t stepNs = secToNs(search_->stepSec());
+    loop_.schedule(stepStartNs_ + stepNs / 5, this, token(kSearchMeasure, searchStep_));
+    loop_.schedule(stepStartNs_ + stepNs, this, token(kSearchStep, searchStep_));
+    std::printf("[bizobs-loadgen] 📐 Step %zu: %.2f journeys/s for %.0fs\n", search_->steps() + 1, search_->rate(),
+                search_->stepSec());
+    std::fflush(stdout);
+    scheduleNextArrival();
+}
+
+void Engine::endSearchStep() {
+    const size_t steps = journey_.steps.size();
+    std::vector<WindowSample> samples;
+    samples.reserve(steps + 1);
+    for (size_t i = 0; i <= steps; ++i) {
+        const size_t tx = i < steps ? stepTx0_ + i : completeTx_;
+        const WindowTx& w = window_[tx];
+        samples.push_back(WindowSample{&stats_[tx].name, w.count, w.fail,
+                                       usToMs(w.latency.valueAtPercentile(99))});
+    }
+    const double rate = search_->rate();
+    const bool held = search_->finishStep(samples, pending_.size());
+    std::printf("[bizobs-loadgen] 📐 %.2f journeys/s %s%s\n", rate, held ? "held" : "failed: ",
+                held ? "" : search_->lastReason().c_str());
+    std::fflush(stdout);
+
+    ++searchStep_; // drops this step's outstanding arrival
+    if (held && !search_->done()) {
+        beginSearchStep();
+        return;
+    }
+    // The backlog of a failed step is not carried into the next one
+    arrivalsDropped_ += pending_.size();
+    pending_.clear();
+    if (search_->done()) {
+        finishArrivals();
+        loop_.schedule(nowNs() + secToNs(opts_.graceSec), this, token(kHardStop, 0));
+        return;
+    }
+    // Its in-flight journeys too: the next step starts cooldown after they end
+    if (freeVus_.size() == vus_.size())
+        loop_.schedule(nowNs() + secToNs(search_->cooldownSec()), this, token(kSearchResume, searchStep_));
+    else
+        searchDraining_ = true;
+}
+
+uint64_t Engine::totalTx() const {
+    uint64_t n = 0;
+    for (size_t i = 0; i < journey_.steps.size(); ++i) n += stats_.all()[stepTx0_ + i].count();
+    return n + stats_.all()[completeTx_].count();
+}
+
+int Engine::run() {
+    t0_ = nowNs();
+    lastReportNs_ = t0_;
+    const size_t n = vus_.size();
+    const uint64_t rampUp = secToNs(scenario_.rampUpSec);
+    const uint64_t plateauEnd = rampUp + secToNs(scenario_.durationSec);
+    const uint64_t rampDown = secToNs(scenario_.rampDownSec);
+
+    if (scenario_.openModel) {
+        if (!search_) scheduleNextArrival(); // a search starts its first step after the banner
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            loop_.schedule(t0_ + rampUp * i / n, this, token(kStartVu, i));
+            loop_.schedule(t0_ + plateauEnd + rampDown * i / n, this, token(kStopVu, i));
+        }
+    }
+    if (!search_) loop_.schedule(t0_ + plateauEnd + rampDown + secToNs(opts_.graceSec), this, token(kHardStop, 0));
+    if (opts_.reportIntervalSec > 0)
+        loop_.schedule(t0_ + secToNs(opts_.reportIntervalSec), this, token(kReport, 0));
+
+    std::printf("[bizobs-loadgen] 🚀 %s: %zu VUs, %zu steps, ramp %.0fs / hold %.0fs / ramp-down %.0fs -> %s\n",
+                journey_.companyName.c_str(), n, journey_.steps.size(), scenario_.rampUpSec,
+                scenario_.durationSec, scenario_.rampDownSec, opts_.baseUrl.c_str());
+    std::printf("[bizobs-loadgen] 🏷️  LSN=%s LTN=%s mode=%s connections=%s\n", lsn_.c_str(), ltn_.c_str(),
+                opts_.chainedJourney ? "chained" : "per-step", opts_.keepAlive ? "keep-alive" : "per-request");
+    if (search_)
+        std::printf("[bizobs-loadgen] 📐 Capacity search from %.2f journeys/s, %.0fs steps, p99 <= %.0f ms, errors <= %.1f%%, at most %zu concurrent\n",
+                    search_->rate(), search_->stepSec(), scenario_.responseTimeThresholdMs,
+                    scenario_.errorRateThresholdPct, n);
+    else if (scenario_.openModel)
+        std::printf("[bizobs-loadgen] 📈 Open model: %.2f journeys/s at plateau, %.0f journeys offered, at most %zu concurrent\n",
+                    arrivalRate(scenario_), arrivals_.totalArrivals(), n);
+    std::printf("[bizobs-loadgen] 💤 Think time: %s, mean %.0f ms/step after %gx time compression\n",
+                thinkDistributionName(scenario_.thinkDistribution), meanThinkMs(), scenario_.timeCompression);
+    if (errors_.enabled())
+        std::printf("[bizobs-loadgen] 🎲 Error schedule: %.2f%% of steps, seed %u (x-error-schedule)\n",
+                    scenario_.errorRatePct, errors_.seed());
+    std::fflush(stdout);
+
+    if (search_) beginSearchStep();
+    loop_.run();
+
+    report(true);
+    if (search_) search_->printReport();
+    writeSummary();
+    return interrupted_ ? 130 : 0;
+}
+
+void Engine::onTimer(uint64_t tok) {
+    const auto kind = static_cast<TimerKind>(tok >> 32);
+    const size_t index = tok & 0xFFFFFFFFull;
+    switch (kind) {
+    case kStartVu:
+        vus_[index]->start();
+        break;
+    case kStopVu:
+        vus_[index]->requestStop();
+        break;
+    case kReport:
+        report(false);
+        loop_.schedule(nowNs() + secToNs(opts_.reportIntervalSec), this, token(kReport, 0));
+        break;
+    case kArrival:
+        if (search_ && (index != searchStep_ || arrivalsDone_)) break;
+        onArrival();
+        break;
+    case kSearchMeasure:
+        if (index != searchStep_) break;
+        for (WindowTx& w : window_) {
+            w.count = w.fail = 0;
+            w.latency.reset();
+        }
+        break;
+    case kSearchStep:
+        if (index == searchStep_) endSearchStep();
+        break;
+    case kSearchResume:
+        if (index == searchStep_) beginSearchStep();
+        break;
+    case kHardStop:
+        std::printf("[bizobs-loadgen] ⏱️  Grace period exceeded, abandoning in-flight journeys\n");
+        loop_.stop();
+        break;
+    }
+}
+
+void Engine::onIo(uint32_t) {
+    signalfd_siginfo si;
+    while (read(signalFd_, &si, sizeof si) == sizeof si) {
+        std::printf("[bizobs-loadgen] 🛑 Received signal %u, stopping\n", si.ssi_signo);
+        interrupted_ = true;
+    }
+    loop_.stop();
+}
+
+void Engine::report(bool final) {
+    const uint64_t now = nowNs();
+    const uint64_t tx = totalTx();
+    const double windowSec = static_cast<double>(now - lastReportNs_) / 1e9;
+    const double rps = windowSec > 0 ? static_cast<double>(tx - lastReportTx_) / windowSec : 0;
+    lastReportNs_ = now;
+    lastReportTx_ = tx;
+
+    int active = 0;
+    for (const auto& vu : vus_) active += vu->active() ? 1 : 0;
+
+    uint64_t pass = 0, fail = 0;
+    for (size_t i = 0; i < journey_.steps.size(); ++i) {
+        pass += stats_.all()[stepTx0_ + i].pass;
+        fail += stats_.all()[stepTx0_ + i].fail;
+    }
+    const TxStats& j = stats_.all()[journeyTx_];
+    std::printf("[bizobs-loadgen] t=%.1fs active_vus=%d journeys=%llu journeys_failed=%llu "
+                "steps_passed=%llu steps_failed=%llu rps=%.1f",
+                static_cast<double>(now - t0_) / 1e9, active,
+                static_cast<unsigned long long>(j.count()), static_cast<unsigned long long>(j.fail),
+                static_cast<unsigned long long>(pass), static_cast<unsigned long long>(fail), rps);
+    if (search_)
+        std::printf(" search_rate=%.2f", search_->rate());
+    if (scenario_.openModel)
+        std::printf(" arrivals=%llu queued=%zu", static_cast<unsigned long long>(arrivalsOffered_), pending_.size());
+    std::printf("\n");
+
+    results_.flush();
+    if (opts_.exportHistograms) writeHistograms(final);
+
+    if (final) {
+        for (const TxStats& s : stats_.all()) {
+            if (s.count() == 0) continue;
+            std::printf("[bizobs-loadgen] TX %-32s count=%llu pass=%llu fail=%llu avg_ms=%.1f min_ms=%.1f max_ms=%.1f "
+                        "p50_ms=%.1f p99_ms=%.1f p999_ms=%.1f\n",
+                        s.name.c_str(), static_cast<unsigned long long>(s.count()),
+                        static_cast<unsigned long long>(s.pass), static_cast<unsigned long long>(s.fail),
+                        static_cast<double>(s.sumUs) / static_cast<double>(s.count()) / 1000.0,
+                        usToMs(s.minUs), usToMs(s.maxUs), usToMs(s.latency.valueAtPercentile(50)),
+                        usToMs(s.latency.valueAtPercentile(99)), usToMs(s.latency.valueAtPercentile(99.9)));
+        }
+    }
+    std::fflush(stdout);
+}
+
+void Engine::writeSummary() const {
+    if (opts_.resultsDir.empty()) return;
+    std::string out = "{\"engine\":\"bizobs-loadgen\",\"companyName\":\"";
+    json::appendEscaped(out, journey_.companyName);
+    out += "\",\"scenario\":\"";
+    json::appendEscaped(out, scenario_.name);
+    out += "\",\"LSN\":\"";
+    json::appendEscaped(out, lsn_);
+    out += "\",\"LTN\":\"";
+    json::appendEscaped(out, ltn_);
+    char buf[256];
+    std::snprintf(buf, sizeof buf, "\",\"vusers\":%zu,\"elapsedSec\":%.3f,\"interrupted\":%s,",
+                  vus_.size(), static_cast<double>(nowNs() - t0_) / 1e9, interrupted_ ? "true" : "false");
+    out += buf;
+    if (scenario_.openModel) {
+        // Arrivals still queued at the end never started: offered load the
+        // server could not absorb
+        std::snprintf(buf, sizeof buf, "\"arrivalModel\":\"open\",\"arrivalRate\":%.3f,\"arrivalsOffered\":%llu,"
+                      "\"arrivalsQueued\":%llu,\"arrivalsMissed\":%zu,",
+                      arrivalRate(scenario_), static_cast<unsigned long long>(arrivalsOffered_),
+                      static_cast<unsigned long long>(arrivalsQueued_), pending_.size());
+    } else {
+        std::snprintf(buf, sizeof buf, "\"arrivalModel\":\"closed\",");
+    }
+    out += buf;
+    if (search_) {
+        search_->appendJson(out);
+        std::snprintf(buf, sizeof buf, "\"arrivalsDropped\":%llu,", static_cast<unsigned long long>(arrivalsDropped_));
+        out += buf;
+    }
+    if (errors_.enabled()) {
+        std::snprintf(buf, sizeof buf, "\"errorSchedule\":{\"seed\":%u,\"ratePct\":%.2f,\"scheduled\":%llu},",
+                      errors_.seed(), scenario_.errorRatePct, static_cast<unsigned long long>(scheduledErrors_));
+        out += buf;
+    }
+    std::snprintf(buf, sizeof buf, "\"thinkTime\":{\"distribution\":\"%s\",\"timeCompression\":%g,\"meanMs\":%.1f},",
+                  thinkDistributionName(scenario_.thinkDistribution), scenario_.timeCompression, meanThinkMs());
+    out += buf;
+    // Request arenas settle at each VU's largest iteration
+    size_t arenaMax = 0, arenaTotal = 0;
+    for (const auto& vu : vus_) {
+        arenaMax = std::max(arenaMax, vu->arenaBytes());
+        arenaTotal += vu->arenaBytes();
+    }
+    std::snprintf(buf, sizeof buf, "\"requestArenaBytes\":{\"maxPerVu\":%zu,\"total\":%zu},", arenaMax, arenaTotal);
+    out += buf;
+    if (results_.enabled()) {
+        std::snprintf(buf, sizeof buf, "\"resultRecords\":%llu,", static_cast<unsigned long long>(results_.records()));
+        out += buf;
+    }
+    if (customers_.enabled()) {
+        std::snprintf(buf, sizeof buf, "\"customerPool\":%zu,", customers_.size());
+        out += buf;
+    }
+    out += "\"transactions\":[";
+    bool first = true;
+    for (const TxStats& s : stats_.all()) {
+        if (!first) out += ',';
+        first = false;
+        out += "{\"name\":\"";
+        json::appendEscaped(out, s.name);
+        const double avg = s.count() ? static_cast<double>(s.sumUs) / static_cast<double>(s.count()) / 1000.0 : 0;
+        std::snprintf(buf, sizeof buf, "\",\"count\":%llu,\"pass\":%llu,\"fail\":%llu,\"avgMs\":%.3f,\"minMs\":%.3f,\"maxMs\":%.3f",
+                      static_cast<unsigned long long>(s.count()), static_cast<unsigned long long>(s.pass),
+                      static_cast<unsigned long long>(s.fail), avg,
+                      s.count() ? usToMs(s.minUs) : 0, usToMs(s.maxUs));
+        out += buf;
+        out += ",\"latencyMs\":";
+        appendPercentiles(out, s.latency);
+        out += ",\"serviceMs\":";
+        appendPercentiles(out, s.service);
+        out += '}';
+    }
+    out += "]}\n";
+
+    const std::string path = opts_.resultsDir + "/engine_summary.json";
+    std::ofstream f(path, std::ios::trunc);
+    if (!f) {
+        std::fprintf(stderr, "[bizobs-loadgen] ❌ Cannot write %s\n", path.c_str());
+        return;
+    }
+    f << out;
+    std::printf("[bizobs-loadgen] ✅ Summary written to %s\n", path.c_str());
+}
+
+// Counts, not percentiles, so a coordinator can add shards bucket by bucket:
+// "latency"/"service" are flat [index, count, index, count, ...] lists in
+// HdrHistogram bucket order. Written to a temp file and renamed, so a reader
+// polling mid-run never sees half a file.
+void Engine::writeHistograms(bool final) const {
+    if (opts_.resultsDir.empty()) return;
+    std::string out = "{\"engine\":\"bizobs-loadgen\",\"LTN\":\"";
+    json::appendEscaped(out, ltn_);
+    char buf[256];
+    std::snprintf(buf, sizeof buf, "\",\"final\":%s,\"vuOffset\":%d,\"vusers\":%zu,\"elapsedSec\":%.3f,"
+                  "\"subBucketBits\":%u,\"arrivalsOffered\":%llu,\"arrivalsMissed\":%zu,\"scheduledErrors\":%llu,"
+                  "\"transactions\":[",
+                  final ? "true" : "false", opts_.vuOffset, vus_.size(), static_cast<double>(nowNs() - t0_) / 1e9,
+                  HdrHistogram::kSubBucketBits, static_cast<unsigned long long>(arrivalsOffered_),
+                  pending_.size(), static_cast<unsigned long long>(scheduledErrors_));
+    out += buf;
+    auto appendBuckets = [&out, &buf](const HdrHistogram& h) {
+        out += '[';
+        bool firstBucket = true;
+        h.forEachBucket([&](size_t index, uint64_t count) {
+            std::snprintf(buf, sizeof buf, "%s%zu,%llu", firstBucket ? "" : ",", index,
+                          static_cast<unsigned long long>(count));
+            out += buf;
+            firstBucket = false;
+        });
+        out += ']';
+    };
+    bool first = true;
+    for (const TxStats& s : stats_.all()) {
+        if (!first) out += ',';
+        first = false;
+        out += "{\"name\":\"";
+        json::appendEscaped(out, s.name);
+        std::snprintf(buf, sizeof buf, "\",\"pass\":%llu,\"fail\":%llu,\"sumUs\":%llu,\"minUs\":%llu,\"maxUs\":%llu,\"latency\":",
+                      static_cast<unsigned long long>(s.pass), static_cast<unsigned long long>(s.fail),
+                      static_cast<unsigned long long>(s.sumUs),
+                      static_cast<unsigned long long>(s.count() ? s.minUs : 0), static_cast<unsigned long long>(s.maxUs));
+        out += buf;
+        appendBuckets(s.latency);
+        out += ",\"service\":";
+        appendBuckets(s.service);
+        out += '}';
+    }
+    out += "]}\n";
+
+    const std::string path = opts_.resultsDir + "/engine_histograms.json";
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::trunc);
+        if (!f) {
+            std::fprintf(stderr, "[bizobs-loadgen] ❌ Cannot write %s\n", tmp.c_str());
+            return;
+        }
+        f << out;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+        std::fprintf(stderr, "[bizobs-loadgen] ❌ Cannot rename %s: %s\n", tmp.c_str(), std::strerror(errno));
+}
+
+} // namespace bizobs::loadgen
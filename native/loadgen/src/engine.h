@@ -0,0 +1,176 @@
+/*
+ * Engine: owns the event loop, the VU population and the run schedule.
+ *
+ * Schedule (closed model, same knobs as scenarios/<profile>.json):
+ *   VU i starts at        rampUp * i / vusers
+ *   VU i is told to stop  rampUp + duration + rampDown * i / vusers
+ *   hard stop             rampUp + duration + rampDown + grace
+ * A VU restarts its journey after journey_interval seconds of pacing, or
+ * exits once it has run `iterations` journeys.
+ *
+ * Open model (arrival_model "open"): journeys start on the ArrivalSchedule
+ * curve whether or not earlier ones have finished. Arrival k goes to any
+ * idle VU; if all `vusers` are busy it queues and starts, late, on the next
+ * VU to free up. A slow server therefore grows the queue and the journey
+ * times instead of quietly lowering the offered load.
+ *
+ * Capacity search (loadrunner_config.capacity_search, capacity_search.h):
+ * an open model whose rate is set step by step by the search instead of the
+ * ramp/plateau curve; the run ends when the search does.
+ */
+#pragma once
+
+#include "arrival.h"
+#include "body_template.h"
+#include "capacity_search.h"
+#include "error_schedule.h"
+#include "event_loop.h"
+#include "http_client.h"
+#include "journey.h"
+#include "customer_pool.h"
+#include "results_store.h"
+#include "stats.h"
+#include "think_time.h"
+#include "vuser.h"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+struct EngineOptions {
+    std::string baseUrl = "http://localhost:8080";
+    std::string resultsDir;     // engine_summary.json is written here when set
+    double reportIntervalSec = 5;
+    double graceSec = 60;
+    int requestTimeoutMs = 30000; // web_set_timeout("Receive", 30)
+    bool chainedJourney = false;  // --journey-mode chained: one request per journey
+    std::string bodyTemplatesPath; // generator's body-templates.json; compiled from the journey if empty
+    bool keepAlive = false;       // --keep-alive 1: one persistent connection per VU
+    uint64_t seed = 0;            // 0 = time based
+    int vuOffset = 0;             // --vu-offset: VU ids start at offset + 1 (one shard of a distributed run)
+    int vuTotal = 0;              // --vu-total: VUs across all shards; 0 = vuOffset + vusers
+    bool exportHistograms = false; // --export-histograms 1: engine_histograms.json at every report
+    std::string resultsFile;    // --results-file: append a 24-byte record per transaction (results_store.h)
+    std::string customersPath;  // --customers: shared customers.dat pool (customer_pool.h)
+};
+
+class Engine final : public IoHandler, public TimerHandler {
+public:
+    Engine(Journey journey, Scenario scenario, EngineOptions opts);
+    ~Engine() override;
+
+    // Blocks until the schedule completes or SIGINT/SIGTERM; returns exit code.
+    int run();
+
+    // --- used by VUser ---
+    EventLoop& loop() { return loop_; }
+    const Endpoint& endpoint() const { return endpoint_; }
+    const Journey& journey() const { return journey_; }
+    const Scenario& scenario() const { return scenario_; }
+    const EngineOptions& options() const { return opts_; }
+    const std::string& lsn() const { return lsn_; }
+    const std::string& ltn() const { return ltn_; }
+    const std::string& simulatePath() const { return simulatePath_; }
+    uint64_t seed() const { return seed_; }
+    const ErrorSchedule& errors() const { return errors_; }
+    const JourneyBodies& bodies() const { return bodies_; }
+    const ThinkTime& thinkTime() const { return think_; }
+    const CustomerPool& customers() const { return customers_; }
+
+    // "TSN=<step>" per step, "TSN=Journey_Completion" at steps.size() and
+    // "TSN=Full_Customer_Journey" (the chained request) at steps.size() + 1
+    const std::string& dtStepSuffix(size_t index) const { return dtStepSuffix_[index]; }
+
+    uint64_t pacingNs() const;
+
+    // service: request on the wire; latency: from the request's intended start
+    void recordStep(const VUser& vu, size_t step, bool ok, uint64_t serviceNs, uint64_t latencyNs);
+    void countScheduledError() { ++scheduledErrors_; }
+    // Journey_Complete passes on its own request, Full_Customer_Journey only
+    // when every step did too (LR_PASS / LR_AUTO in the generated script)
+    void recordJourney(const VUser& vu, bool completionOk, bool journeyOk, uint64_t completionServiceNs,
+                       uint64_t completionLatencyNs, uint64_t journeyServiceNs, uint64_t journeyLatencyNs);
+    void vuFinished();
+    // Open model: the VU finished its journey and can take the next arrival.
+    void vuAvailable(VUser& vu);
+
+    void onIo(uint32_t events) override;   // signalfd
+    void onTimer(uint64_t token) override; // schedule + reporter
+
+private:
+    enum TimerKind : uint64_t { kStartVu = 1, kStopVu, kReport, kHardStop, kArrival, kSearchMeasure, kSearchStep, kSearchResume };
+
+    Journey journey_;
+    Scenario scenario_;
+    EngineOptions opts_;
+    EventLoop loop_;
+    Endpoint endpoint_;
+    std::string lsn_, ltn_, simulatePath_;
+    std::vector<std::string> dtStepSuffix_;
+    JourneyBodies bodies_;
+    uint64_t seed_;
+    ErrorSchedule errors_;
+    ThinkTime think_;
+    uint64_t scheduledErrors_ = 0; // steps sent with x-error-schedule naming them
+
+    std::vector<std::unique_ptr<VUser>> vus_;
+
+    // Open model: arrivals that found every VU busy wait in pending_ with
+    // their scheduled start, so queueing shows up in Full_Customer_Journey
+    ArrivalSchedule arrivals_;
+    std::vector<VUser*> freeVus_;
+    std::deque<uint64_t> pending_;
+    uint64_t nextArrival_ = 0;    // index into arrivals_
+    uint64_t nextArrivalNs_ = 0;
+    bool arrivalsDone_ = false;
+    uint64_t arrivalsOffered_ = 0;
+    uint64_t arrivalsQueued_ = 0;
+
+    // Capacity search: arrivals at a constant rate per step. Timers carry
+    // the step number, so an arrival from an earlier step is ignored. The
+    // window counts each transaction from the end of the step's settle time.
+    struct WindowTx {
+        uint64_t count = 0;
+        uint64_t fail = 0;
+        HdrHistogram latency;
+    };
+    std::optional<CapacitySearch> search_;
+    std::vector<WindowTx> window_;
+    uint32_t searchStep_ = 0;
+    uint64_t stepStartNs_ = 0;
+    uint64_t stepArrivals_ = 0;
+    uint64_t arrivalsDropped_ = 0; // queued when a step failed
+    bool searchDraining_ = false;  // failed step's journeys still running
+    StatsTable stats_;
+    size_t stepTx0_ = 0;        // slot of the first step; steps are contiguous
+    size_t completeTx_ = 0;
+    size_t journeyTx_ = 0;
+    ResultStore results_;
+    CustomerPool customers_;
+
+    int signalFd_ = -1;
+    uint64_t t0_ = 0;
+    uint64_t lastReportNs_ = 0;
+    uint64_t lastReportTx_ = 0;
+    int finishedVus_ = 0;
+    bool interrupted_ = false;
+
+    static uint64_t token(TimerKind kind, uint64_t index) { return (static_cast<uint64_t>(kind) << 32) | index; }
+    void scheduleNextArrival();
+    void onArrival();
+    void recordWindow(size_t tx, bool ok, uint64_t latencyNs);
+    void beginSearchStep();
+    void endSearchStep();
+    void finishArrivals();
+    void report(bool final);
+    void writeSummary() const;
+    void writeHistograms(bool final) const;
+    uint64_t totalTx() const;
+    double meanThinkMs() const;
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,37 @@
+#include "error_schedule.h"
+
+namespace bizobs::loadgen {
+
+namespace {
+
+// 32-bit integer finaliser; unsigned int arithmetic only, so the LoadRunner
+// C side reproduces it exactly
+uint32_t mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+} // namespace
+
+ErrorSchedule::ErrorSchedule(uint64_t seed, bool enabled, double ratePct)
+    : seed_(static_cast<uint32_t>(seed)) {
+    if (!enabled || ratePct <= 0) rateBp_ = 0;
+    else if (ratePct >= 100) rateBp_ = 10000;
+    else rateBp_ = static_cast<uint32_t>(ratePct * 100 + 0.5);
+}
+
+uint32_t ErrorSchedule::vuSeed(int vu) const {
+    return mix(seed_ ^ (static_cast<uint32_t>(vu) * 0x9e3779b9u));
+}
+
+bool ErrorSchedule::fails(uint32_t vuSeed, int iteration, size_t step) const {
+    if (rateBp_ == 0) return false;
+    const uint32_t h = mix(vuSeed ^ mix(static_cast<uint32_t>(iteration) * 0x85ebca6bu + static_cast<uint32_t>(step)));
+    return h % 10000 < rateBp_;
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,35 @@
+/*
+ * Seeded per-VU error schedule, decided before the request goes out.
+ *
+ * Whether step s of a VU's iteration i fails is a pure hash of
+ * (seed, VU, i, s) against error_rate: the same --seed fails the same
+ * requests on every run, and the generated LoadRunner script (err_mix() /
+ * err_plan_iteration()) computes the identical schedule for a given seed.
+ *
+ * The failing steps travel as "x-error-schedule: <step>,<step>"; the step
+ * service answers with the error itself, so the client books the real HTTP
+ * outcome and never fails a transaction after the fact.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bizobs::loadgen {
+
+class ErrorSchedule {
+public:
+    ErrorSchedule(uint64_t seed, bool enabled, double ratePct);
+
+    bool enabled() const { return rateBp_ > 0; }
+    uint32_t seed() const { return seed_; }
+    // Per-VU seed, derived once in vuser_init()
+    uint32_t vuSeed(int vu) const;
+    bool fails(uint32_t vuSeed, int iteration, size_t step) const;
+
+private:
+    uint32_t seed_;
+    uint32_t rateBp_; // basis points, 10000 = every step
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,87 @@
+#include "event_loop.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace bizobs::loadgen {
+
+uint64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+EventLoop::EventLoop() : epfd_(epoll_create1(EPOLL_CLOEXEC)) {
+    if (epfd_ < 0) throw std::runtime_error(std::string("epoll_create1: ") + std::strerror(errno));
+}
+
+EventLoop::~EventLoop() {
+    close(epfd_);
+}
+
+void EventLoop::add(int fd, uint32_t events, IoHandler* h) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.ptr = h;
+    if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) < 0)
+        throw std::runtime_error(std::string("epoll_ctl ADD: ") + std::strerror(errno));
+}
+
+void EventLoop::modify(int fd, uint32_t events, IoHandler* h) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.ptr = h;
+    if (epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) < 0)
+        throw std::runtime_error(std::string("epoll_ctl MOD: ") + std::strerror(errno));
+}
+
+void EventLoop::remove(int fd) {
+    epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void EventLoop::schedule(uint64_t deadlineNs, TimerHandler* h, uint64_t token) {
+    timers_.push(Timer{deadlineNs, seq_++, h, token});
+}
+
+void EventLoop::fireDueTimers() {
+    const uint64_t now = nowNs();
+    while (!timers_.empty() && timers_.top().deadline <= now) {
+        Timer t = timers_.top();
+        timers_.pop();
+        t.handler->onTimer(t.token);
+        if (!running_) return;
+    }
+}
+
+void EventLoop::run() {
+    constexpr int kMaxEvents = 256;
+    epoll_event events[kMaxEvents];
+    running_ = true;
+
+    while (running_) {
+        int timeoutMs = -1;
+        if (!timers_.empty()) {
+            const uint64_t now = nowNs();
+            const uint64_t due = timers_.top().deadline;
+            // Round up so we never spin on a sub-millisecond remainder
+            timeoutMs = due <= now ? 0 : static_cast<int>((due - now + 999999) / 1000000);
+        }
+
+        int n = epoll_wait(epfd_, events, kMaxEvents, timeoutMs);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("epoll_wait: ") + std::strerror(errno));
+        }
+        for (int i = 0; i < n && running_; ++i)
+            static_cast<IoHandler*>(events[i].data.ptr)->onIo(events[i].events);
+
+        if (running_) fireDueTimers();
+    }
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,68 @@
+/*
+ * Single-threaded epoll reactor with a min-heap of timers.
+ *
+ * Every VU is a plain state machine driven from here: socket readiness goes
+ * through IoHandler, think time / pacing / request timeouts through
+ * TimerHandler. No per-VU threads, so thousands of VUs cost a few KB each.
+ */
+#pragma once
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+uint64_t nowNs(); // CLOCK_MONOTONIC
+
+class IoHandler {
+public:
+    virtual ~IoHandler() = default;
+    virtual void onIo(uint32_t events) = 0;
+};
+
+class TimerHandler {
+public:
+    virtual ~TimerHandler() = default;
+    // `token` is whatever was passed to schedule(); handlers use it to drop
+    // timers that were superseded (there is no explicit cancel).
+    virtual void onTimer(uint64_t token) = 0;
+};
+
+class EventLoop {
+public:
+    EventLoop();
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    void add(int fd, uint32_t events, IoHandler* h);
+    void modify(int fd, uint32_t events, IoHandler* h);
+    void remove(int fd);
+
+    void schedule(uint64_t deadlineNs, TimerHandler* h, uint64_t token);
+
+    // Runs until stop() is called from a handler.
+    void run();
+    void stop() { running_ = false; }
+
+private:
+    struct Timer {
+        uint64_t deadline;
+        uint64_t seq;
+        TimerHandler* handler;
+        uint64_t token;
+        bool operator>(const Timer& o) const {
+            return deadline != o.deadline ? deadline > o.deadline : seq > o.seq;
+        }
+    };
+
+    int epfd_;
+    bool running_ = false;
+    uint64_t seq_ = 0;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+
+    void fireDueTimers();
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,81 @@
+#include "hdr_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bizobs::loadgen {
+
+namespace {
+
+// 3 significant digits: 2 * 10^3 distinct values per power of two, rounded
+// up to 2^11 sub-buckets; the lower half of every bucket past the first
+// overlaps the previous one and is not stored.
+constexpr unsigned kSubBucketBits = HdrHistogram::kSubBucketBits;
+constexpr uint64_t kSubBucketCount = 1ull << kSubBucketBits;
+constexpr unsigned kSubBucketHalfBits = kSubBucketBits - 1;
+constexpr uint64_t kSubBucketHalfCount = 1ull << kSubBucketHalfBits;
+constexpr uint64_t kSubBucketMask = kSubBucketCount - 1;
+
+constexpr size_t bucketCount() {
+    size_t buckets = 1;
+    uint64_t covered = kSubBucketCount;
+    while (covered <= HdrHistogram::kMaxUs) {
+        covered <<= 1;
+        ++buckets;
+    }
+    return buckets;
+}
+
+constexpr size_t kCountsLen = (bucketCount() + 1) * kSubBucketHalfCount;
+
+} // namespace
+
+HdrHistogram::HdrHistogram() : counts_(kCountsLen, 0) {}
+
+size_t HdrHistogram::indexFor(uint64_t value) {
+    const unsigned pow2Ceiling = 64 - static_cast<unsigned>(__builtin_clzll(value | kSubBucketMask));
+    const unsigned bucket = pow2Ceiling - (kSubBucketHalfBits + 1);
+    const uint64_t subBucket = value >> bucket;
+    return (static_cast<size_t>(bucket + 1) << kSubBucketHalfBits) + static_cast<size_t>(subBucket - kSubBucketHalfCount);
+}
+
+uint64_t HdrHistogram::highestEquivalent(size_t index) {
+    int bucket = static_cast<int>(index >> kSubBucketHalfBits) - 1;
+    uint64_t subBucket = (index & (kSubBucketHalfCount - 1)) + kSubBucketHalfCount;
+    if (bucket < 0) {
+        subBucket -= kSubBucketHalfCount;
+        bucket = 0;
+    }
+    return (subBucket << bucket) + (1ull << bucket) - 1;
+}
+
+void HdrHistogram::record(uint64_t valueUs) {
+    if (valueUs > kMaxUs) valueUs = kMaxUs;
+    ++counts_[indexFor(valueUs)];
+    ++total_;
+    if (valueUs > max_) max_ = valueUs;
+}
+
+void HdrHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+    max_ = 0;
+}
+
+uint64_t HdrHistogram::valueAtPercentile(double percentile) const {
+    if (total_ == 0) return 0;
+    if (percentile > 100) percentile = 100;
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total_)));
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= target) {
+            const uint64_t v = highestEquivalent(i);
+            return v < max_ ? v : max_;
+        }
+    }
+    return max_;
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,49 @@
+/*
+ * Fixed-memory HDR latency histogram (HdrHistogram layout).
+ *
+ * Values in microseconds from 1 us to kMaxUs at 3 significant digits: every
+ * recorded value lands in a bucket no wider than 0.1% of it, so percentiles
+ * are exact to that resolution whatever the sample count. Memory is
+ * allocated once (~190 KB) and recording is a shift, a mask and an add.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+class HdrHistogram {
+public:
+    static constexpr uint64_t kMaxUs = 3600ull * 1000000ull; // 1 hour; larger values clamp
+
+    HdrHistogram();
+
+    void record(uint64_t valueUs);
+    void reset();
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+    // Highest value equivalent to the sample at `percentile` (0..100).
+    uint64_t valueAtPercentile(double percentile) const;
+    // Calls f(index, count) for every non-empty bucket, in index order. The
+    // index is stable for a given layout, so histograms from several engines
+    // merge by adding counts per index.
+    template <class F>
+    void forEachBucket(F&& f) const {
+        for (size_t i = 0; i < counts_.size(); ++i)
+            if (counts_[i]) f(i, counts_[i]);
+    }
+    static constexpr unsigned kSubBucketBits = 11;
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+
+    static size_t indexFor(uint64_t value);
+    static uint64_t highestEquivalent(size_t index);
+};
+
+} // namespace bizobs::loadgen
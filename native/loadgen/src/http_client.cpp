@@ -0,0 +1,310 @@
+#include "http_client.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace bizobs::loadgen {
+
+Endpoint resolveEndpoint(const std::string& baseUrl) {
+    std::string rest = baseUrl;
+    const std::string scheme = "http://";
+    if (rest.compare(0, scheme.size(), scheme) != 0)
+        throw std::runtime_error("only http:// base URLs are supported: " + baseUrl);
+    rest.erase(0, scheme.size());
+
+    Endpoint ep;
+    size_t slash = rest.find('/');
+    std::string hostPort = rest.substr(0, slash);
+    if (slash != std::string::npos) {
+        ep.pathPrefix = rest.substr(slash);
+        while (!ep.pathPrefix.empty() && ep.pathPrefix.back() == '/') ep.pathPrefix.pop_back();
+    }
+
+    std::string host = hostPort, port = "80";
+    if (size_t colon = hostPort.rfind(':'); colon != std::string::npos) {
+        host = hostPort.substr(0, colon);
+        port = hostPort.substr(colon + 1);
+    }
+    ep.hostHeader = hostPort;
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (int rc = getaddrinfo(host.c_str(), port.c_str(), &hints, &res); rc != 0)
+        throw std::runtime_error("cannot resolve " + hostPort + ": " + gai_strerror(rc));
+    std::memcpy(&ep.addr, res->ai_addr, res->ai_addrlen);
+    ep.addrLen = static_cast<socklen_t>(res->ai_addrlen);
+    freeaddrinfo(res);
+    return ep;
+}
+
+HttpClient::HttpClient(EventLoop& loop, const Endpoint& ep, HttpListener& listener, bool keepAlive)
+    : loop_(loop), ep_(ep), listener_(listener), keepAlive_(keepAlive) {}
+
+HttpClient::~HttpClient() {
+    closeSocket();
+}
+
+void HttpClient::closeSocket() {
+    if (fd_ >= 0) {
+        loop_.remove(fd_);
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+void HttpClient::send(std::string_view request, uint64_t timeoutNs) {
+    wbuf_ = request;
+    woff_ = 0;
+    rbuf_.clear();
+    bodyStart_ = 0;
+    contentLength_ = -1;
+    chunked_ = false;
+    status_ = 0;
+    serverClose_ = false;
+    headRequest_ = request.compare(0, 5, "HEAD ") == 0;
+    startNs_ = nowNs();
+    ++gen_;
+    pendingError_ = nullptr;
+    loop_.schedule(startNs_ + timeoutNs, this, gen_);
+
+    reused_ = fd_ >= 0;
+    if (reused_) {
+        // Write from the loop rather than inline so a failure never re-enters
+        // the listener from inside send()
+        state_ = State::Writing;
+        loop_.modify(fd_, EPOLLOUT, this);
+        return;
+    }
+    connectFresh();
+}
+
+void HttpClient::connectFresh() {
+    state_ = State::Connecting;
+    fd_ = socket(ep_.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        deferFail("socket() failed");
+        return;
+    }
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+
+    int rc = connect(fd_, reinterpret_cast<const sockaddr*>(&ep_.addr), ep_.addrLen);
+    if (rc < 0 && errno != EINPROGRESS) {
+        deferFail("connect failed");
+        return;
+    }
+    loop_.add(fd_, EPOLLOUT, this);
+}
+
+bool HttpClient::retryFresh() {
+    if (!reused_ || !rbuf_.empty()) return false;
+    reused_ = false;
+    closeSocket();
+    woff_ = 0;
+    connectFresh();
+    return true;
+}
+
+void HttpClient::deferFail(const char* err) {
+    // Report on the next loop turn rather than re-entering the listener from
+    // inside send(); a VU that retries immediately would otherwise recurse.
+    pendingError_ = err;
+    loop_.schedule(nowNs(), this, gen_);
+}
+
+void HttpClient::onTimer(uint64_t token) {
+    if (token != gen_ || state_ == State::Idle) return;
+    fail(pendingError_ ? pendingError_ : "timeout");
+}
+
+void HttpClient::onIo(uint32_t events) {
+    if (state_ == State::Idle) {
+        // Kept-alive socket between exchanges: the server closed it or sent
+        // something unsolicited, either way it is no longer reusable
+        closeSocket();
+        return;
+    }
+    if (state_ == State::Connecting) {
+        int err = 0;
+        socklen_t len = sizeof err;
+        getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0 || (events & EPOLLERR)) {
+            fail("connect failed");
+            return;
+        }
+        state_ = State::Writing;
+    }
+    if (state_ == State::Writing) {
+        doWrite();
+        return;
+    }
+    if (state_ == State::Reading) doRead();
+}
+
+void HttpClient::doWrite() {
+    while (woff_ < wbuf_.size()) {
+        ssize_t n = ::send(fd_, wbuf_.data() + woff_, wbuf_.size() - woff_, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            if (errno == EINTR) continue;
+            if (!retryFresh()) fail("write failed");
+            return;
+        }
+        woff_ += static_cast<size_t>(n);
+    }
+    state_ = State::Reading;
+    loop_.modify(fd_, EPOLLIN | EPOLLRDHUP, this);
+}
+
+void HttpClient::doRead() {
+    char buf[16384];
+    bool eof = false;
+    for (;;) {
+        ssize_t n = recv(fd_, buf, sizeof buf, 0);
+        if (n > 0) {
+            rbuf_.append(buf, static_cast<size_t>(n));
+            if (static_cast<size_t>(n) < sizeof buf) break;
+            continue;
+        }
+        if (n == 0) { eof = true; break; }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        if (errno == EINTR) continue;
+        if (!retryFresh()) fail("read failed");
+        return;
+    }
+
+    if (bodyStart_ == 0 && !parseHead()) {
+        if (eof && !retryFresh()) fail(rbuf_.empty() ? "empty reply" : "malformed response");
+        return;
+    }
+    // Interim responses (100 Continue, 103 Early Hints) precede the real one
+    while (status_ >= 100 && status_ < 200 && status_ != 101) {
+        rbuf_.erase(0, bodyStart_);
+        bodyStart_ = 0;
+        contentLength_ = -1;
+        chunked_ = false;
+        status_ = 0;
+        if (!parseHead()) {
+            if (eof) fail("connection closed after an interim response");
+            return;
+        }
+    }
+    std::string decoded;
+    std::string_view body;
+    if (bodyComplete(eof, decoded, body)) {
+        complete(body);
+    } else if (eof) {
+        fail("connection closed mid-body");
+    }
+}
+
+bool HttpClient::parseHead() {
+    size_t end = rbuf_.find("\r\n\r\n");
+    if (end == std::string::npos) return false;
+    if (rbuf_.compare(0, 5, "HTTP/") != 0) return false;
+
+    size_t sp = rbuf_.find(' ');
+    if (sp == std::string::npos || sp > end) return false;
+    status_ = std::atoi(rbuf_.c_str() + sp + 1);
+    serverClose_ = rbuf_.compare(0, 8, "HTTP/1.0") == 0;
+
+    size_t line = rbuf_.find("\r\n") + 2;
+    while (line < end) {
+        size_t eol = rbuf_.find("\r\n", line);
+        const char* h = rbuf_.c_str() + line;
+        size_t hlen = eol - line;
+        if (hlen > 15 && strncasecmp(h, "content-length:", 15) == 0) {
+            contentLength_ = std::strtol(h + 15, nullptr, 10);
+        } else if (hlen > 18 && strncasecmp(h, "transfer-encoding:", 18) == 0) {
+            std::string v(h + 18, hlen - 18);
+            chunked_ = strcasestr(v.c_str(), "chunked") != nullptr;
+        } else if (hlen > 11 && strncasecmp(h, "connection:", 11) == 0) {
+            std::string v(h + 11, hlen - 11);
+            serverClose_ = strcasestr(v.c_str(), "close") != nullptr;
+        }
+        line = eol + 2;
+    }
+    bodyStart_ = end + 4;
+    return true;
+}
+
+bool HttpClient::bodyComplete(bool eof, std::string& decoded, std::string_view& body) {
+    if (bodyless()) {
+        body = std::string_view();
+        return true;
+    }
+    if (chunked_) {
+        size_t pos = bodyStart_;
+        decoded.clear();
+        for (;;) {
+            size_t eol = rbuf_.find("\r\n", pos);
+            if (eol == std::string::npos) return false;
+            unsigned long size = std::strtoul(rbuf_.c_str() + pos, nullptr, 16);
+            pos = eol + 2;
+            if (size == 0) {
+                // Trailer lines, then the empty line ending the message: the
+                // whole of it is read, so nothing is left on a kept-alive socket
+                for (;;) {
+                    eol = rbuf_.find("\r\n", pos);
+                    if (eol == std::string::npos) return false;
+                    if (eol == pos) break;
+                    pos = eol + 2;
+                }
+                body = decoded;
+                return true;
+            }
+            if (rbuf_.size() < pos + size + 2) return false;
+            decoded.append(rbuf_, pos, size);
+            pos += size + 2;
+        }
+    }
+    if (contentLength_ >= 0) {
+        if (rbuf_.size() - bodyStart_ < static_cast<size_t>(contentLength_)) return false;
+        body = std::string_view(rbuf_).substr(bodyStart_, static_cast<size_t>(contentLength_));
+        return true;
+    }
+    // Close-delimited body
+    if (!eof) return false;
+    body = std::string_view(rbuf_).substr(bodyStart_);
+    return true;
+}
+
+void HttpClient::complete(std::string_view body) {
+    const bool reusable = keepAlive_ && !serverClose_ && (bodyless() || chunked_ || contentLength_ >= 0);
+    if (reusable) {
+        loop_.modify(fd_, EPOLLRDHUP, this);
+    } else {
+        closeSocket();
+    }
+    state_ = State::Idle;
+    HttpResult r;
+    r.transportOk = true;
+    r.status = status_;
+    r.startNs = startNs_;
+    r.endNs = nowNs();
+    r.body = body;
+    listener_.onHttpResult(r);
+}
+
+void HttpClient::fail(const char* err) {
+    closeSocket();
+    state_ = State::Idle;
+    HttpResult r;
+    r.error = err;
+    r.status = status_;
+    r.startNs = startNs_;
+    r.endNs = nowNs();
+    listener_.onHttpResult(r);
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,110 @@
+/*
+ * Non-blocking HTTP/1.1 client, one outstanding exchange at a time.
+ *
+ * Each VU owns one HttpClient. The caller hands over fully assembled request
+ * bytes (owned by the VU's arena, not copied); the client connects, writes, parses the status line plus
+ * Content-Length / chunked / close-delimited bodies and reports back through
+ * HttpListener. Errors never throw - they surface as !transportOk results,
+ * the same way LoadRunner reports a failed web_custom_request.
+ *
+ * With keepAlive the socket survives a complete exchange unless the server
+ * closes or asks to close it; an exchange on a reused socket that fails
+ * before any response byte arrives is retried once on a fresh connection
+ * (the server may have dropped the idle socket while the VU was thinking).
+ */
+#pragma once
+
+#include "event_loop.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+
+namespace bizobs::loadgen {
+
+struct Endpoint {
+    sockaddr_storage addr{};
+    socklen_t addrLen = 0;
+    std::string hostHeader; // "host:port"
+    std::string pathPrefix; // base URL path, without trailing slash
+};
+
+// Parses http://host[:port][/prefix] and resolves it once at startup.
+Endpoint resolveEndpoint(const std::string& baseUrl);
+
+struct HttpResult {
+    bool transportOk = false;
+    int status = 0;
+    const char* error = nullptr; // static string when !transportOk
+    uint64_t startNs = 0;
+    uint64_t endNs = 0;
+    std::string_view body;       // valid only during the callback
+};
+
+class HttpListener {
+public:
+    virtual ~HttpListener() = default;
+    virtual void onHttpResult(const HttpResult& r) = 0;
+};
+
+class HttpClient final : public IoHandler, public TimerHandler {
+public:
+    HttpClient(EventLoop& loop, const Endpoint& ep, HttpListener& listener, bool keepAlive = false);
+    ~HttpClient() override;
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    // Starts an exchange; `request` must be a complete HTTP/1.1 message and
+    // stay valid until the result callback (a retry resends the same bytes).
+    void send(std::string_view request, uint64_t timeoutNs);
+    bool busy() const { return state_ != State::Idle; }
+
+    void onIo(uint32_t events) override;
+    void onTimer(uint64_t token) override;
+
+private:
+    enum class State { Idle, Connecting, Writing, Reading };
+
+    EventLoop& loop_;
+    const Endpoint& ep_;
+    HttpListener& listener_;
+    const bool keepAlive_;
+
+    State state_ = State::Idle;
+    int fd_ = -1;
+    uint64_t gen_ = 0; // bumps per exchange so stale timeouts are ignored
+    uint64_t startNs_ = 0;
+    const char* pendingError_ = nullptr;
+    bool reused_ = false;      // current exchange runs on a kept-alive socket
+    bool serverClose_ = false; // response said Connection: close or was HTTP/1.0
+    bool headRequest_ = false; // its response has headers only
+
+    std::string_view wbuf_;
+    size_t woff_ = 0;
+    std::string rbuf_;
+
+    // Parsed response framing
+    size_t bodyStart_ = 0;
+    long contentLength_ = -1;
+    bool chunked_ = false;
+    int status_ = 0;
+
+    // 1xx, 204, 304 and HEAD responses end with their headers
+    bool bodyless() const { return headRequest_ || status_ < 200 || status_ == 204 || status_ == 304; }
+    void connectFresh();
+    void closeSocket();
+    // Reconnects and resends if a reused socket failed before any response
+    // byte; returns false when the failure should be reported.
+    bool retryFresh();
+    void fail(const char* err);
+    void deferFail(const char* err);
+    void complete(std::string_view body);
+    void doWrite();
+    void doRead();
+    bool parseHead();
+    // Returns true once the whole body is present; `body` gets the payload.
+    bool bodyComplete(bool eof, std::string& decoded, std::string_view& body);
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,144 @@
+#include "journey.h"
+
+#include "json.h"
+
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace bizobs::loadgen {
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot open " + path);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static json::Value parseFile(const std::string& path) {
+    try {
+        return json::Value::parse(readFile(path));
+    } catch (const json::ParseError& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+}
+
+static std::string stripSpaces(const std::string& s) {
+    std::string out;
+    for (char c : s)
+        if (c != ' ' && c != '\t') out += c;
+    return out;
+}
+
+Journey loadJourney(const std::string& path) {
+    json::Value root = parseFile(path);
+    // Accept both the flat test-config.json shape and a {journey: {...}} wrapper
+    const json::Value* cfg = &root;
+    if (const json::Value* inner = root.get("journey"); inner && inner->get("steps")) cfg = inner;
+
+    Journey j;
+    j.companyName = cfg->str("companyName", "DefaultCompany");
+    j.domain = cfg->str("domain", "default.com");
+    j.industryType = cfg->str("industryType", "general");
+    j.journeyType = cfg->str("journeyType");
+    if (const json::Value* af = cfg->get("additionalFields"); af && af->isObject())
+        j.additionalFieldsJson = json::dump(*af);
+
+    const json::Value* steps = cfg->get("steps");
+    if (!steps || !steps->isArray() || steps->items().empty())
+        throw std::runtime_error(path + ": journey has no steps");
+
+    int index = 0;
+    for (const json::Value& s : steps->items()) {
+        ++index;
+        JourneyStep step;
+        step.name = s.str("stepName", s.str("name", "Step_" + std::to_string(index)));
+        step.serviceName = s.str("serviceName", step.name + "Service");
+        step.description = s.str("description", s.str("stepDescription"));
+        step.category = s.str("category");
+        step.estimatedDuration = s.num("estimatedDuration", s.num("duration", 5000));
+        if (const double minutes = s.num("estimatedDuration"); minutes > 0) step.thinkMinutes = minutes;
+        if (const json::Value* sub = s.get("substeps"); sub && sub->isArray())
+            step.substepsJson = json::dump(*sub);
+        j.steps.push_back(std::move(step));
+    }
+    return j;
+}
+
+Scenario loadScenario(const std::string& path) {
+    json::Value root = parseFile(path);
+    Scenario sc;
+    sc.name = root.str("scenario", sc.name);
+
+    if (const json::Value* lr = root.get("loadrunner_config")) {
+        sc.vusers = static_cast<int>(lr->num("vusers", sc.vusers));
+        sc.rampUpSec = lr->num("ramp_up_time", sc.rampUpSec);
+        sc.durationSec = lr->num("duration", sc.durationSec);
+        sc.rampDownSec = lr->num("ramp_down_time", sc.rampDownSec);
+        sc.journeyIntervalSec = lr->num("journey_interval", sc.journeyIntervalSec);
+        sc.thinkTimeMs = static_cast<int>(lr->num("think_time", sc.thinkTimeMs));
+        sc.thinkDistribution = parseThinkDistribution(lr->str("think_time_distribution", "fixed"));
+        sc.thinkSigma = lr->num("think_time_sigma", sc.thinkSigma);
+        sc.timeCompression = lr->num("time_compression", sc.timeCompression);
+        sc.openModel = lr->str("arrival_model", "closed") == "open";
+        sc.arrivalRate = lr->num("arrival_rate", sc.arrivalRate);
+        if (const json::Value* cs = lr->get("capacity_search")) {
+            CapacitySearchConfig& c = sc.capacitySearch;
+            c.enabled = cs->boolean("enabled", true);
+            c.startRate = cs->num("start_rate", c.startRate);
+            c.maxRate = cs->num("max_rate", c.maxRate);
+            c.stepSec = cs->num("step_time", c.stepSec);
+            c.growth = cs->num("growth", c.growth);
+            c.precision = cs->num("precision", c.precision);
+            c.maxSteps = static_cast<int>(cs->num("max_steps", c.maxSteps));
+            c.cooldownSec = cs->num("cooldown", c.cooldownSec);
+        }
+    }
+    if (const json::Value* tags = root.get("dynatrace_tags")) {
+        sc.lsn = tags->str("LSN");
+        sc.ltn = tags->str("LTN");
+    }
+    if (const json::Value* err = root.get("error_simulation")) {
+        sc.errorSimulation = err->boolean("enabled", sc.errorSimulation);
+        sc.errorRatePct = err->num("error_rate", sc.errorRatePct);
+    }
+    if (const json::Value* mon = root.get("monitoring")) {
+        sc.responseTimeThresholdMs = mon->num("response_time_threshold");
+        sc.errorRateThresholdPct = mon->num("error_rate_threshold");
+        sc.throughputTarget = mon->num("throughput_target");
+    }
+    return sc;
+}
+
+ThinkDistribution parseThinkDistribution(const std::string& name) {
+    if (name == "fixed") return ThinkDistribution::Fixed;
+    if (name == "exponential") return ThinkDistribution::Exponential;
+    if (name == "lognormal") return ThinkDistribution::Lognormal;
+    throw std::runtime_error("Unknown think time distribution " + name);
+}
+
+const char* thinkDistributionName(ThinkDistribution d) {
+    switch (d) {
+    case ThinkDistribution::Exponential: return "exponential";
+    case ThinkDistribution::Lognormal: return "lognormal";
+    case ThinkDistribution::Fixed: break;
+    }
+    return "fixed";
+}
+
+std::string defaultLsn(const Journey& j) {
+    return "BizObs_" + stripSpaces(j.companyName) + "_" + j.domain + "_Journey";
+}
+
+std::string defaultLtn(const Journey& j) {
+    char date[16];
+    std::time_t now = std::time(nullptr);
+    std::tm tm{};
+    gmtime_r(&now, &tm);
+    std::strftime(date, sizeof date, "%Y%m%d", &tm);
+    return stripSpaces(j.companyName) + "_LoadTest_" + date;
+}
+
+} // namespace bizobs::loadgen
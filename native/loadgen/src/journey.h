@@ -0,0 +1,93 @@
+/*
+ * Journey + scenario model for the BizObs load engine.
+ *
+ * Journey: the same test-config.json the LoadRunner manager writes
+ *          (companyName, domain, steps[] ...).
+ * Scenario: loadrunner-tests/scenarios/<profile>.json.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+struct JourneyStep {
+    std::string name;           // TSN
+    std::string serviceName;
+    std::string description;
+    std::string category;
+    double estimatedDuration = 0;
+    double thinkMinutes = 5;    // estimatedDuration when it is a positive number of minutes
+    std::string substepsJson = "[]"; // pre-serialised, copied verbatim into bodies
+};
+
+struct Journey {
+    std::string companyName;
+    std::string domain;
+    std::string industryType;
+    std::string journeyType;
+    std::string additionalFieldsJson = "{}";
+    std::vector<JourneyStep> steps;
+};
+
+enum class ThinkDistribution { Fixed, Exponential, Lognormal };
+
+// loadrunner_config.capacity_search (capacity_search.h)
+struct CapacitySearchConfig {
+    bool enabled = false;
+    double startRate = 0;    // journeys/sec of the first step, 0 = a quarter of throughput_target
+    double maxRate = 0;      // 0 = no ceiling
+    double stepSec = 30;     // per rate; the first fifth settles, the rest is measured
+    double growth = 2;       // rate multiplier while steps hold
+    double precision = 0.05; // bisection stops when failed/held is within 1 + precision
+    int maxSteps = 20;
+    double cooldownSec = 5;  // pause after a failed step
+};
+
+struct Scenario {
+    std::string name = "adhoc";
+    int vusers = 1;
+    double rampUpSec = 0;
+    double durationSec = 60;
+    double rampDownSec = 0;
+    double journeyIntervalSec = 0; // IterationDelay between a VU's iterations
+    int thinkTimeMs = -1;          // -1: derive from step estimatedDuration like the generator
+    ThinkDistribution thinkDistribution = ThinkDistribution::Fixed;
+    double thinkSigma = 0.5;       // lognormal shape
+    double timeCompression = 60;   // real seconds per test second; 60 = estimated minutes as seconds
+    int iterations = 0;            // per VU, 0 = until the schedule ends (closed model only)
+
+    // Open model: journeys arrive on a ramp/plateau/ramp-down rate curve and
+    // vusers caps how many run at once; closed model: vusers loop with pacing
+    bool openModel = false;
+    double arrivalRate = 0;        // journeys/sec at the plateau, 0 = throughputTarget
+
+    std::string lsn;
+    std::string ltn;
+
+    bool errorSimulation = false;
+    double errorRatePct = 5; // template default when the scenario doesn't say
+
+    double responseTimeThresholdMs = 0;
+    double errorRateThresholdPct = 0;
+    double throughputTarget = 0;
+
+    CapacitySearchConfig capacitySearch;
+};
+
+// Both throw std::runtime_error with the path in the message.
+Journey loadJourney(const std::string& path);
+Scenario loadScenario(const std::string& path);
+
+std::string readFile(const std::string& path);
+
+// "fixed" | "exponential" | "lognormal"; throws std::runtime_error otherwise.
+ThinkDistribution parseThinkDistribution(const std::string& name);
+const char* thinkDistributionName(ThinkDistribution d);
+
+// LSN/LTN derivation shared with generateLoadRunnerScript().
+std::string defaultLsn(const Journey& j);
+std::string defaultLtn(const Journey& j);
+
+} // namespace bizobs::loadgen
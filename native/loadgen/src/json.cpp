@@ -0,0 +1,285 @@
+#include "json.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace bizobs::loadgen::json {
+
+class Parser {
+public:
+    explicit Parser(std::string_view text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+    Value parseDocument() {
+        Value v = parseValue();
+        skipWs();
+        if (p_ != end_) fail("trailing characters");
+        return v;
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+
+    [[noreturn]] void fail(const char* what) {
+        throw ParseError(std::string("json: ") + what);
+    }
+
+    void skipWs() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) ++p_;
+    }
+
+    bool consume(std::string_view lit) {
+        if (static_cast<size_t>(end_ - p_) < lit.size()) return false;
+        if (std::string_view(p_, lit.size()) != lit) return false;
+        p_ += lit.size();
+        return true;
+    }
+
+    Value parseValue() {
+        skipWs();
+        if (p_ == end_) fail("unexpected end of input");
+        Value v;
+        switch (*p_) {
+        case '{': parseObject(v); break;
+        case '[': parseArray(v); break;
+        case '"':
+            v.type_ = Value::Type::String;
+            v.s_ = parseString();
+            break;
+        case 't':
+            if (!consume("true")) fail("bad literal");
+            v.type_ = Value::Type::Bool;
+            v.b_ = true;
+            break;
+        case 'f':
+            if (!consume("false")) fail("bad literal");
+            v.type_ = Value::Type::Bool;
+            break;
+        case 'n':
+            if (!consume("null")) fail("bad literal");
+            break;
+        default: parseNumber(v); break;
+        }
+        return v;
+    }
+
+    void parseObject(Value& v) {
+        v.type_ = Value::Type::Object;
+        ++p_;
+        skipWs();
+        if (p_ < end_ && *p_ == '}') { ++p_; return; }
+        for (;;) {
+            skipWs();
+            if (p_ == end_ || *p_ != '"') fail("expected object key");
+            std::string key = parseString();
+            skipWs();
+            if (p_ == end_ || *p_ != ':') fail("expected ':'");
+            ++p_;
+            v.o_.emplace_back(std::move(key), parseValue());
+            skipWs();
+            if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+            if (p_ < end_ && *p_ == '}') { ++p_; return; }
+            fail("expected ',' or '}'");
+        }
+    }
+
+    void parseArray(Value& v) {
+        v.type_ = Value::Type::Array;
+        ++p_;
+        skipWs();
+        if (p_ < end_ && *p_ == ']') { ++p_; return; }
+        for (;;) {
+            v.a_.push_back(parseValue());
+            skipWs();
+            if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+            if (p_ < end_ && *p_ == ']') { ++p_; return; }
+            fail("expected ',' or ']'");
+        }
+    }
+
+    static void appendUtf8(std::string& out, unsigned cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    unsigned parseHex4() {
+        if (end_ - p_ < 4) fail("short \\u escape");
+        unsigned cp = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p_++;
+            cp <<= 4;
+            if (c >= '0' && c <= '9') cp |= c - '0';
+            else if (c >= 'a' && c <= 'f') cp |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') cp |= c - 'A' + 10;
+            else fail("bad \\u escape");
+        }
+        return cp;
+    }
+
+    std::string parseString() {
+        ++p_; // opening quote
+        std::string out;
+        while (p_ < end_ && *p_ != '"') {
+            char c = *p_++;
+            if (c != '\\') { out += c; continue; }
+            if (p_ == end_) fail("unterminated escape");
+            char e = *p_++;
+            switch (e) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned cp = parseHex4();
+                if (cp >= 0xD800 && cp <= 0xDBFF && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+                    p_ += 2;
+                    unsigned lo = parseHex4();
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default: fail("bad escape");
+            }
+        }
+        if (p_ == end_) fail("unterminated string");
+        ++p_; // closing quote
+        return out;
+    }
+
+    void parseNumber(Value& v) {
+        const char* start = p_;
+        if (p_ < end_ && *p_ == '-') ++p_;
+        while (p_ < end_ && ((*p_ >= '0' && *p_ <= '9') || *p_ == '.' || *p_ == 'e' ||
+                             *p_ == 'E' || *p_ == '+' || *p_ == '-'))
+            ++p_;
+        if (p_ == start) fail("unexpected character");
+        std::string tmp(start, p_);
+        char* parsedEnd = nullptr;
+        v.type_ = Value::Type::Number;
+        v.n_ = std::strtod(tmp.c_str(), &parsedEnd);
+        if (parsedEnd != tmp.c_str() + tmp.size()) fail("bad number");
+    }
+};
+
+Value Value::parse(std::string_view text) {
+    return Parser(text).parseDocument();
+}
+
+const Value* Value::get(std::string_view key) const {
+    if (type_ != Type::Object) return nullptr;
+    for (const auto& [k, v] : o_)
+        if (k == key) return &v;
+    return nullptr;
+}
+
+std::string Value::str(std::string_view key, const std::string& fallback) const {
+    const Value* v = get(key);
+    return v && v->isString() ? v->s_ : fallback;
+}
+
+double Value::num(std::string_view key, double fallback) const {
+    const Value* v = get(key);
+    return v && v->isNumber() ? v->n_ : fallback;
+}
+
+bool Value::boolean(std::string_view key, bool fallback) const {
+    const Value* v = get(key);
+    return v && v->type_ == Type::Bool ? v->b_ : fallback;
+}
+
+void appendEscaped(std::string& out, std::string_view s) {
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof buf, "\\u%04x", c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+void appendNumber(std::string& out, double n) {
+    char buf[32];
+    if (std::isfinite(n) && n == std::floor(n) && std::fabs(n) < 1e15) {
+        std::snprintf(buf, sizeof buf, "%.0f", n);
+    } else {
+        // Shortest of the two that reads back exactly (0.1, not 0.10000000000000001)
+        std::snprintf(buf, sizeof buf, "%.15g", n);
+        if (std::strtod(buf, nullptr) != n) std::snprintf(buf, sizeof buf, "%.17g", n);
+    }
+    out += buf;
+}
+
+void dump(const Value& v, std::string& out) {
+    switch (v.type()) {
+    case Value::Type::Null: out += "null"; break;
+    case Value::Type::Bool: out += v.asBool() ? "true" : "false"; break;
+    case Value::Type::Number: appendNumber(out, v.asNumber()); break;
+    case Value::Type::String:
+        out += '"';
+        appendEscaped(out, v.asString());
+        out += '"';
+        break;
+    case Value::Type::Array: {
+        out += '[';
+        bool first = true;
+        for (const auto& item : v.items()) {
+            if (!first) out += ',';
+            first = false;
+            dump(item, out);
+        }
+        out += ']';
+        break;
+    }
+    case Value::Type::Object: {
+        out += '{';
+        bool first = true;
+        for (const auto& [k, item] : v.members()) {
+            if (!first) out += ',';
+            first = false;
+            out += '"';
+            appendEscaped(out, k);
+            out += "\":";
+            dump(item, out);
+        }
+        out += '}';
+        break;
+    }
+    }
+}
+
+std::string dump(const Value& v) {
+    std::string out;
+    dump(v, out);
+    return out;
+}
+
+} // namespace bizobs::loadgen::json
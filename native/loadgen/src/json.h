@@ -0,0 +1,72 @@
+/*
+ * Minimal JSON DOM for the BizObs load engine.
+ *
+ * Only what the engine needs to read test-config.json / scenarios/<profile>.json and
+ * to re-emit sub-trees (substeps, additionalFields) into request bodies.
+ * No external dependencies so the engine builds on a bare load VM.
+ */
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bizobs::loadgen::json {
+
+struct ParseError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+class Value {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Value() = default;
+
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == Type::Null; }
+    bool isNumber() const { return type_ == Type::Number; }
+    bool isString() const { return type_ == Type::String; }
+    bool isArray() const { return type_ == Type::Array; }
+    bool isObject() const { return type_ == Type::Object; }
+
+    // Lookup helpers return nullptr / fallback instead of throwing so that
+    // loaders can stay tolerant of the many hand-edited configs in the repo.
+    const Value* get(std::string_view key) const;
+    std::string str(std::string_view key, const std::string& fallback = "") const;
+    double num(std::string_view key, double fallback = 0) const;
+    bool boolean(std::string_view key, bool fallback = false) const;
+
+    bool asBool() const { return b_; }
+    double asNumber() const { return n_; }
+    const std::string& asString() const { return s_; }
+    const std::vector<Value>& items() const { return a_; }
+    const std::vector<std::pair<std::string, Value>>& members() const { return o_; }
+
+    static Value parse(std::string_view text);
+
+private:
+    friend class Parser;
+
+    Type type_ = Type::Null;
+    bool b_ = false;
+    double n_ = 0;
+    std::string s_;
+    std::vector<Value> a_;
+    std::vector<std::pair<std::string, Value>> o_;
+};
+
+// Serialise compactly (no whitespace), preserving member order.
+void dump(const Value& v, std::string& out);
+std::string dump(const Value& v);
+
+// Append `s` as the inside of a JSON string literal (no surrounding quotes).
+void appendEscaped(std::string& out, std::string_view s);
+
+// Append `n` the way JSON.stringify would for the values configs contain:
+// integers without a fraction, everything else round-trippable.
+void appendNumber(std::string& out, double n);
+
+} // namespace bizobs::loadgen::json
@@ -0,0 +1,175 @@
+/*
+ * bizobs-loadgen - native load engine for BizObs journeys.
+ *
+ * Fallback driver for /api/loadrunner/start-test when wlrun/mmdrv are not
+ * installed; also runnable by hand against a scenario profile:
+ *
+ *   bizobs-loadgen --config loadrunner-tests/BT/test-config.json \
+ *                  --scenario loadrunner-tests/scenarios/spike-test.json
+ */
+#include "engine.h"
+#include "journey.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+using namespace bizobs::loadgen;
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr,
+        "Usage: bizobs-loadgen --config <test-config.json> [options]\n"
+        "\n"
+        "  --scenario <file>          loadrunner-tests/scenarios/<profile>.json profile\n"
+        "  --base-url <url>           BizObs server (default http://localhost:8080)\n"
+        "  --vusers <n>               override scenario vusers\n"
+        "  --ramp-up <s>              override ramp_up_time\n"
+        "  --duration <s>             override duration (hold after ramp-up)\n"
+        "  --ramp-down <s>            override ramp_down_time\n"
+        "  --journey-interval <s>     pacing between a VU's iterations\n"
+        "  --think-time-ms <ms>       mean think time per step (default: estimatedDuration minutes)\n"
+        "  --think-dist <dist>        fixed (default), exponential or lognormal around the mean\n"
+        "  --think-sigma <s>          lognormal shape (default 0.5)\n"
+        "  --time-compression <x>     divide think time by x (default 60: minutes as seconds)\n"
+        "  --iterations <n>           journeys per VU, 0 = until schedule ends (closed model)\n"
+        "  --arrival-model <model>    closed (VUs loop with pacing) or open (journeys/s curve)\n"
+        "  --arrival-rate <n>         open model plateau in journeys/s (default throughput_target)\n"
+        "  --capacity-search <0|1>    step/bisect the arrival rate against the monitoring thresholds\n"
+        "  --search-start-rate <n>    first step in journeys/s (default throughput_target / 4)\n"
+        "  --search-max-rate <n>      never offer more than this (default no ceiling)\n"
+        "  --search-step <s>          seconds per rate step (default 30)\n"
+        "  --error-simulation <0|1>   send a seeded x-error-schedule the services fail steps by\n"
+        "  --error-rate <pct>         share of steps scheduled to fail (default 5)\n"
+        "  --lsn <name> / --ltn <name> Dynatrace tags (default: generator naming)\n"
+        "  --results-dir <dir>        write engine_summary.json here\n"
+        "  --report-interval <s>      progress line period (default 5, 0 = off)\n"
+        "  --grace <s>                wait for in-flight journeys (default 60)\n"
+        "  --timeout-ms <ms>          per-request timeout (default 30000)\n"
+        "  --journey-mode <mode>      per-step (default) or chained: whole journey per request\n"
+        "  --body-templates <file>    compiled bodies from the generator (body-templates.json)\n"
+        "  --keep-alive <0|1>         reuse one connection per VU (default 0: close per request)\n"
+        "  --seed <n>                 RNG and error schedule seed for reproducible runs\n"
+        "  --vu-offset <n>            number VUs from n + 1 (one shard of a distributed run)\n"
+        "  --vu-total <n>             VUs across all shards (default offset + vusers): customer row stride\n"
+        "  --export-histograms <0|1>  rewrite engine_histograms.json at every progress report\n"
+        "  --results-file <path>      append one 24-byte record per transaction (results.bin)\n"
+        "  --customers <file>         shared customers.dat pool, one row per VU and iteration\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string configPath, scenarioPath;
+    EngineOptions opts;
+    // Command-line overrides are applied after the scenario file is loaded
+    struct Override { const char* flag; std::string value; };
+    Override overrides[] = {
+        {"--vusers", {}}, {"--ramp-up", {}}, {"--duration", {}}, {"--ramp-down", {}},
+        {"--journey-interval", {}}, {"--think-time-ms", {}}, {"--iterations", {}},
+        {"--think-dist", {}}, {"--think-sigma", {}}, {"--time-compression", {}},
+        {"--error-simulation", {}}, {"--error-rate", {}}, {"--lsn", {}}, {"--ltn", {}},
+        {"--arrival-model", {}}, {"--arrival-rate", {}},
+        {"--capacity-search", {}}, {"--search-start-rate", {}}, {"--search-max-rate", {}}, {"--search-step", {}},
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!std::strcmp(arg, "--help") || !std::strcmp(arg, "-h")) {
+            usage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "[bizobs-loadgen] ❌ Missing value for %s\n", arg);
+            usage();
+            return 2;
+        }
+        const char* val = argv[++i];
+        if (!std::strcmp(arg, "--config")) configPath = val;
+        else if (!std::strcmp(arg, "--scenario")) scenarioPath = val;
+        else if (!std::strcmp(arg, "--base-url")) opts.baseUrl = val;
+        else if (!std::strcmp(arg, "--results-dir")) opts.resultsDir = val;
+        else if (!std::strcmp(arg, "--report-interval")) opts.reportIntervalSec = std::atof(val);
+        else if (!std::strcmp(arg, "--grace")) opts.graceSec = std::atof(val);
+        else if (!std::strcmp(arg, "--timeout-ms")) opts.requestTimeoutMs = std::atoi(val);
+        else if (!std::strcmp(arg, "--seed")) opts.seed = std::strtoull(val, nullptr, 10);
+        else if (!std::strcmp(arg, "--body-templates")) opts.bodyTemplatesPath = val;
+        else if (!std::strcmp(arg, "--keep-alive")) opts.keepAlive = std::atoi(val) != 0;
+        else if (!std::strcmp(arg, "--vu-offset")) opts.vuOffset = std::atoi(val);
+        else if (!std::strcmp(arg, "--vu-total")) opts.vuTotal = std::atoi(val);
+        else if (!std::strcmp(arg, "--export-histograms")) opts.exportHistograms = std::atoi(val) != 0;
+        else if (!std::strcmp(arg, "--results-file")) opts.resultsFile = val;
+        else if (!std::strcmp(arg, "--customers")) opts.customersPath = val;
+        else if (!std::strcmp(arg, "--journey-mode")) {
+            if (std::strcmp(val, "chained") && std::strcmp(val, "per-step")) {
+                std::fprintf(stderr, "[bizobs-loadgen] ❌ Unknown journey mode %s\n", val);
+                return 2;
+            }
+            opts.chainedJourney = !std::strcmp(val, "chained");
+        }
+        else {
+            bool known = false;
+            for (Override& o : overrides) {
+                if (!std::strcmp(arg, o.flag)) {
+                    o.value = val;
+                    known = true;
+                }
+            }
+            if (!known) {
+                std::fprintf(stderr, "[bizobs-loadgen] ❌ Unknown option %s\n", arg);
+                usage();
+                return 2;
+            }
+        }
+    }
+
+    if (configPath.empty()) {
+        usage();
+        return 2;
+    }
+
+    try {
+        Journey journey = loadJourney(configPath);
+        Scenario scenario = scenarioPath.empty() ? Scenario{} : loadScenario(scenarioPath);
+
+        for (const Override& o : overrides) {
+            if (o.value.empty()) continue;
+            const std::string flag = o.flag;
+            const char* v = o.value.c_str();
+            if (flag == "--vusers") scenario.vusers = std::atoi(v);
+            else if (flag == "--ramp-up") scenario.rampUpSec = std::atof(v);
+            else if (flag == "--duration") scenario.durationSec = std::atof(v);
+            else if (flag == "--ramp-down") scenario.rampDownSec = std::atof(v);
+            else if (flag == "--journey-interval") scenario.journeyIntervalSec = std::atof(v);
+            else if (flag == "--think-time-ms") scenario.thinkTimeMs = std::atoi(v);
+            else if (flag == "--think-dist") scenario.thinkDistribution = parseThinkDistribution(o.value);
+            else if (flag == "--think-sigma") scenario.thinkSigma = std::atof(v);
+            else if (flag == "--time-compression") scenario.timeCompression = std::atof(v);
+            else if (flag == "--iterations") scenario.iterations = std::atoi(v);
+            else if (flag == "--error-simulation") scenario.errorSimulation = std::atoi(v) != 0;
+            else if (flag == "--error-rate") scenario.errorRatePct = std::atof(v);
+            else if (flag == "--lsn") scenario.lsn = o.value;
+            else if (flag == "--ltn") scenario.ltn = o.value;
+            else if (flag == "--arrival-model") {
+                if (o.value != "open" && o.value != "closed")
+                    throw std::runtime_error("Unknown arrival model " + o.value);
+                scenario.openModel = o.value == "open";
+            }
+            else if (flag == "--arrival-rate") scenario.arrivalRate = std::atof(v);
+            else if (flag == "--capacity-search") scenario.capacitySearch.enabled = std::atoi(v) != 0;
+            else if (flag == "--search-start-rate") scenario.capacitySearch.startRate = std::atof(v);
+            else if (flag == "--search-max-rate") scenario.capacitySearch.maxRate = std::atof(v);
+            else if (flag == "--search-step") scenario.capacitySearch.stepSec = std::atof(v);
+        }
+
+        Engine engine(std::move(journey), std::move(scenario), std::move(opts));
+        return engine.run();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "[bizobs-loadgen] ❌ %s\n", e.what());
+        return 1;
+    }
+}
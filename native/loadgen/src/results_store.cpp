@@ -0,0 +1,70 @@
+#include "results_store.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace bizobs::loadgen {
+
+namespace {
+
+void put(unsigned char* p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint64_t wallUs() {
+    timespec ts{};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ull + static_cast<uint64_t>(ts.tv_nsec) / 1000;
+}
+
+} // namespace
+
+ResultStore::ResultStore(const std::string& path) {
+    if (path.empty()) return;
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    buf_.reserve(kBufferRecords * kRecordBytes);
+}
+
+ResultStore::~ResultStore() {
+    if (fd_ < 0) return;
+    flush();
+    close(fd_);
+}
+
+void ResultStore::append(int vu, int iteration, size_t tsn, bool ok, uint64_t serviceUs) {
+    if (fd_ < 0) return;
+    const size_t at = buf_.size();
+    buf_.resize(at + kRecordBytes);
+    unsigned char* p = buf_.data() + at;
+    put(p, wallUs(), 8);
+    put(p + 8, static_cast<uint32_t>(vu), 4);
+    put(p + 12, static_cast<uint32_t>(iteration), 4);
+    put(p + 16, tsn > 0xffff ? 0xffff : tsn, 2);
+    p[18] = ok ? 0 : 1;
+    p[19] = 0;
+    put(p + 20, serviceUs > 0xffffffffull ? 0xffffffffull : serviceUs, 4);
+    ++records_;
+    if (buf_.size() >= kBufferRecords * kRecordBytes) flush();
+}
+
+void ResultStore::flush() {
+    size_t off = 0;
+    while (off < buf_.size()) {
+        const ssize_t n = write(fd_, buf_.data() + off, buf_.size() - off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::fprintf(stderr, "[bizobs-loadgen] ❌ Cannot append results: %s\n", std::strerror(errno));
+            break;
+        }
+        off += static_cast<size_t>(n);
+    }
+    buf_.clear();
+}
+
+} // namespace bizobs::loadgen
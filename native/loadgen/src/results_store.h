@@ -0,0 +1,52 @@
+/*
+ * Append-only binary results file: one fixed 24-byte record per transaction.
+ *
+ * Same layout as services/results-store.js, which /results/:testId scans,
+ * and as the writers in bizobs-journey-template.c and the load simulator.
+ * Little-endian:
+ *   0   u64  transaction end, us since the Unix epoch
+ *   8   u32  VU id
+ *   12  u32  iteration
+ *   16  u16  TSN id: step index; steps = Journey_Complete,
+ *            steps + 1 = Full_Customer_Journey
+ *   18  u8   status, 0 pass / 1 fail
+ *   19  u8   reserved, 0
+ *   20  u32  service time in us, saturating
+ * There is no header. Writers append whole records with O_APPEND, so several
+ * processes can share one file and a reader only needs its length.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+class ResultStore {
+public:
+    static constexpr size_t kRecordBytes = 24;
+
+    // Empty path: disabled, append() is a no-op. Throws if the file cannot be opened.
+    explicit ResultStore(const std::string& path);
+    ~ResultStore();
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    bool enabled() const { return fd_ >= 0; }
+    uint64_t records() const { return records_; }
+
+    void append(int vu, int iteration, size_t tsn, bool ok, uint64_t serviceUs);
+    // Writes buffered records; called at every progress report and on exit.
+    void flush();
+
+private:
+    static constexpr size_t kBufferRecords = 2048;
+
+    int fd_ = -1;
+    std::vector<unsigned char> buf_;
+    uint64_t records_ = 0;
+};
+
+} // namespace bizobs::loadgen
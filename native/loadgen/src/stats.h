@@ -0,0 +1,59 @@
+/*
+ * Transaction accounting, one slot per transaction name.
+ *
+ * Slots are allocated up front (one per TSN plus the journey-level
+ * transactions) so the hot path is an array index, never a map lookup.
+ *
+ * Each slot keeps two histograms. `service` is the request's own time on
+ * the wire (what LoadRunner reports as response time). `latency` counts from
+ * when the request should have been sent - the scheduled arrival or the end
+ * of think time - so a stall that delays later requests still shows up in
+ * their percentiles instead of being coordinated away.
+ */
+#pragma once
+
+#include "hdr_histogram.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+struct TxStats {
+    std::string name;
+    uint64_t pass = 0;
+    uint64_t fail = 0;
+    uint64_t sumUs = 0;
+    uint64_t minUs = std::numeric_limits<uint64_t>::max();
+    uint64_t maxUs = 0;
+    HdrHistogram service;
+    HdrHistogram latency;
+
+    uint64_t count() const { return pass + fail; }
+    void record(bool ok, uint64_t serviceUs, uint64_t latencyUs) {
+        ok ? ++pass : ++fail;
+        sumUs += serviceUs;
+        if (serviceUs < minUs) minUs = serviceUs;
+        if (serviceUs > maxUs) maxUs = serviceUs;
+        service.record(serviceUs);
+        latency.record(latencyUs < serviceUs ? serviceUs : latencyUs);
+    }
+};
+
+class StatsTable {
+public:
+    size_t add(std::string name) {
+        slots_.push_back(TxStats{});
+        slots_.back().name = std::move(name);
+        return slots_.size() - 1;
+    }
+    TxStats& operator[](size_t id) { return slots_[id]; }
+    const std::vector<TxStats>& all() const { return slots_; }
+
+private:
+    std::vector<TxStats> slots_;
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,49 @@
+#include "think_time.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bizobs::loadgen {
+
+namespace {
+
+// (0, 1): never 0, so ln(u) stays finite
+double uniform(uint32_t r) {
+    return (static_cast<double>(r >> 8) + 0.5) / 16777216.0;
+}
+
+} // namespace
+
+ThinkTime::ThinkTime(const Journey& journey, const Scenario& scenario)
+    : dist_(scenario.thinkDistribution), sigma_(scenario.thinkSigma) {
+    const double compression = scenario.timeCompression > 0 ? scenario.timeCompression : 1;
+    meanMs_.reserve(journey.steps.size());
+    for (const JourneyStep& s : journey.steps) {
+        const double realMs = scenario.thinkTimeMs >= 0 ? scenario.thinkTimeMs : s.thinkMinutes * 60000;
+        meanMs_.push_back(realMs / compression);
+    }
+}
+
+uint64_t ThinkTime::sampleNs(size_t step, uint32_t r1, uint32_t r2) const {
+    const double mean = meanMs_[step];
+    double ms = mean;
+    if (mean > 0) {
+        switch (dist_) {
+        case ThinkDistribution::Exponential:
+            ms = -mean * std::log(uniform(r1));
+            break;
+        case ThinkDistribution::Lognormal: {
+            // Box-Muller normal draw
+            const double z = std::sqrt(-2 * std::log(uniform(r1))) * std::cos(6.283185307179586 * uniform(r2));
+            ms = std::exp(std::log(mean) - sigma_ * sigma_ / 2 + sigma_ * z);
+            break;
+        }
+        case ThinkDistribution::Fixed:
+            break;
+        }
+    }
+    ms = std::min(ms, mean * kMaxFactor);
+    return static_cast<uint64_t>(std::llround(ms)) * 1000000ull;
+}
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,45 @@
+/*
+ * Per-step think time: a mean per TSN, a distribution around it and a
+ * time-compression factor, sampled at millisecond resolution.
+ *
+ * The mean is the scenario's think_time when set, otherwise the step's
+ * estimatedDuration (minutes of real customer time). Dividing by
+ * time_compression maps that real time onto test time, so the same journey
+ * mix runs 10-100x faster without more VUs; the default of 60 replays each
+ * estimated minute as a second.
+ *
+ * Distributions (same formulas as think_time_sample() in the generated script):
+ *   fixed        the mean
+ *   exponential  -mean * ln(u)
+ *   lognormal    exp(mu + sigma * z), mu = ln(mean) - sigma^2 / 2 keeps the mean
+ * Samples are capped at kMaxFactor x the mean so one draw cannot park a VU
+ * for the rest of the run.
+ */
+#pragma once
+
+#include "journey.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bizobs::loadgen {
+
+class ThinkTime {
+public:
+    static constexpr double kMaxFactor = 10;
+
+    ThinkTime(const Journey& journey, const Scenario& scenario);
+
+    // Mean, already compressed, of `step` in ms.
+    double meanMs(size_t step) const { return meanMs_[step]; }
+    // One draw for `step` from two independent 32-bit random values.
+    uint64_t sampleNs(size_t step, uint32_t r1, uint32_t r2) const;
+
+private:
+    ThinkDistribution dist_;
+    double sigma_;
+    std::vector<double> meanMs_;
+};
+
+} // namespace bizobs::loadgen
@@ -0,0 +1,380 @@
+#include "vuser.h"
+
+#include "engine.h"
+#include "json.h"
+
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <string_view>
+
+namespace bizobs::loadgen {
+
+VUser::VUser(Engine& engine, int id)
+    : eng_(engine), id_(id), http_(engine.loop(), engine.endpoint(), *this, engine.options().keepAlive),
+      rng_(engine.seed() ^ (0x9E3779B97F4A7C15ull * static_cast<uint64_t>(id + 1))) {
+    if (rng_ == 0) rng_ = 1;
+}
+
+uint32_t VUser::nextRandom() {
+    // xorshift64*: cheap, per-VU, reproducible from --seed
+    rng_ ^= rng_ >> 12;
+    rng_ ^= rng_ << 25;
+    rng_ ^= rng_ >> 27;
+    return static_cast<uint32_t>((rng_ * 2685821657736338717ull) >> 32);
+}
+
+void VUser::armTimer(uint64_t delayNs) {
+    timerDeadlineNs_ = nowNs() + delayNs;
+    eng_.loop().schedule(timerDeadlineNs_, this, ++timerGen_);
+}
+
+void VUser::start() {
+    if (phase_ != Phase::Idle) return;
+    init();
+    beginIteration(nowNs());
+}
+
+void VUser::startJourney(uint64_t scheduledNs) {
+    if (phase_ == Phase::Idle) init();
+    beginIteration(scheduledNs);
+}
+
+void VUser::init() {
+    // vuser_init(): without a pool, pick this VU's customer once
+    if (!eng_.customers().enabled()) {
+        const CustomerProfile& customer = kCustomers[nextRandom() % std::size(kCustomers)];
+        trafficSource_ = kTrafficSources[nextRandom() % std::size(kTrafficSources)];
+        segment_ = customer.segment;
+        slot(Slot::CustomerName).clear();
+        json::appendEscaped(slot(Slot::CustomerName), customer.name);
+        slot(Slot::CustomerEmail).clear();
+        json::appendEscaped(slot(Slot::CustomerEmail), customer.email);
+        slot(Slot::CustomerSegment).clear();
+        json::appendEscaped(slot(Slot::CustomerSegment), customer.segment);
+    }
+
+    dtHeader_.reserve(512);
+    dtHeader_ = "LSN=" + eng_.lsn() + ";LTN=" + eng_.ltn() + ";VU=" + std::to_string(id_) +
+                ";SI=NativeEngine;PC=BizObs-Demo;AN=" + eng_.journey().companyName + ";CID=";
+    dtCidOffset_ = dtHeader_.size();
+    errorSeed_ = eng_.errors().vuSeed(id_);
+}
+
+void VUser::requestStop() {
+    stopRequested_ = true;
+    if (phase_ == Phase::Idle || phase_ == Phase::Pacing) finish();
+}
+
+void VUser::finish() {
+    if (phase_ == Phase::Done) return;
+    ++timerGen_; // drop any pending pacing timer
+    phase_ = Phase::Done;
+    eng_.vuFinished();
+}
+
+void VUser::beginIteration(uint64_t scheduledNs) {
+    const int maxIterations = eng_.scenario().openModel ? 0 : eng_.scenario().iterations;
+    if (stopRequested_ || (maxIterations > 0 && iteration_ >= maxIterations)) {
+        finish();
+        return;
+    }
+    ++iteration_;
+    step_ = 0;
+    journeyOk_ = true;
+    journeyStartNs_ = scheduledNs;
+    journeyBeganNs_ = nowNs();
+    intendedNs_ = scheduledNs;
+
+    // Action(): per-iteration correlation identifiers, same shapes as the generator
+    const long t = static_cast<long>(std::time(nullptr));
+    char buf[256];
+    std::snprintf(buf, sizeof buf, "LR_%s_%d_%d_%ld", eng_.ltn().c_str(), id_, iteration_, t);
+    slot(Slot::CorrelationId) = buf;
+    std::snprintf(buf, sizeof buf, "customer_%d_%d_%ld", id_, iteration_, t % 10000);
+    slot(Slot::CustomerId) = buf;
+    std::snprintf(buf, sizeof buf, "session_%s_%d_%d", eng_.lsn().c_str(), id_, iteration_);
+    slot(Slot::SessionId) = buf;
+    slot(Slot::TraceId) = "trace_" + slot(Slot::CorrelationId) + "_" + std::to_string(t);
+    pickCustomer();
+
+    dtHeader_.resize(dtCidOffset_);
+    dtHeader_ += slot(Slot::CorrelationId);
+    dtHeader_ += ';';
+    dtTsnOffset_ = dtHeader_.size();
+    arena_.reset();
+    planErrors();
+
+    if (eng_.options().chainedJourney) sendJourney();
+    else sendStep();
+}
+
+// Row (iteration - 1) * vuTotal + VU: ids already carry the shard's offset,
+// so every VU of every shard gets a different customer each iteration until
+// the run has used the whole pool
+void VUser::pickCustomer() {
+    const CustomerPool& pool = eng_.customers();
+    if (!pool.enabled()) return;
+    const size_t row = static_cast<size_t>(iteration_ - 1) * static_cast<size_t>(eng_.options().vuTotal) +
+                       static_cast<size_t>(id_ - 1);
+    const PooledCustomer c = pool.at(row);
+    // Pool values are JSON-safe: copied, not escaped, into buffers that keep their capacity
+    slot(Slot::CustomerName).assign(c.name);
+    slot(Slot::CustomerEmail).assign(c.email);
+    slot(Slot::CustomerSegment).assign(c.segment);
+    segment_ = c.segment;
+    trafficSource_ = c.trafficSource;
+}
+
+void VUser::planErrors() {
+    errorSchedule_.clear();
+    const ErrorSchedule& errors = eng_.errors();
+    if (!errors.enabled()) return;
+    const auto& steps = eng_.journey().steps;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (!errors.fails(errorSeed_, iteration_, i)) continue;
+        if (!errorSchedule_.empty()) errorSchedule_ += ',';
+        errorSchedule_ += steps[i].name;
+        eng_.countScheduledError();
+    }
+}
+
+void VUser::appendCommonHeaders(Arena& req, size_t tsnIndex, size_t bodyLen) {
+    const Endpoint& ep = eng_.endpoint();
+    dtHeader_.resize(dtTsnOffset_);
+    dtHeader_ += eng_.dtStepSuffix(tsnIndex);
+
+    req += "POST ";
+    req += eng_.simulatePath();
+    req += " HTTP/1.1\r\nHost: ";
+    req += ep.hostHeader;
+    req += "\r\nContent-Type: application/json\r\nUser-Agent: LoadRunner-BizObs-Agent/1.0\r\nConnection: ";
+    req += eng_.options().keepAlive ? "keep-alive" : "close";
+    req += "\r\nx-loadrunner-test: true\r\nX-dynaTrace: ";
+    req += dtHeader_;
+    req += "\r\nx-correlation-id: ";
+    req += slot(Slot::CorrelationId);
+    req += "\r\nx-customer-id: ";
+    req += slot(Slot::CustomerId);
+    req += "\r\nx-session-id: ";
+    req += slot(Slot::SessionId);
+    req += "\r\nx-trace-id: ";
+    req += slot(Slot::TraceId);
+    req += "\r\nx-test-iteration: ";
+    req += std::to_string(iteration_);
+    req += "\r\nContent-Length: ";
+    req += std::to_string(bodyLen);
+    req += "\r\n";
+}
+
+void VUser::appendErrorSchedule(Arena& req) const {
+    if (errorSchedule_.empty()) return;
+    req += "x-error-schedule: ";
+    req += errorSchedule_;
+    req += "\r\n";
+}
+
+void VUser::sendStep() {
+    const JourneyStep& s = eng_.journey().steps[step_];
+    const BodyTemplate& body = eng_.bodies().steps[step_];
+    const size_t bodyLen = body.renderedSize(slots_);
+
+    Arena& req = arena_;
+    req.reserve(768 + bodyLen);
+    appendCommonHeaders(req, step_, bodyLen);
+    req += "x-step-name: ";
+    req += s.name;
+    req += "\r\nx-service-name: ";
+    req += s.serviceName;
+    req += "\r\nx-customer-segment: ";
+    req += segment_;
+    req += "\r\nx-traffic-source: ";
+    req += trafficSource_;
+    req += "\r\n";
+    appendErrorSchedule(req);
+    req += "\r\n";
+    body.render(req, slots_);
+
+    phase_ = Phase::Step;
+    http_.send(req.take(), static_cast<uint64_t>(eng_.options().requestTimeoutMs) * 1000000ull);
+}
+
+void VUser::sendJourney() {
+    // Every step in one body: the first service chains the rest and answers
+    // with journey.stepTimings
+    const Journey& j = eng_.journey();
+    const JourneyStep& first = j.steps.front();
+    const BodyTemplate& body = eng_.bodies().journey;
+    const size_t bodyLen = body.renderedSize(slots_);
+
+    Arena& req = arena_;
+    req.reserve(768 + bodyLen);
+    appendCommonHeaders(req, j.steps.size() + 1, bodyLen);
+    req += "x-step-name: ";
+    req += first.name;
+    req += "\r\nx-service-name: ";
+    req += first.serviceName;
+    req += "\r\nx-customer-segment: ";
+    req += segment_;
+    req += "\r\nx-traffic-source: ";
+    req += trafficSource_;
+    req += "\r\n";
+    appendErrorSchedule(req);
+    req += "\r\n";
+    body.render(req, slots_);
+
+    phase_ = Phase::Journey;
+    http_.send(req.take(), static_cast<uint64_t>(eng_.options().requestTimeoutMs) * 1000000ull);
+}
+
+void VUser::sendCompletion() {
+    char when[32];
+    const std::time_t now = std::time(nullptr);
+    std::tm tm{};
+    gmtime_r(&now, &tm);
+    std::strftime(when, sizeof when, "%Y-%m-%dT%H:%M:%SZ", &tm);
+    slot(Slot::CompletionTime) = when;
+
+    const BodyTemplate& body = eng_.bodies().completion;
+    const size_t bodyLen = body.renderedSize(slots_);
+    Arena& req = arena_;
+    req.reserve(768 + bodyLen);
+    appendCommonHeaders(req, eng_.journey().steps.size(), bodyLen);
+    req += "\r\n";
+    body.render(req, slots_);
+
+    phase_ = Phase::Completion;
+    http_.send(req.take(), static_cast<uint64_t>(eng_.options().requestTimeoutMs) * 1000000ull);
+}
+
+void VUser::onHttpResult(const HttpResult& r) {
+    if (phase_ == Phase::Step) onStepResult(r);
+    else if (phase_ == Phase::Journey) onJourneyResult(r);
+    else if (phase_ == Phase::Completion) onCompletionResult(r);
+}
+
+namespace {
+
+// The "stepTimings" array out of a simulate-journey response. The rest of the
+// body (the nested per-service chain) can be tens of KB, so only this slice
+// is handed to the JSON parser.
+std::string_view findStepTimings(std::string_view body) {
+    constexpr std::string_view key = "\"stepTimings\":";
+    size_t pos = body.find(key);
+    if (pos == std::string_view::npos) return {};
+    pos = body.find('[', pos + key.size());
+    if (pos == std::string_view::npos) return {};
+    int depth = 0;
+    bool inString = false;
+    for (size_t i = pos; i < body.size(); ++i) {
+        const char c = body[i];
+        if (inString) {
+            if (c == '\\') ++i;
+            else if (c == '"') inString = false;
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '[' || c == '{') {
+            ++depth;
+        } else if ((c == ']' || c == '}') && --depth == 0) {
+            return body.substr(pos, i - pos + 1);
+        }
+    }
+    return {};
+}
+
+} // namespace
+
+void VUser::onStepResult(const HttpResult& r) {
+    // simulate-journey answers 200 for the journey; a step the service failed
+    // shows up in its stepTimings entry
+    bool ok = r.transportOk && r.status > 0 && r.status < 400;
+    if (ok) {
+        try {
+            const json::Value timings = json::Value::parse(findStepTimings(r.body));
+            if (!timings.items().empty()) ok = timings.items().front().str("stepStatus") == "completed";
+        } catch (const json::ParseError&) {
+            // no stepTimings: the HTTP status is all there is
+        }
+    }
+
+    eng_.recordStep(*this, step_, ok, r.endNs - r.startNs, r.endNs - intendedNs_);
+    if (!ok) journeyOk_ = false;
+
+    phase_ = Phase::Think;
+    const uint32_t r1 = nextRandom();
+    const uint32_t r2 = nextRandom();
+    armTimer(eng_.thinkTime().sampleNs(step_, r1, r2));
+}
+
+void VUser::onJourneyResult(const HttpResult& r) {
+    const size_t steps = eng_.journey().steps.size();
+    size_t reported = 0;
+    // The chain runs its steps back to back, so each one is as late as the
+    // request left after its intended start: latency is that lateness plus
+    // the step's own server time, as a per-step request would have seen it
+    const uint64_t lateNs = r.startNs > intendedNs_ ? r.startNs - intendedNs_ : 0;
+
+    if (r.transportOk && r.status > 0 && r.status < 400) {
+        try {
+            const json::Value timings = json::Value::parse(findStepTimings(r.body));
+            for (const json::Value& t : timings.items()) {
+                if (reported == steps) break;
+                const bool ok = t.str("stepStatus") == "completed";
+                step_ = reported++;
+                const auto serverNs = static_cast<uint64_t>(t.num("durationMs") * 1e6);
+                eng_.recordStep(*this, step_, ok, serverNs, lateNs + serverNs);
+                if (!ok) journeyOk_ = false;
+            }
+        } catch (const json::ParseError&) {
+            // fall through: every step is booked as failed below
+        }
+    }
+    // Steps the response did not account for, like report_chained_step()
+    for (step_ = reported; step_ < steps; ++step_) {
+        eng_.recordStep(*this, step_, false, 0, 0);
+        journeyOk_ = false;
+    }
+    intendedNs_ = r.endNs;
+    sendCompletion();
+}
+
+void VUser::onCompletionResult(const HttpResult& r) {
+    const bool ok = r.transportOk && r.status > 0 && r.status < 400;
+    eng_.recordJourney(*this, ok, ok && journeyOk_, r.endNs - r.startNs, r.endNs - intendedNs_,
+                       r.endNs - journeyBeganNs_, r.endNs - journeyStartNs_);
+
+    if (eng_.scenario().openModel) {
+        phase_ = Phase::Waiting;
+        eng_.vuAvailable(*this);
+        return;
+    }
+    if (stopRequested_) {
+        finish();
+        return;
+    }
+    const int maxIterations = eng_.scenario().iterations;
+    if (maxIterations > 0 && iteration_ >= maxIterations) {
+        finish();
+        return;
+    }
+    phase_ = Phase::Pacing;
+    armTimer(eng_.pacingNs());
+}
+
+void VUser::onTimer(uint64_t token) {
+    if (token != timerGen_) return;
+    switch (phase_) {
+    case Phase::Think:
+        intendedNs_ = timerDeadlineNs_;
+        if (++step_ < eng_.journey().steps.size()) sendStep();
+        else sendCompletion();
+        break;
+    case Phase::Pacing:
+        beginIteration(timerDeadlineNs_);
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace bizobs::loadgen
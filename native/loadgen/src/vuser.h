@@ -0,0 +1,111 @@
+/*
+ * One virtual user: the Action() loop of bizobs-journey-template.c as a
+ * non-blocking state machine.
+ *
+ *   iteration -> [step request -> think]* -> completion event -> pacing
+ *
+ * Each step is its own transaction (TSN = step name), passed or failed on
+ * what the server answered. Steps the seeded ErrorSchedule picks for this
+ * iteration are named in x-error-schedule and the service fails them itself.
+ *
+ * Chained mode replaces the step loop with one request carrying every step;
+ * per-step transactions are then booked from journey.stepTimings:
+ *
+ *   iteration -> chained journey request -> completion event -> pacing
+ *
+ * Under the open arrival model there is no pacing: the engine hands the VU
+ * an arrival with startJourney() and the VU returns to the engine's idle
+ * pool when the completion event is done.
+ */
+#pragma once
+
+#include "arena.h"
+#include "body_template.h"
+#include "customers.h"
+#include "event_loop.h"
+#include "http_client.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace bizobs::loadgen {
+
+class Engine;
+
+class VUser final : public HttpListener, public TimerHandler {
+public:
+    VUser(Engine& engine, int id);
+
+    int id() const { return id_; }
+    int iteration() const { return iteration_; }
+    size_t arenaBytes() const { return arena_.capacity(); }
+    bool done() const { return phase_ == Phase::Done; }
+    bool active() const { return phase_ != Phase::Idle && phase_ != Phase::Waiting && phase_ != Phase::Done; }
+
+    void start();
+    // Open model: run one journey for an arrival scheduled at `scheduledNs`;
+    // journey time counts from the schedule, not from when a VU was free.
+    void startJourney(uint64_t scheduledNs);
+    // Finish the current iteration, then exit (LoadRunner "gradual exit").
+    void requestStop();
+
+    void onHttpResult(const HttpResult& r) override;
+    void onTimer(uint64_t token) override;
+
+private:
+    enum class Phase { Idle, Step, Think, Journey, Completion, Pacing, Waiting, Done };
+
+    Engine& eng_;
+    const int id_;
+    HttpClient http_;
+    Arena arena_; // this iteration's request bytes, reset before the next one
+    Phase phase_ = Phase::Idle;
+    bool stopRequested_ = false;
+    uint64_t timerGen_ = 0;
+    uint64_t timerDeadlineNs_ = 0;
+    uint64_t rng_;
+    uint32_t errorSeed_ = 0;      // ErrorSchedule::vuSeed(id)
+    std::string errorSchedule_;   // this iteration's x-error-schedule value, empty = none
+
+    int iteration_ = 0;
+    size_t step_ = 0;
+    bool journeyOk_ = true;
+    uint64_t journeyStartNs_ = 0; // scheduled start (open model) or pacing deadline
+    uint64_t journeyBeganNs_ = 0; // when the first request actually went out
+    uint64_t intendedNs_ = 0;     // when the in-flight request should have been sent
+
+    // This iteration's customer: a customers.dat row (per iteration) with
+    // --customers, else one of kCustomers (per VU)
+    std::string_view segment_;
+    std::string_view trafficSource_;
+    // correlation/customer/session/trace ids (per iteration) and the escaped
+    // customer profile, patched into the compiled bodies
+    SlotValues slots_;
+
+    // X-dynaTrace value: VU-constant prefix (start), CID (per iteration),
+    // TSN suffix (per step, from Engine::dtStepSuffix)
+    std::string dtHeader_;
+    size_t dtCidOffset_ = 0;
+    size_t dtTsnOffset_ = 0;
+
+    uint32_t nextRandom();
+    void armTimer(uint64_t delayNs);
+    void init();
+    void beginIteration(uint64_t scheduledNs);
+    void sendStep();
+    void sendJourney();
+    void sendCompletion();
+    void onStepResult(const HttpResult& r);
+    void onJourneyResult(const HttpResult& r);
+    void onCompletionResult(const HttpResult& r);
+    void finish();
+
+    void pickCustomer();
+    void planErrors();
+    void appendCommonHeaders(Arena& req, size_t tsnIndex, size_t bodyLen);
+    void appendErrorSchedule(Arena& req) const;
+    std::string& slot(Slot s) { return slots_[static_cast<size_t>(s)]; }
+};
+
+} // namespace bizobs::loadgen
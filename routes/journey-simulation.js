@@ -3,253 +3,148 @@ import http from 'http';
 import crypto, { randomBytes } from 'crypto';
 import fs from 'fs';
 import path from 'path';
-import { ensureServiceRunning, getServicePort, getServiceNameFromStep, stopServicesForCompany, stopAllServices } from '../services/service-manager.js';
+import { ensureServiceRunning as ensureServiceRunningHere, getServicePort as getServicePortHere, getServiceNameFromStep, stopServicesForCompany as stopServicesForCompanyHere } from '../services/service-manager.js';
 import loadRunnerManager from '../scripts/continuous-loadrunner.js';
 import { startAutoLoadWatcher } from '../services/auto-load.js';
+import { pooledRequest, servicePoolStats, SERVICE_MAX_SOCKETS, SERVICE_MAX_FREE_SOCKETS } from '../services/service-pool.js';
+import { acquireServiceSlot, concurrencyLimitStats, resetConcurrencyLimits, SERVICE_ADAPTIVE_LIMIT } from '../services/concurrency-limit.js';
+import { GenerationScheduler } from '../services/generation-scheduler.js';
+import { IS_CLUSTER_WORKER, ownerMethod, serveOwner, callOwner, broadcast, onBroadcast, gather, onGather } from '../services/cluster.js';
+import { groupAt, stepGroups } from '../services/step-groups.cjs';
+import { contextForwardingEnabled, contextRequest, markContextSent, isContextMissing, FORWARDING_HEADER, CONTEXT_HEADER } from '../services/journey-context.cjs';
 // Import transaction tracking for volume-based chaos triggering
-import { recordTransaction } from '../dist/agents/gremlin/autonomousScheduler.js';
+import { recordTransaction as recordTransactionHere } from '../dist/agents/gremlin/autonomousScheduler.js';
 
 const router = express.Router();
 
+// Routes a cluster worker serves itself; the rest of this router runs in the
+// owner process only (services/cluster.js)
+export const CLUSTER_WORKER_ROUTES = new Set([
+  '/simulate-journey',
+  '/simulate-multiple-journeys',
+  '/simulate-batch-chained',
+  '/simulate-single-step-journeys'
+]);
+
+// ============ OWNER STATE ============
+// Child services, LoadRunner tests and chaos counters belong to the owner; in
+// a cluster worker these are calls to it. A worker remembers a running
+// service's port for SERVICE_PORT_CACHE_MS so each step is not a round trip;
+// the owner tells the workers to forget them when it stops services.
+// Concurrency limiters and connection pools are per process: every worker
+// has its own, and the admin routes gather theirs.
+const SERVICE_PORT_CACHE_MS = parseInt(process.env.SERVICE_PORT_CACHE_MS || '0') || 1000;
+const servicePortCache = new Map(); // worker only: [stepName, context] -> { port, expires }
+
+serveOwner('ensureServiceRunning', ensureServiceRunningHere);
+const ensureServiceRunning = IS_CLUSTER_WORKER ? ensureServiceViaOwner : ensureServiceRunningHere;
+const getServicePort = ownerMethod('getServicePort', getServicePortHere);
+const recordTransaction = ownerMethod('recordTransaction', recordTransactionHere, { notify: true });
+const stopServicesForCompany = ownerMethod('stopServicesForCompany', async companyName => {
+  const stopped = await stopServicesForCompanyHere(companyName);
+  broadcast('service-ports', null);
+  return stopped;
+});
+if (IS_CLUSTER_WORKER) {
+  onBroadcast('service-ports', () => servicePortCache.clear());
+  onGather('service-calls', () => ({ concurrencyLimits: concurrencyLimitStats(), connectionPools: servicePoolStats() }));
+}
+
+async function ensureServiceViaOwner(stepName, companyContext = {}) {
+  const key = JSON.stringify([stepName, companyContext]);
+  const cached = servicePortCache.get(key);
+  if (cached && cached.expires > Date.now()) return cached.port;
+  const port = await callOwner('ensureServiceRunning', stepName, companyContext);
+  // Blocked starts come back as objects and are asked again next time
+  if (port && typeof port !== 'object') {
+    if (servicePortCache.size >= 1000) servicePortCache.clear();
+    servicePortCache.set(key, { port, expires: Date.now() + SERVICE_PORT_CACHE_MS });
+  }
+  return port;
+}
+// ============ END OWNER STATE ============
+
 // ============ CONTINUOUS JOURNEY GENERATION ============
-// Track active continuous journeys by company
-const activeContinuousJourneys = new Map();
+// Every company's generator runs on one shared timer wheel with a global
+// journeys/min budget (services/generation-scheduler.js); state is
+// checkpointed on an interval and on shutdown. The scheduler lives in the
+// owner only: a cluster worker neither restores nor writes generator state
+
+// Send step services the journey context once and take delta responses
+// (JOURNEY_CONTEXT_FORWARDING, services/journey-context.cjs)
+const JOURNEY_CONTEXT_FORWARDING = contextForwardingEnabled();
+
+// Most customers one /simulate-batch-chained request (or one scheduler grant) may carry in `batch`
+const JOURNEY_BATCH_MAX = parseInt(process.env.JOURNEY_BATCH_MAX || '0') || 100;
 const CONTINUOUS_GEN_STATE_FILE = path.join(process.cwd(), 'logs', 'continuous-generation-state.json');
+const continuousGenerator = IS_CLUSTER_WORKER ? null : new GenerationScheduler({
+  runBatch: runContinuousBatch,
+  stateFile: CONTINUOUS_GEN_STATE_FILE,
+  maxBatch: JOURNEY_BATCH_MAX
+});
 
-// Save continuous generation state to disk
-function saveContinuousGenState() {
-  try {
-    const state = {};
-    for (const [key, value] of activeContinuousJourneys.entries()) {
-      state[key] = value.config; // Save the config, not the timeout
-    }
-    fs.writeFileSync(CONTINUOUS_GEN_STATE_FILE, JSON.stringify(state, null, 2));
-  } catch (err) {
-    console.error('[continuous-gen] Failed to save state:', err.message);
-  }
+/** Save changed generator state now; awaited by the server's shutdown. */
+export function checkpointContinuousGeneration() {
+  return continuousGenerator ? continuousGenerator.checkpoint() : Promise.resolve();
 }
 
 // Load and restore continuous generation state on server start
 function restoreContinuousGenState() {
   try {
-    if (fs.existsSync(CONTINUOUS_GEN_STATE_FILE)) {
-      const state = JSON.parse(fs.readFileSync(CONTINUOUS_GEN_STATE_FILE, 'utf8'));
-      console.log(`[continuous-gen] 🔄 Restoring ${Object.keys(state).length} continuous generation(s)...`);
-      
-      for (const [companyName, config] of Object.entries(state)) {
-        console.log(`[continuous-gen] Restarting continuous generation for ${companyName}`);
-        startContinuousGeneration(config.journeyConfig, config.stepData, config.currentPayload, config.chained, config.thinkTimeMs);
-      }
+    const state = continuousGenerator.loadState();
+    if (Object.keys(state).length === 0) return;
+    console.log(`[continuous-gen] 🔄 Restoring ${Object.keys(state).length} continuous generation(s)...`);
+    for (const [companyName, config] of Object.entries(state)) {
+      console.log(`[continuous-gen] Restarting continuous generation for ${companyName}`);
+      startContinuousGeneration(config.journeyConfig, config.stepData, config.currentPayload, config.chained, config.thinkTimeMs, config.weight);
     }
   } catch (err) {
     console.error('[continuous-gen] Failed to restore state:', err.message);
   }
 }
 
-// Start continuous data generation for a journey (10-20 requests per minute)
-function startContinuousGeneration(journeyConfig, stepData, currentPayload, chained, thinkTimeMs) {
+// Start continuous data generation for a journey (10-20 requests per minute
+// per unit of weight, within the shared budget)
+function startContinuousGeneration(journeyConfig, stepData, currentPayload, chained, thinkTimeMs, weight = 1) {
   const { companyName } = currentPayload;
-  const journeyKey = `${companyName}`;
-  
-  // Stop existing continuous generation for this company
-  if (activeContinuousJourneys.has(journeyKey)) {
-    console.log(`[continuous-gen] Stopping existing generation for ${companyName}`);
-    const entry = activeContinuousJourneys.get(journeyKey);
-    clearTimeout(entry.timeoutId);
-  }
-  
-  // Generate requests every 3-6 seconds (10-20 per minute)
-  const minInterval = 3000; // 3 seconds = 20 per minute
-  const maxInterval = 6000; // 6 seconds = 10 per minute
-  
-  console.log(`[continuous-gen] 🔄 Starting continuous generation for ${companyName} (10-20 requests/min)`);
-  
-  const generateRequest = async () => {
-    try {
-      const customerId = `customer_${Math.floor(Math.random() * 10000)}`;
-      const correlationId = crypto.randomUUID();
-      const journeyId = `journey_${Date.now()}_${Math.random().toString(36).substr(2, 9)}`;
-      
-      const payload = {
-        ...currentPayload,
-        journeyId,
-        customerId,
-        correlationId,
-        startTime: new Date().toISOString()
-      };
-      
-      // Execute journey in background
-      if (chained) {
-        const first = stepData[0];
-        if (!first) return;
-        
-        const firstPort = await ensureServiceRunning(first.stepName, { 
-          ...currentPayload, 
-          stepName: first.stepName, 
-          serviceName: first.serviceName 
-        });
-        
-        const chainedPayload = {
-          journeyId: payload.journeyId,
-          customerId: payload.customerId,
-          correlationId: payload.correlationId,
-          startTime: payload.startTime,
-          companyName: payload.companyName,
-          domain: payload.domain,
-          industryType: payload.industryType,
-          stepName: first.stepName,
-          serviceName: first.serviceName,
-          description: first.description,
-          category: first.category,
-          nextServices: stepData.slice(1).map(s => ({
-            stepName: s.stepName,
-            serviceName: s.serviceName,
-            description: s.description,
-            category: s.category,
-            hasError: s.hasError,
-            errorMessage: s.errorMessage
-          })),
-          additionalFields: payload.additionalFields,
-          customerProfile: payload.customerProfile,
-          traceMetadata: payload.traceMetadata
-        };
-        
-        await makeServiceRequest(firstPort, first.serviceName, chainedPayload);
-      } else {
-        // Parallel execution
-        for (const stepInfo of stepData) {
-          const port = await ensureServiceRunning(stepInfo.stepName, { 
-            ...currentPayload, 
-            stepName: stepInfo.stepName, 
-            serviceName: stepInfo.serviceName 
-          });
-          
-          const stepPayload = {
-            ...payload,
-            stepName: stepInfo.stepName,
-            serviceName: stepInfo.serviceName,
-            description: stepInfo.description,
-            category: stepInfo.category
-          };
-          
-          await makeServiceRequest(port, stepInfo.serviceName, stepPayload);
-          await new Promise(r => setTimeout(r, thinkTimeMs || 250));
-        }
-      }
-      
-      console.log(`[continuous-gen] ✅ Generated journey ${journeyId} for ${companyName}`);
-    } catch (error) {
-      console.error(`[continuous-gen] ❌ Error generating journey for ${companyName}:`, error.message);
-      console.error(`[continuous-gen] ❌ Stack:`, error.stack);
-    }
-  };
-  
-  // Schedule next request with random interval
-  const scheduleNext = () => {
-    const interval = Math.floor(Math.random() * (maxInterval - minInterval + 1)) + minInterval;
-    const timeoutId = setTimeout(async () => {
-      await generateRequest();
-      scheduleNext();
-    }, interval);
-    
-    // Store both timeout and config for persistence
-    activeContinuousJourneys.set(journeyKey, {
-      timeoutId,
-      config: {
-        journeyConfig,
-        stepData,
-        currentPayload,
-        chained,
-        thinkTimeMs
-      }
-    });
-    
-    // Save state to disk
-    saveContinuousGenState();
-  };
-  
-  // Start first request immediately
-  generateRequest().then(() => scheduleNext());
-  
-  return journeyKey;
+  console.log(`[continuous-gen] 🔄 Starting continuous generation for ${companyName} (${10 * weight}-${20 * weight} requests/min)`);
+  return continuousGenerator.add(`${companyName}`, { journeyConfig, stepData, currentPayload, chained, thinkTimeMs }, { weight });
 }
 
 // Stop continuous generation for a company
 function stopContinuousGeneration(companyName) {
-  const journeyKey = `${companyName}`;
-  if (activeContinuousJourneys.has(journeyKey)) {
-    const entry = activeContinuousJourneys.get(journeyKey);
-    clearTimeout(entry.timeoutId);
-    activeContinuousJourneys.delete(journeyKey);
-    saveContinuousGenState(); // Update persistent state
-    console.log(`[continuous-gen] 🛑 Stopped continuous generation for ${companyName}`);
-    return true;
-  }
-  return false;
+  if (!continuousGenerator.remove(`${companyName}`)) return false;
+  console.log(`[continuous-gen] 🛑 Stopped continuous generation for ${companyName}`);
+  return true;
 }
 
-// Helper to make service requests
-async function makeServiceRequest(port, serviceName, payload) {
-  return new Promise((resolve, reject) => {
-    const options = {
-      hostname: 'localhost',
-      port: port,
-      path: '/',
-      method: 'POST',
-      headers: {
-        'Content-Type': 'application/json'
-      },
-      timeout: 5000
-    };
-    
-    const req = http.request(options, (res) => {
-      let data = '';
-      res.on('data', (chunk) => { data += chunk; });
-      res.on('end', () => {
-        if (res.statusCode >= 400) {
-          console.error(`[continuous-gen] ❌ Service ${serviceName} on port ${port} returned ${res.statusCode}`);
-          reject(new Error(`HTTP ${res.statusCode}: ${data}`));
-          return;
-        }
-        try {
-          resolve(JSON.parse(data));
-        } catch (e) {
-          resolve({ status: 'ok', rawData: data });
-        }
-      });
-    });
-    
-    req.on('error', (err) => {
-      console.error(`[continuous-gen] ❌ Request to ${serviceName} on port ${port} failed:`, err.message);
-      reject(err);
-    });
-    
-    req.on('timeout', () => {
-      console.error(`[continuous-gen] ⏱️ Timeout calling ${serviceName} on port ${port}`);
-      req.destroy();
-      reject(new Error('Request timeout'));
+// One scheduler grant: `count` journeys for a company as one batched call,
+// the same fan-out /simulate-batch-chained does, without the HTTP hop
+function runContinuousBatch({ journeyConfig, stepData, currentPayload, chained, thinkTimeMs }, count) {
+  const batch = Array.from({ length: count }, () => ({
+    journeyId: `journey_${Date.now()}_${Math.random().toString(36).substr(2, 9)}`,
+    customerId: `customer_${Math.floor(Math.random() * 10000)}`,
+    correlationId: crypto.randomUUID(),
+    startTime: new Date().toISOString()
+  }));
+  const body = {
+    ...currentPayload,
+    journey: { ...journeyConfig, ...currentPayload, steps: journeyConfig?.steps || stepData },
+    chained,
+    thinkTimeMs,
+    loadRunnerTriggered: true, // never starts a LoadRunner test of its own
+    batch
+  };
+  return runInProcess(simulateJourneyBatch, body, { 'x-continuous-generation': 'true' }, batch[0].correlationId)
+    .then(({ body: result }) => {
+      if (result?.summary) console.log(`[continuous-gen] ✅ Generated ${result.summary.completed}/${count} journeys for ${currentPayload.companyName}`);
+      return result;
     });
-    
-    try {
-      req.write(JSON.stringify(payload));
-      req.end();
-    } catch (err) {
-      console.error(`[continuous-gen] ❌ Error writing payload to ${serviceName}:`, err.message);
-      reject(err);
-    }
-  });
 }
 
 // Get status of continuous generation
 function getContinuousGenerationStatus() {
-  const status = {};
-  for (const [key, timeoutId] of activeContinuousJourneys.entries()) {
-    status[key] = {
-      active: true,
-      ratePerMinute: '10-20 requests'
-    };
-  }
-  return status;
+  return continuousGenerator.status();
 }
 // ============ END CONTINUOUS GENERATION ============
 
@@ -319,7 +214,8 @@ function extractTracingHeaders(req) {
         lowerKey.startsWith('x-correlation-id') || 
         lowerKey.startsWith('x-span-id') || 
         lowerKey.startsWith('dt-') ||
-        lowerKey.startsWith('uber-trace-id')) {
+        lowerKey.startsWith('uber-trace-id') ||
+        lowerKey === 'x-error-schedule') {   // load test error schedule, rides along with the trace
       tracingHeaders[key] = req.headers[key];
     }
   }
@@ -632,8 +528,26 @@ function generateDynamicServiceName(stepName, description = '', category = '', o
   return dynamicServiceName;
 }
 
-// Circuit breaker state per service
+// Circuit breaker state per service. The owner's map is the one results are
+// counted in; a cluster worker's is a mirror the owner pushes changes to.
 const circuitBreakerState = new Map();
+serveOwner('circuitBreakers', () => Object.fromEntries(circuitBreakerState));
+if (IS_CLUSTER_WORKER) {
+  onBroadcast('circuit-breaker', ({ serviceName, breaker }) => {
+    if (serviceName === null) {
+      circuitBreakerState.clear();
+      resetConcurrencyLimits();
+    } else if (!breaker) {
+      circuitBreakerState.delete(serviceName);
+      resetConcurrencyLimits(serviceName);
+    } else {
+      circuitBreakerState.set(serviceName, breaker);
+    }
+  });
+  callOwner('circuitBreakers').then(breakers => {
+    for (const [serviceName, breaker] of Object.entries(breakers)) circuitBreakerState.set(serviceName, breaker);
+  }, err => console.warn('[journey-sim] Could not load circuit breakers from the owner:', err.message));
+}
 
 // Initialize circuit breaker for a service
 function initCircuitBreaker(serviceName) {
@@ -670,7 +584,16 @@ function canMakeRequest(serviceName) {
 
 // Record success/failure for circuit breaker
 function recordResult(serviceName, success) {
+  if (IS_CLUSTER_WORKER) {
+    // A success only changes a breaker that has seen failures
+    const mirror = circuitBreakerState.get(serviceName);
+    if (!success || (mirror && (mirror.failureCount > 0 || mirror.state !== 'CLOSED'))) {
+      recordResultInOwner(serviceName, success);
+    }
+    return;
+  }
   const breaker = initCircuitBreaker(serviceName);
+  const previous = { state: breaker.state, failing: breaker.failureCount > 0 };
   
   if (success) {
     breaker.failureCount = 0;
@@ -684,10 +607,56 @@ function recordResult(serviceName, success) {
       console.log(`[journey-sim] Circuit breaker OPENED for ${serviceName} after ${breaker.failureCount} failures`);
     }
   }
+  // Workers hear of every change that decides what they send or allow
+  if (breaker.state !== previous.state || (breaker.failureCount > 0) !== previous.failing || breaker.state !== 'CLOSED') {
+    broadcast('circuit-breaker', { serviceName, breaker });
+  }
+}
+const recordResultInOwner = ownerMethod('circuitResult', recordResult, { notify: true });
+
+// One timing entry per planned step, in journey order. In chained mode each
+// service nests its downstream response under `.next` and a parallel group's
+// responses under `.parallel`, so the chain is walked from the results this
+// server called; steps the chain never reached come back as not_reached.
+function buildStepTimings(stepData, journeyResults, chained) {
+  const nodes = [];
+  if (chained) {
+    const pending = [...journeyResults];
+    while (pending.length > 0 && nodes.length < stepData.length) {
+      const node = pending.shift();
+      if (!node || typeof node !== 'object') continue;
+      nodes.push(node);
+      if (Array.isArray(node.parallel)) pending.push(...node.parallel);
+      if (node.next) pending.push(node.next);
+    }
+  } else {
+    nodes.push(...journeyResults);
+  }
+  const byStep = new Map();
+  for (const node of nodes) {
+    if (node.stepName && !byStep.has(node.stepName)) byStep.set(node.stepName, node);
+  }
+
+  return stepData.map(({ stepName, serviceName }) => {
+    const node = byStep.get(stepName);
+    if (!node) {
+      return { stepName, serviceName, stepStatus: 'not_reached', httpStatus: 0, durationMs: 0 };
+    }
+    const failed = node.status === 'failed' || node.status === 'error' || Number(node.httpStatus) >= 400;
+    return {
+      stepName,
+      serviceName: node.service || node.serviceName || serviceName,
+      stepStatus: failed ? 'failed' : 'completed',
+      httpStatus: Number(node.httpStatus) || (failed ? 500 : 200),
+      durationMs: Math.round(Number(node.stepDurationMs ?? node.processingTime ?? 0))
+    };
+  });
 }
 
 // Call a service with improved error handling and retry logic
-async function callDynamicService(stepName, port, payload, incomingHeaders = {}) {
+// `options.outcomeOnly`: the caller books only status and error, so a
+// successful response is drained unread instead of buffered and parsed
+async function callDynamicService(stepName, port, payload, incomingHeaders = {}, options = {}) {
   // Check circuit breaker first
   if (!canMakeRequest(stepName)) {
     const breaker = circuitBreakerState.get(stepName);
@@ -705,6 +674,44 @@ async function callDynamicService(stepName, port, payload, incomingHeaders = {})
     };
   }
 
+  // Then the service's adaptive concurrency limit: wait briefly or shed
+  const slot = await acquireServiceSlot(stepName);
+  if (!slot) {
+    const limit = concurrencyLimitStats(stepName);
+    console.log(`[journey-sim] Concurrency limit reached for ${stepName} (${limit?.inFlight}/${limit?.limit} in flight, ${limit?.queueDepth} queued), shedding request`);
+
+    return {
+      status: 'failed',
+      httpStatus: 503,
+      error: `Service ${stepName} is over its concurrency limit`,
+      errorType: 'concurrency_limited',
+      serviceName: stepName,
+      timestamp: new Date().toISOString(),
+      concurrencyLimit: limit,
+      fallback: true
+    };
+  }
+
+  let result;
+  try {
+    result = await callServiceOnce(stepName, port, payload, incomingHeaders, options);
+  } finally {
+    // Timeouts and dropped connections cut the limit; any response is an RTT
+    // sample, less the time a chained service spent on the steps after it
+    const dropped = result?.errorType === 'timeout_error' || result?.errorType === 'connection_error';
+    slot.release(dropped || !result ? 'dropped' : 'ok', result?._downstreamMs || 0);
+  }
+  return result;
+}
+
+// Server-Timing downstream;dur= of a step service response: think time and
+// the chained steps after it
+function downstreamMs(res) {
+  const match = /(?:^|,)\s*downstream;dur=([\d.]+)/.exec(res.headers['server-timing'] || '');
+  return match ? Number(match[1]) : 0;
+}
+
+function callServiceOnce(stepName, port, payload, incomingHeaders, { outcomeOnly = false } = {}) {
   return new Promise((resolve, reject) => {
     // Build outgoing headers by preserving tracing headers when present
     const headers = {
@@ -750,6 +757,8 @@ async function callDynamicService(stepName, port, payload, incomingHeaders = {})
     if (incomingHeaders['x-dynatrace-trace-id']) headers['x-dynatrace-trace-id'] = incomingHeaders['x-dynatrace-trace-id'];
     if (incomingHeaders['x-dynatrace-parent-span-id']) headers['x-dynatrace-parent-span-id'] = incomingHeaders['x-dynatrace-parent-span-id'];
     if (incomingHeaders['uber-trace-id']) headers['uber-trace-id'] = incomingHeaders['uber-trace-id'];
+    if (incomingHeaders['x-error-schedule']) headers['x-error-schedule'] = incomingHeaders['x-error-schedule'];
+    if (JOURNEY_CONTEXT_FORWARDING) headers[FORWARDING_HEADER] = 'delta';
 
     // Ensure a traceparent exists so OneAgent and downstream services will join the trace
     if (!headers['traceparent']) {
@@ -785,26 +794,29 @@ async function callDynamicService(stepName, port, payload, incomingHeaders = {})
       timeout: 15000  // Increased timeout to 15 seconds
     };
     
-    const req = http.request(options, (res) => {
-      let body = '';
-      res.on('data', chunk => body += chunk);
-      res.on('end', () => {
-        try {
-          // Check if response is HTML (error page) instead of JSON
-          if (body.trim().startsWith('<html') || body.trim().startsWith('<!DOCTYPE')) {
-            console.error(`[journey-sim] ${stepName} returned HTML error page (status ${res.statusCode}):`, body.substring(0, 200));
-            
-            // Record circuit breaker failure for HTML errors
-            recordResult(stepName, false);
-            
-            // Create a fallback JSON response for HTML error pages
-            const fallbackResponse = {
-              status: 'failed',
+    // Delta mode sends a service only the step's delta once it has the journey context
+    const send = (forceFull) => {
+      const contextReq = JOURNEY_CONTEXT_FORWARDING ? contextRequest(port, headers['x-correlation-id'], payload, forceFull) : null;
+      const req = pooledRequest({
+        ...options,
+        headers: contextReq?.ref ? { ...headers, [CONTEXT_HEADER]: 'ref' } : headers
+      }, (res) => {
+        // The service lost this journey's context: send it again in full
+        if (contextReq?.ref && isContextMissing(res)) {
+          res.resume();
+          return send(true);
+        }
+        if (contextReq) markContextSent(contextReq);
+
+        if (outcomeOnly && res.statusCode < 400) {
+          res.resume();
+          res.on('end', () => {
+            recordResult(stepName, true);
+            const outcome = {
+              status: 'completed',
               httpStatus: res.statusCode,
-              error: `Service returned HTML error page (status ${res.statusCode})`,
-              errorType: 'html_error_response',
               serviceName: stepName,
-              timestamp: new Date().toISOString(),
+              _downstreamMs: downstreamMs(res),
               _traceInfo: {
                 requestTraceparent: headers['traceparent'],
                 requestTracestate: headers['tracestate'],
@@ -812,117 +824,187 @@ async function callDynamicService(stepName, port, payload, incomingHeaders = {})
                 requestCorrelationId: headers['x-correlation-id']
               }
             };
-            resolve(fallbackResponse);
-            return;
-          }
+            if (typeof global.recordTraceValidation === 'function') {
+              global.recordTraceValidation(stepName, headers, outcome);
+            }
+            resolve(outcome);
+          });
+          return;
+        }
 
-          // Try to parse as JSON
-          const parsed = body ? JSON.parse(body) : {};
-          // Attach HTTP status for downstream logic
-          parsed.httpStatus = res.statusCode;
-          // Include trace validation info
-          parsed._traceInfo = {
-            requestTraceparent: headers['traceparent'],
-            requestTracestate: headers['tracestate'],
-            responseTraceparent: res.headers['traceparent'],
-            requestCorrelationId: headers['x-correlation-id']
-          };
+        let body = '';
+        res.on('data', chunk => body += chunk);
+        res.on('end', () => {
+          try {
+            // Check if response is HTML (error page) instead of JSON
+            if (body.trim().startsWith('<html') || body.trim().startsWith('<!DOCTYPE')) {
+              console.error(`[journey-sim] ${stepName} returned HTML error page (status ${res.statusCode}):`, body.substring(0, 200));
+            
+              // Record circuit breaker failure for HTML errors
+              recordResult(stepName, false);
+            
+              // Create a fallback JSON response for HTML error pages
+              const fallbackResponse = {
+                status: 'failed',
+                httpStatus: res.statusCode,
+                error: `Service returned HTML error page (status ${res.statusCode})`,
+                errorType: 'html_error_response',
+                serviceName: stepName,
+                timestamp: new Date().toISOString(),
+                _traceInfo: {
+                  requestTraceparent: headers['traceparent'],
+                  requestTracestate: headers['tracestate'],
+                  responseTraceparent: res.headers['traceparent'],
+                  requestCorrelationId: headers['x-correlation-id']
+                }
+              };
+              resolve(fallbackResponse);
+              return;
+            }
+
+            // Try to parse as JSON
+            const parsed = body ? JSON.parse(body) : {};
+            // Attach HTTP status for downstream logic
+            parsed.httpStatus = res.statusCode;
+            parsed._downstreamMs = downstreamMs(res);
+            // Include trace validation info
+            parsed._traceInfo = {
+              requestTraceparent: headers['traceparent'],
+              requestTracestate: headers['tracestate'],
+              responseTraceparent: res.headers['traceparent'],
+              requestCorrelationId: headers['x-correlation-id']
+            };
           
-          // Record circuit breaker result
-          const isSuccess = res.statusCode >= 200 && res.statusCode < 400;
-          recordResult(stepName, isSuccess);
+            // Record circuit breaker result
+            const isSuccess = res.statusCode >= 200 && res.statusCode < 400;
+            recordResult(stepName, isSuccess);
           
-          console.log(`[journey-sim] ${stepName} responded with status ${res.statusCode}, trace: ${headers['traceparent']?.substring(0, 20)}...`);
+            console.log(`[journey-sim] ${stepName} responded with status ${res.statusCode}, trace: ${headers['traceparent']?.substring(0, 20)}...`);
           
-          // Record trace validation data for debugging
-          if (typeof global.recordTraceValidation === 'function') {
-            global.recordTraceValidation(stepName, headers, parsed);
-          }
+            // Record trace validation data for debugging
+            if (typeof global.recordTraceValidation === 'function') {
+              global.recordTraceValidation(stepName, headers, parsed);
+            }
           
-          resolve(parsed);
-        } catch (e) {
-          console.error(`[journey-sim] JSON parse error from ${stepName}:`, e.message, 'Body preview:', body.substring(0, 200));
+            resolve(parsed);
+          } catch (e) {
+            console.error(`[journey-sim] JSON parse error from ${stepName}:`, e.message, 'Body preview:', body.substring(0, 200));
           
-          // Record circuit breaker failure
-          recordResult(stepName, false);
+            // Record circuit breaker failure
+            recordResult(stepName, false);
           
-          // Create a structured error response instead of rejecting
-          const errorResponse = {
-            status: 'failed',
-            httpStatus: res.statusCode || 500,
-            error: `Invalid JSON response from ${stepName}: ${e.message}`,
-            errorType: 'json_parse_error',
-            serviceName: stepName,
-            timestamp: new Date().toISOString(),
-            responsePreview: body.substring(0, 200),
-            _traceInfo: {
-              requestTraceparent: headers['traceparent'],
-              requestTracestate: headers['tracestate'],
-              responseTraceparent: res.headers['traceparent'],
-              requestCorrelationId: headers['x-correlation-id']
-            }
-          };
-          resolve(errorResponse);
-        }
+            // Create a structured error response instead of rejecting
+            const errorResponse = {
+              status: 'failed',
+              httpStatus: res.statusCode || 500,
+              error: `Invalid JSON response from ${stepName}: ${e.message}`,
+              errorType: 'json_parse_error',
+              serviceName: stepName,
+              timestamp: new Date().toISOString(),
+              responsePreview: body.substring(0, 200),
+              _traceInfo: {
+                requestTraceparent: headers['traceparent'],
+                requestTracestate: headers['tracestate'],
+                responseTraceparent: res.headers['traceparent'],
+                requestCorrelationId: headers['x-correlation-id']
+              }
+            };
+            resolve(errorResponse);
+          }
+        });
       });
-    });
     
-    req.on('error', (err) => {
-      console.error(`[journey-sim] Request error to ${stepName} on port ${port}:`, err.message);
+      req.on('error', (err) => {
+        console.error(`[journey-sim] Request error to ${stepName} on port ${port}:`, err.message);
       
-      // Record circuit breaker failure
-      recordResult(stepName, false);
+        // Record circuit breaker failure
+        recordResult(stepName, false);
       
-      // Create a structured error response instead of rejecting
-      const errorResponse = {
-        status: 'failed',
-        httpStatus: 503,
-        error: `Connection error to ${stepName}: ${err.message}`,
-        errorType: 'connection_error',
-        serviceName: stepName,
-        timestamp: new Date().toISOString(),
-        _traceInfo: {
-          requestTraceparent: headers['traceparent'],
-          requestTracestate: headers['tracestate'],
-          requestCorrelationId: headers['x-correlation-id']
-        }
-      };
-      resolve(errorResponse);
-    });
+        // Create a structured error response instead of rejecting
+        const errorResponse = {
+          status: 'failed',
+          httpStatus: 503,
+          error: `Connection error to ${stepName}: ${err.message}`,
+          errorType: 'connection_error',
+          serviceName: stepName,
+          timestamp: new Date().toISOString(),
+          _traceInfo: {
+            requestTraceparent: headers['traceparent'],
+            requestTracestate: headers['tracestate'],
+            requestCorrelationId: headers['x-correlation-id']
+          }
+        };
+        resolve(errorResponse);
+      });
     
-    req.on('timeout', () => {
-      console.error(`[journey-sim] Request timeout to ${stepName} on port ${port}`);
-      req.destroy();
+      req.on('timeout', () => {
+        console.error(`[journey-sim] Request timeout to ${stepName} on port ${port}`);
+        req.destroy();
       
-      // Record circuit breaker failure
-      recordResult(stepName, false);
+        // Record circuit breaker failure
+        recordResult(stepName, false);
       
-      // Create a structured error response instead of rejecting
-      const errorResponse = {
-        status: 'failed',
-        httpStatus: 408,
-        error: `Timeout calling ${stepName} on port ${port}`,
-        errorType: 'timeout_error',
-        serviceName: stepName,
-        timestamp: new Date().toISOString(),
-        _traceInfo: {
-          requestTraceparent: headers['traceparent'],
-          requestTracestate: headers['tracestate'],
-          requestCorrelationId: headers['x-correlation-id']
-        }
-      };
-      resolve(errorResponse);
-    });
+        // Create a structured error response instead of rejecting
+        const errorResponse = {
+          status: 'failed',
+          httpStatus: 408,
+          error: `Timeout calling ${stepName} on port ${port}`,
+          errorType: 'timeout_error',
+          serviceName: stepName,
+          timestamp: new Date().toISOString(),
+          _traceInfo: {
+            requestTraceparent: headers['traceparent'],
+            requestTracestate: headers['tracestate'],
+            requestCorrelationId: headers['x-correlation-id']
+          }
+        };
+        resolve(errorResponse);
+      });
     
-    const payloadString = JSON.stringify(payload);
-    console.log(`[journey-sim] Sending to ${stepName}:`, payloadString);
-    req.write(payloadString);
-    req.end();
+      const payloadString = JSON.stringify(contextReq ? contextReq.body : payload);
+      console.log(`[journey-sim] Sending to ${stepName}:`, payloadString);
+      req.write(payloadString);
+      req.end();
+    };
+    send(false);
   });
 }
 
+// Continuous LoadRunner test for a company's first journey: null when one is
+// already running, the continuousGeneration status when it was started
+const autoStartLoadTest = ownerMethod('autoStartLoadTest', async (companyName, journeyConfig) => {
+  // Skip if a LoadRunner test is already running for this company
+  const existingTest = loadRunnerManager.activeTests[companyName];
+  if (existingTest && existingTest.pid) {
+    console.log(`[journey-sim] ℹ️  Skipping LoadRunner auto-start (already running)`);
+    return null;
+  }
+  
+  // Clear stop flags from previous "stop everything" so new journeys can generate load
+  global.stoppingEverything = false;
+  loadRunnerManager._clearStopFlag(loadRunnerManager._stopAllFlagPath());
+  
+  // Restart auto-load watcher if it was stopped by a previous stop-all
+  startAutoLoadWatcher();
+  
+  try {
+    await loadRunnerManager.startLoadTest(journeyConfig, 'light-load');
+    console.log(`[journey-sim] 🎯 LoadRunner continuous test started for ${companyName}`);
+    return {
+      active: true,
+      company: companyName,
+      method: 'LoadRunner',
+      scenario: 'light-load',
+      ratePerMinute: '10-20 requests'
+    };
+  } catch (err) {
+    console.error(`[journey-sim] ⚠️  Failed to start LoadRunner test:`, err.message);
+    return { active: false, reason: 'called_from_loadrunner' };
+  }
+});
+
 // Simulate journey
-router.post('/simulate-journey', async (req, res) => {
+async function simulateJourney(req, res) {
   console.log('[journey-sim] Route handler called');
   
   // Auto-start continuous journey generator on first journey simulation
@@ -1008,6 +1090,8 @@ router.post('/simulate-journey', async (req, res) => {
             timestamp: step.timestamp,
             duration: step.duration,
             substeps: step.substeps,
+            // Consecutive steps sharing one run concurrently (services/step-groups.cjs)
+            parallelGroup: step.parallelGroup,
             originalStep: step // Keep original for reference
           };
           console.log('[journey-sim] Extracted step data:', JSON.stringify(extractedStep, null, 2));
@@ -1192,109 +1276,125 @@ router.post('/simulate-journey', async (req, res) => {
     const journeyResults = [];
     
     if (chained) {
-      const first = stepData[0];
-      if (!first) {
+      if (!stepData[0]) {
         throw new Error('No steps available for chained execution');
       }
       
-      // Ensure first service is up with correct company context
-      const firstPort = await ensureServiceRunning(first.stepName, { ...companyContext, stepName: first.stepName, serviceName: first.serviceName }); // Handle both old and new format
-      const actualServiceName = first.serviceName || getServiceNameFromStep(first.stepName);
-      
-      // Guard against port exhaustion — if no port was allocated, fail gracefully
-      if (!firstPort) {
-        throw new Error(`Service ${actualServiceName} could not start: no available ports (port exhaustion). Try stopping unused services first.`);
-      }
-      
-      console.log(`[journey-sim] [chained] Calling first service ${actualServiceName} on port ${firstPort}`);
-      
-      // Create step-specific payload for chained execution - ONLY include current step data
-      const firstStepInfo = errorPlannedSteps[0];
-      const chainedPayload = {
-        // Journey metadata
-        journeyId: currentPayload.journeyId,
-        customerId: currentPayload.customerId,
-        correlationId: currentPayload.correlationId,
-        startTime: currentPayload.startTime,
-        companyName: currentPayload.companyName,
-        domain: currentPayload.domain,
-        industryType: currentPayload.industryType,
-        journeyType: currentPayload.journeyType,
-        
-        // Current step specific data ONLY
-        stepName: first.stepName,
-        stepIndex: 1,
-        totalSteps: stepData.length,
-        stepDescription: firstStepInfo.description || '',
-        stepCategory: firstStepInfo.category || '',
-        
-        // Add Copilot duration fields for OneAgent capture
-        estimatedDuration: firstStepInfo.estimatedDuration,
-        businessRationale: firstStepInfo.businessRationale,
-        substeps: firstStepInfo.substeps,
-        estimatedDurationMs: firstStepInfo.estimatedDuration ? firstStepInfo.estimatedDuration * 60 * 1000 : null,
+      // Call the service for step `index` with the rest of the journey to chain;
+      // `extraFields` go into its payload
+      const callChainedStep = async (index, extraFields = {}) => {
+        const step = stepData[index];
+        // Ensure the service is up with correct company context
+        const port = await ensureServiceRunning(step.stepName, { ...companyContext, stepName: step.stepName, serviceName: step.serviceName }); // Handle both old and new format
+        const actualServiceName = step.serviceName || getServiceNameFromStep(step.stepName);
         
-        // CRITICAL: Full steps array for service-to-service chaining
-        steps: stepData,
+        // Guard against port exhaustion — if no port was allocated, fail gracefully
+        if (!port) {
+          throw new Error(`Service ${actualServiceName} could not start: no available ports (port exhaustion). Try stopping unused services first.`);
+        }
         
-        // Chain configuration
-        thinkTimeMs,
-        isChained: true,
-        nextStepName: stepData.length > 1 ? stepData[1].stepName : null,
-        nextStepService: stepData.length > 1 ? stepData[1].serviceName : null,
+        console.log(`[journey-sim] [chained] Calling service ${actualServiceName} on port ${port}`);
         
-        // Current step's substeps
-        subSteps: firstStepInfo.originalStep?.subSteps || firstStepInfo.substeps || [],
+        // Create step-specific payload for chained execution - ONLY include current step data
+        const stepInfo = errorPlannedSteps[index];
+        const chainedPayload = {
+          // Journey metadata
+          journeyId: currentPayload.journeyId,
+          customerId: currentPayload.customerId,
+          correlationId: currentPayload.correlationId,
+          startTime: currentPayload.startTime,
+          companyName: currentPayload.companyName,
+          domain: currentPayload.domain,
+          industryType: currentPayload.industryType,
+          journeyType: currentPayload.journeyType,
+          
+          // Current step specific data ONLY
+          stepName: step.stepName,
+          stepIndex: index + 1,
+          totalSteps: stepData.length,
+          stepDescription: stepInfo.description || '',
+          stepCategory: stepInfo.category || '',
+          
+          // Add Copilot duration fields for OneAgent capture
+          estimatedDuration: stepInfo.estimatedDuration,
+          businessRationale: stepInfo.businessRationale,
+          substeps: stepInfo.substeps,
+          estimatedDurationMs: stepInfo.estimatedDuration ? stepInfo.estimatedDuration * 60 * 1000 : null,
+          
+          // CRITICAL: Full steps array for service-to-service chaining
+          steps: stepData,
+          
+          // Chain configuration
+          thinkTimeMs,
+          isChained: true,
+          nextStepName: stepData.length > index + 1 ? stepData[index + 1].stepName : null,
+          nextStepService: stepData.length > index + 1 ? stepData[index + 1].serviceName : null,
+          
+          // Current step's substeps
+          subSteps: stepInfo.originalStep?.subSteps || stepInfo.substeps || [],
+          
+          // Error configuration for this step
+          hasError: stepInfo.hasError,
+          errorType: stepInfo.errorType,
+          errorMessage: stepInfo.errorMessage,
+          httpStatus: stepInfo.httpStatus,
+          retryable: stepInfo.retryable,
+          severity: stepInfo.severity,
+          
+          // Include full customer/business context in each trace
+          // 🔑 Merge hasError + error details INTO additionalFields so OneAgent bizevent capture includes them
+          additionalFields: {
+            ...(currentPayload.additionalFields || {}),
+            hasError: stepInfo.hasError === true,
+            ...(stepInfo.hasError === true ? {
+              errorType: stepInfo.errorType || 'unknown',
+              errorMessage: stepInfo.errorMessage || '',
+              httpStatus: stepInfo.httpStatus || 500,
+              errorSeverity: stepInfo.severity || (stepInfo.httpStatus >= 500 ? 'critical' : 'warning')
+            } : {})
+          },
+          customerProfile: currentPayload.customerProfile || {},
+          traceMetadata: currentPayload.traceMetadata || {},
+          sources: currentPayload.sources || [],
+          provider: currentPayload.provider || 'unknown',
+          ...extraFields
+        };
         
-        // Error configuration for first step
-        hasError: firstStepInfo.hasError,
-        errorType: firstStepInfo.errorType,
-        errorMessage: firstStepInfo.errorMessage,
-        httpStatus: firstStepInfo.httpStatus,
-        retryable: firstStepInfo.retryable,
-        severity: firstStepInfo.severity,
+        console.log(`[journey-sim] [chained] Step-specific payload for ${actualServiceName}:`, JSON.stringify(chainedPayload, null, 2));
         
-        // Include full customer/business context in each trace
-        // 🔑 Merge hasError + error details INTO additionalFields so OneAgent bizevent capture includes them
-        additionalFields: {
-          ...(currentPayload.additionalFields || {}),
-          hasError: firstStepInfo.hasError === true,
-          ...(firstStepInfo.hasError === true ? {
-            errorType: firstStepInfo.errorType || 'unknown',
-            errorMessage: firstStepInfo.errorMessage || '',
-            httpStatus: firstStepInfo.httpStatus || 500,
-            errorSeverity: firstStepInfo.severity || (firstStepInfo.httpStatus >= 500 ? 'critical' : 'warning')
-          } : {})
-        },
-        customerProfile: currentPayload.customerProfile || {},
-        traceMetadata: currentPayload.traceMetadata || {},
-        sources: currentPayload.sources || [],
-        provider: currentPayload.provider || 'unknown'
+        const result = await callDynamicService(step.stepName, port, chainedPayload, { 'x-correlation-id': correlationId, ...tracingHeaders });
+        return result && { ...result, stepNumber: index + 1, serviceName: actualServiceName };
       };
-      
-      console.log(`[journey-sim] [chained] Step-specific payload for first service:`, JSON.stringify(chainedPayload, null, 2));
-      
-      const chainedResult = await callDynamicService(first.stepName, firstPort, chainedPayload, { 'x-correlation-id': correlationId, ...tracingHeaders });
-      
-      if (chainedResult) {
-        journeyResults.push({
-          ...chainedResult,
-          stepNumber: 1,
-          serviceName: actualServiceName
-        });
+
+      // The first service chains the rest. A parallel group at the start of
+      // the journey is fanned out from here instead, and the chain continues
+      // from the step after it once every member has answered.
+      for (let index = 0; index < stepData.length;) {
+        const group = groupAt(stepData, index);
+        if (group.length === 1) {
+          const chainedResult = await callChainedStep(index);
+          if (chainedResult) journeyResults.push(chainedResult);
+          break;
+        }
+        console.log(`[journey-sim] [chained] Parallel group: ${group.map(i => stepData[i].stepName).join(', ')}`);
+        const members = await Promise.all(group.map(i => callChainedStep(i, { parallelMember: true })));
+        journeyResults.push(...members.filter(Boolean));
+        index = group[group.length - 1] + 1;
+        if (index < stepData.length) await new Promise(resolve => setTimeout(resolve, thinkTimeMs));
       }
     } else {
-      for (let i = 0; i < stepData.length; i++) {
+      // One step's request and result (null for a step that cannot be called)
+      const runStep = async (i) => {
         const stepInfo = errorPlannedSteps[i];
         if (!stepInfo) {
           console.error(`[journey-sim] Step ${i} is undefined, skipping`);
-          continue;
+          return null;
         }
         
         const { stepName, serviceName: payloadServiceName } = stepInfo;
         if (!stepName) {
           console.error(`[journey-sim] Step ${i} has no stepName, skipping`);
-          continue;
+          return null;
         }
         
         const serviceName = payloadServiceName || getServiceNameFromStep(stepName);
@@ -1304,7 +1404,7 @@ router.post('/simulate-journey', async (req, res) => {
         // Guard against port exhaustion — if no port was allocated, fail the step gracefully
         if (!servicePort) {
           console.error(`[journey-sim] ❌ Step ${i + 1}: No port available for ${serviceName} (port exhaustion)`);
-          journeyResults.push({
+          return {
             stepNumber: i + 1,
             stepName,
             serviceName,
@@ -1312,9 +1412,7 @@ router.post('/simulate-journey', async (req, res) => {
             httpStatus: 503,
             error: `Service ${serviceName} could not start: no available ports`,
             errorType: 'port_exhaustion'
-          });
-          await new Promise(resolve => setTimeout(resolve, thinkTimeMs));
-          continue;
+          };
         }
         
         try {
@@ -1375,26 +1473,30 @@ router.post('/simulate-journey', async (req, res) => {
           const stepResult = await callDynamicService(stepName, servicePort, stepPayload, { 'x-correlation-id': correlationId, ...tracingHeaders });
           
           const isFailed = stepResult?.status === 'failed' || (stepResult?.httpStatus && stepResult.httpStatus >= 400);
-          journeyResults.push({
+          console.log(`[journey-sim] ✅ Step ${i + 1}: ${serviceName}`);
+          return {
             ...stepResult,
             stepNumber: i + 1,
             stepName,
             serviceName,
             status: isFailed ? 'failed' : (stepResult?.status || 'completed')
-          });
-          
-          console.log(`[journey-sim] ✅ Step ${i + 1}: ${serviceName}`);
+          };
         } catch (error) {
           console.error(`[journey-sim] ❌ Step ${i + 1} failed: ${error.message}`);
-          journeyResults.push({
+          return {
             stepNumber: i + 1,
             stepName,
             serviceName,
             status: 'failed',
             error: error.message
-          });
+          };
         }
-        
+      };
+
+      // A parallel group's steps go out together; think time follows each group
+      for (const group of stepGroups(errorPlannedSteps)) {
+        const results = await Promise.all(group.map(runStep));
+        journeyResults.push(...results.filter(Boolean));
         await new Promise(resolve => setTimeout(resolve, thinkTimeMs));
       }
     }
@@ -1408,6 +1510,8 @@ router.post('/simulate-journey', async (req, res) => {
       completedSteps: journeyResults.filter(r => r.status !== 'failed').length,
       stepNames: stepData.map(s => s.stepName),
       steps: journeyResults,
+      // Flat per-step view for load drivers that run the whole journey in one request
+      stepTimings: buildStepTimings(stepData, journeyResults, chained),
       additionalFields: generateAdditionalFields(currentPayload.additionalFields, currentPayload.companyName, 0),
       customerProfile: generateCustomerProfile(currentPayload.customerProfile, currentPayload.companyName, 0),
       traceMetadata: generateTraceMetadata(currentPayload.traceMetadata, correlationId, 0),
@@ -1423,37 +1527,14 @@ router.post('/simulate-journey', async (req, res) => {
                              req.body.loadRunnerTriggered === true ||
                              req.body.loadRunnerTest === true;
     
-    // Also skip if a LoadRunner test is already running for this company
-    const existingTest = loadRunnerManager.activeTests[currentPayload.companyName];
-    const alreadyRunning = existingTest && existingTest.pid;
-    
     let continuousGeneration = { active: false, reason: 'called_from_loadrunner' };
     
-    if (!isFromLoadRunner && !alreadyRunning) {
-      // Clear stop flags from previous "stop everything" so new journeys can generate load
-      global.stoppingEverything = false;
-      loadRunnerManager._clearStopFlag(loadRunnerManager._stopAllFlagPath());
-      
-      // Restart auto-load watcher if it was stopped by a previous stop-all
-      startAutoLoadWatcher();
-      
+    if (!isFromLoadRunner) {
       const journeyConfig = req.body.journey || req.body.aiJourney || req.body;
-      try {
-        await loadRunnerManager.startLoadTest(journeyConfig, 'light-load');
-        console.log(`[journey-sim] 🎯 LoadRunner continuous test started for ${currentPayload.companyName}`);
-        continuousGeneration = {
-          active: true,
-          company: currentPayload.companyName,
-          method: 'LoadRunner',
-          scenario: 'light-load',
-          ratePerMinute: '10-20 requests'
-        };
-      } catch (err) {
-        console.error(`[journey-sim] ⚠️  Failed to start LoadRunner test:`, err.message);
-      }
+      const started = await autoStartLoadTest(currentPayload.companyName, journeyConfig);
+      if (started) continuousGeneration = started;
     } else {
-      const reason = isFromLoadRunner ? 'called from LoadRunner/auto-load' : 'already running';
-      console.log(`[journey-sim] ℹ️  Skipping LoadRunner auto-start (${reason})`);
+      console.log(`[journey-sim] ℹ️  Skipping LoadRunner auto-start (called from LoadRunner/auto-load)`);
     }
     
     // Record transaction for volume-based chaos triggering
@@ -1477,7 +1558,102 @@ router.post('/simulate-journey', async (req, res) => {
       error: error.message
     });
   }
-});
+}
+
+router.post('/simulate-journey', simulateJourney);
+
+// Run a route handler without an HTTP hop; resolves with the status and
+// JSON body it would have answered
+function runInProcess(handler, body, headers, correlationId) {
+  return new Promise(resolve => {
+    const res = {
+      statusCode: 200,
+      status(code) {
+        this.statusCode = code;
+        return this;
+      },
+      json(payload) {
+        resolve({ httpStatus: this.statusCode, body: payload });
+        return this;
+      }
+    };
+    handler({ body, headers, correlationId }, res)
+      .catch(e => resolve({ httpStatus: 500, body: { success: false, error: e.message } }));
+  });
+}
+
+function runJourneyInProcess(body, headers, correlationId) {
+  return runInProcess(simulateJourney, body, headers, correlationId);
+}
+
+/**
+ * Batched driver mode for /simulate-batch-chained: the body is one chained
+ * /simulate-journey body plus `batch`, one entry per customer with its own
+ * journeyId, customerId, correlationId and any per-customer fields. Every
+ * customer runs concurrently through the service chain (paced by the
+ * per-service concurrency limits) and gets its own trace; the response has one
+ * result per customer, in order, each with its journey.stepTimings.
+ */
+async function simulateJourneyBatch(req, res) {
+  const { batch, ...shared } = req.body;
+  if (batch.length === 0 || batch.length > JOURNEY_BATCH_MAX) {
+    return res.status(400).json({
+      ok: false,
+      error: `Batch must carry 1-${JOURNEY_BATCH_MAX} customers, got ${batch.length}`,
+      maxCustomers: JOURNEY_BATCH_MAX
+    });
+  }
+
+  const started = Date.now();
+  const plannedSteps = shared.journey?.steps || shared.steps || [];
+  // Per-customer trace context: drop the batch request's own W3C context
+  const { traceparent, tracestate, ...headers } = req.headers;
+  const results = await Promise.all(batch.map(async (entry, index) => {
+    const correlationId = entry.correlationId || `${req.correlationId}-${index + 1}`;
+    const body = {
+      ...shared,
+      ...entry,
+      correlationId,
+      journey: shared.journey ? { ...shared.journey, ...entry } : undefined,
+      // Only the first customer may auto-start continuous load, as one request would
+      ...(index > 0 ? { loadRunnerTriggered: true } : {})
+    };
+    const customerStart = Date.now();
+    const { httpStatus, body: result } = await runJourneyInProcess(body, { ...headers, 'x-correlation-id': correlationId }, correlationId);
+    // One entry per planned step even when the journey failed outright, since
+    // drivers read each customer's timings by position
+    const reported = result?.journey?.stepTimings || [];
+    const stepTimings = plannedSteps.map((step, k) => reported[k] || {
+      stepName: step.stepName || step.name,
+      serviceName: step.serviceName,
+      stepStatus: 'not_reached',
+      httpStatus: 0,
+      durationMs: 0
+    });
+    const failed = httpStatus >= 400 || !result?.success || stepTimings.some(t => t.stepStatus !== 'completed');
+    return {
+      index: index + 1,
+      journeyId: body.journey?.journeyId || body.journeyId,
+      customerId: body.customerId,
+      correlationId,
+      status: failed ? 'failed' : 'completed',
+      httpStatus,
+      journeyMs: Date.now() - customerStart,
+      ...(result?.error ? { error: result.error } : {}),
+      // Last, so each entry's timings can be captured positionally
+      stepTimings
+    };
+  }));
+
+  const failedCount = results.filter(r => r.status === 'failed').length;
+  console.log(`[journey-sim] Batch of ${batch.length} journeys: ${batch.length - failedCount} completed, ${failedCount} failed in ${Date.now() - started}ms`);
+  res.json({
+    ok: true,
+    mode: 'batch',
+    summary: { customers: batch.length, completed: batch.length - failedCount, failed: failedCount, batchMs: Date.now() - started },
+    results
+  });
+}
 
 // Multiple customer journey simulation with detailed output
 router.post('/simulate-multiple-journeys', async (req, res) => {
@@ -1811,7 +1987,7 @@ router.post('/simulate-multiple-journeys', async (req, res) => {
             };
 
             console.log(`[journey-sim] Customer ${customerIndex + 1}: Calling ${step.stepName} on port ${port}`);
-            const response = await callDynamicService(step.stepName, port, payload, traceHeaders);
+            const response = await callDynamicService(step.stepName, port, payload, traceHeaders, { outcomeOnly: true });
             const processingTime = Date.now() - stepStartTime;
 
             // Enhanced response evaluation
@@ -2055,7 +2231,7 @@ router.post('/simulate-multiple-journeys', async (req, res) => {
               'x-correlation-id': correlationId
             };
 
-            const response = await callDynamicService(step.stepName, port, payload, traceHeaders);
+            const response = await callDynamicService(step.stepName, port, payload, traceHeaders, { outcomeOnly: true });
             const processingTime = Date.now() - stepStartTime;
 
             const stepResult = {
@@ -2261,6 +2437,7 @@ router.post('/simulate-multiple-journeys', async (req, res) => {
 
 // Batch simulate: run the 6-step chained flow for multiple customers
 router.post('/simulate-batch-chained', async (req, res) => {
+  if (Array.isArray(req.body?.batch)) return simulateJourneyBatch(req, res);
   try {
     const {
       customers = 1,
@@ -2424,7 +2601,7 @@ router.post('/simulate-batch-chained', async (req, res) => {
         console.log('[journey-sim] FINAL PAYLOAD additionalFields:', JSON.stringify(payload.additionalFields, null, 2));
         console.log('[journey-sim] FINAL PAYLOAD customerProfile:', JSON.stringify(payload.customerProfile, null, 2));
         console.log('[journey-sim] FINAL PAYLOAD traceMetadata:', JSON.stringify(payload.traceMetadata, null, 2));
-        const r = await callDynamicService(first.stepName, firstPort, payload, { 'x-correlation-id': correlationId });
+        const r = await callDynamicService(first.stepName, firstPort, payload, { 'x-correlation-id': correlationId }, { outcomeOnly: true });
         const isFailed = r?.status === 'failed' || (r?.httpStatus && r.httpStatus >= 400);
         if (isFailed) failed++; else completed++;
         if (i < 5) results.push({ index: i + 1, status: isFailed ? 'failed' : 'completed', service: first.serviceName, httpStatus: r?.httpStatus, error: r?.error });
@@ -2548,7 +2725,7 @@ router.post('/simulate-single-step-journeys', async (req, res) => {
           
           const r = await callDynamicService(step.stepName, stepPort, payload, { 
             'x-correlation-id': stepCorrelationId 
-          });
+          }, { outcomeOnly: true });
           
           const isFailed = r?.status === 'failed' || (r?.httpStatus && r.httpStatus >= 400);
           if (isFailed) failed++; else completed++;
@@ -2608,7 +2785,8 @@ router.get('/continuous-generation/status', (req, res) => {
       ok: true,
       method: 'LoadRunner',
       activeJourneys: Object.keys(lrStatus).length,
-      journeys: lrStatus
+      journeys: lrStatus,
+      scheduler: getContinuousGenerationStatus()
     });
   } catch (error) {
     res.status(500).json({ ok: false, error: error.message });
@@ -2619,7 +2797,8 @@ router.get('/continuous-generation/status', (req, res) => {
 router.post('/continuous-generation/stop/:companyName', async (req, res) => {
   try {
     const { companyName } = req.params;
-    const stopped = await loadRunnerManager.stopLoadTest(companyName);
+    const generatorStopped = stopContinuousGeneration(companyName);
+    const stopped = await loadRunnerManager.stopLoadTest(companyName) || generatorStopped;
     res.json({
       ok: true,
       stopped,
@@ -2634,7 +2813,10 @@ router.post('/continuous-generation/stop/:companyName', async (req, res) => {
 // Stop all continuous generation
 router.post('/continuous-generation/stop-all', async (req, res) => {
   try {
-    const stoppedCount = await loadRunnerManager.stopAllTests();
+    let stoppedCount = await loadRunnerManager.stopAllTests();
+    for (const companyName of Object.keys(getContinuousGenerationStatus().generators)) {
+      if (stopContinuousGeneration(companyName)) stoppedCount++;
+    }
     res.json({
       ok: true,
       stopped: stoppedCount,
@@ -2645,17 +2827,24 @@ router.post('/continuous-generation/stop-all', async (req, res) => {
   }
 });
 
-// Initialize: Restore LoadRunner tests when module loads
-loadRunnerManager.restoreActiveTests();
+// Initialize: Restore LoadRunner tests and scheduled generators when module loads
+// (in the owner; a cluster worker has neither)
+if (!IS_CLUSTER_WORKER) {
+  loadRunnerManager.restoreActiveTests();
+  restoreContinuousGenState();
+}
 
 // Reset circuit breakers (admin endpoint)
 router.post('/admin/reset-circuit-breakers', (req, res) => {
   const { serviceName } = req.body;
   
   if (serviceName) {
-    // Reset specific service
-    if (circuitBreakerState.has(serviceName)) {
-      circuitBreakerState.delete(serviceName);
+    // Reset specific service; workers may hold a limiter for it either way
+    const found = circuitBreakerState.delete(serviceName);
+    resetConcurrencyLimits(serviceName);
+    broadcast('circuit-breaker', { serviceName, breaker: null });
+    broadcast('service-ports', null);
+    if (found) {
       console.log(`[journey-sim] Circuit breaker reset for ${serviceName}`);
       res.json({ success: true, message: `Circuit breaker reset for ${serviceName}` });
     } else {
@@ -2665,13 +2854,18 @@ router.post('/admin/reset-circuit-breakers', (req, res) => {
     // Reset all
     const count = circuitBreakerState.size;
     circuitBreakerState.clear();
+    resetConcurrencyLimits();
+    broadcast('circuit-breaker', { serviceName: null });
+    broadcast('service-ports', null);
     console.log(`[journey-sim] All circuit breakers reset (${count} services)`);
     res.json({ success: true, message: `Reset ${count} circuit breaker(s)` });
   }
 });
 
-// Get circuit breaker status
-router.get('/admin/circuit-breakers', (req, res) => {
+// Get circuit breaker status; limits and pools are this process's, plus
+// each cluster worker's under `workers`
+router.get('/admin/circuit-breakers', async (req, res) => {
+  const workers = await gather('service-calls');
   const breakers = [];
   for (const [serviceName, breaker] of circuitBreakerState.entries()) {
     breakers.push({
@@ -2680,10 +2874,20 @@ router.get('/admin/circuit-breakers', (req, res) => {
       failureCount: breaker.failureCount,
       lastFailureTime: breaker.lastFailureTime ? new Date(breaker.lastFailureTime).toISOString() : null,
       threshold: breaker.threshold,
-      timeout: breaker.timeout
+      timeout: breaker.timeout,
+      concurrencyLimit: concurrencyLimitStats(serviceName)
     });
   }
-  res.json({ breakers });
+  res.json({
+    breakers,
+    adaptiveConcurrency: SERVICE_ADAPTIVE_LIMIT,
+    connectionPools: {
+      maxSockets: SERVICE_MAX_SOCKETS,
+      maxFreeSockets: SERVICE_MAX_FREE_SOCKETS,
+      ports: servicePoolStats()
+    },
+    workers: workers.map(({ pid, result }) => ({ pid, ...result }))
+  });
 });
 
 export default router;
@@ -1,9 +1,17 @@
 import express from 'express';
 import { spawn, exec } from 'child_process';
 import fs from 'fs/promises';
+import { createWriteStream } from 'fs';
 import path from 'path';
 import crypto from 'crypto';
 import { fileURLToPath } from 'url';
+import { warmUpServices } from '../services/service-manager.js';
+import { OutputRingBuffer, TestOutputParser } from '../services/test-output.js';
+import { RESULTS_FILE, aggregateResults, tsnNames } from '../services/results-store.js';
+import { CUSTOMER_POOL_FILE, CUSTOMER_POOL_SIZE, CUSTOMER_RECORD_BYTES, linkCustomerPool } from '../services/customer-pool.js';
+import { ArtifactCache, artifactKey } from '../services/artifact-cache.js';
+import { logSettings } from '../services/load-log.js';
+import { parallelGroupOf, stepGroups } from '../services/step-groups.cjs';
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = path.dirname(__filename);
@@ -20,21 +28,664 @@ const LOADRUNNER_CONFIGS = {
   peak: { journeyInterval: 2, duration: 1200 }         // New user every 2 seconds for 20 minutes (600 users)
 };
 
+// Scenario profile (loadrunner-tests/scenarios/<name>.json) behind each test
+// profile; supplies vusers, ramp times, throughput target and arrival model
+const SCENARIO_PROFILES = {
+  light: 'light-load',
+  medium: 'medium-load',
+  heavy: 'heavy-load',
+  stress: 'stress-test',
+  peak: 'spike-test'
+};
+
+// Think time distributions both drivers sample around the per-step mean
+const THINK_DISTRIBUTIONS = ['fixed', 'exponential', 'lognormal'];
+// Real seconds per test second when neither the scenario nor the request
+// says: each estimated minute of a step is replayed as one second
+const DEFAULT_TIME_COMPRESSION = 60;
+
 // Active test sessions tracking
 const activeTests = new Map();
 
+// Native load engine (native/loadgen). Built with `npm run build:loadgen`;
+// BIZOBS_LOADGEN_BIN points at a binary installed elsewhere.
+const LOADGEN_BIN = process.env.BIZOBS_LOADGEN_BIN ||
+  path.join(__dirname, '..', 'native', 'loadgen', 'build', 'bizobs-loadgen');
+
+// Generated test artifacts, reused while a test's inputs are unchanged
+const artifactCache = new ArtifactCache(path.join(__dirname, '..', 'loadrunner-tests', 'cache'));
+
+// Drivers on this host, probed once at startup rather than per test. Only a
+// missing native engine is probed again, so `npm run build:loadgen` needs no
+// restart.
+const driverTools = detectDriverTools();
+
+async function detectDriverTools() {
+  const loadRunner = await new Promise(resolve => exec('which mmdrv || which wlrun', error => resolve(!error)));
+  return { loadRunner, nativeEngine: await canExecute(LOADGEN_BIN) };
+}
+
+async function canExecute(file) {
+  try {
+    await fs.access(file, fs.constants.X_OK);
+    return true;
+  } catch {
+    return false;
+  }
+}
+
+/**
+ * Load the schedule part of a scenario profile, or null when it doesn't exist.
+ * duration is left to the caller: /start-test takes it from durationMinutes.
+ */
+async function loadScenarioSchedule(name) {
+  if (!name || !/^[\w-]+$/.test(name)) return null;
+  try {
+    const file = path.join(__dirname, '..', 'loadrunner-tests', 'scenarios', `${name}.json`);
+    const profile = JSON.parse(await fs.readFile(file, 'utf8'));
+    const lr = profile.loadrunner_config || {};
+    return {
+      scenario: name,
+      vusers: lr.vusers,
+      rampUp: lr.ramp_up_time,
+      rampDown: lr.ramp_down_time,
+      journeyInterval: lr.journey_interval,
+      arrivalModel: lr.arrival_model === 'open' ? 'open' : 'closed',
+      throughputTarget: lr.arrival_rate || profile.monitoring?.throughput_target,
+      errorRate: profile.error_simulation?.error_rate,
+      thinkTimeMs: lr.think_time,
+      thinkDistribution: lr.think_time_distribution,
+      thinkSigma: lr.think_time_sigma,
+      timeCompression: lr.time_compression,
+      batchSize: lr.batch_size,
+      logLevel: lr.log_level,
+      logSample: lr.log_sample
+    };
+  } catch (e) {
+    return null;
+  }
+}
+
+/**
+ * Open-model arrival curve: 0 -> rate over rampUp, rate for duration, rate -> 0
+ * over rampDown. Same shape as the native engine's ArrivalSchedule.
+ */
+function buildArrivalSchedule(testConfig) {
+  const { duration, rampUp = 0, rampDown = 0, journeyInterval = 30 } = testConfig;
+  // Without a scenario target, keep the profile's "one customer per journeyInterval"
+  const rate = testConfig.throughputTarget > 0 ? testConfig.throughputTarget : 1 / journeyInterval;
+  return {
+    rate,
+    points: [[0, rampUp > 0 ? 0 : rate], [rampUp, rate], [rampUp + duration, rate], [rampUp + duration + rampDown, 0]],
+    totalJourneys: Math.round(rate * (rampUp / 2 + duration + rampDown / 2))
+  };
+}
+
+/**
+ * LSN/LTN naming shared by the generated script and the native engine so
+ * both drivers land under the same Dynatrace load test.
+ */
+function buildDynatraceTags(companyName, domain, timestamp) {
+  return {
+    LSN: `BizObs_${companyName.replace(/\s+/g, '')}_${domain}_Journey`,
+    LTN: `${companyName.replace(/\s+/g, '')}_LoadTest_${timestamp.split('T')[0].replace(/-/g, '')}`
+  };
+}
+
+/**
+ * Build the X-dynaTrace header layout for a generated script.
+ *
+ * The header is split so the hot path never re-formats it:
+ *   prefix  "LSN=..;LTN=..;VU=<n>;SI=LoadRunner;PC=BizObs-Demo;AN=..;CID="  (vuser_init)
+ *   CID     "<correlation_id>;"                                           (once per iteration)
+ *   suffix  "TSN=<step>"                                                  (static table, per step)
+ * Chained scripts add a Full_Customer_Journey entry for the single request
+ * that carries the whole journey. The prefix is measured and allocated once
+ * per VU; each iteration's header comes from the VU arena, sized to its CID
+ * plus the longest suffix.
+ * Returns the C declarations plus the prefix format for vuser_init().
+ */
+function buildDynatraceHeaderTable(stepNames, LSN, LTN, companyName, chainedJourney = false) {
+  const tsns = [...stepNames, 'Journey_Completion', ...(chainedJourney ? ['Full_Customer_Journey'] : [])];
+  const suffixes = tsns.map(name => `TSN=${name}`);
+  const fmt = value => String(value).replace(/%/g, '%%');
+  const prefixTemplate = `LSN=${fmt(LSN)};LTN=${fmt(LTN)};VU=%d;SI=LoadRunner;PC=BizObs-Demo;AN=${fmt(companyName)};CID=`;
+  const declarations = `// X-dynaTrace header: VU-constant prefix formatted once in vuser_init(),
+// CID appended once per iteration, TSN copied from a static table per step
+#define DT_SUFFIX_MAX ${Math.max(...suffixes.map(sfx => Buffer.byteLength(sfx)))}
+#define DT_STEP_COMPLETION ${stepNames.length}${chainedJourney ? `\n#define DT_STEP_JOURNEY ${stepNames.length + 1}` : ''}
+char* dt_prefix;        // per VU, malloc'd to its measured length
+char* dt_test_header;   // per iteration, from the VU arena
+int dt_tsn_offset;
+
+static const char* const dt_step_suffix[] = {
+${suffixes.map(sfx => `    ${JSON.stringify(sfx)}`).join(',\n')}
+};
+static const int dt_step_suffix_len[] = { ${suffixes.map(sfx => Buffer.byteLength(sfx)).join(', ')} };
+
+// Point the header at step N: one bounded copy, no formatting
+void dt_set_step(int step) {
+    memcpy(dt_test_header + dt_tsn_offset, dt_step_suffix[step], dt_step_suffix_len[step] + 1);
+}`;
+
+  return { declarations, prefixTemplate };
+}
+
+/**
+ * Per-step latency histograms for a generated script: HdrHistogram layout in
+ * 1 ms units at 2 significant digits (8 KB per step, fixed for the whole run).
+ * With a closed-model pacing interval, a step that took longer than the
+ * interval is backfilled for the iterations it held up (coordinated
+ * omission). vuser_end() publishes p50/p99/p99.9 per TSN as data points.
+ */
+function buildLatencyHistogramTable(stepNames, expectedIntervalMs = 0) {
+  return `// Per-step latency histograms: bucket b holds 128 sub-buckets of 2^b ms each,
+// so every value is kept within 1% and the memory never grows
+#define LAT_STEPS ${stepNames.length}
+#define LAT_HALF 128
+#define LAT_COUNTS (16 * LAT_HALF)
+#define LAT_MAX_MS 3600000
+#define LAT_EXPECTED_INTERVAL_MS ${Math.max(0, Math.round(expectedIntervalMs))}
+unsigned int lat_counts[LAT_STEPS][LAT_COUNTS];
+unsigned int lat_total[LAT_STEPS];
+int lat_max[LAT_STEPS];
+
+static const char* const lat_step_name[] = {
+${stepNames.map(name => `    ${toCStringLiteral(name)}`).join(',\n')}
+};
+
+void lat_record_value(int step, int ms) {
+    int bucket = 0;
+    if (ms < 0) ms = 0;
+    if (ms > LAT_MAX_MS) ms = LAT_MAX_MS;
+    while ((ms >> bucket) >= 2 * LAT_HALF) bucket++;
+    lat_counts[step][bucket * LAT_HALF + (ms >> bucket)]++;
+    lat_total[step]++;
+    if (ms > lat_max[step]) lat_max[step] = ms;
+}
+
+// Record one step sample plus the samples a stall kept from being sent
+void lat_record(int step, double seconds) {
+    int ms = (int)(seconds * 1000.0 + 0.5);
+    int missing;
+    lat_record_value(step, ms);
+    if (LAT_EXPECTED_INTERVAL_MS <= 0) return;
+    for (missing = ms - LAT_EXPECTED_INTERVAL_MS; missing >= LAT_EXPECTED_INTERVAL_MS; missing -= LAT_EXPECTED_INTERVAL_MS)
+        lat_record_value(step, missing);
+}
+
+int lat_percentile(int step, double percentile) {
+    unsigned int target = (unsigned int)(percentile / 100.0 * lat_total[step] + 0.999999);
+    unsigned int seen = 0;
+    int i, bucket, value;
+    if (target == 0) target = 1;
+    for (i = 0; i < LAT_COUNTS; i++) {
+        seen += lat_counts[step][i];
+        if (seen >= target) {
+            bucket = i / LAT_HALF - 1;
+            value = i % LAT_HALF + LAT_HALF;
+            if (bucket < 0) { bucket = 0; value -= LAT_HALF; }
+            value = (value << bucket) + (1 << bucket) - 1;
+            return value < lat_max[step] ? value : lat_max[step];
+        }
+    }
+    return lat_max[step];
+}
+
+void lat_report(void) {
+    char name[160];
+    int step;
+    for (step = 0; step < LAT_STEPS; step++) {
+        if (lat_total[step] == 0) continue;
+        sprintf(name, "p50_%s", lat_step_name[step]);
+        lr_user_data_point(name, lat_percentile(step, 50));
+        sprintf(name, "p99_%s", lat_step_name[step]);
+        lr_user_data_point(name, lat_percentile(step, 99));
+        sprintf(name, "p99.9_%s", lat_step_name[step]);
+        lr_user_data_point(name, lat_percentile(step, 99.9));
+    }
+}`;
+}
+
+/**
+ * Seeded per-VU error schedule for a generated script, the same hash as the
+ * native engine's ErrorSchedule: step s of iteration i fails when
+ * err_mix(vu seed ^ err_mix(i * K + s)) % 10000 < the rate in basis points.
+ * Action() plans each iteration up front and sends the failing step names in
+ * x-error-schedule; the step service fails them inline, so a rerun with the
+ * same seed fails the same requests and no transaction is failed client-side.
+ */
+function buildErrorScheduleTable(stepNames, errorRatePct, errorSeed) {
+  const rateBp = Math.max(0, Math.min(10000, Math.round((Number(errorRatePct) || 0) * 100)));
+  const scheduleMax = stepNames.reduce((len, name) => len + Buffer.byteLength(name) + 1, 1);
+  return `// Seeded error schedule: x-error-schedule names this iteration's failing steps
+#define ERR_STEPS ${stepNames.length}
+#define ERR_RATE_BP ${rateBp}
+#define ERR_SEED ${(errorSeed >>> 0)}u
+char err_schedule[${scheduleMax}];
+unsigned int err_vu_seed;
+
+static const char* const err_step_name[] = {
+${stepNames.map(name => `    ${toCStringLiteral(name)}`).join(',\n')}
+};
+
+unsigned int err_mix(unsigned int x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+void err_plan_iteration(int iteration) {
+    int step, len = 0;
+    err_schedule[0] = '\\0';
+    if (ERR_RATE_BP <= 0) return;
+    for (step = 0; step < ERR_STEPS; step++) {
+        if (err_mix(err_vu_seed ^ err_mix((unsigned int)iteration * 0x85ebca6bu + (unsigned int)step)) % 10000 >= ERR_RATE_BP) continue;
+        len += sprintf(err_schedule + len, "%s%s", len ? "," : "", err_step_name[step]);
+    }
+}`;
+}
+
+/**
+ * Per-step think time for a generated script, the same model as the native
+ * engine's ThinkTime: the mean is testConfig.thinkTimeMs or the step's
+ * estimatedDuration minutes, divided by the time-compression factor, and
+ * think_time_sample() draws fixed / exponential / lognormal around it with
+ * millisecond resolution (capped at 10x the mean). The VU's stream is seeded
+ * from its error-schedule seed, so a rerun with the same seed thinks alike.
+ */
+function buildThinkTimeTable(steps, testConfig) {
+  const { thinkTimeMs, thinkDistribution = 'fixed', thinkSigma = 0.5 } = testConfig;
+  const compression = testConfig.timeCompression > 0 ? testConfig.timeCompression : DEFAULT_TIME_COMPRESSION;
+  const meansMs = steps.map(step => {
+    const minutes = Number(step.estimatedDuration) > 0 ? Number(step.estimatedDuration) : 5;
+    const realMs = Number.isFinite(thinkTimeMs) && thinkTimeMs >= 0 ? thinkTimeMs : minutes * 60000;
+    return Math.round(realMs / compression * 1000) / 1000;
+  });
+  return `// Think time: ${thinkDistribution} around each step's mean, ${compression}x time compression
+#define THINK_FIXED 0
+#define THINK_EXPONENTIAL 1
+#define THINK_LOGNORMAL 2
+#define THINK_DIST ${Math.max(0, THINK_DISTRIBUTIONS.indexOf(thinkDistribution))}
+#define THINK_SIGMA ${Number(thinkSigma) > 0 ? Number(thinkSigma) : 0.5}
+#define THINK_MAX_FACTOR 10.0
+unsigned int think_rng;
+
+static const double think_mean_ms[] = { ${meansMs.map(ms => ms.toFixed(3)).join(', ')} };
+
+// (0, 1) from the VU's xorshift32 stream; never 0, so log(u) stays finite
+double think_uniform() {
+    think_rng ^= think_rng << 13;
+    think_rng ^= think_rng >> 17;
+    think_rng ^= think_rng << 5;
+    return ((think_rng >> 8) + 0.5) / 16777216.0;
+}
+
+// Seconds for lr_think_time(), which takes fractions
+double think_time_sample(int step) {
+    double mean = think_mean_ms[step], ms = mean;
+    if (mean > 0 && THINK_DIST == THINK_EXPONENTIAL) {
+        ms = -mean * log(think_uniform());
+    } else if (mean > 0 && THINK_DIST == THINK_LOGNORMAL) {
+        double z = sqrt(-2 * log(think_uniform())) * cos(6.283185307179586 * think_uniform());
+        ms = exp(log(mean) - THINK_SIGMA * THINK_SIGMA / 2 + THINK_SIGMA * z);
+    }
+    if (ms > mean * THINK_MAX_FACTOR) ms = mean * THINK_MAX_FACTOR;
+    return (double)(long)(ms + 0.5) / 1000.0;
+}`;
+}
+
+/**
+ * Render a string as a C string literal. JSON escapes are valid C except
+ * \\uXXXX, which C only accepts outside the basic character set; control
+ * characters are re-emitted as octal escapes.
+ */
+function toCStringLiteral(value) {
+  return JSON.stringify(String(value))
+    .replace(/\\u([0-9a-fA-F]{4})/g, (m, hex) => {
+      const code = parseInt(hex, 16);
+      return code < 0x80 ? `\\${code.toString(8).padStart(3, '0')}` : m;
+    });
+}
+
+// Long static text as adjacent C literals, ~100 characters per line
+function cLiteralLines(value, indent = '    ') {
+  const chars = Array.from(value);
+  const lines = [];
+  for (let i = 0; i < chars.length || i === 0; i += 100) {
+    lines.push(toCStringLiteral(chars.slice(i, i + 100).join('')));
+  }
+  return lines.join(`\n${indent}`);
+}
+
+// Per-VU values patched into compiled request bodies. The order fixes the slot
+// ids in the generated C and in body-templates.json read by the native engine.
+const BODY_SLOTS = [
+  'correlation_id', 'customer_id', 'session_id', 'trace_id',
+  'customer_name', 'customer_email', 'customer_segment', 'completion_time'
+];
+// Batch customers 2..K carry their own profile; the native engine never batches
+const BATCH_PROFILE_FIELDS = ['customer_name', 'customer_email', 'customer_segment'];
+const batchProfileSlots = batchSize =>
+  Array.from({ length: batchSize - 1 }, (_, i) => BATCH_PROFILE_FIELDS.map(field => `${field}_${i + 2}`)).flat();
+const slotPattern = slotNames => new RegExp(`\\{(${slotNames.join('|')})\\}`, 'g');
+
+/**
+ * Compile a request body into static JSON segments interleaved with slots:
+ * segments[0] slot[0] segments[1] ... slot[n-1] segments[n]. Slot values are
+ * substituted raw, so they must already be JSON-safe (ids and demo profiles).
+ */
+function compileBodyTemplate(body, slotNames = BODY_SLOTS) {
+  const json = JSON.stringify(body);
+  const segments = [];
+  const slots = [];
+  let last = 0;
+  for (const match of json.matchAll(slotPattern(slotNames))) {
+    segments.push(json.slice(last, match.index));
+    slots.push(match[1]);
+    last = match.index + match[0].length;
+  }
+  segments.push(json.slice(last));
+  return { segments, slots };
+}
+
+/**
+ * Every simulate-journey body a journey needs, compiled once per test: one per
+ * step, the whole-journey chained body and the completion event. With
+ * batchSize > 1 also the /simulate-batch-chained body: the chained body plus
+ * one `batch` entry per customer, ids suffixed -1..-K from the iteration's and
+ * each with its own customer's profile (slots customer_name_2.. past the first).
+ */
+function compileJourneyBodies(journeyConfig, errorSimulationEnabled, batchSize = 1) {
+  const { companyName, domain, steps = [], additionalFields = {}, journeyType, industryType } = journeyConfig;
+  const stepObject = (step, index) => {
+    const stepName = step.stepName || step.name || `Step_${index + 1}`;
+    return {
+      stepNumber: index + 1,
+      stepName,
+      serviceName: step.serviceName || `${stepName}Service`,
+      description: step.description || step.stepDescription || '',
+      estimatedDuration: step.estimatedDuration || step.duration || 5000,
+      substeps: step.substeps || [],
+      // The server fans a group out concurrently in chained mode
+      ...(parallelGroupOf(step) !== null ? { parallelGroup: parallelGroupOf(step) } : {})
+    };
+  };
+  const profile = (suffix = '', userId = '{customer_id}') => ({
+    name: `{customer_name${suffix}}`,
+    email: `{customer_email${suffix}}`,
+    segment: `{customer_segment${suffix}}`,
+    userId,
+    deviceType: 'desktop',
+    location: 'US-East'
+  });
+  const envelope = stepList => ({
+    journeyId: '{correlation_id}',
+    customerId: '{customer_id}',
+    sessionId: '{session_id}',
+    traceId: '{trace_id}',
+    chained: true,
+    thinkTimeMs: 250,
+    errorSimulationEnabled: !!errorSimulationEnabled,
+    journey: {
+      journeyId: '{correlation_id}',
+      companyName,
+      domain,
+      // What the warm-up started the services with, so the first request
+      // resolves the same context instead of restarting them
+      industryType: industryType || 'general',
+      journeyType: journeyType || '',
+      steps: stepList,
+      additionalFields: additionalFields || {},
+      customerProfile: profile()
+    }
+  });
+
+  const batchEntry = n => ({
+    journeyId: `{correlation_id}-${n}`,
+    correlationId: `{correlation_id}-${n}`,
+    customerId: `{customer_id}-${n}`,
+    sessionId: `{session_id}-${n}`,
+    traceId: `{trace_id}-${n}`,
+    customerProfile: profile(n > 1 ? `_${n}` : '', `{customer_id}-${n}`)
+  });
+  const batchSlots = [...BODY_SLOTS, ...batchProfileSlots(batchSize)];
+
+  return {
+    slots: batchSize > 1 ? batchSlots : BODY_SLOTS,
+    steps: steps.map((step, index) => compileBodyTemplate(envelope([stepObject(step, index)]))),
+    journey: compileBodyTemplate(envelope(steps.map(stepObject))),
+    ...(batchSize > 1 ? {
+      batch: compileBodyTemplate({
+        ...envelope(steps.map(stepObject)),
+        batch: Array.from({ length: batchSize }, (_, i) => batchEntry(i + 1))
+      }, batchSlots)
+    } : {}),
+    completion: compileBodyTemplate({
+      eventType: 'journey_completed',
+      correlationId: '{correlation_id}',
+      customerId: '{customer_id}',
+      companyName,
+      customerName: '{customer_name}',
+      customerSegment: '{customer_segment}',
+      totalSteps: steps.length,
+      loadTest: true,
+      completionTime: '{completion_time}'
+    })
+  };
+}
+
+/**
+ * C tables for compiled bodies. Each body becomes a static segment table plus
+ * slot ids; render_body() memcpy's segments and the VU's current slot values
+ * into one per-VU buffer that is passed straight to web_custom_request() as
+ * its "Body=" argument.
+ */
+function buildBodyTemplateTable(entries, slotNames = BODY_SLOTS) {
+  const slotEnum = slotNames.map(slot => `SLOT_${slot.toUpperCase()}`);
+  const tables = entries.map(([name, { segments, slots }]) => {
+    const text = segments.map((seg, i) => (i === 0 ? `Body=${seg}` : seg));
+    const lengths = text.map(seg => Buffer.byteLength(seg));
+    return `static const char* const ${name}_text[] = {
+${text.map(seg => `    ${cLiteralLines(seg)}`).join(',\n')}
+};
+static const int ${name}_text_len[] = { ${lengths.join(', ')} };
+static const int ${name}_slot[] = { ${slots.length ? slots.map(slot => `SLOT_${slot.toUpperCase()}`).join(', ') : '-1'} };
+static const body_template ${name} = { ${slots.length}, ${name}_text, ${name}_text_len, ${name}_slot };`;
+  });
+
+  return `// Request bodies compiled at generation time: static JSON segments with
+// per-VU slots, so an iteration only copies bytes instead of re-substituting
+// {param} placeholders through multi-KB literals. Slots point at static
+// tables or arena strings; a rendered body is sized exactly in the VU arena
+enum { ${slotEnum.join(', ')}, SLOT_COUNT };
+const char* slot_value[SLOT_COUNT];
+int slot_len[SLOT_COUNT];
+
+typedef struct {
+    int slots;
+    const char* const* text;
+    const int* text_len;
+    const int* slot;
+} body_template;
+
+${tables.join('\n\n')}
+
+// The value must outlive the iteration: a static table entry or an arena string
+void set_slot(int slot, const char* value) {
+    slot_value[slot] = value;
+    slot_len[slot] = strlen(value);
+}
+
+const char* render_body(const body_template* t) {
+    char* body;
+    char* p;
+    int i, n = 0;
+    for (i = 0; i < t->slots; i++) n += t->text_len[i] + slot_len[t->slot[i]];
+    n += t->text_len[i] + 1;
+    p = body = arena_alloc(n);
+    for (i = 0; i < t->slots; i++) {
+        memcpy(p, t->text[i], t->text_len[i]);
+        p += t->text_len[i];
+        memcpy(p, slot_value[t->slot[i]], slot_len[t->slot[i]]);
+        p += slot_len[t->slot[i]];
+    }
+    memcpy(p, t->text[i], t->text_len[i] + 1);
+    return body;
+}`;
+}
+
+/**
+ * Per-VU bump arena for a generated script, same policy as the native
+ * engine's Arena: everything an iteration formats (ids, the X-dynaTrace
+ * header, rendered bodies) is carved from the current chunk; a chunk that
+ * runs out chains a bigger one, and arena_reset() at the end of Action()
+ * folds the chain into one chunk of the largest iteration seen. Strings are
+ * sized with a measuring snprintf, so long journeys grow the arena instead
+ * of truncating or overrunning a fixed buffer.
+ */
+function buildArenaTable() {
+  return `// Per-VU request arena: reset at the end of every iteration
+#define ARENA_INITIAL 4096
+typedef struct arena_chunk {
+    struct arena_chunk* prev;
+    int size;
+    int used;
+} arena_chunk;
+arena_chunk* arena_top;
+int arena_iter_bytes;   // handed out since the last reset
+int arena_high_water;   // largest iteration so far
+
+arena_chunk* arena_chunk_new(int size, arena_chunk* prev) {
+    arena_chunk* c = (arena_chunk*)malloc(sizeof(arena_chunk) + size);
+    if (c == NULL) {
+        lr_error_message("Request arena: cannot allocate %d bytes", size);
+        lr_exit(LR_EXIT_VUSER, LR_FAIL);
+    }
+    c->prev = prev;
+    c->size = size;
+    c->used = 0;
+    return c;
+}
+
+char* arena_alloc(int n) {
+    char* p;
+    n = (n + 7) & ~7;
+    if (arena_top == NULL || arena_top->size - arena_top->used < n) {
+        int size = arena_top != NULL ? arena_top->size * 2 : ARENA_INITIAL;
+        if (size < n) size = (n + 1023) & ~1023;
+        arena_top = arena_chunk_new(size, arena_top);
+    }
+    p = (char*)(arena_top + 1) + arena_top->used;
+    arena_top->used += n;
+    arena_iter_bytes += n;
+    return p;
+}
+
+// Format into exactly the bytes needed: measure, allocate, format
+char* arena_printf(const char* fmt, ...) {
+    va_list args;
+    char* p;
+    int n;
+    va_start(args, fmt);
+    n = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+    p = arena_alloc(n + 1);
+    va_start(args, fmt);
+    vsnprintf(p, n + 1, fmt, args);
+    va_end(args);
+    return p;
+}
+
+void arena_free_chain(void) {
+    while (arena_top != NULL) {
+        arena_chunk* prev = arena_top->prev;
+        free(arena_top);
+        arena_top = prev;
+    }
+}
+
+void arena_reset(void) {
+    if (arena_iter_bytes > arena_high_water) arena_high_water = arena_iter_bytes;
+    if (arena_top != NULL && arena_top->prev != NULL) {
+        arena_free_chain();
+        arena_top = arena_chunk_new((arena_high_water + 1023) & ~1023, NULL);
+    }
+    if (arena_top != NULL) arena_top->used = 0;
+    arena_iter_bytes = 0;
+}`;
+}
+
 /**
  * Generate LoadRunner script from JSON journey configuration - Sequential Load Simulation
  * Uses the same journey format as single simulation but generates multiple customers
+ *
+ * options.journeyMode 'per-step' (default) sends one simulate-journey request
+ * per step. 'chained' sends the full step list once with chained:true and books
+ * each step's transaction from the server-side timings in journey.stepTimings.
+ * Steps sharing a parallelGroup (services/step-groups.cjs) go out together: in
+ * per-step mode in one web_concurrent_start/web_concurrent_end group, booked
+ * from each response's stepTimings; in chained mode the server fans them out.
+ *
+ * options.batchSize K > 1 is chained mode with K customers per iteration in
+ * one /simulate-batch-chained request; every customer's steps are booked from
+ * its own stepTimings, so each TSN gets K transactions per iteration.
+ *
+ * options.connectionReuse keeps one keep-alive connection per VU: VU and
+ * iteration headers become auto headers set once, steps only add their own
+ * request-scoped headers, and nothing is cleaned up or reverted between steps.
+ *
+ * options.customerPool is the customers.dat the script reads its customer
+ * from each iteration (services/customer-pool.js); relative to the script
+ * directory by default.
  */
-function generateLoadRunnerScript(journeyConfig, testConfig, errorSimulationEnabled = true) {
+function generateLoadRunnerScript(journeyConfig, testConfig, errorSimulationEnabled = true, options = {}) {
+  const { journeyMode = 'per-step', connectionReuse = false, customerPool = CUSTOMER_POOL_FILE } = options;
+  const batchSize = Math.max(1, Math.floor(options.batchSize || 1));
   const { companyName, domain, steps = [], additionalFields = {}, journeyType, industryType } = journeyConfig;
   const testId = crypto.randomUUID();
   const timestamp = new Date().toISOString().replace(/[:.]/g, '-');
   
   // Generate LSN, TSN, LTN based on company and test config
-  const LSN = `BizObs_${companyName.replace(/\s+/g, '')}_${domain}_Journey`;
-  const LTN = `${companyName.replace(/\s+/g, '')}_LoadTest_${timestamp.split('T')[0].replace(/-/g, '')}`;
+  const { LSN, LTN } = buildDynatraceTags(companyName, domain, timestamp);
+  const stepNames = steps.map((step, index) => step.stepName || step.name || `Step_${index + 1}`);
+  const chainedJourney = journeyMode === 'chained' || batchSize > 1;
+  const dtHeader = buildDynatraceHeaderTable(stepNames, LSN, LTN, companyName, chainedJourney);
+  const bodies = compileJourneyBodies(journeyConfig, errorSimulationEnabled, batchSize);
+  const bodyTable = buildBodyTemplateTable([
+    ...(chainedJourney
+      ? [['body_journey', batchSize > 1 ? bodies.batch : bodies.journey]]
+      : bodies.steps.map((body, index) => [`body_step_${index + 1}`, body])),
+    ['body_completion', bodies.completion]
+  ], bodies.slots);
+  // Closed-model pacing is the gap a stalled step keeps later iterations from filling
+  const latencyTable = buildLatencyHistogramTable(stepNames,
+    testConfig.arrivalModel === 'open' ? 0 : (testConfig.journeyInterval || 0) * 1000);
+  const errorSeed = testConfig.errorSeed || 1;
+  const errorTable = buildErrorScheduleTable(stepNames,
+    errorSimulationEnabled ? (testConfig.errorRate ?? 5) : 0, errorSeed);
+  const thinkTable = buildThinkTimeTable(steps, testConfig);
+  const log = logSettings(testConfig.logLevel, testConfig.logSample);
+  // Same VU count generateScenarioFile() runs, so (iteration, VU) rows never overlap
+  const customerStride = testConfig.vusers ||
+    Math.max(1, Math.floor((testConfig.duration || 0) / (testConfig.journeyInterval || 1)));
+
+  // Headers each request re-adds when connections are not reused; with
+  // connectionReuse they are auto headers set in vuser_init() / Action()
+  const sharedHeaders = `    web_add_header("x-correlation-id", "{correlation_id}");
+    web_add_header("x-customer-id", "{customer_id}");
+    web_add_header("x-session-id", "{session_id}");
+    web_add_header("x-trace-id", "{trace_id}");
+`;
+  const profileHeaders = `    web_add_header("x-customer-segment", "{customer_segment}");
+    web_add_header("x-traffic-source", "{traffic_source}");
+    web_add_header("x-test-iteration", lr_eval_string("{pIteration}"));
+    web_add_header("Content-Type", "application/json");
+    web_add_header("User-Agent", "LoadRunner-BizObs-Agent/1.0");
+`;
   
   const scriptHeader = `/*
  * LoadRunner Script Generated from BizObs Journey Configuration
@@ -47,140 +698,266 @@ function generateLoadRunnerScript(journeyConfig, testConfig, errorSimulationEnab
  * LSN: ${LSN} (Load Script Name)
  * TSN: Dynamic per step (Test Step Names)
  * LTN: ${LTN} (Load Test Name)
+ * Error schedule seed: ${errorSeed}
+ * Think time: ${testConfig.thinkDistribution || 'fixed'}, ${testConfig.timeCompression > 0 ? testConfig.timeCompression : DEFAULT_TIME_COMPRESSION}x time compression
+ * Logging: ${log.level}${log.level === 'info' ? `, 1 in ${log.sample} iterations` : ''}
  */
 
+#include <stdarg.h>
+#include <stdio.h>
+#include <math.h>
 #include "web_api.h"
 #include "lrun.h"
 
-// Global Dynatrace integration variables
-char dt_test_header[1024];
-char correlation_id[64];
-char customer_id[64];
-char session_id[64];
-char trace_id[64];
-char correlation_id[64];
-char customer_id[64];
-char session_id[64];
-char trace_id[64];
-
-// Demo customer profiles for realistic simulation
-char* customer_names[] = {
-    "Sarah Johnson", "Michael Chen", "Emma Rodriguez", "David Kim", 
-    "Ashley Thompson", "Robert Martinez", "Jennifer Lee", "Christopher Brown",
-    "Amanda Wilson", "Joshua Garcia", "Melissa Davis", "Andrew Miller",
-    "Jessica Anderson", "Kevin Taylor", "Lauren Thomas", "Brian Jackson"
-};
-
-char* customer_emails[] = {
-    "sarah.johnson@email.com", "michael.chen@email.com", "emma.rodriguez@email.com",
-    "david.kim@email.com", "ashley.thompson@email.com", "robert.martinez@email.com",
-    "jennifer.lee@email.com", "christopher.brown@email.com", "amanda.wilson@email.com",
-    "joshua.garcia@email.com", "melissa.davis@email.com", "andrew.miller@email.com",
-    "jessica.anderson@email.com", "kevin.taylor@email.com", "lauren.thomas@email.com",
-    "brian.jackson@email.com"
-};
+// Global Dynatrace integration variables (LoadRunner gives each Vuser its own
+// copy); formatted into the VU arena every iteration
+char* correlation_id;
+char* customer_id;
+char* session_id;
+char* trace_id;
+
+// Journey and step lines go out for 1 in LOG_SAMPLE iterations (none at log
+// level error); failures always do. Every transaction is still counted in
+// the histograms and results
+#define LOG_INFO ${log.level === 'info' ? 1 : 0}
+#define LOG_SAMPLE ${log.sample}
+int log_iteration = LOG_INFO;
+#define log_info if (log_iteration) lr_output_message
+
+${buildArenaTable()}
+
+${dtHeader.declarations}
+
+${bodyTable}
+
+${latencyTable}
+
+${errorTable}
+
+${thinkTable}
+${!chainedJourney && stepGroups(steps).some(group => group.length > 1) ? `
+// Book a parallel group member's transaction from the stepTimings entry its
+// response carried; a request that failed or never answered is a 0 s failure
+void report_concurrent_step(int step, const char* tsn) {
+    char param[32];
+    double seconds;
+    int status = LR_FAIL;
+    sprintf(param, "{step_ms_%d}", step + 1);
+    seconds = atof(lr_eval_string(param)) / 1000.0;
+    sprintf(param, "{step_status_%d}", step + 1);
+    if (strcmp(lr_eval_string(param), "completed") == 0) status = LR_PASS;
+    lr_set_transaction(tsn, seconds, status);
+    lat_record(step, seconds);
+    if (status != LR_PASS) lr_error_message("Step %s failed in parallel group: status %s", tsn, lr_eval_string(param));
+}
+` : ''}${chainedJourney ? `
+// Book step N's transaction from the stepTimings entry captured for this
+// iteration; a step the chain never reached (or a failed request) is a 0 s failure
+void report_chained_step(int entry, int step, const char* tsn) {
+    double seconds = 0;
+    int status = LR_FAIL;
+    if (entry < lr_paramarr_len("step_ms") && entry < lr_paramarr_len("step_status")) {
+        seconds = atof(lr_paramarr_idx("step_ms", entry + 1)) / 1000.0;
+        if (strcmp(lr_paramarr_idx("step_status", entry + 1), "completed") == 0) status = LR_PASS;
+    }
+    lr_set_transaction(tsn, seconds, status);
+    lat_record(step, seconds);
+    if (status != LR_PASS) lr_error_message("Step %s failed in chained journey %s", tsn, correlation_id);
+}
 
-char* customer_segments[] = {
-    "Premium", "Standard", "Budget", "Enterprise", "SMB", "Startup"
+// Customers per iteration; customer c's timings follow the first c customers'
+// ${stepNames.length} entries each in the response
+#define JOURNEY_BATCH ${batchSize}
+void report_chained_journey(int customer) {
+${stepNames.map((name, index) => `    report_chained_step(customer * ${stepNames.length} + ${index}, ${index}, ${toCStringLiteral(name)});`).join('\n')}
+}
+` : ''}
+// Shared customer pool (customers.dat): a header row, then one customer per
+// fixed ${CUSTOMER_RECORD_BYTES}-byte row. Every VU reads the same file, one row per iteration
+// into its own record buffer; the page cache holds the only copy.
+#define CUSTOMER_POOL ${toCStringLiteral(customerPool)}
+#define CUSTOMER_RECORD ${CUSTOMER_RECORD_BYTES}
+#define CUSTOMER_POOL_SIZE ${options.customerPoolSize || CUSTOMER_POOL_SIZE}
+#define CUSTOMER_STRIDE ${customerStride}
+// Customers per iteration, each with its own row (a batched request's profiles)
+#define CUSTOMER_BATCH ${batchSize}
+FILE* customer_pool;
+char customer_record[CUSTOMER_BATCH][CUSTOMER_RECORD + 1];
+char* customer_fields[4]; // first customer's name, email, segment, traffic source
+// Body slots of customer c's name, email and segment
+static const int customer_slot[CUSTOMER_BATCH][3] = {
+${Array.from({ length: batchSize }, (_, c) => `    { ${BATCH_PROFILE_FIELDS.map(field => `SLOT_${field.toUpperCase()}${c > 0 ? `_${c + 1}` : ''}`).join(', ')} }`).join(',\n')}
 };
 
-char* traffic_sources[] = {
-    "Google_Ads", "Facebook_Campaign", "Email_Newsletter", "Direct_Traffic",
-    "Referral_Partner", "Organic_Search", "Social_Media", "Content_Marketing"
-};
+// Customer c of an iteration is row ((iteration - 1) * CUSTOMER_STRIDE + VU - 1)
+// * CUSTOMER_BATCH + c, split in place; a VU that cannot read the pool keeps a
+// fixed customer
+void load_customer(int vuser_id, int iteration) {
+    int c, n;
+    char* p;
+    char* fields[4];
+    long first = ((long)(iteration - 1) * CUSTOMER_STRIDE + vuser_id - 1) * CUSTOMER_BATCH;
+    for (c = 0; c < CUSTOMER_BATCH; c++) {
+        long row = (first + c) % CUSTOMER_POOL_SIZE;
+        char* record = customer_record[c];
+        if (customer_pool == NULL || fseek(customer_pool, (row + 1) * CUSTOMER_RECORD, SEEK_SET) != 0 ||
+            fread(record, 1, CUSTOMER_RECORD, customer_pool) != CUSTOMER_RECORD) {
+            strcpy(record, "Load Test Customer,load.test@example.com,Standard,Direct_Traffic,");
+        }
+        record[CUSTOMER_RECORD] = '\\0';
+        n = 0;
+        p = record;
+        fields[n++] = p;
+        for (; *p && n < 4; p++) {
+            if (*p == ',') {
+                *p = '\\0';
+                fields[n++] = p + 1;
+            }
+        }
+        for (; *p && *p != ','; p++);
+        *p = '\\0';
+        set_slot(customer_slot[c][0], fields[0]);
+        set_slot(customer_slot[c][1], fields[1]);
+        set_slot(customer_slot[c][2], fields[2]);
+        if (c == 0) memcpy(customer_fields, fields, sizeof(fields));
+    }
+    lr_save_string(customer_fields[0], "customer_name");
+    lr_save_string(customer_fields[1], "customer_email");
+    lr_save_string(customer_fields[2], "customer_segment");
+    lr_save_string(customer_fields[3], "traffic_source");
+}
 
 int vuser_init() {
+    int prefix_len;
     lr_output_message("Starting LoadRunner test for ${companyName}");
     
     // Initialize LoadRunner variables with proper Dynatrace tagging
     lr_save_string("BizObs-Journey-LoadTest", "LSN");  // Load Script Name
     lr_save_string("${companyName}_Performance_Test_${timestamp}", "LTN");  // Load Test Name
     
-    // Generate unique customer profile for this virtual user
-    srand(time(NULL) + lr_get_vuser_id());
-    int customer_index = rand() % 16;
-    lr_save_string(customer_names[customer_index], "customer_name");
-    lr_save_string(customer_emails[customer_index], "customer_email");
-    lr_save_string(customer_segments[rand() % 6], "customer_segment");
-    lr_save_string(traffic_sources[rand() % 8], "traffic_source");
+    // Customers come from the shared pool, one row per iteration; unbuffered,
+    // so a VU holds nothing but its ${CUSTOMER_RECORD_BYTES}-byte record
+    customer_pool = fopen(CUSTOMER_POOL, "rb");
+    if (customer_pool == NULL) lr_error_message("Cannot open customer pool %s", CUSTOMER_POOL);
+    else setvbuf(customer_pool, NULL, _IONBF, 0);
     
     // Set web replay settings for better performance
     web_set_max_html_param_len("1024000");
     web_set_max_retries("3");
     web_set_timeout("Receive", 30);
     web_set_user_agent("LoadRunner-BizObs-Agent/1.0");
+${connectionReuse ? `    
+    // Connection reuse: one keep-alive connection per VU, VU-constant headers
+    // sent as auto headers instead of being re-added to every request
+    web_set_sockets_option("MAX_CONNECTIONS_PER_HOST", "1");
+    web_add_auto_header("Connection", "keep-alive");
+    web_add_auto_header("Content-Type", "application/json");
+    web_add_auto_header("User-Agent", "LoadRunner-BizObs-Agent/1.0");
+` : ''}    
+    // VU-constant part of the X-dynaTrace header, measured then formatted
+    prefix_len = snprintf(NULL, 0, ${JSON.stringify(dtHeader.prefixTemplate)}, lr_get_vuser_id());
+    dt_prefix = (char*)malloc(prefix_len + 1);
+    snprintf(dt_prefix, prefix_len + 1, ${JSON.stringify(dtHeader.prefixTemplate)}, lr_get_vuser_id());
+    
+    // This VU's stream of the seeded error schedule
+    err_vu_seed = err_mix(ERR_SEED ^ ((unsigned int)lr_get_vuser_id() * 0x9e3779b9u));
+    think_rng = err_mix(err_vu_seed ^ 0x5bd1e995u) | 1;
     
     return 0;
 }
 
 int vuser_end() {
     lr_output_message("Completed LoadRunner test for ${companyName} - Customer: {customer_name}");
+    lat_report();
+    lr_output_message("Request arena: %d bytes at the largest iteration", arena_high_water);
+    arena_free_chain();
+    free(dt_prefix);
+    if (customer_pool != NULL) fclose(customer_pool);
     return 0;
 }
 
 int Action() {
     int iteration = lr_get_iteration_number();
     int vuser_id = lr_get_vuser_id();
+    char* completion_time = arena_alloc(32);
+    time_t completion_clock;${batchSize > 1 ? `
+    int customer;` : ''}${connectionReuse ? `
+    char iteration_str[16];` : ''}
     
     // Generate unique correlation ID for each iteration
-    sprintf(correlation_id, "LR_${LTN}_%d_%d_%d", vuser_id, iteration, (int)time(NULL));
+    correlation_id = arena_printf("LR_%s_%d_%d_%d", ${toCStringLiteral(LTN)}, vuser_id, iteration, (int)time(NULL));
     lr_save_string(correlation_id, "correlation_id");
     
     // Generate customer and session IDs with unique values per test run
-    sprintf(customer_id, "customer_%d_%d_%d", vuser_id, iteration, (int)time(NULL) % 10000);
-    sprintf(session_id, "session_${LSN}_%d_%d", vuser_id, iteration);
-    sprintf(trace_id, "trace_%s_%d", correlation_id, (int)time(NULL));
+    customer_id = arena_printf("customer_%d_%d_%d", vuser_id, iteration, (int)time(NULL) % 10000);
+    session_id = arena_printf("session_%s_%d_%d", ${toCStringLiteral(LSN)}, vuser_id, iteration);
+    trace_id = arena_printf("trace_%s_%d", correlation_id, (int)time(NULL));
     
     lr_save_string(customer_id, "customer_id");
     lr_save_string(session_id, "session_id");
     lr_save_string(trace_id, "trace_id");
+    set_slot(SLOT_CORRELATION_ID, correlation_id);
+    set_slot(SLOT_CUSTOMER_ID, customer_id);
+    set_slot(SLOT_SESSION_ID, session_id);
+    set_slot(SLOT_TRACE_ID, trace_id);
+    load_customer(vuser_id, iteration);
+    log_iteration = LOG_INFO && (vuser_id + iteration) % LOG_SAMPLE == 0;
+    
+    // Per-iteration part of the X-dynaTrace header, with room for the longest
+    // TSN suffix; steps only swap the suffix
+    dt_tsn_offset = snprintf(NULL, 0, "%s%s;", dt_prefix, correlation_id);
+    dt_test_header = arena_alloc(dt_tsn_offset + DT_SUFFIX_MAX + 1);
+    snprintf(dt_test_header, dt_tsn_offset + 1, "%s%s;", dt_prefix, correlation_id);
     
+    // Steps this iteration fails, decided before any request goes out
+    err_plan_iteration(iteration);
+${connectionReuse ? `    
+    // Iteration-scoped auto headers; each call replaces the previous iteration's value
+    sprintf(iteration_str, "%d", iteration);
+    web_add_auto_header("x-correlation-id", correlation_id);
+    web_add_auto_header("x-customer-id", customer_id);
+    web_add_auto_header("x-session-id", session_id);
+    web_add_auto_header("x-trace-id", trace_id);
+    web_add_auto_header("x-test-iteration", iteration_str);
+    web_add_auto_header("x-customer-segment", customer_fields[2]);
+    web_add_auto_header("x-traffic-source", customer_fields[3]);
+` : ''}    
     // Set up LoadRunner parameters for LSN/TSN/LTN
     lr_save_string("${LSN}", "LSN");  // Load Script Name
     lr_save_string("${LTN}", "LTN");  // Load Test Name
     
     lr_start_transaction("Full_Customer_Journey");
-    lr_output_message("Starting journey for customer: {customer_name} ({customer_segment}) - Journey: %s", correlation_id);
+    log_info("Starting journey for customer: {customer_name} ({customer_segment}) - Journey: %s", correlation_id);
 `;
 
   // Capture errorSimulationEnabled for use in template strings
   const errorSimEnabled = errorSimulationEnabled;
 
   // Generate step-specific transactions using same format as single simulation
-  const stepTransactions = steps.map((step, index) => {
-    const stepName = step.stepName || step.name || `Step_${index + 1}`;
+  const stepTransaction = (index) => {
+    const step = steps[index];
+    const stepName = stepNames[index];
     const stepDescription = step.description || step.stepDescription || '';
     const serviceName = step.serviceName || `${stepName}Service`;
-    const estimatedDuration = step.estimatedDuration || step.duration || 5000;
-    const substeps = step.substeps || [];
-    
-    // Convert duration to seconds for think time
-    const thinkTimeSeconds = Math.floor(estimatedDuration / 1000) || 5;
-    
     return `
     // Step ${index + 1}: ${stepName} - ${stepDescription}
     lr_save_string("${stepName}", "TSN");  // Test Step Name for this step
     
-    // Build X-dynaTrace header with LSN, TSN, LTN (same format as single simulation)
-    sprintf(dt_test_header, "TSN=%s;LSN=%s;LTN=%s;VU=%d;SI=LoadRunner;PC=BizObs-Demo;AN=${companyName};CID=%s", 
-            "${stepName}", "${LSN}", "${LTN}", lr_get_vuser_id(), "{correlation_id}");
+    // X-dynaTrace header with LSN, TSN, LTN - only the TSN suffix changes per step
+    dt_set_step(${index});
     
     lr_start_transaction("${stepName}");
-    lr_output_message("Executing step: ${stepName} (Service: ${serviceName}) for {customer_name}");
+    log_info("Executing step: ${stepName} (Service: ${serviceName}) for {customer_name}");
     
     // Add all headers exactly as single simulation does
     web_add_header("X-dynaTrace", dt_test_header);
-    web_add_header("x-correlation-id", "{correlation_id}");
-    web_add_header("x-customer-id", "{customer_id}");
-    web_add_header("x-session-id", "{session_id}");
-    web_add_header("x-trace-id", "{trace_id}");
-    web_add_header("x-step-name", "${stepName}");
+${connectionReuse ? '' : sharedHeaders}    web_add_header("x-step-name", "${stepName}");
     web_add_header("x-service-name", "${serviceName}");
-    web_add_header("x-customer-segment", "{customer_segment}");
-    web_add_header("x-traffic-source", "{traffic_source}");
-    web_add_header("x-test-iteration", lr_eval_string("{pIteration}"));
-    web_add_header("Content-Type", "application/json");
-    web_add_header("User-Agent", "LoadRunner-BizObs-Agent/1.0");
+${connectionReuse ? '' : profileHeaders}    if (err_schedule[0]) web_add_header("x-error-schedule", err_schedule);
+    
+    // journey.stepTimings[0].stepStatus: a step the service failed still answers 200
+    lr_save_string("", "step_status");
+    web_reg_save_param_ex("ParamName=step_status", "LB=\\"stepStatus\\":\\"", "RB=\\"", "Ordinal=1", "NotFound=Warning", SEARCH_FILTERS, "Scope=Body", LAST);
     
     // Use exact journey format as single simulation - with journey.steps structure
     web_custom_request("${stepName}_Journey_Step",
@@ -188,51 +965,20 @@ int Action() {
         "Method=POST",
         "Resource=0",
         "RecContentType=application/json",
-        "Body="
-        "{"
-        "\\"journeyId\\": \\"{correlation_id}\\","
-        "\\"customerId\\": \\"{customer_id}\\","
-        "\\"sessionId\\": \\"{session_id}\\","
-        "\\"traceId\\": \\"{trace_id}\\","
-        "\\"chained\\": true,"
-        "\\"thinkTimeMs\\": 250,"
-        "\\"errorSimulationEnabled\\": ${errorSimEnabled ? 'true' : 'false'},"
-        "\\"journey\\": {"
-        "  \\"journeyId\\": \\"{correlation_id}\\","
-        "  \\"companyName\\": \\"${companyName}\\","
-        "  \\"domain\\": \\"${domain}\\","
-        "  \\"steps\\": ["
-        "    {"
-        "      \\"stepNumber\\": ${index + 1},"
-        "      \\"stepName\\": \\"${stepName}\\","
-        "      \\"serviceName\\": \\"${serviceName}\\","
-        "      \\"description\\": \\"${stepDescription}\\","
-        "      \\"estimatedDuration\\": ${estimatedDuration},"
-        "      \\"substeps\\": ${JSON.stringify(substeps)}"
-        "    }"
-        "  ],"
-        "  \\"additionalFields\\": ${JSON.stringify(additionalFields || {})},"
-        "  \\"customerProfile\\": {"
-        "    \\"name\\": \\"{customer_name}\\","
-        "    \\"email\\": \\"{customer_email}\\","
-        "    \\"segment\\": \\"{customer_segment}\\","
-        "    \\"userId\\": \\"{customer_id}\\","
-        "    \\"deviceType\\": \\"desktop\\","
-        "    \\"location\\": \\"US-East\\""
-        "  }"
-        "}"
-        "}",
+        render_body(&body_step_${index + 1}),
         LAST);
     
-    // Check response for errors and handle accordingly
-    if (atoi(lr_eval_string("{status}")) >= 400) {
-        lr_error_message("Step ${stepName} failed with status: %s", lr_eval_string("{status}"));
+    lat_record(${index}, lr_get_transaction_duration("${stepName}"));
+    
+    // The service decides failures (x-error-schedule or feature flags); book what it answered
+    if (web_get_int_property(HTTP_INFO_RETURN_CODE) >= 400 || strcmp(lr_eval_string("{step_status}"), "failed") == 0) {
+        lr_error_message("Step ${stepName} failed: HTTP %d, status %s", web_get_int_property(HTTP_INFO_RETURN_CODE), lr_eval_string("{step_status}"));
         lr_end_transaction("${stepName}", LR_FAIL);
     } else {
         lr_end_transaction("${stepName}", LR_PASS);
     }
     
-    // Clear headers for next request
+${connectionReuse ? '' : `    // Clear headers for next request
     web_cleanup_cookies();
     web_revert_auto_header("x-dynatrace-test");
     web_revert_auto_header("x-correlation-id");
@@ -244,58 +990,177 @@ int Action() {
     web_revert_auto_header("x-traffic-source");
     web_revert_auto_header("x-test-iteration");
     
-    lr_end_transaction("{TSN}", LR_AUTO);
-    lr_output_message("Completed step: {TSN} - Response time: %d ms", lr_get_transaction_duration("{TSN}"));
+`}    lr_end_transaction("{TSN}", LR_AUTO);
+    log_info("Completed step: {TSN} - Response time: %d ms", lr_get_transaction_duration("{TSN}"));
     
-    // Variable think time based on step complexity
-    lr_think_time(${thinkTimeSeconds});
+    // Think time drawn around this step's compressed estimatedDuration
+    lr_think_time(think_time_sample(${index}));
 `;
-  }).join('\n');
+  };
+
+  // A parallel group: every member's request in one concurrent group, then a
+  // transaction per member from the server-side timings its response carried
+  const concurrentStepGroup = (group) => {
+    const names = group.map(index => stepNames[index]);
+    const last = group[group.length - 1];
+    return `
+    // Steps ${group[0] + 1}-${last + 1}: parallel group ${toCStringLiteral(parallelGroupOf(steps[group[0]]))} (${names.join(', ')}), sent concurrently
+    log_info("Executing parallel steps: ${names.join(', ')} for {customer_name}");
+${group.map(index => `    lr_save_string("", "step_status_${index + 1}");
+    lr_save_string("", "step_ms_${index + 1}");`).join('\n')}
+    
+    web_concurrent_start(NULL);
+${group.map(index => {
+    const step = steps[index];
+    const stepName = stepNames[index];
+    return `    
+    // ${stepName}: X-dynaTrace carries its own TSN
+    dt_set_step(${index});
+    web_add_header("X-dynaTrace", dt_test_header);
+${connectionReuse ? '' : sharedHeaders}    web_add_header("x-step-name", "${stepName}");
+    web_add_header("x-service-name", "${step.serviceName || `${stepName}Service`}");
+${connectionReuse ? '' : profileHeaders}    if (err_schedule[0]) web_add_header("x-error-schedule", err_schedule);
+    web_reg_save_param_ex("ParamName=step_status_${index + 1}", "LB=\\"stepStatus\\":\\"", "RB=\\"", "Ordinal=1", "NotFound=Warning", SEARCH_FILTERS, "Scope=Body", LAST);
+    web_reg_save_param_ex("ParamName=step_ms_${index + 1}", "LB=\\"durationMs\\":", "RB=}", "Ordinal=1", "NotFound=Warning", SEARCH_FILTERS, "Scope=Body", LAST);
+    web_custom_request("${stepName}_Journey_Step",
+        "URL=http://localhost:8080/api/journey-simulation/simulate-journey",
+        "Method=POST",
+        "Resource=0",
+        "RecContentType=application/json",
+        render_body(&body_step_${index + 1}),
+        LAST);`;
+  }).join('\n')}
+    
+    web_concurrent_end(NULL);
+    
+${group.map(index => `    report_concurrent_step(${index}, ${toCStringLiteral(stepNames[index])});`).join('\n')}
+${connectionReuse ? '' : `    web_cleanup_cookies();
+`}    
+    // One think time for the group, drawn for its last step
+    lr_think_time(think_time_sample(${last}));
+`;
+  };
+
+  const stepTransactions = stepGroups(steps)
+    .map(group => (group.length === 1 ? stepTransaction(group[0]) : concurrentStepGroup(group)))
+    .join('\n');
+
+  // Whole journey in one request: the first service chains the rest itself
+  // (thinkTimeMs apart) and the response carries one stepTimings entry per step
+  const chainedJourneyRequest = () => {
+    const [firstStep = {}] = steps;
+
+    return `
+    // Whole journey (${steps.length} steps) in one chained request${batchSize > 1 ? `, for ${batchSize} customers` : ''}
+    dt_set_step(DT_STEP_JOURNEY);
+    log_info("Executing chained journey (${steps.length} steps) for {customer_name}${batchSize > 1 ? ` and ${batchSize - 1} more` : ''}");
+    
+    web_add_header("X-dynaTrace", dt_test_header);
+${connectionReuse ? '' : sharedHeaders}    web_add_header("x-step-name", ${toCStringLiteral(stepNames[0] || '')});
+    web_add_header("x-service-name", ${toCStringLiteral(firstStep.serviceName || `${stepNames[0] || ''}Service`)});
+${connectionReuse ? '' : profileHeaders}    if (err_schedule[0]) web_add_header("x-error-schedule", err_schedule);
+    
+    // journey.stepTimings: {"stepName":..,"stepStatus":"completed","httpStatus":200,"durationMs":123}
+    web_reg_save_param_ex("ParamName=step_status", "LB=\\"stepStatus\\":\\"", "RB=\\"", "Ordinal=All", "NotFound=Warning", SEARCH_FILTERS, "Scope=Body", LAST);
+    web_reg_save_param_ex("ParamName=step_ms", "LB=\\"durationMs\\":", "RB=}", "Ordinal=All", "NotFound=Warning", SEARCH_FILTERS, "Scope=Body", LAST);
+    
+    web_custom_request("Chained_Journey",
+        "URL=http://localhost:8080/api/journey-simulation/${batchSize > 1 ? 'simulate-batch-chained' : 'simulate-journey'}",
+        "Method=POST",
+        "Resource=0",
+        "RecContentType=application/json",
+        render_body(&body_journey),
+        LAST);
+    
+    if (web_get_int_property(HTTP_INFO_RETURN_CODE) >= 400) {
+        lr_error_message("Chained journey failed with status: %d", web_get_int_property(HTTP_INFO_RETURN_CODE));
+    }
+    
+    // One transaction per TSN${batchSize > 1 ? ' and customer' : ''}, duration injected from the server-side timings
+${batchSize > 1
+    ? '    for (customer = 0; customer < JOURNEY_BATCH; customer++) report_chained_journey(customer);'
+    : '    report_chained_journey(0);'}
+`;
+  };
 
   const scriptFooter = `
     lr_end_transaction("Full_Customer_Journey", LR_AUTO);
     
     // Log completion with full context
-    lr_output_message("Journey completed for {customer_name} - Total time: %d ms, Correlation: {correlation_id}", 
-                     lr_get_transaction_duration("Full_Customer_Journey"));
+    log_info("Journey completed for {customer_name} - Total time: %d ms, Correlation: {correlation_id}",
+             lr_get_transaction_duration("Full_Customer_Journey"));
     
     // Optional: Add business events for completion tracking
-    web_add_header("x-dynatrace-test", dt_test_header);
-    web_add_header("x-correlation-id", "{correlation_id}");
+    time(&completion_clock);
+    strftime(completion_time, 32, "%Y-%m-%dT%H:%M:%SZ", gmtime(&completion_clock));
+    set_slot(SLOT_COMPLETION_TIME, completion_time);
+    dt_set_step(DT_STEP_COMPLETION);
+    web_add_header("X-dynaTrace", dt_test_header);
+${connectionReuse ? '' : `    web_add_header("x-correlation-id", "{correlation_id}");
     web_add_header("Content-Type", "application/json");
-    
+`}    
     web_custom_request("Journey_Completion_Event",
         "URL=http://localhost:8080/api/journey-simulation/simulate-journey",
         "Method=POST",
         "Resource=0",
         "RecContentType=application/json",
-        "Body="
-        "{"
-        "\\"eventType\\": \\"journey_completed\\","
-        "\\"correlationId\\": \\"{correlation_id}\\","
-        "\\"customerId\\": \\"{customer_id}\\","
-        "\\"companyName\\": \\"${companyName}\\","
-        "\\"customerName\\": \\"{customer_name}\\","
-        "\\"customerSegment\\": \\"{customer_segment}\\","
-        "\\"totalSteps\\": ${steps.length},"
-        "\\"loadTest\\": true,"
-        "\\"completionTime\\": \\"" + lr_eval_string("{TimeNow}") + "\\""
-        "}",
+        render_body(&body_completion),
         LAST);
     
+    // Everything this iteration formatted goes at once
+    arena_reset();
     return 0;
 }`;
 
-  return scriptHeader + stepTransactions + scriptFooter;
+  return scriptHeader + (chainedJourney ? chainedJourneyRequest() : stepTransactions) + scriptFooter;
 }
 
 /**
  * Generate LoadRunner scenario file for sequential load simulation
+ *
+ * testConfig.arrivalModel 'closed' (default) runs `vusers` looping with
+ * journeyInterval pacing. 'open' sets a Full_Customer_Journey/sec goal that
+ * follows the scenario's ramp/plateau/ramp-down curve, with `vusers` as the
+ * ceiling, so offered load does not drop when the server slows down.
  */
 function generateScenarioFile(journeyConfig, testConfig, scriptPath) {
-  const { journeyInterval, duration } = testConfig;
+  const { journeyInterval, duration, rampUp = 10, rampDown = 10, arrivalModel = 'closed' } = testConfig;
   const totalJourneys = Math.floor(duration / journeyInterval);
-  
+  const vusers = testConfig.vusers || Math.max(1, totalJourneys);
+
+  let groupContent;
+  let runtimeContent;
+  if (arrivalModel === 'open') {
+    const arrivals = buildArrivalSchedule(testConfig);
+    // A batched iteration is one Full_Customer_Journey for batchSize customers
+    const batch = testConfig.batchSize > 1 ? testConfig.batchSize : 1;
+    groupContent = `LoadBehavior=goal
+Goal=TransactionsPerSecond
+GoalTransaction=Full_Customer_Journey
+GoalValue=${arrivals.rate / batch}
+MinVUsers=1
+MaxVUsers=${vusers}
+RampUp=${rampUp}
+Duration=${duration}
+RampDown=${rampDown}
+IterationDelay=0
+
+[Arrival Schedule: Group1]
+${arrivals.points.map(([t, rate], i) => `Point${i + 1}=${t},${rate / batch}`).join('\n')}`;
+    runtimeContent = `IterationDelay=Off
+MaxIterations=${Math.ceil(arrivals.totalJourneys / batch)}`;
+  } else {
+    groupContent = `LoadBehavior=basic
+VUsers=${vusers}
+RampUp=${rampUp}
+Duration=${duration}
+RampDown=${rampDown}
+IterationDelay=${journeyInterval}`;
+    runtimeContent = `IterationDelay=Fixed
+IterationDelaySeconds=${journeyInterval}
+MaxIterations=${totalJourneys}`;
+  }
+
   const scenarioContent = `[General]
 Version=1
 
@@ -305,24 +1170,16 @@ Group1=1
 [Group: Group1]
 Scripts=BizObsJourneyTest
 ScalabilityMode=1
-LoadBehavior=goal
-Goal=VUsersPerSec
-GoalValue=1
-RampUp=10
-Duration=${duration}
-RampDown=10
-IterationDelay=${journeyInterval}
+${groupContent}
 
 [Scripts]
 BizObsJourneyTest=${scriptPath}
 
 [Runtime Settings]
 ThinkTime=On
-IterationDelay=Fixed
-IterationDelaySeconds=${journeyInterval}
+${runtimeContent}
 AutomaticTransactions=1
 FailOnHttpErrors=1
-MaxIterations=${totalJourneys}
 `;
 
   return scenarioContent;
@@ -333,39 +1190,20 @@ MaxIterations=${totalJourneys}
  */
 function generateCurlSimulation(journeyConfig, testConfig, testDir, errorSimulationEnabled = true) {
   const { journeyInterval, duration } = testConfig;
+  // Above 1, each tick posts this many customers to /simulate-batch-chained
+  const batchSize = Math.max(1, Math.floor(testConfig.batchSize || 1));
+  // Customer i of journey j is pool row j * batchSize + i
+  const batchEntries = Array.from({ length: batchSize }, (_, i) =>
+    `    { "journeyId": "\$correlation_id-${i + 1}", "correlationId": "\$correlation_id-${i + 1}", "customerId": "\$customer_id-${i + 1}", "sessionId": "\$session_id-${i + 1}", "traceId": "\$trace_id-${i + 1}", "customerProfile": $(batch_profile $(( journey_number * ${batchSize} + ${i} )) "\$customer_id-${i + 1}") }`
+  ).join(',\n');
   const { companyName, domain, steps = [], journeyType, industryType } = journeyConfig;
   const testId = crypto.randomUUID();
   const timestamp = new Date().toISOString().replace(/[:.]/g, '-');
+  const log = logSettings(testConfig.logLevel, testConfig.logSample);
   
-  // Demo customer data for realistic simulation - different customers for each test
-  const customerProfiles = [
-    { name: "Sarah Johnson", email: "sarah.johnson@email.com", segment: "Premium", source: "Google_Ads" },
-    { name: "Michael Chen", email: "michael.chen@email.com", segment: "Standard", source: "Facebook_Campaign" },
-    { name: "Emma Rodriguez", email: "emma.rodriguez@email.com", segment: "Budget", source: "Email_Newsletter" },
-    { name: "David Kim", email: "david.kim@email.com", segment: "Enterprise", source: "Direct_Traffic" },
-    { name: "Ashley Thompson", email: "ashley.thompson@email.com", segment: "SMB", source: "Referral_Partner" },
-    { name: "Robert Martinez", email: "robert.martinez@email.com", segment: "Startup", source: "Organic_Search" },
-    { name: "Jennifer Lee", email: "jennifer.lee@email.com", segment: "Premium", source: "Social_Media" },
-    { name: "Christopher Brown", email: "christopher.brown@email.com", segment: "Standard", source: "Content_Marketing" },
-    { name: "Amanda Wilson", email: "amanda.wilson@email.com", segment: "Budget", source: "Google_Ads" },
-    { name: "Joshua Garcia", email: "joshua.garcia@email.com", segment: "Enterprise", source: "Facebook_Campaign" },
-    { name: "Melissa Davis", email: "melissa.davis@email.com", segment: "Premium", source: "Email_Newsletter" },
-    { name: "Andrew Miller", email: "andrew.miller@email.com", segment: "Standard", source: "Direct_Traffic" },
-    { name: "Jessica Anderson", email: "jessica.anderson@email.com", segment: "SMB", source: "Referral_Partner" },
-    { name: "Kevin Taylor", email: "kevin.taylor@email.com", segment: "Startup", source: "Organic_Search" },
-    { name: "Lauren Thomas", email: "lauren.thomas@email.com", segment: "Premium", source: "Social_Media" },
-    { name: "Brian Jackson", email: "brian.jackson@email.com", segment: "Standard", source: "Content_Marketing" }
-  ];
-
   // Generate LSN/LTN for consistent Dynatrace tagging
-  const LSN = `BizObs_${companyName.replace(/\s+/g, '')}_${domain}_Journey`;
-  const LTN = `${companyName.replace(/\s+/g, '')}_LoadTest_${timestamp.split('T')[0].replace(/-/g, '')}`;
+  const { LSN, LTN } = buildDynatraceTags(companyName, domain, timestamp);
 
-  const trafficSources = [
-    "Google_Ads", "Facebook_Campaign", "Email_Newsletter", "Direct_Traffic",
-    "Referral_Partner", "Organic_Search", "Social_Media", "Content_Marketing"
-  ];
-  
   const curlScript = `#!/bin/bash
 # BizObs LoadRunner Simulation Script with Dynatrace Integration
 # Generated: ${new Date().toISOString()}
@@ -391,16 +1229,38 @@ echo "🎯 Expected Journeys: $TOTAL_JOURNEYS (one every ${journeyInterval}s)"
 echo "🏷️  Load Test Name: $LTN"
 echo "📝 Load Script Name: $LSN"
 
-# Create results directory
-RESULTS_DIR="${testDir}/results"
-mkdir -p "$RESULTS_DIR"
+# Journey lines for 1 in LOG_SAMPLE journeys (none at log level error); the
+# HTTP result line each journey log ends with is always written
+LOG_INFO=${log.level === 'info' ? 1 : 0}
+LOG_SAMPLE=${log.sample}
+logs_journey() { [ "$LOG_INFO" = 1 ] && [ $(( $1 % LOG_SAMPLE )) -eq 0 ]; }
 
-# Demo customer profiles
-declare -a CUSTOMER_NAMES=(${customerProfiles.map(p => `"${p.name}"`).join(' ')})
-declare -a CUSTOMER_EMAILS=(${customerProfiles.map(p => `"${p.email}"`).join(' ')})
-declare -a CUSTOMER_SEGMENTS=(${customerProfiles.map(p => `"${p.segment}"`).join(' ')})
-declare -a TRAFFIC_SOURCES=(${trafficSources.map(s => `"${s}"`).join(' ')})
+# Create results directory (per run; the script itself is shared by every run)
+RESULTS_DIR="\${RESULTS_DIR:-$PWD/results}"
+mkdir -p "$RESULTS_DIR"
 
+# Shared customer pool: header row, then one ${CUSTOMER_RECORD_BYTES}-byte row per customer
+CUSTOMER_POOL="${path.join(testDir, CUSTOMER_POOL_FILE)}"
+CUSTOMER_POOL_SIZE=$(( $(stat -L -c %s "$CUSTOMER_POOL" 2>/dev/null || echo ${CUSTOMER_RECORD_BYTES * 2}) / ${CUSTOMER_RECORD_BYTES} - 1 ))
+
+# Row $1 of the pool into the caller's customer_* locals
+read_customer() {
+    IFS=, read -r customer_name customer_email customer_segment traffic_source customer_location _ < <(
+        dd if="$CUSTOMER_POOL" bs=${CUSTOMER_RECORD_BYTES} skip=$(( $1 % CUSTOMER_POOL_SIZE + 1 )) count=1 2>/dev/null)
+    if [ -z "$customer_name" ]; then
+        customer_name="Load Test Customer"; customer_email="load.test@example.com"
+        customer_segment="Standard"; traffic_source="Direct_Traffic"; customer_location="US-East"
+    fi
+}
+${batchSize > 1 ? `
+# Profile JSON of pool row $1 for batched customer id $2
+batch_profile() {
+    local customer_name customer_email customer_segment traffic_source customer_location
+    read_customer "$1"
+    printf '{ "name": "%s", "email": "%s", "segment": "%s", "userId": "%s", "deviceType": "desktop", "location": "%s" }' \\
+        "$customer_name" "$customer_email" "$customer_segment" "$2" "$customer_location"
+}
+` : ''}
 # Start timestamp
 START_TIME=$(date +%s)
 END_TIME=$((START_TIME + DURATION))
@@ -410,16 +1270,16 @@ execute_customer_journey() {
     local journey_number=$1
     local log_file="$RESULTS_DIR/journey_$journey_number.log"
     
-    # Assign unique customer profile for this journey
-    local customer_index=$((journey_number % ${customerProfiles.length}))
-    local customer_name="\${CUSTOMER_NAMES[$customer_index]}"
-    local customer_email="\${CUSTOMER_EMAILS[$customer_index]}"
-    local customer_segment="\${CUSTOMER_SEGMENTS[$customer_index]}"
-    local traffic_source="\${TRAFFIC_SOURCES[$((RANDOM % ${trafficSources.length}))]}"
+    # This journey's customer: pool row journey_number${batchSize > 1 ? ` * ${batchSize}, the batch's first` : ''}
+    local customer_name customer_email customer_segment traffic_source customer_location
+    read_customer "${batchSize > 1 ? `$(( journey_number * ${batchSize} ))` : '$journey_number'}"
     
     local journey_start=$(date +%s)
     
-    echo "$(date): Starting journey $journey_number - Customer: $customer_name ($customer_segment)" >> "$log_file"
+    local log_info=0
+    logs_journey "$journey_number" && log_info=1
+    
+    [ $log_info = 1 ] && echo "$(date): Starting journey $journey_number - Customer: $customer_name ($customer_segment)" >> "$log_file"
     
     # Generate unique correlation ID for this customer journey
     local correlation_id="LR_\${LTN}_Journey_\${journey_number}_$(date +%s)"
@@ -427,7 +1287,7 @@ execute_customer_journey() {
     local session_id="session_\${LSN}_journey_\${journey_number}"
     local trace_id="trace_\${correlation_id}_$(date +%s)"
     
-    echo "$(date): Journey \$journey_number - Customer: \$customer_name - Correlation: \$correlation_id" >> "$log_file"
+    [ $log_info = 1 ] && echo "$(date): Journey \$journey_number - Customer: \$customer_name - Correlation: \$correlation_id" >> "$log_file"
         
         # Execute complete journey using same format as single simulation
         JOURNEY_PAYLOAD=$(cat <<EOF
@@ -453,9 +1313,12 @@ execute_customer_journey() {
       "segment": "\$customer_segment",
       "userId": "\$customer_id",
       "deviceType": "desktop",
-      "location": "US-East"
+      "location": "\$customer_location"
     }
-  }
+  }${batchSize > 1 ? `,
+  "batch": [
+${batchEntries}
+  ]` : ''}
 }
 EOF
 )
@@ -463,7 +1326,7 @@ EOF
         # Build X-dynaTrace header with LSN/TSN/LTN (same format as single simulation)
         DYNATRACE_HEADER="TSN=Full_Journey;LSN=${LSN};LTN=${LTN};VU=\$journey_number;SI=CurlSimulation;PC=BizObs-Demo;AN=${companyName};CID=\$correlation_id"
         
-        echo "$(date): Journey \$journey_number starting full journey for \$customer_name" >> "$log_file"
+        [ $log_info = 1 ] && echo "$(date): Journey \$journey_number starting full journey for \$customer_name" >> "$log_file"
         
         RESPONSE_TIME_START=$(date +%s%3N)
         HTTP_CODE=$(curl -s -w "%{http_code}" -o /dev/null \\
@@ -479,7 +1342,7 @@ EOF
             -H "x-test-iteration: \$journey_number" \\
             -H "User-Agent: LoadRunner-BizObs-Agent/1.0" \\
             -d "\$JOURNEY_PAYLOAD" \\
-            "\$BASE_URL/api/journey-simulation/simulate-journey")
+            "\$BASE_URL/api/journey-simulation/${batchSize > 1 ? 'simulate-batch-chained' : 'simulate-journey'}")
         
         RESPONSE_TIME_END=$(date +%s%3N)
         RESPONSE_TIME=$((RESPONSE_TIME_END - RESPONSE_TIME_START))
@@ -507,7 +1370,8 @@ EOF
     
     local journey_end=$(date +%s)
     local journey_time=$((journey_end - journey_start))
-    echo "$(date): Journey \$journey_number completed for \$customer_name in \${journey_time}s" >> "$log_file"
+    [ $log_info = 1 ] && echo "$(date): Journey \$journey_number completed for \$customer_name in \${journey_time}s" >> "$log_file"
+    return 0
 }
 
 # Execute sequential customer journeys
@@ -515,7 +1379,7 @@ journey_number=1
 echo "$(date): Starting sequential load simulation..."
 
 while [ $(date +%s) -lt $END_TIME ] && [ $journey_number -le $TOTAL_JOURNEYS ]; do
-    echo "$(date): Executing customer journey $journey_number of $TOTAL_JOURNEYS"
+    logs_journey "$journey_number" && echo "$(date): Executing customer journey $journey_number of $TOTAL_JOURNEYS"
     
     # Execute journey in background to allow for next journey scheduling
     execute_customer_journey $journey_number &
@@ -526,7 +1390,7 @@ while [ $(date +%s) -lt $END_TIME ] && [ $journey_number -le $TOTAL_JOURNEYS ];
     
     # Wait for journey interval before starting next journey
     if [ $journey_number -le $TOTAL_JOURNEYS ] && [ $(date +%s) -lt $END_TIME ]; then
-        echo "$(date): Waiting ${journeyInterval}s before next journey..."
+        logs_journey "$journey_number" && echo "$(date): Waiting ${journeyInterval}s before next journey..."
         sleep $JOURNEY_INTERVAL
     fi
 done
@@ -607,17 +1471,68 @@ echo "✅ Test summary generated: \"$RESULTS_DIR/test_summary.html\""
   return curlScript;
 }
 
+/**
+ * Generate every driver's artifacts for one test into `scratch`, naming
+ * `dir` (where the artifact cache moves them) in the paths they embed.
+ */
+async function writeTestArtifacts(scratch, dir, journeyConfig, testConfig, errorSimulationEnabled, { journeyMode, connectionReuse }) {
+  // Every driver steps through the shared customer pool, linked in as customers.dat
+  let customerPool = CUSTOMER_POOL_FILE;
+  try {
+    await linkCustomerPool(scratch);
+    customerPool = path.join(dir, CUSTOMER_POOL_FILE);
+  } catch (e) {
+    console.warn(`[LoadRunner] ⚠️ Customer pool unavailable, drivers fall back to built-in customers: ${e.message}`);
+  }
+
+  // Generate LoadRunner script
+  const lrScript = generateLoadRunnerScript(journeyConfig, testConfig, errorSimulationEnabled, {
+    journeyMode, connectionReuse, batchSize: testConfig.batchSize, customerPool
+  });
+  await fs.writeFile(path.join(scratch, 'BizObsJourneyTest.c'), lrScript);
+
+  // Generate scenario file
+  const scenarioContent = generateScenarioFile(journeyConfig, testConfig, path.join(dir, 'BizObsJourneyTest.c'));
+  await fs.writeFile(path.join(scratch, 'BizObsJourney.lrs'), scenarioContent);
+
+  // Generate curl simulation as fallback
+  const curlScript = generateCurlSimulation(journeyConfig, testConfig, dir, errorSimulationEnabled);
+  const curlScriptPath = path.join(scratch, 'run_simulation.sh');
+  await fs.writeFile(curlScriptPath, curlScript);
+  await fs.chmod(curlScriptPath, '755');
+
+  // Journey config for the native engine (same shape the LoadRunner manager writes)
+  await fs.writeFile(path.join(scratch, 'test-config.json'), JSON.stringify(journeyConfig, null, 2));
+  // ...and the script's compiled bodies, so both drivers send the same bytes
+  await fs.writeFile(path.join(scratch, 'body-templates.json'),
+    JSON.stringify(compileJourneyBodies(journeyConfig, errorSimulationEnabled), null, 2));
+}
+
 /**
  * Start LoadRunner test from JSON journey
  */
 router.post('/start-test', async (req, res) => {
+  // Pinned artifacts, released by the test process's 'close' once it has one
+  let artifacts = null;
+  let releaseOnClose = false;
   try {
     const {
       journeyConfig,
       testProfile = 'medium',
       durationMinutes = 5,
       customConfig = null,
-      errorSimulationEnabled = false
+      errorSimulationEnabled = false,
+      journeyMode = 'per-step',  // 'chained': whole journey in one request per iteration
+      connectionReuse = false,   // one keep-alive connection per VU
+      scenario = SCENARIO_PROFILES[testProfile],
+      arrivalModel,              // 'open' | 'closed'; defaults to the scenario's arrival_model
+      seed,                      // error schedule seed; reuse one to replay the same failures, derived from the inputs when unset
+      thinkDistribution,         // 'fixed' | 'exponential' | 'lognormal'; defaults to the scenario's
+      timeCompression,           // divide think time by this; defaults to the scenario's, then 60
+      batchSize,                 // customers per request (chained); defaults to the scenario's batch_size, then 1
+      logLevel,                  // 'info' | 'error'; defaults to the scenario's log_level, then LOADTEST_LOG_LEVEL
+      logSample,                 // info lines for 1 in N iterations; defaults to log_sample, then LOADTEST_LOG_SAMPLE
+      warmUp = true              // start and health-check every step service before the load
     } = req.body;
 
     if (!journeyConfig || !journeyConfig.steps || journeyConfig.steps.length === 0) {
@@ -627,35 +1542,59 @@ router.post('/start-test', async (req, res) => {
       });
     }
 
-    // Get test configuration
+    // Get test configuration; the scenario profile adds vusers, ramps and the
+    // arrival target, durationMinutes stays the plateau length
+    const schedule = await loadScenarioSchedule(scenario);
     const testConfig = customConfig || {
       ...LOADRUNNER_CONFIGS[testProfile],
+      ...schedule,
       duration: durationMinutes * 60
     };
+    testConfig.arrivalModel = arrivalModel === 'open' || arrivalModel === 'closed'
+      ? arrivalModel
+      : (testConfig.arrivalModel || 'closed');
+    if (THINK_DISTRIBUTIONS.includes(thinkDistribution)) testConfig.thinkDistribution = thinkDistribution;
+    if (!THINK_DISTRIBUTIONS.includes(testConfig.thinkDistribution)) testConfig.thinkDistribution = 'fixed';
+    if (Number(timeCompression) > 0) testConfig.timeCompression = Number(timeCompression);
+    if (!(testConfig.timeCompression > 0)) testConfig.timeCompression = DEFAULT_TIME_COMPRESSION;
+    if (Number(batchSize) >= 1) testConfig.batchSize = Math.floor(Number(batchSize));
+    if (!(testConfig.batchSize >= 1)) testConfig.batchSize = 1;
+    const log = logSettings(logLevel ?? testConfig.logLevel, logSample ?? testConfig.logSample);
+    testConfig.logLevel = log.level;
+    testConfig.logSample = log.sample;
 
     const testId = crypto.randomUUID();
     const timestamp = new Date().toISOString().replace(/[:.]/g, '-');
-    const testDir = path.join(__dirname, '..', 'loadrunner-tests', `${journeyConfig.companyName || 'test'}_${timestamp}`);
-
-    // Create test directory
+    const { LSN, LTN } = buildDynatraceTags(journeyConfig.companyName || 'test', journeyConfig.domain || 'default.com', timestamp);
+
+    // Everything the artifacts are generated from. LTN carries the date, so
+    // a script is never reused with another day's test name
+    const explicitSeed = Number.isInteger(seed) && seed > 0 ? seed : null;
+    const cacheKey = artifactKey({
+      journeyConfig, testConfig, errorSimulationEnabled: !!errorSimulationEnabled,
+      journeyMode, connectionReuse: !!connectionReuse, seed: explicitSeed, LTN,
+      customerPoolSize: CUSTOMER_POOL_SIZE
+    });
+    // Shared by the generated script and the native engine, so both drivers
+    // (and any rerun with this seed) schedule the same step failures. Without
+    // one, the seed follows the inputs: a rerun replays the cached schedule
+    testConfig.errorSeed = explicitSeed || parseInt(cacheKey.slice(0, 8), 16) % (2 ** 31 - 1) + 1;
+
+    artifacts = await artifactCache.acquire(journeyConfig.companyName, cacheKey, (scratch, dir) =>
+      writeTestArtifacts(scratch, dir, journeyConfig, testConfig, errorSimulationEnabled, { journeyMode, connectionReuse }));
+    const scriptPath = path.join(artifacts.dir, 'BizObsJourneyTest.c');
+    const scenarioPath = path.join(artifacts.dir, 'BizObsJourney.lrs');
+    const curlScriptPath = path.join(artifacts.dir, 'run_simulation.sh');
+    const engineConfigPath = path.join(artifacts.dir, 'test-config.json');
+    const bodyTemplatesPath = path.join(artifacts.dir, 'body-templates.json');
+    const customerPoolPath = path.join(artifacts.dir, CUSTOMER_POOL_FILE);
+    const customerPoolLinked = await fs.access(customerPoolPath).then(() => true, () => false);
+    console.log(`[LoadRunner] ${artifacts.hit ? 'Reusing' : 'Generated'} test artifacts ${artifacts.dir}`);
+
+    // Output and results of this run; the artifacts are shared by every run
+    const testDir = path.join(artifacts.dir, 'runs', timestamp);
     await fs.mkdir(testDir, { recursive: true });
 
-    // Generate LoadRunner script
-    const lrScript = generateLoadRunnerScript(journeyConfig, testConfig, errorSimulationEnabled);
-    const scriptPath = path.join(testDir, 'BizObsJourneyTest.c');
-    await fs.writeFile(scriptPath, lrScript);
-
-    // Generate scenario file
-    const scenarioContent = generateScenarioFile(journeyConfig, testConfig, scriptPath);
-    const scenarioPath = path.join(testDir, 'BizObsJourney.lrs');
-    await fs.writeFile(scenarioPath, scenarioContent);
-
-    // Generate curl simulation as fallback
-    const curlScript = generateCurlSimulation(journeyConfig, testConfig, testDir, errorSimulationEnabled);
-    const curlScriptPath = path.join(testDir, 'run_simulation.sh');
-    await fs.writeFile(curlScriptPath, curlScript);
-    await fs.chmod(curlScriptPath, '755');
-
     // Create test metadata
     const testMetadata = {
       testId,
@@ -663,29 +1602,46 @@ router.post('/start-test', async (req, res) => {
       journeyConfig,
       testConfig,
       testDir,
+      artifactDir: artifacts.dir,
+      artifactKey: cacheKey,
+      artifactCacheHit: artifacts.hit,
       scriptPath,
       scenarioPath,
       curlScriptPath,
+      journeyMode,
+      connectionReuse,
+      batchSize: testConfig.batchSize,
       status: 'initialized'
     };
 
     activeTests.set(testId, testMetadata);
 
-    // Try to detect LoadRunner installation
-    let loadRunnerAvailable = false;
-    try {
-      await new Promise((resolve, reject) => {
-        exec('which mmdrv || which wlrun', (error, stdout) => {
-          if (error) reject(error);
-          else resolve(stdout);
-        });
+    // Cold starts belong to the warm-up, not the first minute of results
+    if (warmUp) {
+      testMetadata.status = 'warming-up';
+      testMetadata.warmUp = await warmUpServices(journeyConfig.steps, {
+        companyName: journeyConfig.companyName || 'DefaultCompany',
+        domain: journeyConfig.domain || 'default.com',
+        industryType: journeyConfig.industryType || 'general',
+        journeyType: journeyConfig.journeyType || ''
       });
-      loadRunnerAvailable = true;
-    } catch (e) {
-      console.log('[LoadRunner] LoadRunner not detected, will use curl simulation');
+      if (!testMetadata.warmUp.ready) {
+        console.warn(`[LoadRunner] ⚠️ Warm-up incomplete for ${testId}, starting load anyway`);
+      }
     }
 
-    // Start the test
+    const tools = await driverTools;
+    const loadRunnerAvailable = tools.loadRunner;
+    let nativeEngineAvailable = false;
+    if (!loadRunnerAvailable) {
+      nativeEngineAvailable = tools.nativeEngine || (tools.nativeEngine = await canExecute(LOADGEN_BIN));
+      if (!nativeEngineAvailable) {
+        console.log(`[LoadRunner] Neither LoadRunner nor the native engine (${LOADGEN_BIN}) found, using curl simulation`);
+      }
+    }
+
+    // Start the test; startTime..loadStartTime is the warm-up
+    testMetadata.loadStartTime = new Date().toISOString();
     let testProcess;
     if (loadRunnerAvailable) {
       // Start LoadRunner test
@@ -694,6 +1650,55 @@ router.post('/start-test', async (req, res) => {
         stdio: ['pipe', 'pipe', 'pipe']
       });
       testMetadata.method = 'loadrunner';
+    } else if (nativeEngineAvailable) {
+      const journeyInterval = testConfig.journeyInterval || 30;
+      const totalJourneys = Math.max(1, Math.floor(testConfig.duration / journeyInterval));
+      const resultsDir = path.join(testDir, 'results');
+      await fs.mkdir(resultsDir, { recursive: true });
+
+      // Open model: the scenario's journeys/sec curve, vusers as the ceiling.
+      // Closed model: same sequential shape as run_simulation.sh, one new
+      // customer every journeyInterval seconds, each running the journey once
+      const scheduleArgs = testConfig.arrivalModel === 'open'
+        ? [
+            '--arrival-model', 'open',
+            '--arrival-rate', String(buildArrivalSchedule(testConfig).rate),
+            '--vusers', String(testConfig.vusers || totalJourneys),
+            '--ramp-up', String(testConfig.rampUp || 0),
+            '--duration', String(testConfig.duration),
+            '--ramp-down', String(testConfig.rampDown || 0)
+          ]
+        : [
+            '--vusers', String(totalJourneys),
+            '--ramp-up', String(totalJourneys * journeyInterval),
+            '--duration', '0',
+            '--iterations', '1'
+          ];
+
+      testProcess = spawn(LOADGEN_BIN, [
+        '--config', engineConfigPath,
+        '--base-url', `http://localhost:${req.app.locals.port || 8080}`,
+        ...scheduleArgs,
+        '--error-simulation', errorSimulationEnabled ? '1' : '0',
+        ...(testConfig.errorRate != null ? ['--error-rate', String(testConfig.errorRate)] : []),
+        '--seed', String(testConfig.errorSeed),
+        '--think-dist', testConfig.thinkDistribution,
+        '--time-compression', String(testConfig.timeCompression),
+        ...(testConfig.thinkSigma > 0 ? ['--think-sigma', String(testConfig.thinkSigma)] : []),
+        ...(Number.isFinite(testConfig.thinkTimeMs) && testConfig.thinkTimeMs >= 0 ? ['--think-time-ms', String(testConfig.thinkTimeMs)] : []),
+        '--journey-mode', journeyMode === 'chained' ? 'chained' : 'per-step',
+        '--body-templates', bodyTemplatesPath,
+        '--keep-alive', connectionReuse ? '1' : '0',
+        '--lsn', LSN,
+        '--ltn', LTN,
+        '--results-dir', resultsDir,
+        '--results-file', path.join(resultsDir, RESULTS_FILE),
+        ...(customerPoolLinked ? ['--customers', customerPoolPath] : [])
+      ], {
+        cwd: testDir,
+        stdio: ['ignore', 'pipe', 'pipe']
+      });
+      testMetadata.method = 'native-engine';
     } else {
       // Start curl simulation
       testProcess = spawn('bash', [curlScriptPath], {
@@ -706,14 +1711,23 @@ router.post('/start-test', async (req, res) => {
     testMetadata.process = testProcess;
     testMetadata.status = 'running';
 
-    // Handle process output
-    let output = '';
+    // Handle process output: the full log streams to disk, memory holds a
+    // fixed tail and the parsed counters, and per-transaction lines stay out
+    // of the server log
+    const outputLog = createWriteStream(path.join(testDir, 'test_output.log'));
+    testMetadata.outputTail = new OutputRingBuffer();
+    testMetadata.outputParser = new TestOutputParser();
     testProcess.stdout.on('data', (data) => {
-      output += data.toString();
-      console.log(`[LoadRunner-${testId}] ${data.toString().trim()}`);
+      outputLog.write(data);
+      testMetadata.outputTail.write(data);
+      for (const { line, kind } of testMetadata.outputParser.push(data)) {
+        if (kind !== 'transaction' && log.level === 'info') console.log(`[LoadRunner-${testId}] ${line}`);
+      }
     });
 
     testProcess.stderr.on('data', (data) => {
+      outputLog.write(data);
+      testMetadata.outputTail.write(data);
       console.error(`[LoadRunner-${testId}] ERROR: ${data.toString().trim()}`);
     });
 
@@ -722,10 +1736,10 @@ router.post('/start-test', async (req, res) => {
       testMetadata.status = code === 0 ? 'completed' : 'failed';
       testMetadata.endTime = new Date().toISOString();
       testMetadata.exitCode = code;
-
-      // Save test output
-      await fs.writeFile(path.join(testDir, 'test_output.log'), output);
+      outputLog.end();
+      artifactCache.release(artifacts.dir);
     });
+    releaseOnClose = true;
 
     res.json({
       success: true,
@@ -733,6 +1747,10 @@ router.post('/start-test', async (req, res) => {
       message: `LoadRunner test started for ${journeyConfig.companyName || 'test company'}`,
       testConfig,
       method: testMetadata.method,
+      journeyMode,
+      arrivalModel: testConfig.arrivalModel,
+      warmUp: testMetadata.warmUp || null,
+      artifacts: { key: cacheKey, cached: artifacts.hit, dir: artifacts.dir },
       estimatedDuration: `${Math.ceil(testConfig.duration / 60)} minutes`,
       resultsPath: testDir,
       monitoringUrl: `/api/loadrunner/status/${testId}`
@@ -740,6 +1758,7 @@ router.post('/start-test', async (req, res) => {
 
   } catch (error) {
     console.error('[LoadRunner] Error starting test:', error);
+    if (artifacts && !releaseOnClose) artifactCache.release(artifacts.dir);
     res.status(500).json({
       success: false,
       error: error.message
@@ -762,18 +1781,20 @@ router.get('/status/:testId', async (req, res) => {
       });
     }
 
-    // Check if results are available
-    let results = null;
-    const resultsPath = path.join(testData.testDir, 'results', 'test_summary.html');
-    
-    try {
-      const resultsExist = await fs.access(resultsPath);
-      results = {
-        summaryPath: resultsPath,
-        available: true
-      };
-    } catch (e) {
-      results = { available: false };
+    // Check if results are available (HTML from the curl script, JSON from the native engine)
+    let results = { available: false };
+    for (const summaryFile of ['test_summary.html', 'engine_summary.json']) {
+      const resultsPath = path.join(testData.testDir, 'results', summaryFile);
+      try {
+        await fs.access(resultsPath);
+        results = {
+          summaryPath: resultsPath,
+          available: true
+        };
+        break;
+      } catch (e) {
+        // try next
+      }
     }
 
     res.json({
@@ -783,11 +1804,15 @@ router.get('/status/:testId', async (req, res) => {
       method: testData.method,
       startTime: testData.startTime,
       endTime: testData.endTime,
+      loadStartTime: testData.loadStartTime,
+      warmUp: testData.warmUp || null,
       testConfig: testData.testConfig,
       journeyConfig: {
         companyName: testData.journeyConfig.companyName,
         stepCount: testData.journeyConfig.steps.length
       },
+      live: testData.outputParser ? testData.outputParser.snapshot() : null,
+      outputBytes: testData.outputTail ? testData.outputTail.totalBytes : 0,
       results
     });
 
@@ -814,14 +1839,16 @@ router.get('/tests', (req, res) => {
       companyName: data.journeyConfig.companyName,
       stepCount: data.journeyConfig.steps.length,
       virtualUsers: data.testConfig.virtualUsers,
-      duration: data.testConfig.duration
+      duration: data.testConfig.duration,
+      artifactCacheHit: data.artifactCacheHit
     }));
 
     res.json({
       success: true,
       tests,
       activeCount: tests.filter(t => t.status === 'running').length,
-      totalCount: tests.length
+      totalCount: tests.length,
+      artifactCache: artifactCache.stats()
     });
 
   } catch (error) {
@@ -832,6 +1859,21 @@ router.get('/tests', (req, res) => {
   }
 });
 
+/**
+ * Get the retained tail of a test's output (the full log is test_output.log)
+ */
+router.get('/output/:testId', (req, res) => {
+  const testData = activeTests.get(req.params.testId);
+  if (!testData) {
+    return res.status(404).json({
+      success: false,
+      error: 'Test not found'
+    });
+  }
+  res.set('Content-Type', 'text/plain; charset=utf-8');
+  res.send(testData.outputTail ? testData.outputTail.toString() : '');
+});
+
 /**
  * Stop a running test
  */
@@ -897,6 +1939,22 @@ router.get('/results/:testId', async (req, res) => {
       res.set('Content-Type', 'text/html');
       res.send(summaryContent);
     } catch (e) {
+      // Per-TSN aggregates over results.bin, readable while the test runs
+      const store = await aggregateResults(path.join(resultsDir, RESULTS_FILE), tsnNames(testData.journeyConfig?.steps));
+      try {
+        const engineSummary = JSON.parse(await fs.readFile(path.join(resultsDir, 'engine_summary.json'), 'utf8'));
+        // Percentiles come straight from the engine's per-TSN histograms,
+        // corrected for coordinated omission; serviceMs has the raw times
+        const percentiles = (engineSummary.transactions || [])
+          .filter(tx => tx.count > 0 && tx.latencyMs)
+          .map(tx => ({ tsn: tx.name, count: tx.count, p50Ms: tx.latencyMs.p50, p99Ms: tx.latencyMs.p99, p999Ms: tx.latencyMs.p999 }));
+        return res.json({ success: true, testId, method: testData.method, ...engineSummary, percentiles, ...(store ? { store } : {}) });
+      } catch (engineErr) {
+        // no native engine summary either
+      }
+      if (store) {
+        return res.json({ success: true, testId, method: testData.method, complete: false, store });
+      }
       res.status(404).json({
         success: false,
         error: 'Test results not yet available'
@@ -920,6 +1978,7 @@ router.get('/profiles', (req, res) => {
     profiles: Object.keys(LOADRUNNER_CONFIGS).map(key => ({
       name: key,
       ...LOADRUNNER_CONFIGS[key],
+      scenario: SCENARIO_PROFILES[key] || null,
       description: {
         light: 'Light sequential load - One journey every 2 minutes',
         medium: 'Medium sequential load - One journey every 1 minute',
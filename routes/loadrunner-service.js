@@ -2,6 +2,11 @@ import express from 'express';
 import http from 'http';
 import https from 'https';
 import crypto from 'crypto';
+import {
+  agentEnabled, agentAuthorized, configuredAgents, planShards, readScenarioProfile, mergeHistogramSnapshots,
+  agentRequest, startAgentRun, getAgentRun, stopAgentRun, stopAllAgentRuns
+} from '../services/load-agent.js';
+import { warmUpServices } from '../services/service-manager.js';
 const router = express.Router();
 
 // Feature flag config cache - refreshed periodically from the API
@@ -36,12 +41,17 @@ setInterval(() => {
 // Active load tests in memory
 const activeLoadTests = new Map();
 
+// Distributed runs by id; kept after they finish so the merged results stay readable
+const distributedRuns = new Map();
+const DISTRIBUTED_POLL_MS = 5000;
+const DISTRIBUTED_RUNS_KEPT = 20;
+
 /**
  * Start a load test using journey data from UI
  * This replaces the old static test-config.json approach
  */
-router.post('/start', (req, res) => {
-  const { journey, ratePerMinute = 2, duration } = req.body;
+router.post('/start', async (req, res) => {
+  const { journey, ratePerMinute = 2, duration, warmUp = true } = req.body;
   
   if (!journey || !journey.steps || journey.steps.length === 0) {
     return res.status(400).json({ 
@@ -56,6 +66,17 @@ router.post('/start', (req, res) => {
   console.log(`[LoadRunner] Rate: ${ratePerMinute} requests/minute`);
   console.log(`[LoadRunner] Journey: ${journey.steps.length} steps`);
   
+  // Start and health-check every step service first, so the first interval
+  // measures steady state rather than cold starts
+  const warmUpResult = warmUp
+    ? await warmUpServices(journey.steps, {
+        companyName,
+        domain: journey.domain || 'default.com',
+        industryType: journey.industryType || 'general',
+        journeyType: journey.journeyType || ''
+      })
+    : null;
+  
   // Calculate interval in ms
   const intervalMs = Math.floor(60000 / ratePerMinute);
   
@@ -270,6 +291,7 @@ router.post('/start', (req, res) => {
     intervalId,
     startTime: new Date().toISOString(),
     duration,
+    warmUp: warmUpResult,
     getStats: () => ({ iterationCount, successCount, errorCount })
   };
   
@@ -288,10 +310,206 @@ router.post('/start', (req, res) => {
     companyName,
     ratePerMinute,
     message: `Load test started for ${companyName}`,
-    stepsCount: journey.steps.length
+    stepsCount: journey.steps.length,
+    warmUp: warmUpResult
   });
 });
 
+/**
+ * Start a distributed load test: shard the scenario's VUs and arrival rate
+ * across the agents (body.agents or BIZOBS_LOAD_AGENTS), all under one LTN,
+ * and poll their histograms into one merged result set.
+ */
+router.post('/distributed/start', async (req, res) => {
+  const {
+    journey,
+    agents = configuredAgents(),
+    scenario = 'spike-test',   // loadrunner-tests/scenarios/<name>.json on every agent
+    vusers,                    // totals across agents; default: the scenario's
+    arrivalRate,
+    arrivalModel,
+    durationSeconds,
+    rampUp,
+    rampDown,
+    journeyMode = 'per-step',
+    connectionReuse = false,
+    errorSimulation = false,
+    errorRate,
+    seed,                      // one error schedule seed for every shard
+    thinkDistribution,
+    timeCompression,
+    targetBaseUrl              // system under test; default: this server
+  } = req.body;
+
+  if (!journey || !journey.steps || journey.steps.length === 0) {
+    return res.status(400).json({ error: 'Invalid journey data. Must include journey.steps array.' });
+  }
+  if (!Array.isArray(agents) || agents.length === 0) {
+    return res.status(400).json({ error: 'No load agents: pass agents[] or set BIZOBS_LOAD_AGENTS' });
+  }
+  const profile = await readScenarioProfile(scenario);
+  if (!profile) {
+    return res.status(400).json({ error: `Unknown scenario ${scenario}` });
+  }
+
+  const model = arrivalModel === 'open' || arrivalModel === 'closed' ? arrivalModel : profile.arrivalModel;
+  const totals = { vusers: Number(vusers) > 0 ? Number(vusers) : profile.vusers, arrivalRate: Number(arrivalRate) > 0 ? Number(arrivalRate) : profile.arrivalRate };
+  const shards = planShards(totals, Math.min(agents.length, totals.vusers));
+  const id = `dist_${Date.now()}_${crypto.randomBytes(4).toString('hex')}`;
+  const companyName = journey.companyName || 'Unknown';
+  const timestamp = new Date().toISOString().replace(/[:.]/g, '-');
+  const company = companyName.replace(/\s+/g, '');
+  const common = {
+    journey,
+    scenario,
+    arrivalModel: model,
+    duration: durationSeconds,
+    rampUp,
+    rampDown,
+    journeyMode,
+    keepAlive: connectionReuse,
+    errorSimulation,
+    errorRate,
+    seed: Number.isInteger(seed) && seed > 0 ? seed : crypto.randomInt(1, 2 ** 31),
+    thinkDistribution,
+    timeCompression,
+    vuTotal: totals.vusers,    // customer row stride, so shards read disjoint pool rows
+    lsn: `BizObs_${company}_Distributed`,
+    ltn: `${company}_Distributed_${timestamp}`,
+    targetBaseUrl: targetBaseUrl || `${req.protocol}://${req.get('host')}`
+  };
+
+  const run = {
+    id,
+    companyName,
+    scenario,
+    arrivalModel: model,
+    lsn: common.lsn,
+    ltn: common.ltn,
+    seed: common.seed,
+    targetBaseUrl: common.targetBaseUrl,
+    startTime: new Date().toISOString(),
+    status: 'running',
+    shards: shards.map((shard, i) => ({ agent: agents[i], runId: `${id}_${i}`, vusers: shard.vusers, vuOffset: shard.vuOffset, arrivalRate: model === 'open' ? shard.arrivalRate : undefined, status: 'starting', histograms: null }))
+  };
+
+  const started = await Promise.allSettled(run.shards.map(shard => agentRequest(shard.agent, 'POST', '/agent/runs', {
+    ...common,
+    runId: shard.runId,
+    vusers: shard.vusers,
+    vuOffset: shard.vuOffset,
+    ...(model === 'open' ? { arrivalRate: shard.arrivalRate } : {})
+  })));
+  started.forEach((result, i) => {
+    run.shards[i].status = result.status === 'fulfilled' ? 'running' : 'failed';
+    if (result.status === 'rejected') run.shards[i].error = result.reason.message;
+  });
+  if (run.shards.every(shard => shard.status === 'failed')) {
+    return res.status(502).json({ error: 'No load agent accepted its shard', shards: run.shards.map(({ agent, error }) => ({ agent, error })) });
+  }
+
+  distributedRuns.set(id, run);
+  for (const oldId of [...distributedRuns.keys()].slice(0, Math.max(0, distributedRuns.size - DISTRIBUTED_RUNS_KEPT))) {
+    if (distributedRuns.get(oldId).status !== 'running') distributedRuns.delete(oldId);
+  }
+
+  const merged = () => mergeHistogramSnapshots(run.shards.map(shard => shard.histograms));
+  const pollId = setInterval(() => pollDistributedRun(run), DISTRIBUTED_POLL_MS);
+  activeLoadTests.set(id, {
+    id,
+    journey,
+    companyName,
+    ratePerMinute: model === 'open' ? totals.arrivalRate * 60 : null,
+    intervalId: pollId,
+    startTime: run.startTime,
+    duration: durationSeconds,
+    agents: run.shards.map(shard => shard.agent),
+    // Fan the stop out; the engines write final histograms on SIGINT, read once more shortly after
+    stopAgents: () => {
+      run.status = 'stopping';
+      Promise.allSettled(run.shards.filter(shard => shard.status === 'running').map(shard =>
+        agentRequest(shard.agent, 'POST', `/agent/runs/${shard.runId}/stop`)))
+        .then(() => setTimeout(() => pollDistributedRun(run).then(() => { run.status = 'stopped'; }), DISTRIBUTED_POLL_MS));
+    },
+    getStats: () => {
+      const journeyTx = merged().find(tx => tx.name === 'Full_Customer_Journey') || { count: 0, pass: 0, fail: 0 };
+      return { iterationCount: journeyTx.count, successCount: journeyTx.pass, errorCount: journeyTx.fail };
+    }
+  });
+
+  console.log(`[LoadRunner] Distributed test ${id}: ${totals.vusers} VUs over ${run.shards.length} agent(s), LTN ${run.ltn}`);
+  res.json({
+    success: true,
+    loadTestId: id,
+    companyName,
+    ltn: run.ltn,
+    seed: run.seed,
+    shards: run.shards.map(({ agent, vusers, vuOffset, arrivalRate, status, error }) => ({ agent, vusers, vuOffset, arrivalRate, status, error }))
+  });
+});
+
+/**
+ * Merged results of a distributed test, live while it runs
+ */
+router.get('/distributed/:id', (req, res) => {
+  const run = distributedRuns.get(req.params.id);
+  if (!run) {
+    return res.status(404).json({ error: 'Distributed test not found' });
+  }
+  const elapsed = run.shards.map(shard => shard.histograms?.elapsedSec || 0);
+  res.json({
+    id: run.id,
+    status: run.status,
+    companyName: run.companyName,
+    scenario: run.scenario,
+    arrivalModel: run.arrivalModel,
+    LSN: run.lsn,
+    LTN: run.ltn,
+    seed: run.seed,
+    startTime: run.startTime,
+    elapsedSec: Math.max(0, ...elapsed),
+    arrivalsOffered: run.shards.reduce((n, shard) => n + (shard.histograms?.arrivalsOffered || 0), 0),
+    arrivalsMissed: run.shards.reduce((n, shard) => n + (shard.histograms?.arrivalsMissed || 0), 0),
+    shards: run.shards.map(({ agent, runId, vusers, vuOffset, status, error, histograms }) => ({ agent, runId, vusers, vuOffset, status, error, final: histograms?.final || false })),
+    transactions: mergeHistogramSnapshots(run.shards.map(shard => shard.histograms))
+  });
+});
+
+// ---------------------------------------------------------------------------
+// Agent endpoints: this instance runs a shard for a coordinator
+// ---------------------------------------------------------------------------
+
+router.use('/agent', (req, res, next) => {
+  // Off unless opted in, so a default deployment is not an open load relay
+  if (!agentEnabled()) return res.status(404).json({ error: 'Agent mode is disabled (set BIZOBS_AGENT_TOKEN or BIZOBS_AGENT_MODE=1)' });
+  if (!agentAuthorized(req)) return res.status(401).json({ error: 'Invalid agent token' });
+  next();
+});
+
+router.post('/agent/runs', async (req, res) => {
+  try {
+    const run = await startAgentRun(req.body);
+    res.status(202).json({ success: true, runId: run.runId });
+  } catch (err) {
+    res.status(400).json({ error: err.message });
+  }
+});
+
+router.get('/agent/runs/:runId', async (req, res) => {
+  const run = await getAgentRun(req.params.runId);
+  if (!run) return res.status(404).json({ error: 'Agent run not found' });
+  res.json(run);
+});
+
+router.post('/agent/runs/:runId/stop', (req, res) => {
+  if (!stopAgentRun(req.params.runId)) return res.status(404).json({ error: 'Agent run not found' });
+  res.json({ success: true });
+});
+
+router.post('/agent/stop-all', (req, res) => {
+  res.json({ success: true, stopped: stopAllAgentRuns() });
+});
+
 /**
  * Stop a running load test
  */
@@ -336,7 +554,9 @@ router.get('/status', (req, res) => {
       success: stats.successCount,
       errors: stats.errorCount,
       successRate: stats.iterationCount > 0 ? 
-        ((stats.successCount / stats.iterationCount) * 100).toFixed(2) + '%' : 'N/A'
+        ((stats.successCount / stats.iterationCount) * 100).toFixed(2) + '%' : 'N/A',
+      ...(test.warmUp ? { warmUpMs: test.warmUp.durationMs } : {}),
+      ...(test.agents ? { agents: test.agents } : {})
     });
   }
   
@@ -349,19 +569,51 @@ router.get('/status', (req, res) => {
 /**
  * Stop all load tests
  */
-router.post('/stop-all', (req, res) => {
+router.post('/stop-all', async (req, res) => {
   const stoppedCount = activeLoadTests.size;
   
   for (const loadTestId of activeLoadTests.keys()) {
     stopLoadTest(loadTestId);
   }
   
+  // Shards this instance runs as an agent, and every configured agent in
+  // case a coordinator restart lost track of its runs
+  const agentShards = stopAllAgentRuns();
+  const fanOut = await Promise.allSettled(configuredAgents().map(agent => agentRequest(agent, 'POST', '/agent/stop-all')));
+  
   res.json({
     success: true,
-    message: `Stopped ${stoppedCount} load test(s)`
+    message: `Stopped ${stoppedCount} load test(s)`,
+    agentShards,
+    agents: fanOut.map((result, i) => ({ agent: configuredAgents()[i], stopped: result.value?.stopped ?? null, error: result.reason?.message }))
   });
 });
 
+// Refresh a distributed run's shards from their agents; retire it once every shard is done
+async function pollDistributedRun(run) {
+  await Promise.allSettled(run.shards.filter(shard => shard.status === 'running').map(async shard => {
+    try {
+      const remote = await agentRequest(shard.agent, 'GET', `/agent/runs/${shard.runId}`);
+      shard.misses = 0;
+      if (remote.histograms) shard.histograms = remote.histograms;
+      if (remote.status !== 'running') shard.status = remote.status;
+      if (remote.error) shard.error = remote.error;
+    } catch (err) {
+      // Keep the last snapshot; an agent that stays unreachable is marked lost by the next poll
+      shard.error = err.message;
+      shard.misses = (shard.misses || 0) + 1;
+      if (shard.misses >= 3) shard.status = 'lost';
+    }
+  }));
+  if (run.shards.every(shard => shard.status !== 'running') && run.status === 'running') {
+    run.status = 'finished';
+    const test = activeLoadTests.get(run.id);
+    if (test) clearInterval(test.intervalId);
+    activeLoadTests.delete(run.id);
+    console.log(`[LoadRunner] Distributed test ${run.id} finished (LTN ${run.ltn})`);
+  }
+}
+
 // Helper function to stop a load test
 function stopLoadTest(loadTestId) {
   const test = activeLoadTests.get(loadTestId);
@@ -371,6 +623,7 @@ function stopLoadTest(loadTestId) {
   }
   
   clearInterval(test.intervalId);
+  if (test.stopAgents) test.stopAgents();
   activeLoadTests.delete(loadTestId);
   
   const stats = test.getStats();
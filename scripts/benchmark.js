@@ -0,0 +1,378 @@
+#!/usr/bin/env node
+
+/**
+ * BizObs Benchmark
+ * Replays the scenario profiles through the native engine against one pinned
+ * journey and compares the run with a stored baseline per scenario
+ *
+ *   node scripts/benchmark.js [--scenario light-load,spike-test] [--update-baseline]
+ *   node scripts/benchmark.js --micro
+ *
+ * Each scenario keeps its VUs, arrival model, rate, think-time model and
+ * error simulation but runs on a short fixed schedule (--ramp-up/--duration)
+ * with a fixed seed, after a one-journey warm-up that starts every step
+ * service. Recorded: journeys/s, per-TSN p50/p99, main server CPU and peak
+ * RSS, and the child services' count, CPU and RSS, sampled from /proc (so the
+ * server has to run on this host for those). A run regresses when throughput
+ * drops, or a percentile, CPU or RSS rises, by more than --threshold percent,
+ * or the child-service count changes. Exit code 1 on any regression.
+ *
+ * --micro runs bizobs-loadgen-bench (the step hot path without the network)
+ * and compares its ns/op the same way.
+ */
+
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import { spawn } from 'child_process';
+import { fileURLToPath } from 'url';
+
+const __dirname = path.dirname(fileURLToPath(import.meta.url));
+const ROOT = path.join(__dirname, '..');
+const SCENARIOS_DIR = path.join(ROOT, 'loadrunner-tests', 'scenarios');
+const BASELINES_DIR = path.join(ROOT, 'loadrunner-tests', 'baselines');
+const SCENARIOS = ['light-load', 'medium-load', 'heavy-load', 'stress-test', 'spike-test'];
+const LOADGEN_BIN = process.env.BIZOBS_LOADGEN_BIN ||
+  path.join(ROOT, 'native', 'loadgen', 'build', 'bizobs-loadgen');
+const BENCH_BIN = process.env.BIZOBS_LOADGEN_BENCH_BIN ||
+  path.join(ROOT, 'native', 'loadgen', 'build', 'bizobs-loadgen-bench');
+
+const CLK_TCK = 100;          // USER_HZ on every Linux the engine builds on
+const SAMPLE_MS = 1000;
+const MIN_DELTA_MS = 1;       // percentile moves below this are noise, whatever the ratio
+
+function parseArgs(argv) {
+  const opts = {
+    scenarios: SCENARIOS,
+    config: path.join(ROOT, 'loadrunner-tests', 'BT', 'test-config.json'),
+    baseUrl: `http://localhost:${process.env.PORT || 8080}`,
+    rampUp: 10,
+    duration: 60,
+    seed: 20251121,
+    threshold: 10,
+    updateBaseline: false,
+    micro: false,
+    out: null
+  };
+  for (let i = 2; i < argv.length; i++) {
+    const arg = argv[i];
+    const next = () => {
+      if (i + 1 >= argv.length) throw new Error(`Missing value for ${arg}`);
+      return argv[++i];
+    };
+    if (arg === '--scenario') opts.scenarios = next().split(',').map(s => s.trim()).filter(Boolean);
+    else if (arg === '--config') opts.config = path.resolve(next());
+    else if (arg === '--base-url') opts.baseUrl = next().replace(/\/$/, '');
+    else if (arg === '--ramp-up') opts.rampUp = Number(next());
+    else if (arg === '--duration') opts.duration = Number(next());
+    else if (arg === '--seed') opts.seed = Number(next());
+    else if (arg === '--threshold') opts.threshold = Number(next());
+    else if (arg === '--update-baseline') opts.updateBaseline = true;
+    else if (arg === '--micro') opts.micro = true;
+    else if (arg === '--out') opts.out = path.resolve(next());
+    else if (arg === '--help' || arg === '-h') {
+      console.log('Usage: node scripts/benchmark.js [--scenario a,b] [--config test-config.json] [--base-url url]\n' +
+        '         [--ramp-up s] [--duration s] [--seed n] [--threshold pct] [--update-baseline] [--micro] [--out file]');
+      process.exit(0);
+    } else throw new Error(`Unknown option ${arg}`);
+  }
+  for (const s of opts.scenarios) {
+    if (!SCENARIOS.includes(s)) throw new Error(`Unknown scenario ${s} (one of ${SCENARIOS.join(', ')})`);
+  }
+  return opts;
+}
+
+// ============================================
+// Engine runs
+// ============================================
+
+function runProcess(bin, args) {
+  return new Promise((resolve, reject) => {
+    const child = spawn(bin, args, { cwd: ROOT, stdio: ['ignore', 'pipe', 'pipe'] });
+    let stdout = '';
+    let stderr = '';
+    child.stdout.on('data', d => { stdout += d; });
+    child.stderr.on('data', d => { stderr += d; });
+    child.on('error', reject);
+    child.on('close', code => {
+      if (code === 0) resolve(stdout);
+      else reject(new Error(`${path.basename(bin)} exited with ${code}: ${stderr.trim().split('\n').pop() || ''}`));
+    });
+  });
+}
+
+async function getJson(url) {
+  const res = await fetch(url, { signal: AbortSignal.timeout(5000) });
+  if (!res.ok) throw new Error(`${url} answered ${res.status}`);
+  return res.json();
+}
+
+// CPU ticks and resident bytes of one process, or null once it is gone
+function readProc(pid) {
+  try {
+    const stat = fs.readFileSync(`/proc/${pid}/stat`, 'utf8');
+    const fields = stat.slice(stat.lastIndexOf(')') + 2).split(' ');
+    const ticks = Number(fields[11]) + Number(fields[12]); // utime + stime
+    const rss = fs.readFileSync(`/proc/${pid}/status`, 'utf8').match(/^VmRSS:\s+(\d+)\s+kB/m);
+    return { ticks, rssBytes: rss ? Number(rss[1]) * 1024 : 0 };
+  } catch {
+    return null;
+  }
+}
+
+/**
+ * Samples the main server and its child services once a second until
+ * stopped. Child CPU counts every service seen during the run, including
+ * ones started mid-run.
+ */
+function startSampler(baseUrl, serverPid) {
+  const startedAt = Date.now();
+  const server = { first: readProc(serverPid), last: null, rssPeak: 0 };
+  const children = new Map(); // pid -> { first, last }
+  let childCountPeak = 0;
+  let childRssPeak = 0;
+  let polling = false;
+
+  const sample = async () => {
+    if (polling) return;
+    polling = true;
+    try {
+      const s = readProc(serverPid);
+      if (s) {
+        server.last = s;
+        server.rssPeak = Math.max(server.rssPeak, s.rssBytes);
+      }
+      const health = await getJson(`${baseUrl}/api/health`).catch(() => null);
+      const services = health?.childServices || [];
+      childCountPeak = Math.max(childCountPeak, services.length);
+      let rss = 0;
+      for (const svc of services) {
+        if (!svc.pid) continue;
+        const p = readProc(svc.pid);
+        if (!p) continue;
+        const c = children.get(svc.pid) || { first: p };
+        c.last = p;
+        children.set(svc.pid, c);
+        rss += p.rssBytes;
+      }
+      childRssPeak = Math.max(childRssPeak, rss);
+    } finally {
+      polling = false;
+    }
+  };
+
+  sample();
+  const timer = setInterval(sample, SAMPLE_MS);
+  return async () => {
+    clearInterval(timer);
+    await sample();
+    const wallSec = (Date.now() - startedAt) / 1000;
+    const cpuPct = ticks => +(ticks / CLK_TCK / wallSec * 100).toFixed(1);
+    const onHost = server.first && server.last;
+    let childTicks = 0;
+    for (const c of children.values()) childTicks += c.last.ticks - c.first.ticks;
+    return {
+      server: {
+        pid: serverPid,
+        cpuPct: onHost ? cpuPct(server.last.ticks - server.first.ticks) : null,
+        rssPeakMb: onHost ? +(server.rssPeak / 1048576).toFixed(1) : null
+      },
+      childServices: {
+        count: childCountPeak,
+        cpuPct: onHost ? cpuPct(childTicks) : null,
+        rssPeakMb: onHost ? +(childRssPeak / 1048576).toFixed(1) : null
+      }
+    };
+  };
+}
+
+function engineArgs(opts, scenario, resultsDir) {
+  return [
+    '--config', opts.config,
+    '--scenario', path.join(SCENARIOS_DIR, `${scenario}.json`),
+    '--base-url', opts.baseUrl,
+    '--ramp-up', String(opts.rampUp),
+    '--duration', String(opts.duration),
+    '--ramp-down', '0',
+    '--seed', String(opts.seed),
+    '--report-interval', '0',
+    '--grace', '10',
+    '--lsn', 'BizObs_Benchmark',
+    '--ltn', `Benchmark_${scenario.replace(/-/g, '_')}`,
+    '--results-dir', resultsDir
+  ];
+}
+
+async function benchScenario(opts, scenario, serverPid) {
+  const resultsDir = fs.mkdtempSync(path.join(os.tmpdir(), `bizobs-bench-${scenario}-`));
+  try {
+    // Cold starts belong to the warm-up, not the measured run
+    await runProcess(LOADGEN_BIN, [
+      ...engineArgs(opts, scenario, resultsDir),
+      '--vusers', '1', '--iterations', '1', '--arrival-model', 'closed',
+      '--ramp-up', '0', '--duration', '0', '--think-time-ms', '0'
+    ]);
+
+    const stopSampler = startSampler(opts.baseUrl, serverPid);
+    await runProcess(LOADGEN_BIN, engineArgs(opts, scenario, resultsDir));
+    const resources = await stopSampler();
+
+    const summary = JSON.parse(fs.readFileSync(path.join(resultsDir, 'engine_summary.json'), 'utf8'));
+    const journeys = summary.transactions.find(t => t.name === 'Full_Customer_Journey');
+    const transactions = {};
+    for (const t of summary.transactions) {
+      transactions[t.name] = { count: t.count, fail: t.fail, p50Ms: t.latencyMs.p50, p99Ms: t.latencyMs.p99 };
+    }
+    return {
+      scenario,
+      recordedAt: new Date().toISOString(),
+      host: os.hostname(),
+      cpus: os.cpus().length,
+      journey: path.relative(ROOT, opts.config),
+      schedule: { rampUpSec: opts.rampUp, durationSec: opts.duration, seed: opts.seed },
+      vusers: summary.vusers,
+      arrivalModel: summary.arrivalModel,
+      elapsedSec: summary.elapsedSec,
+      throughput: {
+        journeysPerSec: +((journeys?.count || 0) / summary.elapsedSec).toFixed(3),
+        journeyFailPct: journeys?.count ? +(journeys.fail / journeys.count * 100).toFixed(2) : 0
+      },
+      transactions,
+      ...resources
+    };
+  } finally {
+    fs.rmSync(resultsDir, { recursive: true, force: true });
+  }
+}
+
+// ============================================
+// Baseline comparison
+// ============================================
+
+// Every metric as [name, value, higherIsWorse]
+function metricsOf(run) {
+  if (run.benchmarks) {
+    return Object.entries(run.benchmarks).map(([name, b]) => [`${name}.nsPerOp`, b.nsPerOp, true]);
+  }
+  const out = [['throughput.journeysPerSec', run.throughput.journeysPerSec, false]];
+  for (const [name, t] of Object.entries(run.transactions)) {
+    out.push([`${name}.p50Ms`, t.p50Ms, true], [`${name}.p99Ms`, t.p99Ms, true]);
+  }
+  out.push(
+    ['server.cpuPct', run.server.cpuPct, true],
+    ['server.rssPeakMb', run.server.rssPeakMb, true],
+    ['childServices.cpuPct', run.childServices.cpuPct, true],
+    ['childServices.rssPeakMb', run.childServices.rssPeakMb, true]
+  );
+  return out;
+}
+
+function compare(run, baseline, threshold) {
+  const previous = new Map(metricsOf(baseline).map(([name, value]) => [name, value]));
+  const rows = [];
+  for (const [name, value, higherIsWorse] of metricsOf(run)) {
+    const base = previous.get(name);
+    if (value == null || base == null) continue;
+    const changePct = base === 0 ? (value === 0 ? 0 : Infinity) : (value - base) / base * 100;
+    const worsePct = higherIsWorse ? changePct : -changePct;
+    const noise = name.endsWith('Ms') && Math.abs(value - base) < MIN_DELTA_MS;
+    rows.push({ name, base, value, changePct, regression: worsePct > threshold && !noise });
+  }
+  if (!run.benchmarks && run.childServices.count !== baseline.childServices.count) {
+    rows.push({
+      name: 'childServices.count',
+      base: baseline.childServices.count,
+      value: run.childServices.count,
+      changePct: null,
+      regression: true
+    });
+  }
+  return rows;
+}
+
+function printComparison(label, rows) {
+  console.log(`\n[Benchmark] ${label}`);
+  for (const r of rows) {
+    const change = r.changePct == null ? 'changed' : `${r.changePct >= 0 ? '+' : ''}${r.changePct.toFixed(1)}%`;
+    console.log(`  ${r.regression ? '❌' : '  '} ${r.name.padEnd(44)} ${String(r.base).padStart(10)} -> ${String(r.value).padStart(10)}  ${change}`);
+  }
+}
+
+function baselinePath(name) {
+  return path.join(BASELINES_DIR, `${name}.json`);
+}
+
+function readBaseline(name) {
+  try {
+    return JSON.parse(fs.readFileSync(baselinePath(name), 'utf8'));
+  } catch (e) {
+    if (e.code === 'ENOENT') return null;
+    throw e;
+  }
+}
+
+function checkAgainstBaseline(name, run, opts) {
+  const baseline = readBaseline(name);
+  if (opts.updateBaseline || !baseline) {
+    fs.mkdirSync(BASELINES_DIR, { recursive: true });
+    fs.writeFileSync(baselinePath(name), JSON.stringify(run, null, 2) + '\n');
+    console.log(`[Benchmark] 📌 ${baseline ? 'Updated' : 'Recorded first'} baseline ${path.relative(ROOT, baselinePath(name))}`);
+    return { name, regressions: [] };
+  }
+  if (baseline.host !== run.host) {
+    console.log(`[Benchmark] ⚠️ ${name} baseline was recorded on ${baseline.host}, this is ${run.host}`);
+  }
+  const rows = compare(run, baseline, opts.threshold);
+  printComparison(`${name} vs baseline of ${baseline.recordedAt}`, rows);
+  return { name, regressions: rows.filter(r => r.regression) };
+}
+
+// ============================================
+// Main
+// ============================================
+
+async function main() {
+  const opts = parseArgs(process.argv);
+  const report = { threshold: opts.threshold, runs: [], regressions: [] };
+
+  const check = (name, run) => {
+    report.runs.push(run);
+    const { regressions } = checkAgainstBaseline(name, run, opts);
+    report.regressions.push(...regressions.map(r => ({ benchmark: name, ...r })));
+  };
+
+  if (opts.micro) {
+    const out = await runProcess(BENCH_BIN, ['--config', opts.config, '--json']);
+    const run = { ...JSON.parse(out), recordedAt: new Date().toISOString(), host: os.hostname() };
+    for (const [name, b] of Object.entries(run.benchmarks)) {
+      console.log(`[Benchmark] ${name.padEnd(10)} ${b.nsPerOp.toFixed(1).padStart(10)} ns/op`);
+    }
+    check('micro', run);
+  } else {
+    const health = await getJson(`${opts.baseUrl}/api/health`);
+    const serverPid = health.mainProcess?.pid;
+    if (!fs.existsSync(`/proc/${serverPid}`)) {
+      console.log(`[Benchmark] ⚠️ Server pid ${serverPid} is not on this host; CPU/RSS will not be recorded`);
+    }
+    for (const scenario of opts.scenarios) {
+      console.log(`[Benchmark] ▶️ ${scenario}: ${opts.rampUp}s ramp-up + ${opts.duration}s against ${path.relative(ROOT, opts.config)}`);
+      const run = await benchScenario(opts, scenario, serverPid);
+      console.log(`[Benchmark] ${scenario}: ${run.throughput.journeysPerSec} journeys/s, ` +
+        `server ${run.server.cpuPct ?? '?'}% CPU / ${run.server.rssPeakMb ?? '?'} MB, ` +
+        `${run.childServices.count} child services`);
+      check(scenario, run);
+    }
+  }
+
+  if (opts.out) fs.writeFileSync(opts.out, JSON.stringify(report, null, 2) + '\n');
+  if (report.regressions.length) {
+    console.log(`\n[Benchmark] ❌ ${report.regressions.length} regression(s) beyond ${opts.threshold}%`);
+    process.exit(1);
+  }
+  console.log(`\n[Benchmark] ✅ No regressions beyond ${opts.threshold}%`);
+}
+
+main().catch(e => {
+  console.error(`[Benchmark] ❌ ${e.message}`);
+  process.exit(2);
+});
@@ -9,6 +9,7 @@ import { spawn, exec } from 'child_process';
 import fs from 'fs';
 import path from 'path';
 import { fileURLToPath } from 'url';
+import { IS_CLUSTER_WORKER } from '../services/cluster.js';
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = path.dirname(__filename);
@@ -22,7 +23,9 @@ class LoadRunnerManager {
   constructor() {
     this.activeTests = this.loadActiveTests();
     // Clear stop flags on fresh startup — stop flags are ephemeral,
-    // meant to prevent respawning during an active stop sequence only
+    // meant to prevent respawning during an active stop sequence only.
+    // A (re)started cluster worker is not a fresh start; the owner manages tests
+    if (IS_CLUSTER_WORKER) return;
     this._clearStopFlag(this._stopAllFlagPath());
     console.log('[LR-Manager] Initialized — stop flags cleared for fresh start');
   }
@@ -9,6 +9,10 @@ import http from 'http';
 import fs from 'fs';
 import path from 'path';
 import crypto from 'crypto';
+import { RESULTS_FILE, appendResultRecords } from '../services/results-store.js';
+import { CUSTOMER_POOL_FILE, ensureCustomerPool, openCustomerPool } from '../services/customer-pool.js';
+import { logSettings, logsIteration } from '../services/load-log.js';
+import { CapacitySearch, SearchWindow, capacitySearchConfig } from '../services/capacity-search.js';
 
 const testDir = process.argv[2];
 const scenario = process.argv[3];
@@ -68,85 +72,92 @@ const { loadrunner_config } = scenarioConfig;
 const intervalMs = (loadrunner_config.journey_interval || 30) * 1000; // Convert to ms
 const thinkTimeMs = loadrunner_config.think_time || 5000;
 
+// Capacity search (services/capacity-search.js): pool mode at the rate the
+// search sets step by step instead of the arrival curve below, judged against
+// the scenario's monitoring thresholds; the simulator exits when it is done
+const SEARCH_CONFIG = capacitySearchConfig(loadrunner_config, process.env.LR_CAPACITY_SEARCH);
+let search = null;
+if (SEARCH_CONFIG) {
+  try {
+    search = new CapacitySearch(SEARCH_CONFIG, scenarioConfig.monitoring,
+      loadrunner_config.arrival_rate || scenarioConfig.monitoring?.throughput_target);
+  } catch (err) {
+    console.error(`[LR-Simulator] ${err.message}`);
+    process.exit(1);
+  }
+}
+const searchWindow = new SearchWindow();
+const CAPACITY_SEARCH_FILE = 'capacity-search.json';
+
+// Dispatch mode. 'sequential' awaits each journey before pacing, so one
+// journey is in flight and a slow server lowers the rate to 1/latency.
+// 'pool' dispatches on a fixed schedule with up to MAX_IN_FLIGHT journeys
+// outstanding. Open-model profiles use pool mode on the same arrival curve as
+// the native engine and /start-test (arrival_rate or
+// monitoring.throughput_target, reached over ramp_up_time). Closed profiles
+// can opt in with LR_DISPATCH=pool and keep one dispatch per journey_interval.
+const openModel = loadrunner_config.arrival_model === 'open';
+const DISPATCH_MODE = search ? 'pool' : process.env.LR_DISPATCH || (openModel ? 'pool' : 'sequential');
+const ARRIVAL_RATE = openModel
+  ? (loadrunner_config.arrival_rate || scenarioConfig.monitoring?.throughput_target || 1000 / intervalMs)
+  : 1000 / intervalMs;
+const RAMP_UP_SEC = openModel ? (loadrunner_config.ramp_up_time || 0) : 0;
+
+// Customers per request. Above 1 each dispatch posts BATCH_SIZE customers to
+// /simulate-batch-chained instead of one to /simulate-journey, so the rate and
+// in-flight cap below count dispatches of BATCH_SIZE journeys each
+const BATCH_SIZE = Math.max(1, parseInt(process.env.LR_BATCH_SIZE || '0') || loadrunner_config.batch_size || 1);
+const DISPATCH_RATE = ARRIVAL_RATE / BATCH_SIZE;
+// vusers caps concurrent journeys, as in the engine's open model
+const MAX_IN_FLIGHT = Math.ceil((parseInt(process.env.LR_MAX_IN_FLIGHT || '0') || loadrunner_config.vusers || 50) / BATCH_SIZE);
+// Due dispatches that may wait for a free slot; beyond this they are dropped
+const MAX_QUEUED = parseInt(process.env.LR_MAX_QUEUED || '0') || MAX_IN_FLIGHT;
+
+// Per-journey lines for 1 in LR_LOG_SAMPLE journeys (none at LR_LOG_LEVEL=error);
+// failures are always logged and every journey still goes to results.bin
+const LOG = logSettings(process.env.LR_LOG_LEVEL || loadrunner_config.log_level,
+  process.env.LR_LOG_SAMPLE || loadrunner_config.log_sample);
+
+// Keep-alive sockets to the main server: one per journey that can be in
+// flight, plus one for feature flag calls
+const SERVER_SOCKETS = (DISPATCH_MODE === 'pool' ? MAX_IN_FLIGHT : 1) + 1;
+const serverAgent = new http.Agent({ keepAlive: true, maxSockets: SERVER_SOCKETS, maxFreeSockets: SERVER_SOCKETS });
+
 console.log(`[LR-Simulator] 🚀 Starting continuous load for ${companyName}`);
-console.log(`[LR-Simulator] 📊 Rate: ${(60000 / intervalMs).toFixed(1)} requests/minute`);
+if (search) {
+  console.log(`[LR-Simulator] 📐 Capacity search from ${search.rate.toFixed(2)} journeys/s, ${SEARCH_CONFIG.stepSec}s steps, p99 <= ${search.thresholdMs} ms, errors <= ${search.errorThresholdPct}%, max ${MAX_IN_FLIGHT} in flight`);
+} else if (DISPATCH_MODE === 'pool') {
+  console.log(`[LR-Simulator] 📊 Rate: ${(ARRIVAL_RATE * 60).toFixed(1)} journeys/minute after ${RAMP_UP_SEC}s ramp, max ${MAX_IN_FLIGHT} in flight, ${MAX_QUEUED} queued`);
+}
+if (BATCH_SIZE > 1) {
+  console.log(`[LR-Simulator] 📦 Batches of ${BATCH_SIZE} customers per request`);
+} else {
+  console.log(`[LR-Simulator] 📊 Rate: ${(60000 / intervalMs).toFixed(1)} requests/minute`);
+}
 console.log(`[LR-Simulator] 🔄 Journey steps: ${steps.length}`);
 
-// Define diverse customer profiles for realistic load simulation
-const loadTestCustomers = [
-  {
-    id: 1,
-    customerName: "Alice Thompson",
-    email: "alice.thompson@techcorp.com",
-    phone: "+1-555-0101",
-    location: "San Francisco, CA",
-    accountAge: 24,
-    loyaltyTier: "Gold"
-  },
-  {
-    id: 2,
-    customerName: "Bob Martinez",
-    email: "bob.m@startup.io",
-    phone: "+1-555-0202",
-    location: "Austin, TX",
-    accountAge: 6,
-    loyaltyTier: "Silver"
-  },
-  {
-    id: 3,
-    customerName: "Carol Chen",
-    email: "cchen@enterprise.com",
-    phone: "+1-555-0303",
-    location: "Seattle, WA",
-    accountAge: 48,
-    loyaltyTier: "Platinum"
-  },
-  {
-    id: 4,
-    customerName: "David Kumar",
-    email: "dkumar@consulting.net",
-    phone: "+1-555-0404",
-    location: "Chicago, IL",
-    accountAge: 12,
-    loyaltyTier: "Gold"
-  },
-  {
-    id: 5,
-    customerName: "Emma Wilson",
-    email: "e.wilson@finance.com",
-    phone: "+1-555-0505",
-    location: "New York, NY",
-    accountAge: 36,
-    loyaltyTier: "Platinum"
-  },
-  {
-    id: 6,
-    customerName: "Frank Rodriguez",
-    email: "f.rodriguez@retail.com",
-    phone: "+1-555-0606",
-    location: "Los Angeles, CA",
-    accountAge: 18,
-    loyaltyTier: "Silver"
-  },
-  {
-    id: 7,
-    customerName: "Grace Park",
-    email: "grace.park@healthcare.org",
-    phone: "+1-555-0707",
-    location: "Boston, MA",
-    accountAge: 30,
-    loyaltyTier: "Gold"
-  },
-  {
-    id: 8,
-    customerName: "Henry Lee",
-    email: "hlee@manufacturing.com",
-    phone: "+1-555-0808",
-    location: "Detroit, MI",
-    accountAge: 9,
-    loyaltyTier: "Bronze"
-  }
-];
+// Customers come from the shared pool (services/customer-pool.js), one row
+// per journey in order: the customers.dat /start-test linked into the company
+// directory, else the host-wide pool
+const companyPoolPath = path.join(testDir, CUSTOMER_POOL_FILE);
+const customerPool = openCustomerPool(process.env.LR_CUSTOMER_POOL ||
+  (fs.existsSync(companyPoolPath) ? companyPoolPath : await ensureCustomerPool()));
+let nextCustomerRow = 0;
+console.log(`[LR-Simulator] 👥 Customer pool: ${customerPool.count} customers`);
+
+function nextCustomer() {
+  const c = customerPool.read(nextCustomerRow++);
+  return {
+    id: c.index + 1,
+    customerName: c.name,
+    email: c.email,
+    phone: `+1-555-${String(c.index % 10000).padStart(4, '0')}`,
+    location: c.location,
+    accountAge: 1 + (c.index % 60),
+    loyaltyTier: c.loyaltyTier,
+    segment: c.segment
+  };
+}
 
 // Helper function to generate diverse product/service details
 function generateDiverseDetails(customerProfile) {
@@ -170,10 +181,9 @@ function generateDiverseDetails(customerProfile) {
   };
 }
 
-// Function to execute a single journey
-async function executeJourney() {
-  // Randomly select a customer from the diverse pool
-  const customer = loadTestCustomers[Math.floor(Math.random() * loadTestCustomers.length)];
+// One customer's simulate-journey body, drawn from the diverse pool
+function buildJourneyPayload() {
+  const customer = nextCustomer();
   
   const journeyId = `lr_journey_${Date.now()}_${crypto.randomBytes(4).toString('hex')}`;
   const customerId = `lr_customer_${customer.id}_${Math.floor(Math.random() * 1000)}`;
@@ -215,6 +225,7 @@ async function executeJourney() {
       location: customer.location,
       accountAge: customer.accountAge,
       loyaltyTier: customer.loyaltyTier,
+      segment: customer.segment,
       simulatedUser: true
     },
     traceMetadata: {
@@ -232,15 +243,19 @@ async function executeJourney() {
     loadRunnerTest: true
   };
   
-  console.log(`[LR-Simulator] 👤 ${customer.customerName} (${customer.loyaltyTier}) - ${diverseDetails.productName} - Priority: ${diverseDetails.priority}`);
+  if (logsIteration(LOG, nextCustomerRow)) console.log(`[LR-Simulator] 👤 ${customer.customerName} (${customer.loyaltyTier}) - ${diverseDetails.productName} - Priority: ${diverseDetails.priority}`);
+  return payload;
+}
 
-  return new Promise((resolve, reject) => {
-    const postData = JSON.stringify(payload);
+// POST a JSON body to the main server; resolves with { status, data } or { error }
+function postToServer(urlPath, body, correlationId) {
+  return new Promise((resolve) => {
+    const postData = JSON.stringify(body);
     
     const options = {
       hostname: 'localhost',
       port: process.env.BIZOBS_PORT || 8080,
-      path: '/api/journey-simulation/simulate-journey',
+      path: urlPath,
       method: 'POST',
       headers: {
         'Content-Type': 'application/json',
@@ -249,32 +264,28 @@ async function executeJourney() {
         'x-loadrunner-test': 'true',
         'x-correlation-id': correlationId
       },
+      agent: serverAgent,
       timeout: 60000
     };
 
+    let settled = false;
+    const settle = (result) => {
+      if (settled) return;
+      settled = true;
+      resolve(result);
+    };
+
     const req = http.request(options, (res) => {
       let data = '';
       res.on('data', chunk => data += chunk);
-      res.on('end', () => {
-        if (res.statusCode === 200) {
-          console.log(`[LR-Simulator] ✅ Journey ${journeyId} completed (${res.statusCode})`);
-          resolve({ success: true, journeyId, status: res.statusCode });
-        } else {
-          console.error(`[LR-Simulator] ❌ Journey ${journeyId} failed (${res.statusCode})`);
-          resolve({ success: false, journeyId, status: res.statusCode, error: data });
-        }
-      });
+      res.on('end', () => settle({ status: res.statusCode, data }));
     });
 
-    req.on('error', (err) => {
-      console.error(`[LR-Simulator] ❌ Request error for ${journeyId}:`, err.message);
-      resolve({ success: false, journeyId, error: err.message });
-    });
+    req.on('error', (err) => settle({ error: err.message }));
 
     req.on('timeout', () => {
-      console.error(`[LR-Simulator] ⏱️  Timeout for ${journeyId}`);
       req.destroy();
-      resolve({ success: false, journeyId, error: 'timeout' });
+      settle({ error: 'timeout' });
     });
 
     req.write(postData);
@@ -282,6 +293,84 @@ async function executeJourney() {
   });
 }
 
+function stepTimingsOf(data) {
+  try {
+    return JSON.parse(data).journey?.stepTimings || [];
+  } catch (e) {
+    return []; // not JSON (e.g. an SSE reply): the journey record alone
+  }
+}
+
+// Function to execute a single journey
+async function executeJourney(dueMs) {
+  const payload = buildJourneyPayload();
+  const { journeyId, correlationId } = payload;
+  const iteration = ++journeySeq;
+  const startedMs = Date.now();
+
+  const { status, data, error } = await postToServer('/api/journey-simulation/simulate-journey', payload, correlationId);
+  const success = status === 200;
+  recordJourneys([{ iteration, journeyMs: Date.now() - startedMs, ok: success, stepTimings: success ? stepTimingsOf(data) : [] }], dueMs);
+
+  if (error === 'timeout') {
+    console.error(`[LR-Simulator] ⏱️  Timeout for ${journeyId}`);
+  } else if (error) {
+    console.error(`[LR-Simulator] ❌ Request error for ${journeyId}:`, error);
+  } else if (success) {
+    if (logsIteration(LOG, iteration)) console.log(`[LR-Simulator] ✅ Journey ${journeyId} completed (${status})`);
+  } else {
+    console.error(`[LR-Simulator] ❌ Journey ${journeyId} failed (${status})`);
+  }
+  return { success, journeyId, status, error: error || (success ? undefined : data), journeys: 1 };
+}
+
+// Fields that differ per customer in a batch; the rest of the body is shared
+const PER_CUSTOMER_FIELDS = ['journeyId', 'customerId', 'correlationId', 'additionalFields', 'customerProfile', 'traceMetadata'];
+
+// BATCH_SIZE customers in one /simulate-batch-chained request, which runs them
+// concurrently through the chain and answers with one result per customer
+async function executeBatch(dueMs) {
+  const payloads = Array.from({ length: BATCH_SIZE }, buildJourneyPayload);
+  const iterations = payloads.map(() => ++journeySeq);
+  const batchId = crypto.randomUUID();
+  const startedMs = Date.now();
+  const { journey, ...shared } = payloads[0];
+  for (const field of PER_CUSTOMER_FIELDS) delete shared[field];
+  const body = {
+    ...shared,
+    journey,
+    batch: payloads.map(p => Object.fromEntries(PER_CUSTOMER_FIELDS.map(field => [field, p[field]])))
+  };
+
+  const { status, data, error } = await postToServer('/api/journey-simulation/simulate-batch-chained', body, batchId);
+  let results = [];
+  if (status === 200) {
+    try {
+      results = JSON.parse(data).results || [];
+    } catch (e) {
+      // counted as failed below
+    }
+  }
+  const elapsedMs = Date.now() - startedMs;
+  recordJourneys(iterations.map((iteration, i) => {
+    const r = results[i];
+    return r
+      ? { iteration, journeyMs: r.journeyMs, ok: r.status === 'completed', stepTimings: r.stepTimings || [] }
+      : { iteration, journeyMs: elapsedMs, ok: false, stepTimings: [] };
+  }), dueMs);
+
+  const completed = results.filter(r => r.status === 'completed').length;
+  if (error || status !== 200) {
+    console.error(`[LR-Simulator] ❌ Batch ${batchId} of ${BATCH_SIZE} failed (${error || status})`);
+  } else if (logsIteration(LOG, iterations[0])) {
+    console.log(`[LR-Simulator] ✅ Batch of ${BATCH_SIZE}: ${completed} completed, ${BATCH_SIZE - completed} failed in ${elapsedMs}ms`);
+  }
+  return { success: completed === BATCH_SIZE, status, error, journeys: BATCH_SIZE };
+}
+
+// `dueMs` is when the dispatch was scheduled, for the capacity search's latencies
+const runDispatch = (dueMs = Date.now()) => (BATCH_SIZE > 1 ? executeBatch(dueMs) : executeJourney(dueMs));
+
 // ============================================
 // Feature Flag Trigger After N Customers
 // ============================================
@@ -319,6 +408,7 @@ async function triggerFeatureFlag(action, errorRate) {
         'Content-Type': 'application/json',
         'Content-Length': Buffer.byteLength(flagPayload)
       },
+      agent: serverAgent,
       timeout: 10000
     };
 
@@ -345,16 +435,97 @@ async function triggerFeatureFlag(action, errorRate) {
   });
 }
 
-// Main execution loop
-async function runLoadTest() {
-  console.log(`[LR-Simulator] 🏃 Load test running for ${companyName}...`);
-  console.log(`[LR-Simulator] 🎯 Feature flag trigger: after ${FEATURE_FLAG_TRIGGER_AFTER} customers (error_rate → ${FEATURE_FLAG_ERROR_RATE})`);
-  if (FEATURE_FLAG_REVERT_AFTER) {
-    console.log(`[LR-Simulator] 🔄 Feature flag revert: after ${FEATURE_FLAG_REVERT_AFTER} customers (self-healing simulation)`);
+let customerCount = 0;
+
+// Per-transaction records in the shared binary results file (see
+// services/results-store.js): the steps the server reports, then
+// Full_Customer_Journey as TSN steps.length + 1
+const RESULTS_PATH = process.env.LR_RESULTS_FILE || path.join(testDir, RESULTS_FILE);
+let resultsFd = null;
+try {
+  resultsFd = fs.openSync(RESULTS_PATH, 'a');
+} catch (err) {
+  console.error(`[LR-Simulator] ⚠️  Results file disabled (${RESULTS_PATH}): ${err.message}`);
+}
+let journeySeq = 0;
+
+// One write per request: every journey's reported steps, then its Full_Customer_Journey.
+// The capacity search window gets the same transactions, the journey timed
+// from `dueMs` so that waiting for a slot counts against the threshold
+function recordJourneys(journeys, dueMs) {
+  if (search) {
+    const sinceDueMs = Date.now() - dueMs;
+    for (const { ok, stepTimings } of journeys) {
+      stepTimings.forEach((t, tsn) => {
+        if (t.stepStatus !== 'not_reached') searchWindow.record(t.stepName || steps[tsn]?.stepName || `TSN ${tsn}`, t.stepStatus === 'completed', t.durationMs);
+      });
+      searchWindow.record('Full_Customer_Journey', ok, sinceDueMs);
+    }
   }
-  
-  let customerCount = 0;
-  
+  if (resultsFd === null) return;
+  const records = [];
+  const timeUs = Date.now() * 1000;
+  for (const { iteration, journeyMs, ok, stepTimings } of journeys) {
+    stepTimings.forEach((t, tsn) => {
+      if (t.stepStatus === 'not_reached') return;
+      records.push({ timeUs, vu: 0, iteration, tsn, ok: t.stepStatus === 'completed', serviceUs: t.durationMs * 1000 });
+    });
+    records.push({ timeUs, vu: 0, iteration, tsn: steps.length + 1, ok, serviceUs: journeyMs * 1000 });
+  }
+  try {
+    appendResultRecords(resultsFd, records);
+  } catch (err) {
+    console.error(`[LR-Simulator] ⚠️  Results write failed: ${err.message}`);
+  }
+}
+
+// Feature flag trigger/revert and progress, run as each journey completes
+async function onJourneyDone(journeys = 1) {
+  const previousCount = customerCount;
+  customerCount += journeys;
+
+  // --- Trigger feature flag after N customers (never during a capacity search) ---
+  if (!search && !featureFlagTriggered && customerCount >= FEATURE_FLAG_TRIGGER_AFTER) {
+    featureFlagTriggered = true;
+    console.log(`\n🚨🚨🚨 [LR-Simulator] FEATURE FLAG TRIGGER 🚨🚨🚨`);
+    console.log(`[LR-Simulator] 💥 Customer #${customerCount} reached — enabling error injection (errors_per_transaction → ${FEATURE_FLAG_ERROR_RATE})`);
+    console.log(`[LR-Simulator] 📊 This simulates a production degradation for self-healing demos\n`);
+    
+    const result = await triggerFeatureFlag('enable', FEATURE_FLAG_ERROR_RATE);
+    if (result.success) {
+      console.log(`[LR-Simulator] ✅ Feature flag SET — errors_per_transaction = ${FEATURE_FLAG_ERROR_RATE}`);
+    } else {
+      console.error(`[LR-Simulator] ❌ Feature flag trigger failed — errors NOT enabled`);
+      featureFlagTriggered = false; // Retry next iteration
+    }
+  }
+
+  // --- Optional: Revert feature flag after additional N customers ---
+  if (FEATURE_FLAG_REVERT_AFTER && featureFlagTriggered && !featureFlagReverted 
+      && customerCount >= FEATURE_FLAG_TRIGGER_AFTER + FEATURE_FLAG_REVERT_AFTER) {
+    featureFlagReverted = true;
+    console.log(`\n✅✅✅ [LR-Simulator] FEATURE FLAG REVERT (SELF-HEALING) ✅✅✅`);
+    console.log(`[LR-Simulator] 🔧 Customer #${customerCount} — reverting error injection (errors_per_transaction → 0)`);
+    console.log(`[LR-Simulator] 📊 This simulates a Dynatrace workflow auto-remediation\n`);
+    
+    const result = await triggerFeatureFlag('revert', 0);
+    if (result.success) {
+      console.log(`[LR-Simulator] ✅ Feature flag REVERTED — errors_per_transaction = 0 (self-healed!)`);
+    }
+  }
+
+  // Log progress every 25 customers
+  if (Math.floor(customerCount / 25) > Math.floor(previousCount / 25)) {
+    const flagStatus = featureFlagReverted ? '🟢 reverted' : featureFlagTriggered ? '🔴 errors ON' : '🟢 clean';
+    const pool = DISPATCH_MODE === 'pool'
+      ? ` | In flight: ${inFlight}, queued: ${queued.length}, late: ${lateDispatches} (max ${maxLatenessMs} ms), dropped: ${droppedDispatches}`
+      : '';
+    console.log(`[LR-Simulator] 📈 Progress: ${customerCount} customers processed | Flag: ${flagStatus}${pool}`);
+  }
+}
+
+// Sequential mode: one journey at a time, journey_interval apart
+async function runSequential() {
   while (true) {
     // Check stop flags before each iteration
     if (shouldStop()) {
@@ -365,44 +536,8 @@ async function runLoadTest() {
     const startTime = Date.now();
     
     try {
-      await executeJourney();
-      customerCount++;
-
-      // --- Trigger feature flag after N customers ---
-      if (!featureFlagTriggered && customerCount >= FEATURE_FLAG_TRIGGER_AFTER) {
-        featureFlagTriggered = true;
-        console.log(`\n🚨🚨🚨 [LR-Simulator] FEATURE FLAG TRIGGER 🚨🚨🚨`);
-        console.log(`[LR-Simulator] 💥 Customer #${customerCount} reached — enabling error injection (errors_per_transaction → ${FEATURE_FLAG_ERROR_RATE})`);
-        console.log(`[LR-Simulator] 📊 This simulates a production degradation for self-healing demos\n`);
-        
-        const result = await triggerFeatureFlag('enable', FEATURE_FLAG_ERROR_RATE);
-        if (result.success) {
-          console.log(`[LR-Simulator] ✅ Feature flag SET — errors_per_transaction = ${FEATURE_FLAG_ERROR_RATE}`);
-        } else {
-          console.error(`[LR-Simulator] ❌ Feature flag trigger failed — errors NOT enabled`);
-          featureFlagTriggered = false; // Retry next iteration
-        }
-      }
-
-      // --- Optional: Revert feature flag after additional N customers ---
-      if (FEATURE_FLAG_REVERT_AFTER && featureFlagTriggered && !featureFlagReverted 
-          && customerCount >= FEATURE_FLAG_TRIGGER_AFTER + FEATURE_FLAG_REVERT_AFTER) {
-        featureFlagReverted = true;
-        console.log(`\n✅✅✅ [LR-Simulator] FEATURE FLAG REVERT (SELF-HEALING) ✅✅✅`);
-        console.log(`[LR-Simulator] 🔧 Customer #${customerCount} — reverting error injection (errors_per_transaction → 0)`);
-        console.log(`[LR-Simulator] 📊 This simulates a Dynatrace workflow auto-remediation\n`);
-        
-        const result = await triggerFeatureFlag('revert', 0);
-        if (result.success) {
-          console.log(`[LR-Simulator] ✅ Feature flag REVERTED — errors_per_transaction = 0 (self-healed!)`);
-        }
-      }
-
-      // Log progress every 25 customers
-      if (customerCount % 25 === 0) {
-        const flagStatus = featureFlagReverted ? '🟢 reverted' : featureFlagTriggered ? '🔴 errors ON' : '🟢 clean';
-        console.log(`[LR-Simulator] 📈 Progress: ${customerCount} customers processed | Flag: ${flagStatus}`);
-      }
+      const result = await runDispatch();
+      await onJourneyDone(result.journeys);
     } catch (err) {
       console.error(`[LR-Simulator] ❌ Execution error:`, err.message);
     }
@@ -421,6 +556,162 @@ async function runLoadTest() {
   }
 }
 
+// Offset (ms) of dispatch k: linear ramp from 0 to DISPATCH_RATE over
+// RAMP_UP_SEC, then the plateau until stopped. Dispatch k is due once k + 1
+// dispatches' worth of rate has accumulated, as in the engine's ArrivalSchedule.
+function dispatchOffsetMs(k) {
+  const target = k + 1;
+  const rampArrivals = DISPATCH_RATE * RAMP_UP_SEC / 2;
+  if (target <= rampArrivals) return Math.sqrt(2 * RAMP_UP_SEC * target / DISPATCH_RATE) * 1000;
+  return (RAMP_UP_SEC + (target - rampArrivals) / DISPATCH_RATE) * 1000;
+}
+
+// Pool-mode backpressure: a due dispatch with no free slot waits (late) and
+// is dropped once MAX_QUEUED are already waiting
+let inFlight = 0;
+const queued = [];            // due times of dispatches waiting for a slot
+let lateDispatches = 0;
+let droppedDispatches = 0;
+let maxLatenessMs = 0;
+const LATE_AFTER_MS = 50;     // timer jitter below this is not counted as late
+
+function dispatch(dueMs) {
+  const latenessMs = Date.now() - dueMs;
+  if (latenessMs > LATE_AFTER_MS) {
+    lateDispatches++;
+    if (latenessMs > maxLatenessMs) maxLatenessMs = latenessMs;
+  }
+  inFlight++;
+  runDispatch(dueMs)
+    .then(result => onJourneyDone(result.journeys))
+    .catch(err => console.error(`[LR-Simulator] ❌ Execution error:`, err.message))
+    .finally(() => {
+      inFlight--;
+      if (queued.length > 0) dispatch(queued.shift());
+    });
+}
+
+// A due dispatch: run it, wait for a slot or drop it
+function offer(dueMs) {
+  if (inFlight < MAX_IN_FLIGHT) {
+    dispatch(dueMs);
+  } else if (queued.length < MAX_QUEUED) {
+    queued.push(dueMs);
+  } else {
+    droppedDispatches++;
+    if (droppedDispatches === 1 || droppedDispatches % 100 === 0) {
+      console.error(`[LR-Simulator] ⚠️  ${droppedDispatches} dispatch(es) dropped: ${inFlight} in flight, ${queued.length} queued`);
+    }
+  }
+}
+
+const sleep = ms => new Promise(resolve => setTimeout(resolve, Math.max(1, ms)));
+
+function exitOnStopFlag() {
+  if (!shouldStop()) return;
+  console.log(`[LR-Simulator] 🛑 Exiting load test for ${companyName} (stop flag). Late: ${lateDispatches}, dropped: ${droppedDispatches}`);
+  process.exit(0);
+}
+
+// Pool mode: dispatch on the schedule whatever is still outstanding
+async function runPool() {
+  const startMs = Date.now();
+  let next = 0;
+  let lastStopCheck = 0;
+  while (true) {
+    const now = Date.now();
+    // Stop flags are two stat calls; once a second is enough at any rate
+    if (now - lastStopCheck >= 1000) {
+      lastStopCheck = now;
+      exitOnStopFlag();
+    }
+
+    // Every dispatch that is due by now, including ones a slow tick skipped
+    let dueMs = startMs + dispatchOffsetMs(next);
+    while (dueMs <= now) {
+      offer(dueMs);
+      dueMs = startMs + dispatchOffsetMs(++next);
+    }
+
+    await sleep(Math.min(1000, dueMs - Date.now()));
+  }
+}
+
+// Capacity search: each step dispatches evenly at the search's rate from its
+// start. A failed step's waiting dispatches are dropped and its journeys
+// finish before the cooldown, so no backlog leaks into the next step.
+async function runSearch() {
+  const stepMs = SEARCH_CONFIG.stepSec * 1000;
+  let lastStopCheck = 0;
+  while (!search.done) {
+    const rate = search.rate;
+    const gapMs = 1000 * BATCH_SIZE / rate;
+    const startMs = Date.now();
+    const settleEndMs = startMs + stepMs / 5;
+    const endMs = startMs + stepMs;
+    let measuring = false;
+    let next = 0;
+    console.log(`[LR-Simulator] 📐 Step ${search.history.length + 1}: ${rate.toFixed(2)} journeys/s for ${SEARCH_CONFIG.stepSec}s`);
+    while (true) {
+      const now = Date.now();
+      if (now - lastStopCheck >= 1000) {
+        lastStopCheck = now;
+        exitOnStopFlag();
+      }
+      if (!measuring && now >= settleEndMs) {
+        measuring = true;
+        searchWindow.reset();
+      }
+      if (now >= endMs) break;
+      let dueMs = startMs + next * gapMs;
+      while (dueMs <= now) {
+        offer(dueMs);
+        dueMs = startMs + ++next * gapMs;
+      }
+      await sleep(Math.min(1000, Math.min(dueMs, measuring ? endMs : settleEndMs) - Date.now()));
+    }
+
+    const step = search.finishStep(searchWindow.samples(), queued.length * BATCH_SIZE);
+    console.log(`[LR-Simulator] 📐 ${rate.toFixed(2)} journeys/s ${step.held ? 'held' : `failed: ${step.reason}`}`);
+    if (step.held && !search.done) continue;
+    droppedDispatches += queued.length;
+    queued.length = 0;
+    while (inFlight > 0) await sleep(100);
+    if (!search.done) await sleep(SEARCH_CONFIG.cooldownSec * 1000);
+  }
+
+  for (const line of search.reportLines('[LR-Simulator]')) console.log(line);
+  const reportPath = path.join(testDir, CAPACITY_SEARCH_FILE);
+  try {
+    fs.writeFileSync(reportPath, JSON.stringify({ companyName, scenario, capacitySearch: search }, null, 2));
+    console.log(`[LR-Simulator] ✅ Capacity search written to ${reportPath}`);
+  } catch (err) {
+    console.error(`[LR-Simulator] ⚠️  Capacity search report not written (${reportPath}): ${err.message}`);
+  }
+  process.exit(0);
+}
+
+// Main execution loop
+async function runLoadTest() {
+  console.log(`[LR-Simulator] 🏃 Load test running for ${companyName} (${DISPATCH_MODE} dispatch)...`);
+  if (search) {
+    console.log(`[LR-Simulator] 🎯 Feature flag trigger: off for the capacity search`);
+  } else {
+    console.log(`[LR-Simulator] 🎯 Feature flag trigger: after ${FEATURE_FLAG_TRIGGER_AFTER} customers (error_rate → ${FEATURE_FLAG_ERROR_RATE})`);
+    if (FEATURE_FLAG_REVERT_AFTER) {
+      console.log(`[LR-Simulator] 🔄 Feature flag revert: after ${FEATURE_FLAG_REVERT_AFTER} customers (self-healing simulation)`);
+    }
+  }
+
+  if (search) {
+    await runSearch();
+  } else if (DISPATCH_MODE === 'pool') {
+    await runPool();
+  } else {
+    await runSequential();
+  }
+}
+
 // Handle graceful shutdown
 process.on('SIGTERM', () => {
   console.log(`[LR-Simulator] 🛑 Received SIGTERM, shutting down...`);
@@ -18,7 +18,7 @@ import { v4 as uuidv4 } from 'uuid';
 import crypto from 'crypto';
 import fs from 'fs/promises';
 import { existsSync, readFileSync, writeFileSync } from 'fs';
-import { ensureServiceRunning, getServiceNameFromStep, getServicePort, stopAllServices, stopCustomerJourneyServices, getChildServices, getChildServiceMeta, performHealthCheck, getServiceStatus, cleanupOrphanedServiceProcesses, getDormantServices, clearDormantServices, clearDormantServicesForCompany, blockCompany } from './services/service-manager.js';
+import { ensureServiceRunning, getServiceNameFromStep, getServicePort, stopAllServices, stopCustomerJourneyServices, getChildServices, getChildServiceMeta, performHealthCheck, getServiceStatus, cleanupOrphanedServiceProcesses, getDormantServices, clearDormantServices, clearDormantServicesForCompany, blockCompany, startServiceLifecycle, getServiceLifecycleStats } from './services/service-manager.js';
 import portManager from './services/port-manager.js';
 import { startAutoLoadWatcher, stopAutoLoadWatcher, stopAllAutoLoads, getAutoLoadStatus, stopAutoLoad } from './services/auto-load.js';
 
@@ -28,7 +28,7 @@ import metricsRouter from './routes/metrics.js';
 import stepsRouter from './routes/steps.js';
 import flowRouter from './routes/flow.js';
 import serviceProxyRouter from './routes/serviceProxy.js';
-import journeySimulationRouter from './routes/journey-simulation.js';
+import journeySimulationRouter, { checkpointContinuousGeneration } from './routes/journey-simulation.js';
 import configRouter from './routes/config.js';
 import loadrunnerRouter from './routes/loadrunner-integration.js';
 import loadrunnerServiceRouter from './routes/loadrunner-service.js';
@@ -46,6 +46,8 @@ import { startDetector as startFixitDetector } from './dist/agents/fixit/problem
 // MCP integration removed - not needed for core functionality
 import { injectDynatraceMetadata, injectErrorMetadata, propagateMetadata, validateMetadata } from './middleware/dynatrace-metadata.js';
 import { performComprehensiveHealthCheck } from './middleware/observability-hygiene.js';
+import { requestContext } from './middleware/request-context.js';
+import { IS_CLUSTER_OWNER, serveOwner, broadcast, startClusterWorkers, stopClusterWorkers, clusterStatus } from './services/cluster.js';
 // MongoDB integration removed
 
 dotenv.config();
@@ -398,47 +400,8 @@ app.use(express.static(path.join(__dirname, 'public')));
 // Inject Dynatrace metadata for ACE-Box compatibility
 app.use(injectDynatraceMetadata);
 
-// Frontend host label (avoid showing raw 'localhost')
-function hostToLabel(host) {
-  if (!host) return 'Unknown Host';
-  if (process.env.APP_DOMAIN_LABEL) return process.env.APP_DOMAIN_LABEL;
-  if (host.includes('localhost') || host.startsWith('127.')) return 'Local Dev';
-  return host;
-}
-
-// Attach helpful request context and distributed tracing
-app.use((req, res, next) => {
-  const cid = req.headers['x-correlation-id'] || uuidv4();
-  req.correlationId = cid;
-  res.setHeader('x-correlation-id', cid);
-
-  // Extract and preserve all Dynatrace tracing headers for propagation
-  req.tracingHeaders = {};
-  const headerKeys = Object.keys(req.headers || {});
-  for (const key of headerKeys) {
-    const lowerKey = key.toLowerCase();
-    // Capture Dynatrace, W3C Trace Context, and other distributed tracing headers
-    if (lowerKey.startsWith('x-dynatrace') || 
-        lowerKey.startsWith('traceparent') || 
-        lowerKey.startsWith('tracestate') || 
-        lowerKey.startsWith('x-trace') || 
-        lowerKey.startsWith('x-request-id') || 
-        lowerKey.startsWith('x-correlation-id') || 
-        lowerKey.startsWith('x-span-id') || 
-        lowerKey.startsWith('dt-') ||
-        lowerKey.startsWith('uber-trace-id')) {
-      req.tracingHeaders[key] = req.headers[key];
-    }
-  }
-
-  const host = req.headers['x-forwarded-host'] || req.headers.host || '';
-  req.frontendHostLabel = hostToLabel(host);
-  res.setHeader('X-App-Domain-Label', req.frontendHostLabel);
-
-  // Expose Socket.IO on request for route handlers
-  req.io = io;
-  next();
-});
+// Correlation id, tracing headers and frontend host label
+app.use(requestContext(io));
 
 // Enhanced event service for separate process communication
 const eventService = {
@@ -1679,12 +1642,14 @@ app.get('/api/admin/services/dormant', (req, res) => {
       stepName: meta.stepName || 'unknown',
       previousPort: meta.previousPort,
       serviceVersion: meta.serviceVersion || null,
-      stoppedAt: meta.stoppedAt
+      stoppedAt: meta.stoppedAt,
+      hibernated: !!meta.hibernated
     }));
     res.json({
       ok: true,
       dormantServices: dormantList,
-      count: dormantList.length
+      count: dormantList.length,
+      lifecycle: getServiceLifecycleStats()
     });
   } catch (e) {
     res.status(500).json({ ok: false, error: e.message });
@@ -1958,6 +1923,23 @@ function recordTraceValidation(stepName, headers, response) {
 // Make recordTraceValidation available globally for journey simulation
 global.recordTraceValidation = recordTraceValidation;
 
+// The same globals for the hot path in cluster workers (cluster-worker.js)
+serveOwner('recordTraceValidation', recordTraceValidation);
+serveOwner('startContinuousJourneyGenerator', () => {
+  if (!global.continuousJourneyProcess) global.startContinuousJourneyGenerator?.();
+});
+serveOwner('featureFlags', () => featureFlags);
+if (IS_CLUSTER_OWNER) {
+  // Flags are changed in place by many routes; workers get a copy when it differs
+  let sharedFlags = JSON.stringify(featureFlags);
+  setInterval(() => {
+    const flags = JSON.stringify(featureFlags);
+    if (flags === sharedFlags) return;
+    sharedFlags = flags;
+    broadcast('featureFlags', featureFlags);
+  }, 1000).unref();
+}
+
 // --- Admin endpoint to restart all core services ---
 app.post('/api/admin/services/restart-all', async (req, res) => {
   try {
@@ -2327,6 +2309,7 @@ app.get('/api/health', (req, res) => {
     status: 'ok',
     timestamp: new Date().toISOString(),
     callerIp,
+    cluster: clusterStatus(),
     mainProcess: {
       pid: process.pid,
       uptime: process.uptime(),
@@ -4522,8 +4505,10 @@ app.use((err, req, res, next) => {
   });
 });
 
-// Start the server and initialize child services
-server.listen(PORT, () => {
+// Start the server and initialize child services. In cluster mode the
+// workers take the public port and this process listens on loopback
+server.listen(...(IS_CLUSTER_OWNER ? [0, '127.0.0.1'] : [PORT]), () => {
+  if (IS_CLUSTER_OWNER) startClusterWorkers(server.address().port);
   console.log(`🚀 Business Observability Server running on port ${PORT}`);
   console.log(`📊 Health check: http://localhost:${PORT}/api/health`);
   app.locals.port = PORT;
@@ -4572,6 +4557,9 @@ server.listen(PORT, () => {
     console.warn('⚠️  Orphan process cleanup failed:', error.message);
   }
 
+  // --- Idle hibernation and the warm pool (SERVICE_IDLE_MINUTES, SERVICE_WARM_POOL) ---
+  startServiceLifecycle();
+
   // --- Check directory structure and permissions ---
   const requiredDirectories = [
     './services',
@@ -4808,7 +4796,7 @@ server.listen(PORT, () => {
 });
 
 // Graceful shutdown
-process.on('SIGTERM', () => {
+process.on('SIGTERM', async () => {
   console.log('🛑 Received SIGTERM, shutting down gracefully...');
   
   // Stop auto-load watcher and all auto-loads
@@ -4820,6 +4808,9 @@ process.on('SIGTERM', () => {
   // Save chaos/feature flag state before shutdown
   saveChaosState();
   
+  // Generator changes since the last interval checkpoint
+  await checkpointContinuousGeneration();
+  
   // Stop continuous journey generator if running
   if (server.continuousJourneyProcess) {
     console.log('[Continuous Journey] Stopping generator...');
@@ -4842,13 +4833,16 @@ process.on('SIGTERM', () => {
   // Close child services
   stopAllServices();
   
+  // Workers hold keep-alive connections to this server
+  stopClusterWorkers();
+  
   server.close(() => {
     console.log('👋 Server closed');
     process.exit(0);
   });
 });
 
-process.on('SIGINT', () => {
+process.on('SIGINT', async () => {
   console.log('🛑 Received SIGINT, shutting down gracefully...');
   
   // Stop auto-load watcher and all auto-loads
@@ -4860,6 +4854,9 @@ process.on('SIGINT', () => {
   // Save chaos/feature flag state before shutdown
   saveChaosState();
   
+  // Generator changes since the last interval checkpoint
+  await checkpointContinuousGeneration();
+  
   // Stop continuous journey generator if running
   if (server.continuousJourneyProcess) {
     console.log('[Continuous Journey] Stopping generator...');
@@ -4882,6 +4879,9 @@ process.on('SIGINT', () => {
   // Close child services using service manager
   stopAllServices();
   
+  // Workers hold keep-alive connections to this server
+  stopClusterWorkers();
+  
   server.close(() => {
     console.log('👋 Server closed');
     process.exit(0);
@@ -4,9 +4,10 @@
  * (MongoDB integration removed)
  */
 
-const { createService } = require('./service-runner.cjs');
+const { createService, onShutdown } = require('./service-runner.cjs');
 const http = require('http');
 const crypto = require('crypto');
+const fs = require('fs');
 
 // In-memory storage for journey data (replaces MongoDB)
 const journeyStorage = {
@@ -18,6 +19,31 @@ const journeyStorage = {
   }
 };
 
+// Write-behind queue: /process enqueues the journey and answers; records are
+// stored in batches of PERSIST_BATCH_SIZE or every PERSIST_FLUSH_MS, and
+// appended to PERSIST_FILE (JSON lines, one write per batch) when it is set
+const PERSIST_BATCH_SIZE = parseInt(process.env.PERSIST_BATCH_SIZE || '0') || 200;
+const PERSIST_FLUSH_MS = parseInt(process.env.PERSIST_FLUSH_MS || '0') || 250;
+const PERSIST_FILE = process.env.PERSIST_FILE || null;
+
+const writeBehind = {
+  queue: [],
+  timer: null,
+  flushing: null,
+  metrics: {
+    enqueued: 0,
+    persisted: 0,
+    failed: 0,
+    flushes: 0,
+    maxQueueDepth: 0,
+    lastFlushMs: 0,
+    maxFlushMs: 0,
+    totalFlushMs: 0,
+    maxQueueWaitMs: 0,
+    lastFlushAt: null
+  }
+};
+
 // Fallback Dynatrace helpers
 const addCustomAttributes = (attributes) => {
   console.log('[dynatrace] Custom attributes:', attributes);
@@ -32,6 +58,147 @@ const sendBusinessEvent = (eventType, data) => {
   console.log('[dynatrace] Business event:', eventType, data);
 };
 
+// Store one journey and its steps in memory; runs at flush time
+function storeJourney(journeyData) {
+  journeyStorage.journeys.set(journeyData.journeyId, journeyData);
+
+  if (journeyData.steps && Array.isArray(journeyData.steps)) {
+    journeyData.steps.forEach((step, index) => {
+      journeyStorage.steps.push({
+        id: crypto.randomUUID(),
+        journeyId: journeyData.journeyId,
+        stepIndex: index + 1,
+        stepName: step.stepName || `Step${index + 1}`,
+        serviceName: step.serviceName || `${step.stepName}Service`,
+        stepData: step,
+        companyContext: {
+          companyName: journeyData.companyName,
+          industryType: journeyData.industryType,
+          domain: journeyData.domain
+        },
+        timestamp: journeyData.storedAt
+      });
+    });
+  }
+
+  journeyStorage.stats.totalJourneys++;
+
+  if (!journeyStorage.stats.companiesStats.has(journeyData.companyName)) {
+    journeyStorage.stats.companiesStats.set(journeyData.companyName, {
+      count: 0,
+      latestJourney: null,
+      avgBusinessValue: 0,
+      industries: new Set()
+    });
+  }
+
+  const companyStats = journeyStorage.stats.companiesStats.get(journeyData.companyName);
+  companyStats.count++;
+  companyStats.latestJourney = journeyData.storedAt;
+  companyStats.avgBusinessValue = ((companyStats.avgBusinessValue * (companyStats.count - 1)) + journeyData.businessValue) / companyStats.count;
+  companyStats.industries.add(journeyData.industryType);
+}
+
+function enqueueJourney(journeyData, correlationId) {
+  const { queue, metrics } = writeBehind;
+  queue.push({ journeyData, correlationId, enqueuedAt: Date.now() });
+  metrics.enqueued++;
+  if (queue.length > metrics.maxQueueDepth) metrics.maxQueueDepth = queue.length;
+
+  if (queue.length >= PERSIST_BATCH_SIZE) {
+    setImmediate(flushJourneys);
+  } else if (!writeBehind.timer) {
+    writeBehind.timer = setTimeout(flushJourneys, PERSIST_FLUSH_MS);
+  }
+}
+
+// Drain the queue one batch at a time; concurrent callers share the pass
+function flushJourneys() {
+  if (writeBehind.timer) {
+    clearTimeout(writeBehind.timer);
+    writeBehind.timer = null;
+  }
+  if (!writeBehind.flushing) {
+    writeBehind.flushing = (async () => {
+      while (writeBehind.queue.length > 0) {
+        await flushBatch(writeBehind.queue.splice(0, PERSIST_BATCH_SIZE));
+      }
+    })().finally(() => { writeBehind.flushing = null; });
+  }
+  return writeBehind.flushing;
+}
+
+async function flushBatch(batch) {
+  const { metrics } = writeBehind;
+  const started = Date.now();
+  const lines = [];
+
+  for (const { journeyData, correlationId, enqueuedAt } of batch) {
+    metrics.maxQueueWaitMs = Math.max(metrics.maxQueueWaitMs, started - enqueuedAt);
+    try {
+      storeJourney(journeyData);
+      if (PERSIST_FILE) lines.push(JSON.stringify(journeyData));
+      metrics.persisted++;
+
+      sendBusinessEvent('journey_data_persisted', {
+        journeyId: journeyData.journeyId,
+        correlationId,
+        companyName: journeyData.companyName,
+        industryType: journeyData.industryType,
+        totalSteps: journeyData.totalSteps,
+        businessValue: journeyData.businessValue,
+        documentId: journeyData.documentId,
+        storageType: 'in-memory'
+      });
+    } catch (error) {
+      metrics.failed++;
+      console.error('[DataPersistenceService] Memory storage failed:', error.message);
+      sendBusinessEvent('journey_storage_failed', {
+        journeyId: journeyData.journeyId,
+        correlationId,
+        error: error.message,
+        companyName: journeyData.companyName,
+        storageType: 'in-memory'
+      });
+    }
+  }
+
+  if (lines.length > 0) {
+    try {
+      await fs.promises.appendFile(PERSIST_FILE, lines.join('\n') + '\n');
+    } catch (error) {
+      console.error(`[DataPersistenceService] Write to ${PERSIST_FILE} failed:`, error.message);
+    }
+  }
+
+  const flushMs = Date.now() - started;
+  metrics.flushes++;
+  metrics.lastFlushMs = flushMs;
+  metrics.totalFlushMs += flushMs;
+  if (flushMs > metrics.maxFlushMs) metrics.maxFlushMs = flushMs;
+  metrics.lastFlushAt = new Date().toISOString();
+  console.log(`[DataPersistenceService] Persisted ${batch.length} journey(s) in ${flushMs}ms (${writeBehind.queue.length} queued)`);
+}
+
+function writeBehindStats() {
+  const { metrics } = writeBehind;
+  return {
+    queueDepth: writeBehind.queue.length,
+    batchSize: PERSIST_BATCH_SIZE,
+    flushIntervalMs: PERSIST_FLUSH_MS,
+    file: PERSIST_FILE,
+    ...metrics,
+    avgFlushMs: metrics.flushes ? +(metrics.totalFlushMs / metrics.flushes).toFixed(1) : 0
+  };
+}
+
+onShutdown(async () => {
+  if (writeBehind.queue.length > 0 || writeBehind.flushing) {
+    console.log(`[DataPersistenceService] Flushing ${writeBehind.queue.length} queued journey(s) before exit`);
+    await flushJourneys();
+  }
+});
+
 createService('DataPersistenceService', (app) => {
   app.post('/process', async (req, res) => {
     const payload = req.body || {};
@@ -134,93 +301,20 @@ createService('DataPersistenceService', (app) => {
         
         addCustomAttributes(customAttributes);
 
-        // Store in memory (replaces MongoDB)
-        let storageResult = null;
-        let storageError = null;
-        
-        try {
-          console.log('[DataPersistenceService] Storing journey data in memory...');
-          
-          // Store journey in memory
-          const documentId = crypto.randomUUID();
-          journeyData.documentId = documentId;
-          journeyData.storedAt = new Date().toISOString();
-          
-          // Store in memory collections
-          journeyStorage.journeys.set(journeyData.journeyId, journeyData);
-          
-          // Store individual steps
-          if (journeyData.steps && Array.isArray(journeyData.steps)) {
-            journeyData.steps.forEach((step, index) => {
-              journeyStorage.steps.push({
-                id: crypto.randomUUID(),
-                journeyId: journeyData.journeyId,
-                stepIndex: index + 1,
-                stepName: step.stepName || `Step${index + 1}`,
-                serviceName: step.serviceName || `${step.stepName}Service`,
-                stepData: step,
-                companyContext: {
-                  companyName: journeyData.companyName,
-                  industryType: journeyData.industryType,
-                  domain: journeyData.domain
-                },
-                timestamp: new Date().toISOString()
-              });
-            });
-          }
-          
-          // Update stats
-          journeyStorage.stats.totalJourneys++;
-          
-          if (!journeyStorage.stats.companiesStats.has(journeyData.companyName)) {
-            journeyStorage.stats.companiesStats.set(journeyData.companyName, {
-              count: 0,
-              latestJourney: null,
-              avgBusinessValue: 0,
-              industries: new Set()
-            });
-          }
-          
-          const companyStats = journeyStorage.stats.companiesStats.get(journeyData.companyName);
-          companyStats.count++;
-          companyStats.latestJourney = journeyData.storedAt;
-          companyStats.avgBusinessValue = ((companyStats.avgBusinessValue * (companyStats.count - 1)) + journeyData.businessValue) / companyStats.count;
-          companyStats.industries.add(journeyData.industryType);
-          
-          storageResult = {
-            success: true,
-            journeyId: journeyData.journeyId,
-            documentId: documentId,
-            timestamp: journeyData.storedAt
-          };
-          
-          console.log(`[DataPersistenceService] Successfully stored journey in memory:`, storageResult);
-          
-          // Send business event for successful storage
-          sendBusinessEvent('journey_data_persisted', {
-            journeyId: journeyData.journeyId,
-            correlationId,
-            companyName: journeyData.companyName,
-            industryType: journeyData.industryType,
-            totalSteps: journeyData.totalSteps,
-            businessValue: journeyData.businessValue,
-            documentId: storageResult.documentId,
-            storageType: 'in-memory'
-          });
-          
-        } catch (error) {
-          console.error('[DataPersistenceService] Memory storage failed:', error.message);
-          storageError = error.message;
-          
-          // Send business event for storage failure
-          sendBusinessEvent('journey_storage_failed', {
-            journeyId: journeyData.journeyId,
-            correlationId,
-            error: error.message,
-            companyName: journeyData.companyName,
-            storageType: 'in-memory'
-          });
-        }
+        // Queue for the write-behind store (replaces MongoDB); the response
+        // does not wait for it
+        const documentId = crypto.randomUUID();
+        journeyData.documentId = documentId;
+        journeyData.storedAt = new Date().toISOString();
+        enqueueJourney(journeyData, correlationId);
+
+        const storageResult = {
+          success: true,
+          journeyId: journeyData.journeyId,
+          documentId,
+          timestamp: journeyData.storedAt
+        };
+        const storageError = null;
 
         // Update journey trace with this final step
         const journeyTrace = Array.isArray(payload.journeyTrace) ? [...payload.journeyTrace] : [];
@@ -230,7 +324,7 @@ createService('DataPersistenceService', (app) => {
           timestamp: new Date().toISOString(),
           correlationId,
           processingTime,
-          storageOperation: storageResult ? 'success' : 'failed',
+          storageOperation: 'queued',
           documentId: storageResult?.documentId || null
         };
         journeyTrace.push(stepEntry);
@@ -253,7 +347,8 @@ createService('DataPersistenceService', (app) => {
             documentId: storageResult?.documentId || null,
             error: storageError,
             storedAt: storageResult?.timestamp || null,
-            storageType: 'in-memory'
+            storageType: 'in-memory',
+            writeBehind: true
           },
           
           // Final journey summary
@@ -323,7 +418,8 @@ createService('DataPersistenceService', (app) => {
         type: 'in-memory',
         journeysStored: journeyStorage.journeys.size,
         stepsStored: journeyStorage.steps.length,
-        companiesTracked: journeyStorage.stats.companiesStats.size
+        companiesTracked: journeyStorage.stats.companiesStats.size,
+        writeBehind: writeBehindStats()
       };
       
       res.json({
@@ -421,7 +517,8 @@ createService('DataPersistenceService', (app) => {
         ...stats,
         generatedAt: new Date().toISOString(),
         service: 'DataPersistenceService',
-        storageType: 'in-memory'
+        storageType: 'in-memory',
+        writeBehind: writeBehindStats()
       });
       
     } catch (error) {
@@ -433,4 +530,4 @@ createService('DataPersistenceService', (app) => {
   });
 });
 
-console.log('[DataPersistenceService] Service initialized with in-memory storage');
\ No newline at end of file
+console.log(`[DataPersistenceService] Service initialized with in-memory storage (write-behind: ${PERSIST_BATCH_SIZE} per batch, ${PERSIST_FLUSH_MS}ms${PERSIST_FILE ? `, ${PERSIST_FILE}` : ''})`);
\ No newline at end of file
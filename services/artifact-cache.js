@@ -0,0 +1,164 @@
+/**
+ * Content-addressed cache of generated load-test artifacts
+ * A test's script, scenario, curl simulation, engine config and body
+ * templates depend only on its inputs (journey, test profile, drivers'
+ * options), so they are generated once into a directory named after a hash
+ * of those inputs and reused by every later test with the same inputs:
+ *
+ *   loadrunner-tests/cache/<Company>_<key>/      artifacts, customers.dat
+ *   loadrunner-tests/cache/<Company>_<key>/runs/<timestamp>/   one per test
+ *
+ * The cache holds LOADTEST_ARTIFACT_CACHE_SIZE entries and evicts the least
+ * recently used one, runs included. Entries with a test still running are
+ * pinned and skipped. Recency survives restarts as the directory's mtime.
+ */
+import fs from 'fs/promises';
+import path from 'path';
+import crypto from 'crypto';
+
+// Bump when a generator changes what it writes, so old entries stop matching
+export const ARTIFACT_FORMAT = 3;
+export const ARTIFACT_CACHE_SIZE = parseInt(process.env.LOADTEST_ARTIFACT_CACHE_SIZE || '0') || 16;
+const KEY_CHARS = 16;
+const KEY_FILE = '.artifact-key';
+
+// JSON with object keys sorted, so the key ignores property order
+function canonicalJson(value) {
+  if (Array.isArray(value)) return `[${value.map(canonicalJson).join(',')}]`;
+  if (value && typeof value === 'object') {
+    return `{${Object.keys(value).sort()
+      .filter(k => value[k] !== undefined)
+      .map(k => `${JSON.stringify(k)}:${canonicalJson(value[k])}`).join(',')}}`;
+  }
+  return JSON.stringify(value ?? null);
+}
+
+/** Hex SHA-256 of the artifact format and `inputs`. */
+export function artifactKey(inputs) {
+  return crypto.createHash('sha256')
+    .update(canonicalJson({ format: ARTIFACT_FORMAT, inputs }))
+    .digest('hex');
+}
+
+export class ArtifactCache {
+  constructor(root, capacity = ARTIFACT_CACHE_SIZE) {
+    this.root = root;
+    this.capacity = Math.max(1, capacity);
+    this.entries = null;      // dir name -> { dir, pins }, least recently used first
+    this.pending = new Map(); // dir name -> { promise, waiters } build in flight
+    this.hits = 0;
+    this.misses = 0;
+    this.evictions = 0;
+  }
+
+  // Entries left by earlier processes, oldest first
+  async load() {
+    if (this.entries) return;
+    const entries = new Map();
+    let names = [];
+    try {
+      names = await fs.readdir(this.root);
+    } catch (e) {
+      if (e.code !== 'ENOENT') throw e;
+    }
+    const found = [];
+    for (const name of names) {
+      const dir = path.join(this.root, name);
+      try {
+        await fs.access(path.join(dir, KEY_FILE));
+        found.push({ name, dir, mtime: (await fs.stat(dir)).mtimeMs });
+      } catch {
+        // Half-built or foreign directory; not an entry
+      }
+    }
+    found.sort((a, b) => a.mtime - b.mtime);
+    for (const { name, dir } of found) entries.set(name, { dir, pins: 0 });
+    this.entries = entries;
+  }
+
+  /**
+   * Directory of the artifacts for `key`, running build(scratch, dir) to
+   * generate them on a miss: files go into scratch, paths written into them
+   * name dir. The entry becomes most recently used and stays pinned
+   * until release(dir).
+   */
+  async acquire(label, key, build) {
+    await this.load();
+    const name = `${String(label || 'test').replace(/[^\w-]+/g, '')}_${key.slice(0, KEY_CHARS)}`;
+    const dir = path.join(this.root, name);
+
+    const cached = this.entries.get(name);
+    if (cached) {
+      this.entries.delete(name);
+      this.entries.set(name, cached);
+      cached.pins++;
+      this.hits++;
+      const now = new Date();
+      await fs.utimes(dir, now, now).catch(() => {});
+      return { dir, key, hit: true };
+    }
+
+    // Concurrent starts of the same test share one build, which inserts the
+    // entry already pinned once per waiter so an eviction cannot take it first
+    let job = this.pending.get(name);
+    if (!job) {
+      job = { promise: null, waiters: 0 };
+      job.promise = this.build(name, dir, key, build, job).finally(() => this.pending.delete(name));
+      this.pending.set(name, job);
+      this.misses++;
+    } else {
+      this.hits++;
+    }
+    job.waiters++;
+    await job.promise;
+    await this.evict();
+    return { dir, key, hit: false };
+  }
+
+  // Generated into a scratch directory and renamed, so an entry is complete or absent
+  async build(name, dir, key, build, job) {
+    const scratch = `${dir}.${process.pid}.tmp`;
+    await fs.rm(scratch, { recursive: true, force: true });
+    await fs.mkdir(scratch, { recursive: true });
+    try {
+      await build(scratch, dir);
+      await fs.writeFile(path.join(scratch, KEY_FILE), `${key}\n`);
+      await fs.rm(dir, { recursive: true, force: true });
+      await fs.rename(scratch, dir);
+    } catch (e) {
+      await fs.rm(scratch, { recursive: true, force: true });
+      throw e;
+    }
+    this.entries.set(name, { dir, pins: job.waiters });
+  }
+
+  release(dir) {
+    const entry = this.entries?.get(path.basename(dir));
+    if (entry && entry.pins > 0) entry.pins--;
+    // Entries kept past capacity while pinned go as soon as they can
+    if (this.entries && this.entries.size > this.capacity) {
+      this.evict().catch(e => console.warn(`[ArtifactCache] Eviction failed: ${e.message}`));
+    }
+  }
+
+  async evict() {
+    for (const [name, entry] of this.entries) {
+      if (this.entries.size <= this.capacity) break;
+      if (entry.pins > 0) continue;
+      this.entries.delete(name);
+      this.evictions++;
+      await fs.rm(entry.dir, { recursive: true, force: true });
+      console.log(`[ArtifactCache] Evicted ${name}`);
+    }
+  }
+
+  stats() {
+    return {
+      entries: this.entries ? this.entries.size : 0,
+      capacity: this.capacity,
+      hits: this.hits,
+      misses: this.misses,
+      evictions: this.evictions
+    };
+  }
+}
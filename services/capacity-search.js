@@ -0,0 +1,191 @@
+/**
+ * Capacity search for the load drivers: the highest arrival rate a journey
+ * holds steady under the scenario's monitoring thresholds
+ * The same step/bisection controller as the native engine
+ * (native/loadgen/src/capacity_search.cpp). Each step offers a constant rate
+ * for step_time seconds; the first fifth settles and the rest is measured. A
+ * step holds when every transaction keeps its p99 within
+ * response_time_threshold and its error rate within error_rate_threshold,
+ * and no more than a second's worth of arrivals is still waiting. Rates grow
+ * by `growth` while steps hold, then bisect between the highest held and the
+ * lowest failed rate until they are `precision` apart. Every transaction is
+ * judged on its own too, so the report names the one that broke first.
+ */
+const MIN_RATE = 0.01; // journeys/sec; backing off below this gives up
+
+/**
+ * loadrunner_config.capacity_search with defaults, or null when the search is
+ * off. `enabled` overrides the block's own flag (LR_CAPACITY_SEARCH).
+ */
+export function capacitySearchConfig(loadrunnerConfig = {}, enabled) {
+  const block = loadrunnerConfig.capacity_search;
+  const on = enabled !== undefined && enabled !== '' ? ['1', 'true', true].includes(enabled) : !!block && block.enabled !== false;
+  if (!on) return null;
+  const cfg = typeof block === 'object' && block ? block : {};
+  return {
+    startRate: Number(cfg.start_rate) || 0,
+    maxRate: Number(cfg.max_rate) || 0,
+    stepSec: Number(cfg.step_time) > 0 ? Number(cfg.step_time) : 30,
+    growth: Number(cfg.growth) > 1 ? Number(cfg.growth) : 2,
+    precision: Number(cfg.precision) > 0 ? Number(cfg.precision) : 0.05,
+    maxSteps: Math.max(1, parseInt(cfg.max_steps) || 20),
+    cooldownSec: cfg.cooldown >= 0 ? Number(cfg.cooldown) : 5
+  };
+}
+
+/** Latency and outcome per transaction name over one measured window. */
+export class SearchWindow {
+  constructor() {
+    this.reset();
+  }
+
+  reset() {
+    this.tx = new Map(); // name -> { count, fail, latencies }
+  }
+
+  record(name, ok, latencyMs) {
+    let w = this.tx.get(name);
+    if (!w) this.tx.set(name, w = { count: 0, fail: 0, latencies: [] });
+    w.count++;
+    if (!ok) w.fail++;
+    w.latencies.push(latencyMs);
+  }
+
+  samples() {
+    return [...this.tx].map(([name, w]) => {
+      const sorted = w.latencies.sort((a, b) => a - b);
+      return { name, count: w.count, fail: w.fail, p99Ms: sorted[Math.min(sorted.length - 1, Math.ceil(sorted.length * 0.99) - 1)] };
+    });
+  }
+}
+
+export class CapacitySearch {
+  /**
+   * `monitoring` is the scenario's block; its throughput_target seeds the first
+   * step when the config has no start_rate. Throws without thresholds.
+   */
+  constructor(cfg, monitoring = {}, fallbackRate = monitoring.throughput_target) {
+    this.cfg = cfg;
+    this.thresholdMs = Number(monitoring.response_time_threshold) || 0;
+    this.errorThresholdPct = Number(monitoring.error_rate_threshold) || 0;
+    if (this.thresholdMs <= 0 && this.errorThresholdPct <= 0) {
+      throw new Error('capacity search needs monitoring.response_time_threshold or error_rate_threshold');
+    }
+    this.rate = cfg.startRate > 0 ? cfg.startRate : Math.max(1, (Number(fallbackRate) || 0) / 4);
+    if (cfg.maxRate > 0 && this.rate > cfg.maxRate) this.rate = cfg.maxRate;
+    this.held = 0;     // highest rate that held
+    this.failed = 0;   // lowest rate that failed, 0 = none yet
+    this.done = false;
+    this.history = [];
+    this.verdicts = new Map(); // name -> { heldUpTo, brokeAt, reason }
+  }
+
+  /** Judge the window just measured at this.rate and move to the next step; returns the step's record. */
+  finishStep(samples, queued) {
+    const step = { rate: this.rate, held: true, reason: '', requests: 0, worstP99Ms: 0, worstErrorPct: 0, queued };
+    for (const s of samples) {
+      if (s.count === 0) continue;
+      step.requests += s.count;
+      const errorPct = 100 * s.fail / s.count;
+      step.worstP99Ms = Math.max(step.worstP99Ms, s.p99Ms);
+      step.worstErrorPct = Math.max(step.worstErrorPct, errorPct);
+
+      let reason = '';
+      if (this.thresholdMs > 0 && s.p99Ms > this.thresholdMs) {
+        reason = `${s.name} p99 ${s.p99Ms.toFixed(0)} ms > ${this.thresholdMs} ms`;
+      } else if (this.errorThresholdPct > 0 && errorPct > this.errorThresholdPct) {
+        reason = `${s.name} errors ${errorPct.toFixed(1)}% > ${this.errorThresholdPct}%`;
+      }
+
+      if (!this.verdicts.has(s.name)) this.verdicts.set(s.name, { heldUpTo: 0, brokeAt: 0, reason: '' });
+      const v = this.verdicts.get(s.name);
+      if (!reason) {
+        v.heldUpTo = Math.max(v.heldUpTo, this.rate);
+        continue;
+      }
+      if (v.brokeAt === 0 || this.rate < v.brokeAt) {
+        v.brokeAt = this.rate;
+        v.reason = reason;
+      }
+      if (step.held) {
+        step.held = false;
+        step.reason = reason;
+      }
+    }
+    // A backlog means the offered rate was not absorbed, whatever the
+    // requests that did run looked like
+    if (step.held && queued > Math.max(1, this.rate)) {
+      step.held = false;
+      step.reason = `${queued} arrivals queued for a free slot`;
+    }
+    if (step.held && step.requests === 0) {
+      step.held = false;
+      step.reason = 'no requests completed (step_time shorter than a journey?)';
+    }
+
+    if (step.held) this.held = Math.max(this.held, this.rate);
+    else if (this.failed === 0 || this.rate < this.failed) this.failed = this.rate;
+    this.history.push(step);
+    this.advance();
+    return step;
+  }
+
+  advance() {
+    const { growth, maxRate, maxSteps, precision } = this.cfg;
+    if (this.history.length >= maxSteps) {
+      this.done = true;
+    } else if (this.failed === 0) {
+      // Still climbing: nothing has failed yet
+      let next = this.rate * growth;
+      if (maxRate > 0 && next > maxRate) {
+        if (this.held >= maxRate) {
+          this.done = true;
+          return;
+        }
+        next = maxRate;
+      }
+      this.rate = next;
+    } else if (this.held === 0) {
+      // The first rate already failed: back off until one holds
+      this.rate = this.failed / growth;
+      if (this.rate < MIN_RATE) this.done = true;
+    } else if (this.failed <= this.held * (1 + precision)) {
+      this.done = true;
+    } else {
+      this.rate = (this.held + this.failed) / 2;
+    }
+  }
+
+  bottleneck() {
+    let worst = null;
+    for (const [name, v] of this.verdicts) {
+      if (v.brokeAt > 0 && (!worst || v.brokeAt < worst.brokeAt)) worst = { name, ...v };
+    }
+    return worst;
+  }
+
+  /** The engine_summary.json capacitySearch block, same field names. */
+  toJSON() {
+    return {
+      maxSustainableRate: this.held,
+      lowestFailedRate: this.failed,
+      thresholds: { p99Ms: this.thresholdMs, errorRatePct: this.errorThresholdPct },
+      stepSec: this.cfg.stepSec,
+      bottleneck: this.bottleneck()?.name || null,
+      steps: this.history,
+      transactions: [...this.verdicts].map(([name, v]) => ({ name, ...v }))
+    };
+  }
+
+  /** Report lines, `prefix` first: the overall result, then held_up_to/broke_at per transaction. */
+  reportLines(prefix) {
+    const b = this.bottleneck();
+    const lines = [`${prefix} 📐 Capacity: ${this.held > 0 ? `${this.held.toFixed(2)} journeys/s held` : 'no rate held'}` +
+      `${this.failed > 0 ? `, failed at ${this.failed.toFixed(2)}` : ''} (${this.history.length} steps)` +
+      `${b ? `; bottleneck ${b.reason}` : ''}`];
+    for (const [name, v] of this.verdicts) {
+      lines.push(`${prefix} CAP ${name.padEnd(32)} held_up_to=${v.heldUpTo.toFixed(2)} broke_at=${v.brokeAt.toFixed(2)}${v.reason ? ` ${v.reason}` : ''}`);
+    }
+    return lines;
+  }
+}
@@ -1,5 +1,6 @@
 const http = require('http');
 const crypto = require('crypto');
+const { FORWARDING_HEADER, CONTEXT_HEADER, contextRequest, markContextSent, isContextMissing } = require('./journey-context.cjs');
 
 const SERVICE_PORTS = {
   'discovery-service': 4101,
@@ -88,7 +89,9 @@ function callService(serviceName, payload, headers = {}, overridePort) {
             lowerKey === 'tracestate' ||
             lowerKey.startsWith('x-dynatrace') ||
             lowerKey.includes('trace') ||
-            lowerKey.includes('span')) {
+            lowerKey.includes('span') ||
+            lowerKey === 'x-error-schedule' ||
+            lowerKey === FORWARDING_HEADER) {
           requestHeaders[key] = headers[key];
         }
       });
@@ -109,26 +112,40 @@ function callService(serviceName, payload, headers = {}, overridePort) {
         k.toLowerCase().includes('dynatrace')
       ));
     
-    const req = http.request(options, (res) => {
-      let body = '';
-      res.setEncoding('utf8');
-      res.on('data', (c) => (body += c));
-      res.on('end', () => {
-        try { 
-          const result = body ? JSON.parse(body) : {};
-          console.log(`✅ [${serviceName}] Service call completed with trace propagation`);
-          resolve(result); 
-        } catch (e) { 
-          console.error(`❌ [${serviceName}] Failed to parse response:`, e.message);
-          reject(e); 
+    // Delta mode sends a service only the step's delta once it has the journey context
+    const forwarding = requestHeaders[FORWARDING_HEADER] === 'delta';
+    const send = (forceFull) => {
+      const contextReq = forwarding ? contextRequest(port, payload?.correlationId, payload || {}, forceFull) : null;
+      const req = http.request({
+        ...options,
+        headers: contextReq?.ref ? { ...requestHeaders, [CONTEXT_HEADER]: 'ref' } : requestHeaders
+      }, (res) => {
+        if (contextReq?.ref && isContextMissing(res)) {
+          res.resume();
+          return send(true);
         }
+        let body = '';
+        res.setEncoding('utf8');
+        res.on('data', (c) => (body += c));
+        res.on('end', () => {
+          try { 
+            const result = body ? JSON.parse(body) : {};
+            if (contextReq) markContextSent(contextReq);
+            console.log(`✅ [${serviceName}] Service call completed with trace propagation`);
+            resolve(result); 
+          } catch (e) { 
+            console.error(`❌ [${serviceName}] Failed to parse response:`, e.message);
+            reject(e); 
+          }
+        });
       });
-    });
-    req.on('error', (err) => {
-      console.error(`❌ [${serviceName}] Service call failed:`, err.message);
-      reject(err);
-    });
-    req.end(JSON.stringify(payload || {}));
+      req.on('error', (err) => {
+        console.error(`❌ [${serviceName}] Service call failed:`, err.message);
+        reject(err);
+      });
+      req.end(JSON.stringify(contextReq ? contextReq.body : payload || {}));
+    };
+    send(false);
   });
 }
 
@@ -0,0 +1,183 @@
+/**
+ * Cluster mode for the main server (CLUSTER_WORKERS > 1)
+ * The process started as server.js stays the owner of all shared state: the
+ * service registry and child services, circuit breakers, LoadRunner tests,
+ * continuous generation, feature flags and Socket.IO. It moves to a loopback
+ * port, and CLUSTER_WORKERS workers (cluster-worker.js) share the public
+ * PORT. A worker runs the journey-simulation hot path itself, JSON parsing and
+ * service proxying included, and streams every other request to the owner
+ * unparsed. What the hot path needs from the owner goes over the IPC calls
+ * below; the owner pushes state changes back with broadcast() and reads the
+ * workers' own state (their limiters and pools) with gather().
+ */
+import cluster from 'cluster';
+import os from 'os';
+import path from 'path';
+import { fileURLToPath } from 'url';
+
+const __dirname = path.dirname(fileURLToPath(import.meta.url));
+
+export const CLUSTER_WORKERS = process.env.CLUSTER_WORKERS === 'auto'
+  ? os.availableParallelism()
+  : parseInt(process.env.CLUSTER_WORKERS || '0') || 0;
+// Set by the owner when it forks, so a server.js run under another cluster
+// manager (pm2) is never mistaken for one of our workers
+export const OWNER_PORT = parseInt(process.env.BIZOBS_OWNER_PORT || '0');
+export const IS_CLUSTER_WORKER = cluster.isWorker && OWNER_PORT > 0;
+export const IS_CLUSTER_OWNER = cluster.isPrimary && CLUSTER_WORKERS > 1;
+
+const CALL_TIMEOUT_MS = 60000;   // covers a cold service start
+const GATHER_TIMEOUT_MS = 2000;
+const RESPAWN_DELAY_MS = 1000;
+
+const handlers = new Map();      // owner: call name -> fn
+const listeners = new Map();     // worker: broadcast name -> [fn]
+const gatherers = new Map();     // worker: gather name -> fn
+const pending = new Map();       // worker: call id -> { resolve, reject, timer }
+const gathering = new Map();     // owner: gather id -> { results, waiting, done }
+let callSeq = 0;
+let gatherSeq = 0;
+let stopping = false;
+let restarts = 0;
+
+/** Serve `name` to workers' callOwner/notifyOwner; harmless outside cluster mode. */
+export function serveOwner(name, fn) {
+  handlers.set(name, fn);
+}
+
+/** `fn` where the owner's state lives, and a stub calling the owner's `fn` in a worker. */
+export function ownerMethod(name, fn, { notify = false } = {}) {
+  if (IS_CLUSTER_WORKER) {
+    return notify ? (...args) => notifyOwner(name, ...args) : (...args) => callOwner(name, ...args);
+  }
+  serveOwner(name, fn);
+  return fn;
+}
+
+export function callOwner(name, ...args) {
+  return new Promise((resolve, reject) => {
+    const id = ++callSeq;
+    const timer = setTimeout(() => {
+      pending.delete(id);
+      reject(new Error(`Owner call ${name} timed out`));
+    }, CALL_TIMEOUT_MS);
+    pending.set(id, { resolve, reject, timer });
+    process.send({ type: 'bizobs:call', id, name, args });
+  });
+}
+
+// Fire and forget: no reply is sent
+export function notifyOwner(name, ...args) {
+  process.send({ type: 'bizobs:call', name, args });
+}
+
+/** Send `data` to every worker's onBroadcast(name) listeners; a no-op without workers. */
+export function broadcast(name, data) {
+  if (!IS_CLUSTER_OWNER) return;
+  for (const worker of Object.values(cluster.workers)) {
+    if (worker.isConnected()) worker.send({ type: 'bizobs:broadcast', name, data });
+  }
+}
+
+export function onBroadcast(name, fn) {
+  if (!listeners.has(name)) listeners.set(name, []);
+  listeners.get(name).push(fn);
+}
+
+/**
+ * Ask every worker's onGather(name) handler; resolves with [{ pid, result }]
+ * from the workers that answered within GATHER_TIMEOUT_MS ([] without workers).
+ */
+export function gather(name, ...args) {
+  const workers = IS_CLUSTER_OWNER ? Object.values(cluster.workers).filter(w => w.isConnected()) : [];
+  if (workers.length === 0) return Promise.resolve([]);
+  return new Promise(resolve => {
+    const id = ++gatherSeq;
+    const results = [];
+    const done = () => {
+      clearTimeout(timer);
+      gathering.delete(id);
+      resolve(results);
+    };
+    const timer = setTimeout(done, GATHER_TIMEOUT_MS);
+    gathering.set(id, { results, waiting: workers.length, done });
+    for (const worker of workers) worker.send({ type: 'bizobs:gather', id, name, args });
+  });
+}
+
+export function onGather(name, fn) {
+  gatherers.set(name, fn);
+}
+
+if (IS_CLUSTER_WORKER) {
+  process.on('message', msg => {
+    if (msg?.type === 'bizobs:reply') {
+      const call = pending.get(msg.id);
+      if (!call) return;
+      pending.delete(msg.id);
+      clearTimeout(call.timer);
+      if (msg.error !== undefined) call.reject(new Error(msg.error));
+      else call.resolve(msg.result);
+    } else if (msg?.type === 'bizobs:broadcast') {
+      for (const fn of listeners.get(msg.name) || []) fn(msg.data);
+    } else if (msg?.type === 'bizobs:gather') {
+      const fn = gatherers.get(msg.name);
+      Promise.resolve()
+        .then(() => (fn ? fn(...msg.args) : null))
+        .catch(error => ({ error: error.message }))
+        .then(result => process.send({ type: 'bizobs:gathered', id: msg.id, result }));
+    }
+  });
+}
+
+function handleWorkerMessage(worker, msg) {
+  if (msg?.type === 'bizobs:gathered') {
+    const request = gathering.get(msg.id);
+    if (!request) return;
+    request.results.push({ pid: worker.process.pid, result: msg.result });
+    if (--request.waiting === 0) request.done();
+    return;
+  }
+  if (msg?.type !== 'bizobs:call') return;
+  const fn = handlers.get(msg.name);
+  Promise.resolve()
+    .then(() => {
+      if (!fn) throw new Error(`No owner handler for ${msg.name}`);
+      return fn(...msg.args);
+    })
+    .then(result => {
+      if (msg.id && worker.isConnected()) worker.send({ type: 'bizobs:reply', id: msg.id, result });
+    }, error => {
+      if (msg.id && worker.isConnected()) worker.send({ type: 'bizobs:reply', id: msg.id, error: error.message });
+      else if (!msg.id) console.error(`[cluster] ${msg.name} from worker ${worker.id} failed: ${error.message}`);
+    });
+}
+
+/** Fork the workers for `ownerPort` (the owner's loopback port) and keep them running. */
+export function startClusterWorkers(ownerPort) {
+  cluster.setupPrimary({ exec: path.join(__dirname, '..', 'cluster-worker.js') });
+  cluster.on('message', handleWorkerMessage);
+  const fork = () => cluster.fork({ BIZOBS_OWNER_PORT: String(ownerPort) });
+  cluster.on('exit', (worker, code, signal) => {
+    if (stopping) return;
+    restarts++;
+    console.warn(`[cluster] ⚠️ Worker ${worker.process.pid} exited (${signal || code}), starting a new one`);
+    setTimeout(fork, RESPAWN_DELAY_MS);
+  });
+  for (let i = 0; i < CLUSTER_WORKERS; i++) fork();
+  console.log(`[cluster] 🧵 ${CLUSTER_WORKERS} workers share the public port; owner on 127.0.0.1:${ownerPort}`);
+}
+
+export function stopClusterWorkers() {
+  stopping = true;
+  for (const worker of Object.values(cluster.workers || {})) worker.kill();
+}
+
+export function clusterStatus() {
+  if (!IS_CLUSTER_OWNER) return { enabled: false };
+  return {
+    enabled: true,
+    workers: Object.values(cluster.workers).map(w => w.process.pid),
+    restarts
+  };
+}
@@ -0,0 +1,168 @@
+/**
+ * Adaptive concurrency limits for calls from the main server to child services
+ * One limiter per service. The limit follows the service's round-trip time:
+ * while recent calls are about as fast as the best the service has recently
+ * managed it grows, and as they slow down it shrinks (the gradient limit from
+ * Netflix's concurrency-limits). Timeouts and
+ * connection errors cut it multiplicatively. Calls over the limit wait in a
+ * short FIFO queue and are shed once it is full or they have waited too long,
+ * so a slowing service sheds load early instead of timing out under all of it.
+ */
+
+export const SERVICE_ADAPTIVE_LIMIT = process.env.SERVICE_ADAPTIVE_LIMIT !== '0';
+const INITIAL_LIMIT = parseInt(process.env.SERVICE_LIMIT_INITIAL || '0') || 20;
+const MIN_LIMIT = parseInt(process.env.SERVICE_LIMIT_MIN || '0') || 2;
+const MAX_LIMIT = parseInt(process.env.SERVICE_LIMIT_MAX || '0') || 200;
+const MAX_QUEUE = parseInt(process.env.SERVICE_LIMIT_QUEUE || '0') || 50;
+const MAX_QUEUE_MS = parseInt(process.env.SERVICE_LIMIT_QUEUE_MS || '0') || 1000;
+
+const TOLERANCE = 1.5;        // recent RTT may reach 1.5x the baseline before the limit drops
+const SMOOTHING = 0.2;        // weight of each new limit estimate
+const BACKOFF = 0.9;          // multiplicative decrease on a timeout or dropped connection
+const SHORT_WINDOW = 10;      // samples in the recent RTT average
+const BASELINE_WINDOWS = 50;  // recent averages the baseline (their minimum) is taken over
+
+class ServiceLimiter {
+  constructor(serviceName) {
+    this.serviceName = serviceName;
+    this.limit = INITIAL_LIMIT;
+    this.inFlight = 0;
+    this.queue = [];
+    this.shortRttMs = 0;
+    this.baselineMs = Infinity;   // min over the current and previous baseline windows
+    this.windowMinMs = Infinity;
+    this.previousMinMs = Infinity;
+    this.windows = 0;
+    this.samples = 0;
+    this.admitted = 0;
+    this.queued = 0;
+    this.shed = 0;
+    this.dropped = 0;
+    this.maxQueueWaitMs = 0;
+  }
+
+  // Resolves with a slot to release when the call ends, or null when shed
+  acquire() {
+    if (this.inFlight < Math.floor(this.limit)) return Promise.resolve(this.admit(Date.now()));
+    if (this.queue.length >= MAX_QUEUE) {
+      this.shed++;
+      return Promise.resolve(null);
+    }
+    this.queued++;
+    return new Promise(resolve => {
+      const waiter = { resolve, enqueuedAt: Date.now() };
+      waiter.timer = setTimeout(() => {
+        const i = this.queue.indexOf(waiter);
+        if (i >= 0) this.queue.splice(i, 1);
+        this.shed++;
+        resolve(null);
+      }, MAX_QUEUE_MS);
+      this.queue.push(waiter);
+    });
+  }
+
+  admit(enqueuedAt) {
+    const now = Date.now();
+    this.maxQueueWaitMs = Math.max(this.maxQueueWaitMs, now - enqueuedAt);
+    this.inFlight++;
+    this.admitted++;
+    let released = false;
+    return {
+      release: (outcome, downstreamMs = 0) => {
+        if (released) return;
+        released = true;
+        this.inFlight--;
+        this.onSample(Math.max(0, Date.now() - now - downstreamMs), outcome);
+        this.drain();
+      }
+    };
+  }
+
+  onSample(rttMs, outcome) {
+    if (outcome === 'dropped') {
+      this.dropped++;
+      this.limit = Math.max(MIN_LIMIT, this.limit * BACKOFF);
+      return;
+    }
+    this.samples++;
+    this.shortRttMs += (rttMs - this.shortRttMs) / Math.min(this.samples, SHORT_WINDOW);
+    if (this.samples % SHORT_WINDOW !== 0) return;
+
+    // Baseline: the best recent average, aged out a window at a time so a
+    // service that gets permanently slower is not held to its old speed
+    this.windowMinMs = Math.min(this.windowMinMs, this.shortRttMs);
+    if (++this.windows >= BASELINE_WINDOWS) {
+      this.previousMinMs = this.windowMinMs;
+      this.windowMinMs = Infinity;
+      this.windows = 0;
+    }
+    this.baselineMs = Math.min(this.windowMinMs, this.previousMinMs);
+
+    const gradient = Math.max(0.5, Math.min(1, TOLERANCE * this.baselineMs / this.shortRttMs));
+    const estimate = gradient * this.limit + Math.sqrt(this.limit);
+    // Only grow when the limit is what holds the callers back
+    if (estimate > this.limit && this.inFlight + 1 < this.limit / 2) return;
+    const next = this.limit * (1 - SMOOTHING) + estimate * SMOOTHING;
+    this.limit = Math.max(MIN_LIMIT, Math.min(MAX_LIMIT, next));
+  }
+
+  drain() {
+    while (this.queue.length > 0 && this.inFlight < Math.floor(this.limit)) {
+      const waiter = this.queue.shift();
+      clearTimeout(waiter.timer);
+      waiter.resolve(this.admit(waiter.enqueuedAt));
+    }
+  }
+
+  stats() {
+    return {
+      limit: Math.floor(this.limit),
+      inFlight: this.inFlight,
+      queueDepth: this.queue.length,
+      rttMs: +this.shortRttMs.toFixed(1),
+      baselineRttMs: Number.isFinite(this.baselineMs) ? +this.baselineMs.toFixed(1) : null,
+      admitted: this.admitted,
+      queued: this.queued,
+      shed: this.shed,
+      dropped: this.dropped,
+      maxQueueWaitMs: this.maxQueueWaitMs
+    };
+  }
+}
+
+const limiters = new Map(); // serviceName -> ServiceLimiter
+const UNLIMITED_SLOT = { release() {} };
+
+/**
+ * Wait for a slot on `serviceName`. Resolves with { release(outcome,
+ * downstreamMs) } or null when the call should be shed; outcome is 'ok' for
+ * any response and 'dropped' for a timeout or connection failure, and
+ * downstreamMs is the part of the call a chained service spent on the steps
+ * after it, left out of this service's RTT sample.
+ */
+export function acquireServiceSlot(serviceName) {
+  if (!SERVICE_ADAPTIVE_LIMIT) return Promise.resolve(UNLIMITED_SLOT);
+  let limiter = limiters.get(serviceName);
+  if (!limiter) {
+    limiter = new ServiceLimiter(serviceName);
+    limiters.set(serviceName, limiter);
+  }
+  return limiter.acquire();
+}
+
+// One service's limiter, or every limiter in this process by service name
+export function concurrencyLimitStats(serviceName) {
+  if (serviceName === undefined) {
+    return Object.fromEntries([...limiters].map(([name, limiter]) => [name, limiter.stats()]));
+  }
+  const limiter = limiters.get(serviceName);
+  return limiter ? limiter.stats() : null;
+}
+
+// Forget learned limits (waiting calls keep their place in the old queue)
+export function resetConcurrencyLimits(serviceName) {
+  if (serviceName) return limiters.delete(serviceName);
+  const count = limiters.size;
+  limiters.clear();
+  return count;
+}
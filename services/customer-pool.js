@@ -0,0 +1,174 @@
+/**
+ * Shared synthetic customer pool (customers.dat) for every load driver
+ * One fixed 128-byte record per customer: a LoadRunner-style parameter table
+ * (comma-separated, header row first) whose rows are padded to the same
+ * length, so record i starts at (i + 1) * 128 and a driver reads its customer
+ * with one positioned read or straight out of a read-only mapping:
+ *
+ *   customer_name,customer_email,customer_segment,traffic_source,location,loyalty_tier,pad
+ *
+ * The last column is space padding up to the newline. Values never contain
+ * a comma, quote or backslash, so they go into JSON bodies as they are. The
+ * pool is generated deterministically from its size, once per host, and
+ * hard-linked into each test directory. The native engine (--customers), the
+ * generated LoadRunner script, the curl simulation and the load simulator
+ * all step through the same rows.
+ */
+import fs from 'fs';
+import path from 'path';
+import { fileURLToPath } from 'url';
+
+const __dirname = path.dirname(fileURLToPath(import.meta.url));
+
+export const CUSTOMER_RECORD_BYTES = 128;
+export const CUSTOMER_POOL_FILE = 'customers.dat';
+export const CUSTOMER_COLUMNS = ['customer_name', 'customer_email', 'customer_segment', 'traffic_source', 'location', 'loyalty_tier', 'pad'];
+// Emails carry the row number, so the pool tops out below a seventh digit
+export const CUSTOMER_POOL_SIZE = Math.min(999999, parseInt(process.env.CUSTOMER_POOL_SIZE || '0') || 100000);
+const SHARED_POOL = path.join(__dirname, '..', 'loadrunner-tests', CUSTOMER_POOL_FILE);
+
+const FIRST_NAMES = [
+  'James', 'Mary', 'Robert', 'Patricia', 'John', 'Jennifer', 'Michael', 'Linda', 'David', 'Elizabeth',
+  'William', 'Barbara', 'Richard', 'Susan', 'Joseph', 'Jessica', 'Thomas', 'Sarah', 'Charles', 'Karen',
+  'Daniel', 'Lisa', 'Matthew', 'Nancy', 'Anthony', 'Betty', 'Mark', 'Margaret', 'Steven', 'Ashley',
+  'Andrew', 'Kimberly', 'Paul', 'Emily', 'Joshua', 'Donna', 'Kevin', 'Michelle', 'Brian', 'Amanda',
+  'Wei', 'Priya', 'Aarav', 'Sofia', 'Mateo', 'Yuki', 'Fatima', 'Omar', 'Chloe', 'Lucas',
+  'Amara', 'Kwame', 'Ingrid', 'Lars', 'Elena', 'Dmitri', 'Aisha', 'Hiroshi', 'Camila', 'Rafael',
+  'Noah', 'Olivia', 'Liam', 'Emma', 'Ethan', 'Ava', 'Mia', 'Leo', 'Zara', 'Arjun'
+];
+const LAST_NAMES = [
+  'Smith', 'Johnson', 'Williams', 'Brown', 'Jones', 'Garcia', 'Miller', 'Davis', 'Rodriguez', 'Martinez',
+  'Hernandez', 'Lopez', 'Gonzalez', 'Wilson', 'Anderson', 'Thomas', 'Taylor', 'Moore', 'Jackson', 'Martin',
+  'Lee', 'Perez', 'Thompson', 'White', 'Harris', 'Sanchez', 'Clark', 'Ramirez', 'Lewis', 'Robinson',
+  'Walker', 'Young', 'Allen', 'King', 'Wright', 'Scott', 'Torres', 'Nguyen', 'Hill', 'Flores',
+  'Green', 'Adams', 'Nelson', 'Baker', 'Hall', 'Rivera', 'Campbell', 'Mitchell', 'Carter', 'Roberts',
+  'Chen', 'Kim', 'Patel', 'Singh', 'Kumar', 'Wang', 'Zhang', 'Tanaka', 'Sato', 'Muller',
+  'Schmidt', 'Rossi', 'Silva', 'Santos', 'Novak', 'Kowalski', 'Ivanov', 'Dubois', 'Murphy', 'Kelly',
+  'Cohen', 'Larsen', 'Jensen', 'Hansen', 'Haddad', 'Okafor', 'Mensah', 'Costa', 'Fischer', 'Moreau'
+];
+const EMAIL_DOMAINS = ['email.com', 'example.com', 'example.net', 'example.org'];
+// Same segments and traffic sources the drivers have always sent
+const SEGMENTS = ['Premium', 'Standard', 'Budget', 'Enterprise', 'SMB', 'Startup'];
+const TRAFFIC_SOURCES = [
+  'Google_Ads', 'Facebook_Campaign', 'Email_Newsletter', 'Direct_Traffic',
+  'Referral_Partner', 'Organic_Search', 'Social_Media', 'Content_Marketing'
+];
+const LOCATIONS = [
+  'US-East', 'US-West', 'US-Central', 'CA-Toronto', 'UK-London', 'EU-West', 'EU-Central',
+  'EU-North', 'APAC-Sydney', 'APAC-Tokyo', 'APAC-Mumbai', 'LATAM-SaoPaulo', 'MEA-Dubai'
+];
+const LOYALTY_TIERS = ['Bronze', 'Silver', 'Gold', 'Platinum'];
+
+// Integer hash of (row, field): every row is independent of the ones before it
+function pick(list, index, field) {
+  let h = Math.imul(index + 1, 0x9e3779b1) ^ Math.imul(field + 1, 0x85ebca77);
+  h = Math.imul(h ^ (h >>> 16), 0x7feb352d);
+  h = Math.imul(h ^ (h >>> 15), 0x846ca68b);
+  return list[((h ^ (h >>> 16)) >>> 0) % list.length];
+}
+
+/** Customer `index` of the pool, as generated. */
+export function customerRecord(index) {
+  const first = pick(FIRST_NAMES, index, 0);
+  const last = pick(LAST_NAMES, index, 1);
+  const initial = String.fromCharCode(65 + (index % 26));
+  return {
+    name: `${first} ${initial}. ${last}`,
+    email: `${first}.${initial}.${last}${index + 1}@${pick(EMAIL_DOMAINS, index, 2)}`.toLowerCase(),
+    segment: pick(SEGMENTS, index, 3),
+    trafficSource: pick(TRAFFIC_SOURCES, index, 4),
+    location: pick(LOCATIONS, index, 5),
+    loyaltyTier: pick(LOYALTY_TIERS, index, 6)
+  };
+}
+
+function writeRow(buf, row, values) {
+  const line = values.join(',');
+  if (line.length >= CUSTOMER_RECORD_BYTES) throw new Error(`Customer row ${row} does not fit ${CUSTOMER_RECORD_BYTES} bytes`);
+  const offset = row * CUSTOMER_RECORD_BYTES;
+  buf.fill(0x20, offset, offset + CUSTOMER_RECORD_BYTES - 1);
+  buf.write(line, offset, 'latin1');
+  buf[offset + CUSTOMER_RECORD_BYTES - 1] = 0x0a;
+}
+
+function isCurrentPool(file, count) {
+  try {
+    const fd = fs.openSync(file, 'r');
+    try {
+      const header = Buffer.alloc(CUSTOMER_COLUMNS[0].length);
+      fs.readSync(fd, header, 0, header.length, 0);
+      return fs.fstatSync(fd).size === (count + 1) * CUSTOMER_RECORD_BYTES &&
+        header.toString('latin1') === CUSTOMER_COLUMNS[0];
+    } finally {
+      fs.closeSync(fd);
+    }
+  } catch (e) {
+    if (e.code === 'ENOENT') return false;
+    throw e;
+  }
+}
+
+/**
+ * Path of a pool of `count` customers, generating it first when it is
+ * missing or a different size. Written to a temp file and renamed, so a
+ * driver never maps a half-written pool.
+ */
+export async function ensureCustomerPool(file = SHARED_POOL, count = CUSTOMER_POOL_SIZE) {
+  if (isCurrentPool(file, count)) return file;
+  const started = Date.now();
+  const buf = Buffer.alloc((count + 1) * CUSTOMER_RECORD_BYTES);
+  writeRow(buf, 0, CUSTOMER_COLUMNS);
+  for (let i = 0; i < count; i++) {
+    const c = customerRecord(i);
+    writeRow(buf, i + 1, [c.name, c.email, c.segment, c.trafficSource, c.location, c.loyaltyTier, '']);
+  }
+  await fs.promises.mkdir(path.dirname(file), { recursive: true });
+  const tmp = `${file}.${process.pid}.tmp`;
+  await fs.promises.writeFile(tmp, buf);
+  await fs.promises.rename(tmp, file);
+  console.log(`[CustomerPool] Generated ${count} customers in ${file} (${Date.now() - started} ms)`);
+  return file;
+}
+
+/**
+ * The shared pool as `dir`/customers.dat: a hard link where the filesystem
+ * allows it (one copy in the page cache for every test), a copy otherwise.
+ */
+export async function linkCustomerPool(dir, count = CUSTOMER_POOL_SIZE) {
+  const shared = await ensureCustomerPool(SHARED_POOL, count);
+  const target = path.join(dir, CUSTOMER_POOL_FILE);
+  if (isCurrentPool(target, count)) return target;
+  await fs.promises.rm(target, { force: true });
+  try {
+    await fs.promises.link(shared, target);
+  } catch {
+    await fs.promises.copyFile(shared, target);
+  }
+  return target;
+}
+
+/**
+ * Read-only handle on a pool file. read(index) wraps around the pool and
+ * returns a fresh object per call; one 128-byte buffer is reused underneath.
+ */
+export function openCustomerPool(file) {
+  const fd = fs.openSync(file, 'r');
+  const count = fs.fstatSync(fd).size / CUSTOMER_RECORD_BYTES - 1;
+  if (!Number.isInteger(count) || count < 1) {
+    fs.closeSync(fd);
+    throw new Error(`${file} is not a customer pool`);
+  }
+  const record = Buffer.alloc(CUSTOMER_RECORD_BYTES);
+  return {
+    count,
+    read(index) {
+      const row = ((index % count) + count) % count;
+      fs.readSync(fd, record, 0, CUSTOMER_RECORD_BYTES, (row + 1) * CUSTOMER_RECORD_BYTES);
+      const [name, email, segment, trafficSource, location, loyaltyTier] = record.toString('latin1').split(',');
+      return { index: row, name, email, segment, trafficSource, location, loyaltyTier };
+    },
+    close() {
+      fs.closeSync(fd);
+    }
+  };
+}
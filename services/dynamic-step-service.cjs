@@ -4,6 +4,7 @@
  */
 const { createService } = require('./service-runner.cjs');
 const { callService, getServiceNameFromStep, getServicePortFromStep } = require('./child-caller.cjs');
+const { groupAt } = require('./step-groups.cjs');
 const { 
   TracedError, 
   withErrorTracking, 
@@ -378,6 +379,20 @@ function getRemediationAction(flagName) {
   return actions[flagName] || 'manual_intervention';
 }
 
+// Injected errors are counted, and logged as one line for 1 in
+// LOADTEST_LOG_SAMPLE of them (none at LOADTEST_LOG_LEVEL=error), the same
+// settings as the load drivers' per-iteration lines (services/load-log.js)
+const INJECTION_LOG_INFO = process.env.LOADTEST_LOG_LEVEL !== 'error';
+const INJECTION_LOG_SAMPLE = parseInt(process.env.LOADTEST_LOG_SAMPLE || '0') || 1;
+const injectedErrors = new Map(); // feature flag (or the load test schedule) -> count
+
+function logInjectedError(serviceName, stepName, errorInjected) {
+  const count = (injectedErrors.get(errorInjected.feature_flag) || 0) + 1;
+  injectedErrors.set(errorInjected.feature_flag, count);
+  if (!INJECTION_LOG_INFO || count % INJECTION_LOG_SAMPLE !== 0) return;
+  console.log(`🚨 [${serviceName}] ${errorInjected.feature_flag} failed ${stepName} with ${errorInjected.error_type} (HTTP ${errorInjected.http_status}), ${count} so far`);
+}
+
 // Wait for a service health endpoint to respond on the given port
 function waitForServiceReady(port, timeout = 5000) {
   return new Promise((resolve) => {
@@ -441,6 +456,7 @@ function createStepService(serviceName, stepName) {
       const payload = req.body || {};
       const correlationId = req.correlationId;
       const thinkTimeMs = Number(payload.thinkTimeMs || 200);
+      const receivedAt = Date.now();
       const currentStepName = payload.stepName || stepName;
       
       // Process payload to ensure single values for arrays (no flattening, just array simplification)
@@ -621,8 +637,32 @@ function createStepService(serviceName, stepName) {
         console.log(`🌐 [Error Config] Using global config from API (Dynatrace controlled): ${globalConfig.errors_per_transaction}`);
       }
       
+      // 🎲 Load-test error schedule: the LoadRunner script / native engine precomputes
+      // (seeded per VU) which steps of this iteration fail and names them in
+      // x-error-schedule, so a rerun with the same seed fails the same requests.
+      // The failure is decided here, inline, and takes precedence over feature flags.
+      const scheduledErrorSteps = String(req.headers['x-error-schedule'] || '')
+        .split(',')
+        .map(name => name.trim())
+        .filter(Boolean);
+      if (scheduledErrorSteps.includes(currentStepName)) {
+        errorInjected = {
+          feature_flag: 'load_test_error_schedule',
+          error_type: 'internal_error',
+          http_status: getHttpStatusForErrorType('internal_error'),
+          message: getErrorMessageForType('internal_error', currentStepName),
+          remediation_action: getRemediationAction('load_test_error_schedule'),
+          recoverable: true,
+          retry_count: 0,
+          injected_at: new Date().toISOString()
+        };
+        logInjectedError(properServiceName, currentStepName, errorInjected);
+      }
+      
       // Check if errors are disabled (errors_per_transaction = 0)
-      if (errorConfig.errors_per_transaction === 0) {
+      if (errorInjected) {
+        // Scheduled by the load driver; feature flags are not consulted
+      } else if (errorConfig.errors_per_transaction === 0) {
         console.log(`⏸️  [Feature Flags] Errors disabled (errors_per_transaction=0) - Self-healing active!`);
         featureFlags = {};
       } else {
@@ -666,8 +706,7 @@ function createStepService(serviceName, stepName) {
                   injected_at: new Date().toISOString()
                 };
                 
-                console.log(`🚦 Feature flag triggered: ${flagName} on step ${currentStepName}`);
-                console.log(`🚨 Injecting error:`, JSON.stringify(errorInjected, null, 2));
+                logInjectedError(properServiceName, currentStepName, errorInjected);
                 break; // Only inject one error per request
               }
             }
@@ -700,9 +739,6 @@ function createStepService(serviceName, stepName) {
           realError.status = errorHttpStatus;
           realError.httpStatus = errorHttpStatus;
           
-          console.error(`🚨 [${properServiceName}] FEATURE FLAG EXCEPTION: ${errorMessage}`);
-          console.error(`🚨 [${properServiceName}] Error Type: ${errorInjected.error_type} | HTTP ${errorHttpStatus} | Flag: ${errorInjected.feature_flag}`);
-          
           // Add error-specific custom attributes for Dynatrace
           addCustomAttributes({
             'journey.step': currentStepName,
@@ -800,6 +836,8 @@ function createStepService(serviceName, stepName) {
           status: errorInjected ? 'error' : 'completed',
           correlationId,
           processingTime,
+          // This step's own time, before any downstream chaining (reported as journey.stepTimings)
+          stepDurationMs: Date.now() - receivedAt,
           pid: process.pid,
           timestamp: new Date().toISOString(),
           // Include step-specific duration fields from the current step data
@@ -841,15 +879,166 @@ function createStepService(serviceName, stepName) {
 
 
         // --- Chaining logic ---
-        let nextStepName = null;
-        let nextServiceName = undefined;
-        
+        // Calls the step at `index` of the journey as this span's child: asks the
+        // main server to ensure its service is running, then sends it this
+        // payload re-targeted at that step. `extraFields` go into its payload.
+        const callStepAt = async (index, extraFields = {}) => {
+          const nextStepData = payload.steps[index];
+          const nextStepName = nextStepData.stepName || nextStepData.name;
+          const nextServiceName = nextStepData.serviceName || getServiceNameFromStep(nextStepName);
+          // Ask main server to ensure next service is running and get its port
+          let nextServicePort = null;
+          try {
+            const adminPort = process.env.MAIN_SERVER_PORT || '4000';
+            nextServicePort = await new Promise((resolve, reject) => {
+              const req = http.request({ hostname: '127.0.0.1', port: adminPort, path: '/api/admin/ensure-service', method: 'POST', headers: { 'Content-Type': 'application/json' } }, (res) => { 
+                let data = '';
+                res.on('data', chunk => data += chunk);
+                res.on('end', () => {
+                  try {
+                    const parsed = JSON.parse(data);
+                    resolve(parsed.port || null);
+                  } catch {
+                    resolve(null);
+                  }
+                });
+              });
+              req.on('error', () => resolve(null));
+              req.end(JSON.stringify({ 
+                stepName: nextStepName, 
+                serviceName: nextServiceName,
+                context: {
+                  companyName: payload.companyName,
+                  domain: payload.domain,
+                  industryType: payload.industryType,
+                  journeyType: payload.journeyType,
+                  stepName: nextStepName,
+                  serviceName: nextServiceName,
+                  category: nextStepData.category || ''
+                }
+              }));
+            });
+            console.log(`[${properServiceName}] Next service ${nextServiceName} allocated on port ${nextServicePort}`);
+          } catch (e) {
+            console.error(`[${properServiceName}] Failed to get next service port:`, e.message);
+          }
+
+          const nextPayload = {
+            ...processedPayload,  // Use flattened payload instead of original
+            // 🔒 CLEAN THE CHAIN v2.6.3: Ensure no error contamination passes downstream
+            hasError: false,
+            error_occurred: false,
+            status: 'completed',
+            error: undefined,
+            traceError: undefined,
+            httpStatus: undefined,
+            _traceInfo: undefined,
+            // 🔧 v2.6.3: Also deep-clean additionalFields.hasError to prevent bizevent contamination
+            additionalFields: {
+              ...(processedPayload.additionalFields || {}),
+              hasError: false,
+              errorType: undefined,
+              errorMessage: undefined,
+              errorSeverity: undefined
+            },
+            stepName: nextStepName,
+            serviceName: nextServiceName,
+            // Add step-specific fields for the next step
+            stepDescription: nextStepData.description || '',
+            stepCategory: nextStepData.category || '',
+            estimatedDuration: nextStepData.estimatedDuration,
+            businessRationale: nextStepData.businessRationale,
+            substeps: nextStepData.substeps,
+            estimatedDurationMs: nextStepData.estimatedDuration ? nextStepData.estimatedDuration * 60 * 1000 : null,
+            action: 'auto_chained',
+            parentStep: currentStepName,
+            correlationId,
+            journeyId: payload.journeyId,
+            // 🔧 v2.6.3: Explicitly propagate ALL environment values for downstream services
+            domain: payload.domain,
+            companyName: payload.companyName,
+            industryType: payload.industryType,
+            journeyType: payload.journeyType,
+            thinkTimeMs,
+            steps: payload.steps,
+            traceId,
+            spanId, // pass as parentSpanId to next
+            journeyTrace,
+            parallelMember: undefined,
+            ...extraFields
+          };
+          
+          // Build proper trace headers for service-to-service call
+          const traceHeaders = { 
+            'x-correlation-id': correlationId,
+            // W3C Trace Context format
+            'traceparent': `00-${traceId.padEnd(32, '0')}-${spanId.padEnd(16, '0')}-01`,
+            // Dynatrace specific headers
+            'x-dynatrace-trace-id': traceId,
+            'x-dynatrace-parent-span-id': spanId
+          };
+          
+          // Pass through any incoming trace state
+          if (incomingTraceState) {
+            traceHeaders['tracestate'] = incomingTraceState;
+          }
+          // The load test error schedule names steps further down the chain too
+          if (req.headers['x-error-schedule']) {
+            traceHeaders['x-error-schedule'] = req.headers['x-error-schedule'];
+          }
+          // Delta-mode forwarding holds for the whole chain
+          if (req.headers['x-journey-forwarding']) {
+            traceHeaders['x-journey-forwarding'] = req.headers['x-journey-forwarding'];
+          }
+          
+          console.log(`[${properServiceName}] Propagating trace to ${nextServiceName}: traceparent=${traceHeaders['traceparent']}`);
+          
+          // Use the port returned from ensure-service API (actual allocated port)
+          const nextPort = nextServicePort || getServicePortFromStep(nextServiceName);
+          console.log(`[${properServiceName}] Calling ${nextServiceName} on port ${nextPort}`);
+          // Ensure next service is listening before calling
+          await waitForServiceReady(nextPort, 5000);
+          return callService(nextServiceName, nextPayload, traceHeaders, nextPort);
+        };
+
+        // 🔧 ERROR ISOLATION v2.6.3: Sanitize downstream responses before nesting.
+        // Strip error indicators so upstream services' response bodies don't contain
+        // nested error fields that OneAgent bizevent capture rules might detect.
+        const sanitizeDownstream = (next) => {
+          if (!next || typeof next !== 'object') return next;
+          const sanitizedNext = { ...next };
+          delete sanitizedNext.error_occurred;
+          delete sanitizedNext.hasError;
+          delete sanitizedNext.error;
+          delete sanitizedNext.traceError;
+          delete sanitizedNext._traceInfo;
+          delete sanitizedNext.httpStatus;
+          // Also sanitize deeper nested responses
+          if (sanitizedNext.next && typeof sanitizedNext.next === 'object') {
+            const sanitizedDeep = { ...sanitizedNext.next };
+            delete sanitizedDeep.error_occurred;
+            delete sanitizedDeep.hasError;
+            delete sanitizedDeep.error;
+            delete sanitizedDeep.traceError;
+            delete sanitizedDeep._traceInfo;
+            delete sanitizedDeep.httpStatus;
+            sanitizedNext.next = sanitizedDeep;
+          }
+          return sanitizedNext;
+        };
+
+        // Think time and the steps after this one, reported apart from our own time
+        const chainStarted = Date.now();
         console.log(`[${properServiceName}] 🔗 CHAINING LOGIC: Checking for next step...`);
         console.log(`[${properServiceName}] 🔗 Current step: ${currentStepName}`);
         console.log(`[${properServiceName}] 🔗 Has steps array: ${!!(payload.steps && Array.isArray(payload.steps))}`);
-        if (payload.steps && Array.isArray(payload.steps)) {
+        if (payload.parallelMember) {
+          // One of a parallel group: the service that fanned the group out
+          // continues the chain once every member has answered
+          console.log(`[${properServiceName}] 🔗 PARALLEL GROUP MEMBER: the caller continues the chain`);
+        } else if (payload.steps && Array.isArray(payload.steps)) {
           console.log(`[${properServiceName}] 🔗 Steps array length: ${payload.steps.length}`);
-          console.log(`[${properServiceName}] 🔗 Steps array contents:`, JSON.stringify(payload.steps.map(s => ({ stepName: s.stepName, serviceName: s.serviceName })), null, 2));
+          console.log(`[${properServiceName}] 🔗 Steps array contents:`, JSON.stringify(payload.steps.map(s => ({ stepName: s.stepName, serviceName: s.serviceName, parallelGroup: s.parallelGroup })), null, 2));
           
           const currentIndex = payload.steps.findIndex(s =>
             (s.stepName === currentStepName) ||
@@ -857,175 +1046,54 @@ function createStepService(serviceName, stepName) {
             (s.serviceName === properServiceName)
           );
           console.log(`[${properServiceName}] 🔗 Current step index: ${currentIndex} of ${payload.steps.length - 1}`);
-          
-          if (currentIndex >= 0 && currentIndex < payload.steps.length - 1) {
-            const nextStep = payload.steps[currentIndex + 1];
-            nextStepName = nextStep ? (nextStep.stepName || nextStep.name) : null;
-            nextServiceName = nextStep && nextStep.serviceName ? nextStep.serviceName : (nextStepName ? getServiceNameFromStep(nextStepName) : undefined);
-            console.log(`[${properServiceName}] 🔗 FOUND NEXT STEP: ${nextStepName} (service: ${nextServiceName})`);
-          } else {
+          let nextIndex = currentIndex >= 0 ? currentIndex + 1 : payload.steps.length;
+          if (nextIndex >= payload.steps.length) {
             console.log(`[${properServiceName}] 🔗 NO NEXT STEP: End of journey (current index: ${currentIndex})`);
-            nextStepName = null;
-            nextServiceName = undefined;
           }
-        } else {
-          console.log(`[${properServiceName}] 🔗 NO STEPS ARRAY in payload - cannot chain!`);
-        }
 
-        if (nextStepName && nextServiceName) {
-          try {
+          // Parallel groups fan out from here, each member a child of this
+          // span, and the chain carries on after the whole group has answered.
+          // The first step without a group is called as before and chains the rest.
+          while (nextIndex < payload.steps.length) {
+            const group = groupAt(payload.steps, nextIndex);
             await new Promise(r => setTimeout(r, thinkTimeMs));
-            // Ask main server to ensure next service is running and get its port
-            let nextServicePort = null;
-            try {
-              const adminPort = process.env.MAIN_SERVER_PORT || '4000';
-              nextServicePort = await new Promise((resolve, reject) => {
-                const req = http.request({ hostname: '127.0.0.1', port: adminPort, path: '/api/admin/ensure-service', method: 'POST', headers: { 'Content-Type': 'application/json' } }, (res) => { 
-                  let data = '';
-                  res.on('data', chunk => data += chunk);
-                  res.on('end', () => {
-                    try {
-                      const parsed = JSON.parse(data);
-                      resolve(parsed.port || null);
-                    } catch {
-                      resolve(null);
-                    }
-                  });
-                });
-                req.on('error', () => resolve(null));
-                req.end(JSON.stringify({ 
-                  stepName: nextStepName, 
-                  serviceName: nextServiceName,
-                  context: {
-                    companyName: payload.companyName,
-                    domain: payload.domain,
-                    industryType: payload.industryType,
-                    journeyType: payload.journeyType,
-                    stepName: nextStepName,
-                    serviceName: nextServiceName,
-                    category: nextStepData?.category || ''
-                  }
-                }));
-              });
-              console.log(`[${properServiceName}] Next service ${nextServiceName} allocated on port ${nextServicePort}`);
-            } catch (e) {
-              console.error(`[${properServiceName}] Failed to get next service port:`, e.message);
-            }
-            // Look up next step's specific data
-            let nextStepData = null;
-            if (payload.steps && Array.isArray(payload.steps)) {
-              nextStepData = payload.steps.find(step => 
-                step.stepName === nextStepName || 
-                step.name === nextStepName ||
-                step.serviceName === nextServiceName
-              );
+            if (group.length === 1) {
+              const nextStepName = payload.steps[nextIndex].stepName || payload.steps[nextIndex].name;
+              console.log(`[${properServiceName}] 🔗 FOUND NEXT STEP: ${nextStepName}`);
+              try {
+                const next = await callStepAt(nextIndex);
+                // Bubble up the full downstream trace to the current response; ensure our own span is included once
+                if (next && Array.isArray(next.trace)) {
+                  const hasCurrent = next.trace.some(s => s.spanId === spanId);
+                  // after any parallel members' spans collected above
+                  response.trace = [...(response.trace || []), ...(hasCurrent ? next.trace : [...next.trace, { traceId, spanId, parentSpanId, stepName: currentStepName }])];
+                }
+                response.next = sanitizeDownstream(next);
+              } catch (e) {
+                response.nextError = e.message;
+                console.error(`[${properServiceName}] Error calling next service:`, e.message);
+              }
+              break;
             }
 
-            const nextPayload = {
-              ...processedPayload,  // Use flattened payload instead of original
-              // 🔒 CLEAN THE CHAIN v2.6.3: Ensure no error contamination passes downstream
-              hasError: false,
-              error_occurred: false,
-              status: 'completed',
-              error: undefined,
-              traceError: undefined,
-              httpStatus: undefined,
-              _traceInfo: undefined,
-              // 🔧 v2.6.3: Also deep-clean additionalFields.hasError to prevent bizevent contamination
-              additionalFields: {
-                ...(processedPayload.additionalFields || {}),
-                hasError: false,
-                errorType: undefined,
-                errorMessage: undefined,
-                errorSeverity: undefined
-              },
-              stepName: nextStepName,
-              serviceName: nextServiceName,
-              // Add step-specific fields for the next step
-              stepDescription: nextStepData?.description || '',
-              stepCategory: nextStepData?.category || '',
-              estimatedDuration: nextStepData?.estimatedDuration,
-              businessRationale: nextStepData?.businessRationale,
-              substeps: nextStepData?.substeps,
-              estimatedDurationMs: nextStepData?.estimatedDuration ? nextStepData.estimatedDuration * 60 * 1000 : null,
-              action: 'auto_chained',
-              parentStep: currentStepName,
-              correlationId,
-              journeyId: payload.journeyId,
-              // 🔧 v2.6.3: Explicitly propagate ALL environment values for downstream services
-              domain: payload.domain,
-              companyName: payload.companyName,
-              industryType: payload.industryType,
-              journeyType: payload.journeyType,
-              thinkTimeMs,
-              steps: payload.steps,
-              traceId,
-              spanId, // pass as parentSpanId to next
-              journeyTrace
-            };
-            
-            // Build proper trace headers for service-to-service call
-            const traceHeaders = { 
-              'x-correlation-id': correlationId,
-              // W3C Trace Context format
-              'traceparent': `00-${traceId.padEnd(32, '0')}-${spanId.padEnd(16, '0')}-01`,
-              // Dynatrace specific headers
-              'x-dynatrace-trace-id': traceId,
-              'x-dynatrace-parent-span-id': spanId
-            };
-            
-            // Pass through any incoming trace state
-            if (incomingTraceState) {
-              traceHeaders['tracestate'] = incomingTraceState;
-            }
-            
-            console.log(`[${properServiceName}] Propagating trace to ${nextServiceName}: traceparent=${traceHeaders['traceparent']}`);
-            
-            // Use the port returned from ensure-service API (actual allocated port)
-            const nextPort = nextServicePort || getServicePortFromStep(nextServiceName);
-            console.log(`[${properServiceName}] Calling ${nextServiceName} on port ${nextPort}`);
-            // Ensure next service is listening before calling
-            await waitForServiceReady(nextPort, 5000);
-            const next = await callService(nextServiceName, nextPayload, traceHeaders, nextPort);
-            // Bubble up the full downstream trace to the current response; ensure our own span is included once
-            if (next && Array.isArray(next.trace)) {
-              const last = next.trace[next.trace.length - 1];
-              // If our span isn't the last, append ours before adopting
-              const hasCurrent = next.trace.some(s => s.spanId === spanId);
-              response.trace = hasCurrent ? next.trace : [...next.trace, { traceId, spanId, parentSpanId, stepName: currentStepName }];
+            console.log(`[${properServiceName}] 🔀 PARALLEL GROUP: ${group.map(i => payload.steps[i].stepName || payload.steps[i].name).join(', ')}`);
+            const members = await Promise.all(group.map(index => callStepAt(index, { parallelMember: true }).catch(e => {
+              console.error(`[${properServiceName}] Error calling parallel step ${payload.steps[index].stepName}:`, e.message);
+              return { stepName: payload.steps[index].stepName || payload.steps[index].name, status: 'failed', error: e.message };
+            })));
+            response.parallel = [...(response.parallel || []), ...members.map(sanitizeDownstream)];
+            for (const member of members) {
+              if (Array.isArray(member?.trace)) response.trace = [...(response.trace || []), ...member.trace];
             }
-            // 🔧 ERROR ISOLATION v2.6.3: Sanitize downstream response before nesting.
-            // Strip error indicators so upstream services' response bodies don't contain
-            // nested error fields that OneAgent bizevent capture rules might detect.
-            if (next && typeof next === 'object') {
-              const sanitizedNext = { ...next };
-              delete sanitizedNext.error_occurred;
-              delete sanitizedNext.hasError;
-              delete sanitizedNext.error;
-              delete sanitizedNext.traceError;
-              delete sanitizedNext._traceInfo;
-              delete sanitizedNext.httpStatus;
-              // Also sanitize deeper nested responses
-              if (sanitizedNext.next && typeof sanitizedNext.next === 'object') {
-                const sanitizedDeep = { ...sanitizedNext.next };
-                delete sanitizedDeep.error_occurred;
-                delete sanitizedDeep.hasError;
-                delete sanitizedDeep.error;
-                delete sanitizedDeep.traceError;
-                delete sanitizedDeep._traceInfo;
-                delete sanitizedDeep.httpStatus;
-                sanitizedNext.next = sanitizedDeep;
-              }
-              response.next = sanitizedNext;
-            } else {
-              response.next = next;
-            }
-          } catch (e) {
-            response.nextError = e.message;
-            console.error(`[${properServiceName}] Error calling next service:`, e.message);
+            nextIndex = group[group.length - 1] + 1;
           }
+        } else {
+          console.log(`[${properServiceName}] 🔗 NO STEPS ARRAY in payload - cannot chain!`);
         }
 
+        // The caller's concurrency limit is fed the RTT minus `downstream`
+        res.setHeader('Server-Timing', `step;dur=${response.stepDurationMs}, downstream;dur=${Date.now() - chainStarted}`);
+
         // Send trace context headers back in response for Dynatrace distributed tracing
         res.setHeader('x-dynatrace-trace-id', traceId);
         res.setHeader('x-dynatrace-span-id', spanId);
@@ -1048,7 +1116,6 @@ function createStepService(serviceName, stepName) {
         // it still returns HTTP 200 to its upstream caller.
         if (errorInjected) {
           const errorHttpStatus = errorInjected.http_status || 500;
-          console.log(`[${properServiceName}] Returning HTTP ${errorHttpStatus} for error isolation (only THIS service shows failure)`);
           res.status(errorHttpStatus).json(response);
         } else {
           res.json(response);
@@ -0,0 +1,297 @@
+/**
+ * One scheduler for every company's continuous journey generation
+ * Each generator fires every 3-6 s (10-20 journeys a minute at weight 1, the
+ * rate the per-company setTimeout chains ran at) and asks for `weight`
+ * journeys. Firings sit in a hierarchical timer wheel driven by a single
+ * drift-corrected tick, so dozens of companies cost one timer. A global
+ * budget of CONTINUOUS_GEN_RATE_PER_MIN journeys is shared out per tick in
+ * proportion to the weights; what a generator is not granted stays as
+ * backlog (at most one firing's worth) for the next ticks. All journeys a
+ * company is granted in a tick go out as one batch, and a company with a
+ * batch still running waits for it. State is checkpointed every
+ * CONTINUOUS_GEN_CHECKPOINT_MS when something changed, not on every change,
+ * and once more on shutdown.
+ */
+import fs from 'fs';
+import path from 'path';
+
+export const GEN_TICK_MS = parseInt(process.env.CONTINUOUS_GEN_TICK_MS || '0') || 100;
+export const GEN_RATE_PER_MIN = parseInt(process.env.CONTINUOUS_GEN_RATE_PER_MIN || '0') || 600;
+export const GEN_CHECKPOINT_MS = parseInt(process.env.CONTINUOUS_GEN_CHECKPOINT_MS || '0') || 5000;
+
+const MIN_INTERVAL_MS = 3000;
+const MAX_INTERVAL_MS = 6000;
+const WHEEL_BITS = 6;         // 64 slots per level
+const WHEEL_LEVELS = 3;       // 64^3 ticks, ~7 h at 100 ms
+const MAX_CATCH_UP_TICKS = 50; // after a stall, later ticks are skipped rather than replayed
+
+/**
+ * Hashed hierarchical timer wheel over absolute tick numbers. Level n slots
+ * span 64^n ticks; a level-n slot is cascaded down when the level below
+ * wraps, so schedule and advance are O(1) per item.
+ */
+export class TimerWheel {
+  constructor(bits = WHEEL_BITS, levels = WHEEL_LEVELS) {
+    this.bits = bits;
+    this.mask = (1 << bits) - 1;
+    this.levels = Array.from({ length: levels }, () => Array.from({ length: 1 << bits }, () => []));
+    this.now = 0;
+    this.size = 0;
+  }
+
+  schedule(item, tick) {
+    this.insert({ item, tick: Math.max(tick, this.now + 1) });
+    this.size++;
+  }
+
+  // A cascaded entry due now goes into the level-0 slot about to be read
+  insert(entry) {
+    const maxDelta = 2 ** (this.bits * this.levels.length) - 1;
+    const at = Math.max(this.now, Math.min(entry.tick, this.now + maxDelta));
+    const delta = at - this.now;
+    let level = 0;
+    while (level < this.levels.length - 1 && delta >= 2 ** (this.bits * (level + 1))) level++;
+    this.levels[level][Math.floor(at / 2 ** (this.bits * level)) & this.mask].push(entry);
+  }
+
+  // Items due at the next tick
+  advance() {
+    this.now++;
+    // Higher levels first, so an item cascaded twice lands in the right slot
+    for (let level = this.levels.length - 1; level > 0; level--) {
+      const span = 2 ** (this.bits * level);
+      if (this.now % span !== 0) continue;
+      const index = Math.floor(this.now / span) & this.mask;
+      const slot = this.levels[level][index];
+      this.levels[level][index] = [];
+      for (const entry of slot) this.insert(entry);
+    }
+    const slot = this.levels[0][this.now & this.mask];
+    this.levels[0][this.now & this.mask] = [];
+    const due = [];
+    for (const entry of slot) {
+      if (entry.tick > this.now) {
+        this.insert(entry); // was past the top level's reach
+        continue;
+      }
+      this.size--;
+      due.push(entry.item);
+    }
+    return due;
+  }
+}
+
+/**
+ * runBatch(config, count) generates `count` journeys for one generator's
+ * config and resolves when they are done.
+ */
+export class GenerationScheduler {
+  constructor({ runBatch, stateFile, ratePerMinute = GEN_RATE_PER_MIN, tickMs = GEN_TICK_MS, maxBatch = 100 }) {
+    this.runBatch = runBatch;
+    this.stateFile = stateFile;
+    this.ratePerMinute = ratePerMinute;
+    this.tickMs = tickMs;
+    this.maxBatch = maxBatch;
+    this.wheel = new TimerWheel();
+    this.generators = new Map();
+    this.waiting = new Set();   // generators with backlog
+    this.tokens = 0;
+    this.timer = null;
+    this.checkpointTimer = null;
+    this.dirty = false;
+    this.ticks = 0;
+    this.skippedTicks = 0;
+  }
+
+  get tokensPerTick() {
+    return this.ratePerMinute / 60000 * this.tickMs;
+  }
+
+  intervalTicks() {
+    const ms = MIN_INTERVAL_MS + Math.random() * (MAX_INTERVAL_MS - MIN_INTERVAL_MS);
+    return Math.max(1, Math.round(ms / this.tickMs));
+  }
+
+  /** Start (or replace) `key`'s generator; the first firing is due on the next tick. */
+  add(key, config, { weight = 1 } = {}) {
+    const previous = this.generators.get(key);
+    if (previous) previous.stopped = true;
+    const generator = {
+      key,
+      config,
+      weight: Math.max(1, Math.floor(weight)),
+      backlog: 0,
+      vtime: 0,
+      inFlight: false,
+      stopped: false,
+      generated: 0,
+      failed: 0,
+      deferred: 0,
+      lastBatch: null
+    };
+    // A newcomer neither owes nor is owed service
+    const others = [...this.generators.values()].filter(g => g !== previous);
+    if (others.length > 0) generator.vtime = Math.min(...others.map(g => g.vtime));
+    this.generators.set(key, generator);
+    this.waiting.delete(previous);
+    this.wheel.schedule(generator, this.wheel.now + 1);
+    this.changed();
+    this.start();
+    return key;
+  }
+
+  remove(key) {
+    const generator = this.generators.get(key);
+    if (!generator) return false;
+    generator.stopped = true;  // its wheel entry is dropped when it comes due
+    this.generators.delete(key);
+    this.waiting.delete(generator);
+    this.changed();
+    if (this.generators.size === 0) this.stop();
+    return true;
+  }
+
+  changed() {
+    this.dirty = true;
+    if (!this.checkpointTimer && this.stateFile) {
+      this.checkpointTimer = setInterval(() => this.checkpoint(), GEN_CHECKPOINT_MS);
+      this.checkpointTimer.unref();
+    }
+  }
+
+  start() {
+    if (this.timer) return;
+    this.epoch = performance.now() - this.wheel.now * this.tickMs;
+    const loop = () => {
+      // Ticks are fixed points from the epoch, so timer lateness never accumulates
+      let behind = Math.floor((performance.now() - this.epoch) / this.tickMs) - this.wheel.now;
+      if (behind > MAX_CATCH_UP_TICKS) {
+        this.skippedTicks += behind - MAX_CATCH_UP_TICKS;
+        this.epoch += (behind - MAX_CATCH_UP_TICKS) * this.tickMs;
+        behind = MAX_CATCH_UP_TICKS;
+      }
+      for (let i = 0; i < behind; i++) this.tick();
+      const next = this.epoch + (this.wheel.now + 1) * this.tickMs;
+      this.timer = setTimeout(loop, Math.max(0, next - performance.now()));
+      this.timer.unref();
+    };
+    this.timer = setTimeout(loop, this.tickMs);
+    this.timer.unref();
+  }
+
+  stop() {
+    clearTimeout(this.timer);
+    this.timer = null;
+  }
+
+  tick() {
+    this.ticks++;
+    // The budget refills per tick and banks at most a second's worth, so it
+    // smooths bursts without saving up an idle minute
+    this.tokens = Math.min(this.tokens + this.tokensPerTick, Math.max(1, this.ratePerMinute / 60));
+    for (const generator of this.wheel.advance()) {
+      if (generator.stopped) continue;
+      generator.backlog = Math.min(generator.backlog + generator.weight, generator.weight * 2);
+      this.waiting.add(generator);
+      this.wheel.schedule(generator, this.wheel.now + this.intervalTicks());
+    }
+    if (this.waiting.size === 0) return;
+
+    const eligible = [...this.waiting].filter(g => !g.inFlight);
+    const granted = new Map();
+    // Weighted fair share: each journey goes to the generator least served
+    // per unit of weight
+    while (this.tokens >= 1 && eligible.length > 0) {
+      let pick = 0;
+      for (let i = 1; i < eligible.length; i++) if (eligible[i].vtime < eligible[pick].vtime) pick = i;
+      const generator = eligible[pick];
+      generator.vtime += 1 / generator.weight;
+      generator.backlog--;
+      this.tokens--;
+      const count = (granted.get(generator) || 0) + 1;
+      granted.set(generator, count);
+      if (generator.backlog === 0 || count >= this.maxBatch) eligible.splice(pick, 1);
+    }
+    for (const generator of this.waiting) {
+      if (!granted.has(generator)) generator.deferred++;
+      if (generator.backlog === 0) this.waiting.delete(generator);
+    }
+    for (const [generator, count] of granted) this.dispatch(generator, count);
+  }
+
+  dispatch(generator, count) {
+    generator.inFlight = true;
+    const started = Date.now();
+    Promise.resolve()
+      .then(() => this.runBatch(generator.config, count))
+      .then(result => {
+        const failed = result?.summary?.failed || 0;
+        generator.generated += count - failed;
+        generator.failed += failed;
+      }, error => {
+        generator.failed += count;
+        console.error(`[continuous-gen] ❌ Batch of ${count} for ${generator.key} failed: ${error.message}`);
+      })
+      .finally(() => {
+        generator.inFlight = false;
+        generator.lastBatch = { customers: count, batchMs: Date.now() - started, at: new Date(started).toISOString() };
+      });
+  }
+
+  /**
+   * Write the generators' configs if they changed since the last checkpoint.
+   * Writes run one at a time: a call during a write waits for it, so the
+   * promise settles once the file holds the current state.
+   */
+  checkpoint() {
+    this.checkpointing = (this.checkpointing || Promise.resolve()).then(() => this.writeCheckpoint());
+    return this.checkpointing;
+  }
+
+  async writeCheckpoint() {
+    if (!this.dirty || !this.stateFile) return;
+    this.dirty = false;
+    const state = {};
+    for (const [key, generator] of this.generators) state[key] = { ...generator.config, weight: generator.weight };
+    const tmp = `${this.stateFile}.${process.pid}.tmp`;
+    try {
+      await fs.promises.mkdir(path.dirname(this.stateFile), { recursive: true });
+      await fs.promises.writeFile(tmp, JSON.stringify(state, null, 2));
+      await fs.promises.rename(tmp, this.stateFile);
+    } catch (err) {
+      this.dirty = true;
+      console.error('[continuous-gen] Failed to save state:', err.message);
+    }
+  }
+
+  /** Saved generator configs, keyed as they were added. */
+  loadState() {
+    if (!this.stateFile || !fs.existsSync(this.stateFile)) return {};
+    return JSON.parse(fs.readFileSync(this.stateFile, 'utf8'));
+  }
+
+  status() {
+    const generators = {};
+    for (const [key, g] of this.generators) {
+      generators[key] = {
+        active: true,
+        weight: g.weight,
+        ratePerMinute: `${10 * g.weight}-${20 * g.weight} requests`,
+        generated: g.generated,
+        failed: g.failed,
+        backlog: g.backlog,
+        deferredTicks: g.deferred,
+        inFlight: g.inFlight,
+        lastBatch: g.lastBatch
+      };
+    }
+    return {
+      generators,
+      budgetPerMinute: this.ratePerMinute,
+      tickMs: this.tickMs,
+      ticks: this.ticks,
+      skippedTicks: this.skippedTicks,
+      scheduled: this.wheel.size
+    };
+  }
+}
@@ -0,0 +1,150 @@
+/**
+ * Journey context forwarding between the main server and step services
+ * (JOURNEY_CONTEXT_FORWARDING=true on the main server)
+ * A step payload is the journey's immutable context - the steps array,
+ * customer profile, trace metadata and company fields, the same at every hop -
+ * plus a small per-step delta. In delta mode (x-journey-forwarding: delta,
+ * carried down the chain) a service no longer echoes the context back in its
+ * response, so the nested chain response grows by one delta per step instead
+ * of one payload per step. Every service caches the context it was sent by
+ * correlation id; a caller that already sent a service this journey's context
+ * sends only the delta with x-journey-context: ref, and resends in full when
+ * the service answers that it no longer has it.
+ * Shared by the main server (journey-simulation.js), the chain's caller
+ * (child-caller.cjs) and the service middleware (service-runner.cjs).
+ */
+
+const FORWARDING_HEADER = 'x-journey-forwarding';
+const CONTEXT_HEADER = 'x-journey-context';
+const MISSING_HEADER = 'x-journey-context-missing';
+
+// Fields that do not change between the hops of one journey
+const CONTEXT_FIELDS = [
+  'steps', 'customerProfile', 'traceMetadata', 'sources', 'provider',
+  'companyName', 'domain', 'industryType', 'journeyType', 'journeyId', 'customerId', 'startTime'
+];
+
+const CONTEXT_CACHE_SIZE = parseInt(process.env.JOURNEY_CONTEXT_CACHE_SIZE || '0') || 2000;
+const CONTEXT_TTL_MS = parseInt(process.env.JOURNEY_CONTEXT_TTL_MS || '0') || 120000;
+
+function contextForwardingEnabled() {
+  return ['1', 'true'].includes(String(process.env.JOURNEY_CONTEXT_FORWARDING || '').toLowerCase());
+}
+
+function splitContext(payload = {}) {
+  const context = {};
+  const delta = {};
+  for (const [key, value] of Object.entries(payload)) {
+    if (CONTEXT_FIELDS.includes(key)) context[key] = value;
+    else delta[key] = value;
+  }
+  return { context, delta };
+}
+
+/** `body` without the context fields, for a delta-mode response. */
+function withoutContext(body) {
+  if (!body || typeof body !== 'object' || Array.isArray(body)) return body;
+  return splitContext(body).delta;
+}
+
+/** Least recently used map with a per-entry time to live. */
+class ContextCache {
+  constructor(size = CONTEXT_CACHE_SIZE, ttlMs = CONTEXT_TTL_MS) {
+    this.size = size;
+    this.ttlMs = ttlMs;
+    this.entries = new Map(); // key -> { value, expires }
+  }
+
+  get(key) {
+    const entry = this.entries.get(key);
+    if (!entry) return undefined;
+    this.entries.delete(key);
+    if (entry.expires < Date.now()) return undefined;
+    this.entries.set(key, entry);
+    return entry.value;
+  }
+
+  set(key, value) {
+    this.entries.delete(key);
+    this.entries.set(key, { value, expires: Date.now() + this.ttlMs });
+    if (this.entries.size > this.size) this.entries.delete(this.entries.keys().next().value);
+  }
+
+  delete(key) {
+    this.entries.delete(key);
+  }
+}
+
+// Caller side: the context each (port, correlation id) was last sent in full.
+// Contexts are compared field by field by reference, so a caller that builds
+// every hop's payload from the same journey objects sends refs, and one that
+// rebuilt them sends the context again.
+const sentContexts = new ContextCache();
+
+function sameContext(a, b) {
+  return CONTEXT_FIELDS.every(key => a[key] === b[key]);
+}
+
+/**
+ * The body to send `payload` to the service on `port` in delta mode: the
+ * delta alone (`ref` true) when that service was already sent this context.
+ * Call markContextSent() once the service has accepted a full body.
+ */
+function contextRequest(port, correlationId, payload, forceFull = false) {
+  const { context, delta } = splitContext(payload);
+  const key = `${port}|${correlationId}`;
+  const sent = correlationId && !forceFull ? sentContexts.get(key) : undefined;
+  if (sent && sameContext(sent, context)) return { key, context, ref: true, body: delta };
+  return { key, context, ref: false, body: payload };
+}
+
+function markContextSent(request) {
+  if (!request.ref) sentContexts.set(request.key, request.context);
+}
+
+/** Whether a response says the service has no context for a ref request. */
+function isContextMissing(res) {
+  return res.statusCode === 409 && res.headers[MISSING_HEADER] === '1';
+}
+
+// Service side: the context of the journeys this service was sent, by correlation id
+const receivedContexts = new ContextCache();
+
+/**
+ * Express middleware for a step service, after body parsing: in delta mode it
+ * caches a full body's context, restores the context of a ref body (409 when
+ * it has none) and leaves the context out of the JSON response.
+ */
+function journeyContextMiddleware() {
+  return (req, res, next) => {
+    if (req.headers[FORWARDING_HEADER] !== 'delta') return next();
+    const correlationId = req.headers['x-correlation-id'];
+    if (req.headers[CONTEXT_HEADER] === 'ref') {
+      const context = correlationId && receivedContexts.get(correlationId);
+      if (!context) {
+        res.setHeader(MISSING_HEADER, '1');
+        return res.status(409).json({ status: 'failed', error: `No journey context cached for ${correlationId}`, errorType: 'context_missing' });
+      }
+      req.body = { ...context, ...req.body };
+    } else if (correlationId && req.body && typeof req.body === 'object') {
+      receivedContexts.set(correlationId, splitContext(req.body).context);
+    }
+    const json = res.json.bind(res);
+    res.json = body => json(withoutContext(body));
+    next();
+  };
+}
+
+module.exports = {
+  FORWARDING_HEADER,
+  CONTEXT_HEADER,
+  CONTEXT_FIELDS,
+  contextForwardingEnabled,
+  splitContext,
+  withoutContext,
+  ContextCache,
+  contextRequest,
+  markContextSent,
+  isContextMissing,
+  journeyContextMiddleware
+};
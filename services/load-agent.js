@@ -0,0 +1,303 @@
+import { spawn } from 'child_process';
+import fs from 'fs/promises';
+import os from 'os';
+import path from 'path';
+import { fileURLToPath } from 'url';
+import { ensureCustomerPool } from './customer-pool.js';
+
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = path.dirname(__filename);
+
+/**
+ * Distributed load: one BizObs instance coordinates, N agents (BizObs
+ * instances on other hosts with the native engine built) each run one shard
+ * of the scenario with bizobs-loadgen.
+ *
+ * The coordinator splits the scenario's VUs and arrival rate across agents
+ * and gives every shard its own VU id range (--vu-offset), so X-dynaTrace VU
+ * ids, the seeded error schedule and customer pool rows (--vu-total) match a
+ * single-engine run of the same size. All shards share one LSN/LTN. Agents
+ * rewrite engine_histograms.json at every progress report; the coordinator
+ * polls it and adds the HDR bucket counts per transaction to report one
+ * merged result set.
+ */
+
+const LOADGEN_BIN = process.env.BIZOBS_LOADGEN_BIN ||
+  path.join(__dirname, '..', 'native', 'loadgen', 'build', 'bizobs-loadgen');
+const SCENARIOS_DIR = path.join(__dirname, '..', 'loadrunner-tests', 'scenarios');
+
+// Shared secret between coordinator and agents. An instance serves the agent
+// endpoints only when it has one, or when BIZOBS_AGENT_MODE=1 opts it in to
+// running shards for any caller (trusted networks only)
+const AGENT_TOKEN = process.env.BIZOBS_AGENT_TOKEN || '';
+const AGENT_MODE = process.env.BIZOBS_AGENT_MODE === '1';
+const AGENT_TOKEN_HEADER = 'x-bizobs-agent-token';
+// Finished agent runs kept for the coordinator's last poll
+const AGENT_RUNS_KEPT = 20;
+
+const agentRuns = new Map();
+
+export function agentEnabled() {
+  return !!AGENT_TOKEN || AGENT_MODE;
+}
+
+export function agentAuthorized(req) {
+  if (!agentEnabled()) return false;
+  return !AGENT_TOKEN || req.get(AGENT_TOKEN_HEADER) === AGENT_TOKEN;
+}
+
+/**
+ * Agents configured for this coordinator: BIZOBS_LOAD_AGENTS is a comma
+ * separated list of base URLs (http://loadgen-1:8080,...).
+ */
+export function configuredAgents() {
+  return (process.env.BIZOBS_LOAD_AGENTS || '').split(',').map(a => a.trim()).filter(Boolean);
+}
+
+/**
+ * Split vusers and arrivalRate over `count` agents. VUs go out as evenly as
+ * integers allow and each shard gets the next VU id range.
+ */
+export function planShards({ vusers, arrivalRate = 0 }, count) {
+  const shards = [];
+  let vuOffset = 0;
+  for (let index = 0; index < count; index++) {
+    const shardVusers = Math.floor(vusers / count) + (index < vusers % count ? 1 : 0);
+    shards.push({ index, vuOffset, vusers: shardVusers, arrivalRate: arrivalRate / count });
+    vuOffset += shardVusers;
+  }
+  return shards.filter(s => s.vusers > 0);
+}
+
+/**
+ * Scenario profile fields the coordinator shards; null when it doesn't exist.
+ */
+export async function readScenarioProfile(name) {
+  if (!name || !/^[\w-]+$/.test(name)) return null;
+  try {
+    const profile = JSON.parse(await fs.readFile(path.join(SCENARIOS_DIR, `${name}.json`), 'utf8'));
+    const lr = profile.loadrunner_config || {};
+    return {
+      scenario: name,
+      vusers: lr.vusers || 1,
+      arrivalModel: lr.arrival_model === 'open' ? 'open' : 'closed',
+      arrivalRate: lr.arrival_rate || profile.monitoring?.throughput_target || 0,
+      duration: lr.duration
+    };
+  } catch (e) {
+    return null;
+  }
+}
+
+// -------------------------------------------------------------------------
+// Histogram merge (same bucket layout as native/loadgen/src/hdr_histogram.cpp)
+// -------------------------------------------------------------------------
+
+// Highest value equivalent to bucket `index`; multiplications instead of
+// shifts, since values pass 2^31 us
+function bucketValue(index, subBucketBits) {
+  const halfBits = subBucketBits - 1;
+  const half = 2 ** halfBits;
+  let bucket = Math.floor(index / half) - 1;
+  let subBucket = (index % half) + half;
+  if (bucket < 0) {
+    subBucket -= half;
+    bucket = 0;
+  }
+  return subBucket * 2 ** bucket + 2 ** bucket - 1;
+}
+
+function addBuckets(into, pairs) {
+  for (let i = 0; i + 1 < pairs.length; i += 2) {
+    into.set(pairs[i], (into.get(pairs[i]) || 0) + pairs[i + 1]);
+  }
+}
+
+// maxUs caps the bucket values; null takes the highest bucket's value
+function percentilesMs(buckets, total, maxUs, subBucketBits) {
+  const indexes = [...buckets.keys()].sort((a, b) => a - b);
+  if (maxUs == null) maxUs = indexes.length ? bucketValue(indexes[indexes.length - 1], subBucketBits) : 0;
+  const at = (percentile) => {
+    if (total === 0) return 0;
+    const target = Math.max(1, Math.ceil(percentile / 100 * total));
+    let seen = 0;
+    for (const index of indexes) {
+      seen += buckets.get(index);
+      if (seen >= target) return Math.min(bucketValue(index, subBucketBits), maxUs);
+    }
+    return maxUs;
+  };
+  const ms = us => Math.round(us) / 1000;
+  return { p50: ms(at(50)), p90: ms(at(90)), p99: ms(at(99)), p999: ms(at(99.9)), max: ms(maxUs) };
+}
+
+/**
+ * Merge engine_histograms.json snapshots from several shards into one
+ * engine_summary-shaped transaction list.
+ */
+export function mergeHistogramSnapshots(snapshots) {
+  const byName = new Map();
+  let subBucketBits = 11;
+  for (const snap of snapshots) {
+    if (!snap) continue;
+    subBucketBits = snap.subBucketBits || subBucketBits;
+    for (const tx of snap.transactions || []) {
+      let m = byName.get(tx.name);
+      if (!m) {
+        m = { name: tx.name, pass: 0, fail: 0, sumUs: 0, minUs: Infinity, maxUs: 0, latency: new Map(), service: new Map() };
+        byName.set(tx.name, m);
+      }
+      m.pass += tx.pass;
+      m.fail += tx.fail;
+      m.sumUs += tx.sumUs;
+      if (tx.pass + tx.fail > 0) m.minUs = Math.min(m.minUs, tx.minUs);
+      m.maxUs = Math.max(m.maxUs, tx.maxUs);
+      addBuckets(m.latency, tx.latency || []);
+      addBuckets(m.service, tx.service || []);
+    }
+  }
+  return [...byName.values()].map(m => {
+    const count = m.pass + m.fail;
+    return {
+      name: m.name,
+      count,
+      pass: m.pass,
+      fail: m.fail,
+      avgMs: count ? Math.round(m.sumUs / count) / 1000 : 0,
+      minMs: count ? m.minUs / 1000 : 0,
+      maxMs: m.maxUs / 1000,
+      // Shards export the service max only; the latency max comes from its top bucket
+      latencyMs: percentilesMs(m.latency, count, null, subBucketBits),
+      serviceMs: percentilesMs(m.service, count, m.maxUs, subBucketBits)
+    };
+  });
+}
+
+// -------------------------------------------------------------------------
+// Coordinator -> agent calls
+// -------------------------------------------------------------------------
+
+export async function agentRequest(agentUrl, method, urlPath, body) {
+  const res = await fetch(`${agentUrl.replace(/\/$/, '')}/api/loadrunner-service${urlPath}`, {
+    method,
+    headers: {
+      'Content-Type': 'application/json',
+      ...(AGENT_TOKEN ? { [AGENT_TOKEN_HEADER]: AGENT_TOKEN } : {})
+    },
+    body: body ? JSON.stringify(body) : undefined,
+    signal: AbortSignal.timeout(10000)
+  });
+  const data = await res.json().catch(() => ({}));
+  if (!res.ok) throw new Error(data.error || `agent ${agentUrl} answered ${res.status}`);
+  return data;
+}
+
+// -------------------------------------------------------------------------
+// Agent side: one engine process per shard
+// -------------------------------------------------------------------------
+
+const num = (value, fallback) => (Number.isFinite(Number(value)) ? String(Number(value)) : fallback);
+
+/**
+ * Engine flags for a shard spec. Only known fields are mapped, so a
+ * coordinator cannot pass arbitrary arguments to the agent's engine.
+ */
+function shardArgs(spec, configPath, resultsDir, customerPool) {
+  const args = ['--config', configPath, '--base-url', spec.targetBaseUrl,
+    '--results-dir', resultsDir, '--export-histograms', '1',
+    '--vusers', num(spec.vusers, '1'), '--vu-offset', num(spec.vuOffset, '0')];
+  if (spec.scenario && /^[\w-]+$/.test(spec.scenario)) args.push('--scenario', path.join(SCENARIOS_DIR, `${spec.scenario}.json`));
+  if (spec.arrivalModel === 'open' || spec.arrivalModel === 'closed') args.push('--arrival-model', spec.arrivalModel);
+  const numeric = {
+    arrivalRate: '--arrival-rate', rampUp: '--ramp-up', duration: '--duration', rampDown: '--ramp-down',
+    iterations: '--iterations', journeyInterval: '--journey-interval', errorRate: '--error-rate',
+    seed: '--seed', timeCompression: '--time-compression', reportInterval: '--report-interval',
+    vuTotal: '--vu-total'
+  };
+  for (const [key, flag] of Object.entries(numeric)) {
+    if (spec[key] != null && Number.isFinite(Number(spec[key]))) args.push(flag, String(Number(spec[key])));
+  }
+  if (spec.errorSimulation != null) args.push('--error-simulation', spec.errorSimulation ? '1' : '0');
+  if (['fixed', 'exponential', 'lognormal'].includes(spec.thinkDistribution)) args.push('--think-dist', spec.thinkDistribution);
+  if (spec.journeyMode === 'chained' || spec.journeyMode === 'per-step') args.push('--journey-mode', spec.journeyMode);
+  if (spec.keepAlive != null) args.push('--keep-alive', spec.keepAlive ? '1' : '0');
+  if (spec.lsn) args.push('--lsn', String(spec.lsn));
+  if (spec.ltn) args.push('--ltn', String(spec.ltn));
+  if (customerPool) args.push('--customers', customerPool);
+  return args;
+}
+
+async function evictFinishedRuns() {
+  const finished = [...agentRuns.values()].filter(r => r.status !== 'running');
+  for (const run of finished.slice(0, Math.max(0, finished.length - AGENT_RUNS_KEPT))) {
+    agentRuns.delete(run.runId);
+    await fs.rm(run.dir, { recursive: true, force: true }).catch(() => {});
+  }
+}
+
+export async function startAgentRun(spec) {
+  if (!spec.runId || !/^[\w-]+$/.test(spec.runId)) throw new Error('runId required');
+  if (!spec.journey?.steps?.length) throw new Error('journey with steps required');
+  if (!/^https?:\/\//.test(spec.targetBaseUrl || '')) throw new Error('targetBaseUrl required');
+  if (agentRuns.get(spec.runId)?.status === 'running') throw new Error(`run ${spec.runId} already running`);
+  await fs.access(LOADGEN_BIN, fs.constants.X_OK).catch(() => {
+    throw new Error(`native engine not built on this agent (${LOADGEN_BIN})`);
+  });
+
+  const dir = await fs.mkdtemp(path.join(os.tmpdir(), `bizobs-agent-${spec.runId}-`));
+  const configPath = path.join(dir, 'test-config.json');
+  await fs.writeFile(configPath, JSON.stringify(spec.journey));
+  // Every agent generates the same pool, so shards draw from one customer set
+  const customerPool = await ensureCustomerPool().catch(e => {
+    console.warn(`[LoadAgent-${spec.runId}] Customer pool unavailable: ${e.message}`);
+    return null;
+  });
+
+  const child = spawn(LOADGEN_BIN, shardArgs(spec, configPath, dir, customerPool), { cwd: dir, stdio: ['ignore', 'pipe', 'pipe'] });
+  const run = { runId: spec.runId, dir, child, status: 'running', exitCode: null, startTime: new Date().toISOString(), vusers: spec.vusers, vuOffset: spec.vuOffset };
+  agentRuns.set(spec.runId, run);
+  child.stdout.on('data', data => console.log(`[LoadAgent-${spec.runId}] ${data.toString().trim()}`));
+  child.stderr.on('data', data => console.error(`[LoadAgent-${spec.runId}] ERROR: ${data.toString().trim()}`));
+  child.on('error', err => {
+    run.status = 'failed';
+    run.error = err.message;
+  });
+  child.on('close', code => {
+    run.exitCode = code;
+    if (run.status === 'running') run.status = code === 0 || code === 130 ? 'finished' : 'failed';
+    evictFinishedRuns();
+  });
+  console.log(`[LoadAgent] Started shard ${spec.runId}: VUs ${spec.vuOffset + 1}-${spec.vuOffset + spec.vusers} -> ${spec.targetBaseUrl}`);
+  return run;
+}
+
+export async function getAgentRun(runId) {
+  const run = agentRuns.get(runId);
+  if (!run) return null;
+  let histograms = null;
+  try {
+    histograms = JSON.parse(await fs.readFile(path.join(run.dir, 'engine_histograms.json'), 'utf8'));
+  } catch (e) {
+    // no report yet
+  }
+  return { runId, status: run.status, exitCode: run.exitCode, error: run.error, startTime: run.startTime, vusers: run.vusers, vuOffset: run.vuOffset, histograms };
+}
+
+export function stopAgentRun(runId) {
+  const run = agentRuns.get(runId);
+  if (!run) return false;
+  // SIGINT: the engine stops, writes its final report and histograms
+  if (run.status === 'running') run.child.kill('SIGINT');
+  return true;
+}
+
+export function stopAllAgentRuns() {
+  let stopped = 0;
+  for (const run of agentRuns.values()) {
+    if (run.status === 'running') {
+      run.child.kill('SIGINT');
+      stopped++;
+    }
+  }
+  return stopped;
+}
@@ -0,0 +1,24 @@
+/**
+ * Log level and sampling for the load drivers' per-iteration output
+ * `info` (default) writes the journey and step lines for 1 in `sample`
+ * iterations; `error` writes only failures. Failures are always written,
+ * whatever the sample. Nothing counts results from these lines: the
+ * generated script, the engine and the simulator count every transaction in
+ * their histograms and results.bin.
+ */
+export const LOG_LEVELS = ['error', 'info'];
+export const LOG_LEVEL = LOG_LEVELS.includes(process.env.LOADTEST_LOG_LEVEL) ? process.env.LOADTEST_LOG_LEVEL : 'info';
+export const LOG_SAMPLE = parseInt(process.env.LOADTEST_LOG_SAMPLE || '0') || 1;
+
+/** { level, sample } from explicit values, falling back to the defaults above. */
+export function logSettings(level, sample) {
+  return {
+    level: LOG_LEVELS.includes(level) ? level : LOG_LEVEL,
+    sample: Math.max(1, Math.floor(Number(sample)) || LOG_SAMPLE)
+  };
+}
+
+/** Whether iteration `n` writes its info lines. */
+export function logsIteration({ level, sample }, n) {
+  return level === 'info' && n % sample === 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * Append-only binary results file (results.bin) shared by every load driver
+ * One fixed 24-byte little-endian record per transaction, no header; see
+ * native/loadgen/src/results_store.h for the layout. The native engine, the
+ * LoadRunner template and the load simulator append to it; the engine writes
+ * the file named by its --results-file flag, which /results/:testId reads
+ * back and aggregates here.
+ *
+ * Node has no mmap, so the file is scanned in fixed chunks straight into a
+ * Buffer owned by that scan (the page cache does the mapping). Aggregates are
+ * cached per file with the offset they cover, so a query during a run only
+ * reads the records appended since the last one. Scans of one file run one
+ * at a time: a query that overlaps another waits for it, then reads whatever
+ * was appended after it, so no range is folded twice.
+ */
+import fs from 'fs';
+
+export const RECORD_BYTES = 24;
+export const RESULTS_FILE = 'results.bin';
+
+const SCAN_CHUNK_RECORDS = 1 << 16; // 1.5 MiB per read
+
+// Same HdrHistogram layout as the engine: 3 significant digits in us
+const SUB_BUCKET_BITS = 11;
+const SUB_BUCKET_HALF_BITS = SUB_BUCKET_BITS - 1;
+const SUB_BUCKET_HALF = 1 << SUB_BUCKET_HALF_BITS;
+const SUB_BUCKET_MASK = (1 << SUB_BUCKET_BITS) - 1;
+const HISTOGRAM_LEN = (32 - SUB_BUCKET_HALF_BITS + 1) * SUB_BUCKET_HALF; // u32 latencies
+
+function bucketIndex(us) {
+  const pow2Ceiling = 32 - Math.clz32(us | SUB_BUCKET_MASK);
+  const bucket = pow2Ceiling - (SUB_BUCKET_HALF_BITS + 1);
+  return ((bucket + 1) << SUB_BUCKET_HALF_BITS) + ((us >>> bucket) - SUB_BUCKET_HALF);
+}
+
+function highestEquivalent(index) {
+  let bucket = (index >> SUB_BUCKET_HALF_BITS) - 1;
+  let subBucket = (index & (SUB_BUCKET_HALF - 1)) + SUB_BUCKET_HALF;
+  if (bucket < 0) {
+    subBucket -= SUB_BUCKET_HALF;
+    bucket = 0;
+  }
+  return subBucket * 2 ** bucket + 2 ** bucket - 1;
+}
+
+/**
+ * TSN id -> name for a journey: the steps, then the two journey-level
+ * transactions, in the order every writer numbers them.
+ */
+export function tsnNames(steps = []) {
+  return [
+    ...steps.map((s, i) => s.stepName || s.name || `Step_${i}`),
+    'Journey_Complete',
+    'Full_Customer_Journey'
+  ];
+}
+
+export function encodeRecord(buf, offset, { timeUs, vu, iteration, tsn, ok, serviceUs }) {
+  buf.writeBigUInt64LE(BigInt(Math.floor(timeUs)), offset);
+  buf.writeUInt32LE(vu >>> 0, offset + 8);
+  buf.writeUInt32LE(iteration >>> 0, offset + 12);
+  buf.writeUInt16LE(Math.min(tsn, 0xffff), offset + 16);
+  buf.writeUInt8(ok ? 0 : 1, offset + 18);
+  buf.writeUInt8(0, offset + 19);
+  buf.writeUInt32LE(Math.min(Math.max(0, Math.round(serviceUs)), 0xffffffff), offset + 20);
+}
+
+/**
+ * Appends `records` as one write on an O_APPEND descriptor, so concurrent
+ * writers never interleave inside a record.
+ */
+export function appendResultRecords(fd, records) {
+  if (!records.length) return;
+  const buf = Buffer.alloc(records.length * RECORD_BYTES);
+  records.forEach((r, i) => encodeRecord(buf, i * RECORD_BYTES, r));
+  fs.writeSync(fd, buf);
+}
+
+const aggregates = new Map(); // path -> { offset, tsns: [stats by TSN id], firstUs, lastUs }
+const scans = new Map(); // path -> the scan in flight for it
+
+// Records are 6 aligned u32 words; `w` views the scan's buffer (little-endian hosts)
+function foldChunk(agg, w, count) {
+  for (let i = 0; i < count; i++) {
+    const o = i * 6;
+    // u64 timestamp as two halves: exact to 2^53 us, far past any test
+    const timeUs = w[o] + w[o + 1] * 4294967296;
+    const tsn = w[o + 4] & 0xffff;
+    const failed = (w[o + 4] >>> 16 & 0xff) !== 0;
+    const us = w[o + 5];
+    let t = agg.tsns[tsn];
+    if (!t) {
+      t = { count: 0, pass: 0, fail: 0, sumUs: 0, minUs: Infinity, maxUs: 0, histogram: new Float64Array(HISTOGRAM_LEN) };
+      agg.tsns[tsn] = t;
+    }
+    t.count++;
+    if (failed) t.fail++; else t.pass++;
+    t.sumUs += us;
+    if (us < t.minUs) t.minUs = us;
+    if (us > t.maxUs) t.maxUs = us;
+    t.histogram[bucketIndex(us)]++;
+    if (timeUs < agg.firstUs) agg.firstUs = timeUs;
+    if (timeUs > agg.lastUs) agg.lastUs = timeUs;
+  }
+}
+
+function percentileMs(t, percentile) {
+  const target = Math.max(1, Math.ceil(percentile / 100 * t.count));
+  let seen = 0;
+  for (let i = 0; i < t.histogram.length; i++) {
+    seen += t.histogram[i];
+    if (seen >= target) return Math.min(highestEquivalent(i), t.maxUs) / 1000;
+  }
+  return t.maxUs / 1000;
+}
+
+/**
+ * Per-TSN counts, pass/fail, mean/min/max and p50/p90/p99/p99.9 in ms over
+ * every whole record in `file`. Returns null when the file does not exist.
+ */
+export async function aggregateResults(file, names = []) {
+  const started = process.hrtime.bigint();
+  const previous = scans.get(file);
+  const scan = (previous ? previous.catch(() => {}) : Promise.resolve()).then(() => scanResults(file));
+  scans.set(file, scan);
+  let agg;
+  try {
+    agg = await scan;
+  } finally {
+    if (scans.get(file) === scan) scans.delete(file);
+  }
+  if (!agg) return null;
+
+  const transactions = [];
+  agg.tsns.forEach((t, id) => transactions.push({
+    tsnId: id,
+    name: names[id] || `TSN_${id}`,
+    count: t.count,
+    pass: t.pass,
+    fail: t.fail,
+    avgMs: +(t.sumUs / t.count / 1000).toFixed(3),
+    minMs: t.minUs / 1000,
+    maxMs: t.maxUs / 1000,
+    p50Ms: percentileMs(t, 50),
+    p90Ms: percentileMs(t, 90),
+    p99Ms: percentileMs(t, 99),
+    p999Ms: percentileMs(t, 99.9)
+  }));
+  return {
+    file,
+    records: agg.offset / RECORD_BYTES,
+    firstRecordAt: agg.lastUs ? new Date(agg.firstUs / 1000).toISOString() : null,
+    lastRecordAt: agg.lastUs ? new Date(agg.lastUs / 1000).toISOString() : null,
+    queryMs: Number(process.hrtime.bigint() - started) / 1e6,
+    transactions
+  };
+}
+
+// Folds the records appended to `file` since its cached aggregate into it;
+// callers run one at a time per file (aggregateResults)
+async function scanResults(file) {
+  let handle;
+  try {
+    handle = await fs.promises.open(file, 'r');
+  } catch (e) {
+    if (e.code === 'ENOENT') return null;
+    throw e;
+  }
+  let agg = aggregates.get(file);
+  try {
+    const { size } = await handle.stat();
+    const end = size - (size % RECORD_BYTES); // a writer may be mid-record
+    if (!agg || agg.offset > end) {
+      agg = { offset: 0, tsns: [], firstUs: Infinity, lastUs: 0 };
+      aggregates.set(file, agg);
+    }
+    if (agg.offset < end) {
+      const buffer = Buffer.allocUnsafe(Math.min(SCAN_CHUNK_RECORDS * RECORD_BYTES, end - agg.offset));
+      const words = new Uint32Array(buffer.buffer, buffer.byteOffset, buffer.length / 4);
+      while (agg.offset < end) {
+        const want = Math.min(buffer.length, end - agg.offset);
+        const { bytesRead } = await handle.read(buffer, 0, want, agg.offset);
+        const count = Math.floor(bytesRead / RECORD_BYTES);
+        if (count === 0) break;
+        foldChunk(agg, words, count);
+        agg.offset += count * RECORD_BYTES;
+      }
+    }
+  } finally {
+    await handle.close();
+  }
+  return agg;
+}
+
+export function forgetResults(file) {
+  aggregates.delete(file);
+}
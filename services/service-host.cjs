@@ -0,0 +1,66 @@
+/**
+ * Multiplexed service host for Dynatrace Business Observability
+ * One Node.js process per company that runs its step services as worker
+ * threads instead of one process each (SERVICE_ISOLATION=worker).
+ *
+ * Every worker runs the same per-service wrapper a spawned child would, with
+ * its own process.env, argv and port, so services keep their names, tags and
+ * listeners; they share the V8 process, its startup cost and OneAgent's view
+ * of the process (title and cwd come from the host).
+ *
+ * IPC with service-manager.js:
+ *   parent -> host  { cmd: 'start', id, script, argv, env }
+ *                   { cmd: 'stop', id }
+ *   host -> parent  { event: 'online', id, threadId }
+ *                   { event: 'exit', id, code }
+ */
+const { Worker } = require('worker_threads');
+const readline = require('readline');
+
+const hostName = process.argv[2] || 'ServiceHost';
+const workers = new Map(); // id -> Worker
+
+function send(message) {
+  if (process.connected) process.send(message);
+}
+
+// Prefix worker output per service, as the manager does for spawned children
+function pipeLines(stream, serviceName, out) {
+  readline.createInterface({ input: stream }).on('line', line => out.write(`[${serviceName}] ${line}\n`));
+}
+
+function startWorker({ id, script, argv = [], env = {} }) {
+  if (workers.has(id)) return;
+  const serviceName = argv[0] || id;
+  const worker = new Worker(script, { argv, env, stdout: true, stderr: true });
+  pipeLines(worker.stdout, serviceName, process.stdout);
+  pipeLines(worker.stderr, `${serviceName}][ERR`, process.stderr);
+  workers.set(id, worker);
+  worker.on('online', () => send({ event: 'online', id, threadId: worker.threadId }));
+  worker.on('error', err => console.error(`[${hostName}] ${serviceName} failed: ${err.message}`));
+  worker.on('exit', code => {
+    workers.delete(id);
+    send({ event: 'exit', id, code });
+  });
+}
+
+process.on('message', message => {
+  if (message.cmd === 'start') {
+    startWorker(message);
+  } else if (message.cmd === 'stop') {
+    const worker = workers.get(message.id);
+    if (worker) worker.terminate();
+  }
+});
+
+// The manager owns the host: when it goes away, so do the services
+process.on('disconnect', () => process.exit(0));
+
+for (const signal of ['SIGTERM', 'SIGINT']) {
+  process.on(signal, async () => {
+    await Promise.all([...workers.values()].map(w => w.terminate()));
+    process.exit(0);
+  });
+}
+
+console.log(`[${hostName}] Service host running with PID ${process.pid}`);
@@ -1,9 +1,11 @@
-import { spawn, execSync } from 'child_process';
+import { spawn, fork, execSync } from 'child_process';
+import { EventEmitter } from 'events';
 import path from 'path';
 import fs from 'fs';
 import { fileURLToPath } from 'url';
 import http from 'http';
 import portManager from './port-manager.js';
+import { primeServicePool } from './service-pool.js';
 import { propagateMetadata } from '../middleware/dynatrace-metadata.js';
 
 const __filename = fileURLToPath(import.meta.url);
@@ -93,6 +95,8 @@ export function cleanupOrphanedServiceProcesses() {
         args.includes('.dynamic-runners') ||
         args.includes('dynamic-step-service.cjs') ||
         args.includes('service-runner.cjs') ||
+        args.includes('service-host.cjs') ||
+        args.includes('warm-service.cjs') ||
         /^(node\s+.*)?[A-Z][a-zA-Z]+Service\s*$/.test(args.trim()) ||
         /^[A-Z][a-zA-Z]+Service$/.test(args.trim())
       );
@@ -295,6 +299,246 @@ function cleanupDeadServices() {
   console.log(`[service-manager] Cleanup completed: ${deadServices.length} dead services removed`);
 }
 
+// ============ MULTIPLEXED SERVICE HOSTS ============
+// SERVICE_ISOLATION=worker runs each company's step services as worker threads
+// in one host process (service-host.cjs) instead of one process per service.
+// A thread costs a V8 isolate rather than a Node runtime, so services start in
+// tens of milliseconds and the ceiling becomes the port range, not memory.
+const SERVICE_ISOLATION = process.env.SERVICE_ISOLATION === 'worker' ? 'worker' : 'process';
+const serviceHosts = new Map(); // companyName -> { proc, handles: Map<workerId, WorkerServiceHandle> }
+let workerSeq = 0;
+
+// Stands in for a ChildProcess in childServices: pid is the host's, kill()
+// stops only this service's thread, 'exit' fires when the thread ends
+class WorkerServiceHandle extends EventEmitter {
+  constructor(host, id) {
+    super();
+    this.host = host;
+    this.id = id;
+    this.threadId = null;
+    this.killed = false;
+    this.exitCode = null;
+  }
+
+  get pid() {
+    return this.host.proc.pid;
+  }
+
+  kill() {
+    if (this.exitCode !== null) return false;
+    this.killed = true;
+    if (this.host.proc.connected) this.host.proc.send({ cmd: 'stop', id: this.id });
+    return true;
+  }
+
+  _exited(code) {
+    if (this.exitCode !== null) return;
+    this.exitCode = code;
+    this.host.handles.delete(this.id);
+    this.emit('exit', code, null);
+    // Retire an empty host; the next service for the company forks a fresh one
+    if (this.host.handles.size === 0) retireServiceHost(this.host);
+  }
+}
+
+function retireServiceHost(host) {
+  if (serviceHosts.get(host.companyName) === host) serviceHosts.delete(host.companyName);
+  if (host.proc.exitCode === null) host.proc.kill('SIGTERM');
+}
+
+function getServiceHost(companyName) {
+  const existing = serviceHosts.get(companyName);
+  if (existing) return existing;
+
+  const hostName = `${companyName.replace(/[^a-zA-Z0-9]/g, '')}ServiceHost`;
+  // Own directory and package.json, as per-service runners get, so OneAgent
+  // reads the host's name rather than the parent's
+  const hostDir = path.join(__dirname, '.dynamic-runners', hostName);
+  fs.mkdirSync(hostDir, { recursive: true });
+  fs.writeFileSync(path.join(hostDir, 'package.json'), JSON.stringify({
+    name: hostName.toLowerCase(),
+    version: '1.0.0',
+    private: true
+  }, null, 2), 'utf-8');
+
+  const proc = fork(path.join(__dirname, 'service-host.cjs'), [hostName], {
+    cwd: hostDir,
+    execArgv: [`--title=${hostName}`],
+    env: {
+      ...process.env,
+      COMPANY_NAME: companyName,
+      DT_APPLICATION_ID: hostName,
+      DT_CUSTOM_PROP: `dtServiceName=${hostName} companyName=${companyName} isolation=worker`,
+      DT_PROCESS_GROUP_NAME: hostName
+    },
+    stdio: ['ignore', 'pipe', 'pipe', 'ipc']
+  });
+  const host = { companyName, proc, handles: new Map() };
+  serviceHosts.set(companyName, host);
+  console.log(`[service-manager] 🧵 Started service host ${hostName} (PID: ${proc.pid}) for ${companyName}`);
+
+  proc.stdout.on('data', d => console.log(d.toString().trim()));
+  proc.stderr.on('data', d => console.error(d.toString().trim()));
+  proc.on('message', message => {
+    const handle = host.handles.get(message.id);
+    if (!handle) return;
+    if (message.event === 'online') handle.threadId = message.threadId;
+    else if (message.event === 'exit') handle._exited(message.code);
+  });
+  proc.on('exit', code => {
+    console.log(`[${hostName}] exited with code ${code}`);
+    if (serviceHosts.get(companyName) === host) serviceHosts.delete(companyName);
+    for (const handle of [...host.handles.values()]) handle._exited(code ?? 1);
+  });
+  return host;
+}
+
+function startServiceWorker(companyName, internalServiceName, scriptPath, argv, env) {
+  const host = getServiceHost(companyName);
+  // A restart may overlap the old thread's exit, so ids are per start
+  const id = `${internalServiceName}#${++workerSeq}`;
+  const handle = new WorkerServiceHandle(host, id);
+  host.handles.set(id, handle);
+  host.proc.send({ cmd: 'start', id, script: scriptPath, argv, env });
+  return handle;
+}
+
+// ============ IDLE HIBERNATION AND WARM POOL ============
+// SERVICE_IDLE_MINUTES > 0 parks a service no journey has asked for in that
+// long: the process stops, its port goes back to the port manager and its
+// metadata waits in dormantServices, so the next ensureServiceRunning()
+// revives it on its saved port. SERVICE_WARM_POOL keeps that many Node
+// processes pre-forked (warm-service.cjs) for process-isolated services to
+// start in, so a start or a revival pays for loading the service's code
+// rather than for a Node runtime.
+const SERVICE_IDLE_MINUTES = parseFloat(process.env.SERVICE_IDLE_MINUTES || '0') || 0;
+const SERVICE_WARM_POOL = SERVICE_ISOLATION === 'process' ? parseInt(process.env.SERVICE_WARM_POOL || '0') || 0 : 0;
+const REACTIVATION_SAMPLES = 200;
+const warmPool = []; // idle warm-service.cjs processes
+const reactivations = []; // most recent { ms, warm }
+let hibernatedTotal = 0;
+let warmUpRestarts = 0; // warmed services restarted by a load request's context
+let lifecycleTimer = null;
+
+function forkWarmProcess() {
+  const proc = fork(path.join(__dirname, 'warm-service.cjs'), [], {
+    execArgv: [],
+    stdio: ['ignore', 'pipe', 'pipe', 'ipc']
+  });
+  // Output is labelled with the service the process ends up running
+  proc.serviceLabel = 'WarmService';
+  proc.stdout.on('data', d => console.log(`[${proc.serviceLabel}] ${d.toString().trim()}`));
+  proc.stderr.on('data', d => console.error(`[${proc.serviceLabel}][ERR] ${d.toString().trim()}`));
+  proc.on('exit', () => {
+    const i = warmPool.indexOf(proc);
+    if (i >= 0) warmPool.splice(i, 1);
+  });
+  warmPool.push(proc);
+}
+
+function refillWarmPool() {
+  while (warmPool.length < SERVICE_WARM_POOL && !global.stoppingEverything) forkWarmProcess();
+}
+
+// Hand a service to a warm process; null when the pool is empty. The
+// process's `ready` resolves once the service listens (false on timeout)
+function startInWarmProcess(scriptPath, argv, env, cwd) {
+  setImmediate(refillWarmPool);
+  const proc = warmPool.shift();
+  if (!proc || !proc.connected) return null;
+  proc.serviceLabel = argv[0];
+  proc.ready = new Promise(resolve => {
+    const timer = setTimeout(() => resolve(false), 5000);
+    proc.on('message', message => {
+      if (message.event === 'listening') {
+        clearTimeout(timer);
+        resolve(true);
+      }
+    });
+    proc.once('exit', () => {
+      clearTimeout(timer);
+      resolve(false);
+    });
+  });
+  proc.send({ cmd: 'start', script: scriptPath, argv, env, cwd });
+  return proc;
+}
+
+// Park a running service: stop it, free its port, keep its metadata dormant
+function hibernateService(serviceName) {
+  const child = childServices[serviceName];
+  const meta = childServiceMeta[serviceName];
+  if (!child || !meta) return;
+  child._beingStopped = true; // the exit handler leaves the bookkeeping to us
+  try { child.kill('SIGTERM'); } catch {}
+  if (meta.port) portManager.releasePort(meta.port, serviceName);
+  dormantServices[serviceName] = {
+    ...meta,
+    previousPort: meta.port,
+    stoppedAt: new Date().toISOString(),
+    hibernated: true
+  };
+  delete childServices[serviceName];
+  delete childServiceMeta[serviceName];
+  hibernatedTotal++;
+}
+
+function hibernateIdleServices() {
+  const cutoff = Date.now() - SERVICE_IDLE_MINUTES * 60000;
+  for (const [serviceName, meta] of Object.entries(childServiceMeta)) {
+    if ((meta.lastUsed || meta.startTime) > cutoff) continue;
+    console.log(`[service-manager] 💤 Hibernating ${serviceName}: idle for ${Math.round((Date.now() - (meta.lastUsed || meta.startTime)) / 60000)} min (port ${meta.port} freed)`);
+    hibernateService(serviceName);
+  }
+}
+
+function recordReactivation(serviceName, ms, warm) {
+  reactivations.push({ ms, warm });
+  if (reactivations.length > REACTIVATION_SAMPLES) reactivations.shift();
+  console.log(`[service-manager] ⏰ Reactivated ${serviceName} in ${ms}ms (${warm ? 'warm pool' : 'cold start'})`);
+}
+
+/**
+ * Idle policy, warm pool and reactivation latency (ms, over the most recent
+ * REACTIVATION_SAMPLES revivals of dormant services)
+ */
+export function getServiceLifecycleStats() {
+  const sorted = reactivations.map(r => r.ms).sort((a, b) => a - b);
+  const at = q => (sorted.length ? sorted[Math.min(sorted.length - 1, Math.ceil(sorted.length * q) - 1)] : null);
+  return {
+    idleMinutes: SERVICE_IDLE_MINUTES,
+    warmPool: { size: SERVICE_WARM_POOL, idle: warmPool.length },
+    hibernated: hibernatedTotal,
+    warmUpRestarts,
+    dormant: Object.keys(dormantServices).length,
+    reactivation: {
+      count: reactivations.length,
+      warm: reactivations.filter(r => r.warm).length,
+      lastMs: reactivations.length ? reactivations[reactivations.length - 1].ms : null,
+      p50Ms: at(0.5),
+      p95Ms: at(0.95),
+      maxMs: sorted.length ? sorted[sorted.length - 1] : null
+    }
+  };
+}
+
+/**
+ * Start the idle sweep and fill the warm pool; called once by the main
+ * server (cluster workers never start services themselves)
+ */
+export function startServiceLifecycle() {
+  if (SERVICE_WARM_POOL > 0) {
+    refillWarmPool();
+    console.log(`[service-manager] 🔥 Warm pool: ${SERVICE_WARM_POOL} pre-forked service process(es)`);
+  }
+  if (SERVICE_IDLE_MINUTES > 0 && !lifecycleTimer) {
+    lifecycleTimer = setInterval(hibernateIdleServices, Math.min(60000, SERVICE_IDLE_MINUTES * 15000));
+    lifecycleTimer.unref();
+    console.log(`[service-manager] 💤 Services idle for ${SERVICE_IDLE_MINUTES} min are hibernated`);
+  }
+}
+// ============ END IDLE HIBERNATION AND WARM POOL ============
+
 // Start child service process
 export async function startChildService(internalServiceName, scriptPath, portParam = null, env = {}) {
   // Use the original step name from env, not derived from service name
@@ -328,63 +572,71 @@ export async function startChildService(internalServiceName, scriptPath, portPar
     // spawn the process there so OneAgent reads THAT package.json name instead of the parent's
     const spawnCwd = env._SERVICE_CWD || undefined;
     
-    const child = spawn('node', [`--title=${dynatraceServiceName}`, scriptPath, dynatraceServiceName], {
-      cwd: spawnCwd,
-      env: { 
-        ...process.env, 
-        SERVICE_NAME: dynatraceServiceName, 
-        FULL_SERVICE_NAME: internalServiceName,
-        PORT: port,
-        MAIN_SERVER_PORT: process.env.PORT || '8080',
-        // Company context for business observability
-        COMPANY_NAME: companyName,
-        DOMAIN: domain,
-        INDUSTRY_TYPE: industryType,
-        CATEGORY: env.CATEGORY || 'general',
-        MAIN_SERVER_PORT: '8080',
-        // ═══════════════════════════════════════════════════════════════
-        // DYNATRACE ONEAGENT - OFFICIAL ENVIRONMENT VARIABLES
-        // These are the REAL variables that OneAgent reads for service detection
-        // ═══════════════════════════════════════════════════════════════
-        
-        // 🔑 DT_APPLICATION_ID: Overrides package.json name for Web application id
-        // This is what OneAgent uses for service detection/naming
-        DT_APPLICATION_ID: dynatraceServiceName,
-        
-        // 🔑 DT_CUSTOM_PROP: Adds custom metadata properties to the service
-        DT_CUSTOM_PROP: `dtServiceName=${dynatraceServiceName} companyName=${companyName} domain=${domain} industryType=${industryType} journeyType=${env.JOURNEY_TYPE || 'unknown'} stepName=${stepName || 'unknown'}`,
-        
-        // 🏷️ DT_TAGS: Space-separated key=value pairs for Dynatrace tags
-        DT_TAGS: `company=${companyName.replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()} service=${dynatraceServiceName.replace(/[^a-zA-Z0-9]/g, '').toLowerCase()} app=bizobs-journey environment=ace-box industry=${industryType.replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()} journey-type=${(env.JOURNEY_TYPE || 'unknown').replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()} journey-detail=${(env.JOURNEY_DETAIL || stepName || 'unknown_journey').replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()} version=gen-${serviceVersionCounter[internalServiceName] || 1} stage=${companyName.replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()}`,
-        
-        // 📦 DT_RELEASE_*: Release tracking metadata (version increments per restart)
-        DT_RELEASE_PRODUCT: 'BizObs-Engine',
-        DT_RELEASE_STAGE: companyName.replace(/[^a-zA-Z0-9]/g, '-').toLowerCase(),
-        DT_RELEASE_VERSION: `${serviceVersionCounter[internalServiceName] || 1}.0.0`,
-        DT_RELEASE_BUILD_VERSION: `gen-${serviceVersionCounter[internalServiceName] || 1}`,
-        
-        // 🔗 DT_CLUSTER_ID / DT_NODE_ID: Cluster and node identification
-        DT_CLUSTER_ID: dynatraceServiceName,
-        DT_NODE_ID: `${dynatraceServiceName}-node`,
-        
-        // 🔑 DT_APPLICATION_ID: Overrides package.json name for Web application id
-        DT_APPLICATION_ID: dynatraceServiceName,
-        
-        // 📋 Internal env vars for app-level code (NOT read by OneAgent)
-        DT_SERVICE_NAME: dynatraceServiceName,
-        DYNATRACE_SERVICE_NAME: dynatraceServiceName,
-        
-        // Override inherited parent values that would confuse OneAgent
-        DT_LOGICAL_SERVICE_NAME: dynatraceServiceName,
-        DT_APPLICATION_NAME: dynatraceServiceName,
-        DT_PROCESS_GROUP_NAME: dynatraceServiceName,
-        ...env 
-      },
-      stdio: ['ignore', 'pipe', 'pipe']
-    });
+    const childEnv = {
+      ...process.env, 
+      SERVICE_NAME: dynatraceServiceName, 
+      FULL_SERVICE_NAME: internalServiceName,
+      PORT: port,
+      MAIN_SERVER_PORT: process.env.PORT || '8080',
+      // Company context for business observability
+      COMPANY_NAME: companyName,
+      DOMAIN: domain,
+      INDUSTRY_TYPE: industryType,
+      CATEGORY: env.CATEGORY || 'general',
+      MAIN_SERVER_PORT: '8080',
+      // ═══════════════════════════════════════════════════════════════
+      // DYNATRACE ONEAGENT - OFFICIAL ENVIRONMENT VARIABLES
+      // These are the REAL variables that OneAgent reads for service detection
+      // ═══════════════════════════════════════════════════════════════
+      
+      // 🔑 DT_APPLICATION_ID: Overrides package.json name for Web application id
+      // This is what OneAgent uses for service detection/naming
+      DT_APPLICATION_ID: dynatraceServiceName,
+      
+      // 🔑 DT_CUSTOM_PROP: Adds custom metadata properties to the service
+      DT_CUSTOM_PROP: `dtServiceName=${dynatraceServiceName} companyName=${companyName} domain=${domain} industryType=${industryType} journeyType=${env.JOURNEY_TYPE || 'unknown'} stepName=${stepName || 'unknown'}`,
+      
+      // 🏷️ DT_TAGS: Space-separated key=value pairs for Dynatrace tags
+      DT_TAGS: `company=${companyName.replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()} service=${dynatraceServiceName.replace(/[^a-zA-Z0-9]/g, '').toLowerCase()} app=bizobs-journey environment=ace-box industry=${industryType.replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()} journey-type=${(env.JOURNEY_TYPE || 'unknown').replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()} journey-detail=${(env.JOURNEY_DETAIL || stepName || 'unknown_journey').replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()} version=gen-${serviceVersionCounter[internalServiceName] || 1} stage=${companyName.replace(/[^a-zA-Z0-9]/g, '_').toLowerCase()}`,
+      
+      // 📦 DT_RELEASE_*: Release tracking metadata (version increments per restart)
+      DT_RELEASE_PRODUCT: 'BizObs-Engine',
+      DT_RELEASE_STAGE: companyName.replace(/[^a-zA-Z0-9]/g, '-').toLowerCase(),
+      DT_RELEASE_VERSION: `${serviceVersionCounter[internalServiceName] || 1}.0.0`,
+      DT_RELEASE_BUILD_VERSION: `gen-${serviceVersionCounter[internalServiceName] || 1}`,
+      
+      // 🔗 DT_CLUSTER_ID / DT_NODE_ID: Cluster and node identification
+      DT_CLUSTER_ID: dynatraceServiceName,
+      DT_NODE_ID: `${dynatraceServiceName}-node`,
+      
+      // 🔑 DT_APPLICATION_ID: Overrides package.json name for Web application id
+      DT_APPLICATION_ID: dynatraceServiceName,
+      
+      // 📋 Internal env vars for app-level code (NOT read by OneAgent)
+      DT_SERVICE_NAME: dynatraceServiceName,
+      DYNATRACE_SERVICE_NAME: dynatraceServiceName,
+      
+      // Override inherited parent values that would confuse OneAgent
+      DT_LOGICAL_SERVICE_NAME: dynatraceServiceName,
+      DT_APPLICATION_NAME: dynatraceServiceName,
+      DT_PROCESS_GROUP_NAME: dynatraceServiceName,
+      ...env
+    };
     
-    child.stdout.on('data', d => console.log(`[${dynatraceServiceName}] ${d.toString().trim()}`));
-    child.stderr.on('data', d => console.error(`[${dynatraceServiceName}][ERR] ${d.toString().trim()}`));
+    let child;
+    if (SERVICE_ISOLATION === 'worker') {
+      child = startServiceWorker(companyName, internalServiceName, scriptPath, [dynatraceServiceName], childEnv);
+    } else if (SERVICE_WARM_POOL > 0 && (child = startInWarmProcess(scriptPath, [dynatraceServiceName], childEnv, spawnCwd))) {
+      console.log(`[service-manager] 🔥 ${dynatraceServiceName} starting in warm process ${child.pid}`);
+    } else {
+      child = spawn('node', [`--title=${dynatraceServiceName}`, scriptPath, dynatraceServiceName], {
+        cwd: spawnCwd,
+        env: childEnv,
+        stdio: ['ignore', 'pipe', 'pipe']
+      });
+      child.stdout.on('data', d => console.log(`[${dynatraceServiceName}] ${d.toString().trim()}`));
+      child.stderr.on('data', d => console.error(`[${dynatraceServiceName}][ERR] ${d.toString().trim()}`));
+    }
     child.on('exit', code => {
       console.log(`[${dynatraceServiceName}] exited with code ${code}`);
       // If stopService is handling cleanup (saving to dormant), skip this
@@ -413,8 +665,13 @@ export async function startChildService(internalServiceName, scriptPath, portPar
       port,
       stepName: stepName,  // Include step name for UI display
       baseServiceName: dynatraceServiceName,
-      serviceVersion
+      serviceVersion,
+      isolation: SERVICE_ISOLATION,
+      warm: !!child.ready,
+      lastUsed: startTimeMs
     };
+    // A warm process says when it listens, so the readiness poll finds it up
+    if (child.ready) await child.ready;
     return child;
     
   } catch (error) {
@@ -441,6 +698,7 @@ export async function ensureServiceRunning(stepName, companyContext = {}) {
   }
   
   console.log(`[service-manager] ensureServiceRunning called for step: ${stepName}`);
+  const calledAt = Date.now();
   
   // Use exact serviceName from payload if provided, otherwise auto-generate with context
   const stepContext = {
@@ -493,6 +751,7 @@ export async function ensureServiceRunning(stepName, companyContext = {}) {
   // If service exists and is still running AND context matches, return it immediately
   if (existing && !existing.killed && existing.exitCode === null && !metaMismatch) {
     console.log(`[service-manager] Service ${internalServiceName} already running (PID: ${existing.pid}), reusing existing instance for ${companyName}`);
+    if (existingMeta) existingMeta.lastUsed = calledAt;
     // Return the port number
     return existingMeta?.port;
   }
@@ -500,6 +759,7 @@ export async function ensureServiceRunning(stepName, companyContext = {}) {
   // Check dormant services — metadata match means quick revival
   // Port reuse happens automatically via portManager.savedPortMap
   const dormant = dormantServices[internalServiceName];
+  let reviving = false; // timed as a reactivation once it is ready
   if (dormant && !existing) {
     const dormantMatch = dormant.domain === desiredMeta.domain &&
                          dormant.industryType === desiredMeta.industryType &&
@@ -507,6 +767,7 @@ export async function ensureServiceRunning(stepName, companyContext = {}) {
     if (dormantMatch) {
       console.log(`[service-manager] 🔄 Reviving dormant service ${internalServiceName} (was on port ${dormant.previousPort})`);
       delete dormantServices[internalServiceName];
+      reviving = true;
     } else {
       console.log(`[service-manager] Dormant service ${internalServiceName} metadata mismatch, starting fresh`);
       delete dormantServices[internalServiceName];
@@ -515,6 +776,11 @@ export async function ensureServiceRunning(stepName, companyContext = {}) {
 
   if (!existing || metaMismatch) {
     if (existing && metaMismatch) {
+      // A load test's requests should resolve the context its warm-up used
+      if (existingMeta.warmedUp) {
+        warmUpRestarts++;
+        console.warn(`[service-manager] ⚠️ Warmed-up service ${internalServiceName} restarted by a request with another context (domain ${existingMeta.domain} -> ${desiredMeta.domain}, industry ${existingMeta.industryType} -> ${desiredMeta.industryType})`);
+      }
       console.log(`[service-manager] Context change detected for ${internalServiceName}. Restarting service to apply new tags:`, JSON.stringify({ from: existingMeta, to: desiredMeta }));
       try { existing.kill('SIGTERM'); } catch {}
       delete childServices[internalServiceName];
@@ -554,6 +820,7 @@ export async function ensureServiceRunning(stepName, companyContext = {}) {
             throw new Error(`Service ${dynatraceServiceName} not responding on port ${allocatedPort}`);
           }
         }
+        if (reviving) recordReactivation(internalServiceName, Date.now() - calledAt, !!childServiceMeta[internalServiceName]?.warm);
         return allocatedPort;
       } else {
         // Ensure runners directory exists
@@ -659,6 +926,7 @@ export async function ensureServiceRunning(stepName, companyContext = {}) {
             throw new Error(`Service ${dynatraceServiceName} not responding on port ${allocatedPort}`);
           }
         }
+        if (reviving) recordReactivation(internalServiceName, Date.now() - calledAt, !!childServiceMeta[internalServiceName]?.warm);
         return allocatedPort;
       }
     } catch (e) {
@@ -1109,6 +1377,58 @@ export async function ensureServiceReadyForStep(stepName, companyContext = {}, t
   }
 }
 
+// Idle sockets opened per service by warmUpServices()
+const SERVICE_WARM_SOCKETS = parseInt(process.env.SERVICE_WARM_SOCKETS || '4');
+
+/**
+ * Start, health-check and pool-prime every service a journey needs, in
+ * parallel, before a load test releases its first request. Uses the same
+ * company context as simulate-journey so the load reuses these instances.
+ */
+export async function warmUpServices(steps = [], companyContext = {}, timeoutMs = 8000) {
+  const started = Date.now();
+  const unique = new Map();
+  for (const step of steps) {
+    const stepName = step.stepName || step.name;
+    if (!stepName) continue;
+    const key = step.serviceName || stepName;
+    if (!unique.has(key)) unique.set(key, { ...step, stepName });
+  }
+
+  const services = await Promise.all([...unique.values()].map(async (step) => {
+    const t0 = Date.now();
+    const result = { stepName: step.stepName, serviceName: step.serviceName || null, port: null, ready: false, pooledSockets: 0 };
+    try {
+      const port = await ensureServiceRunning(step.stepName, {
+        ...companyContext,
+        stepName: step.stepName,
+        serviceName: step.serviceName,
+        description: step.description,
+        category: step.category
+      });
+      if (port) {
+        result.port = port;
+        const meta = Object.values(childServiceMeta).find(m => m.port === port);
+        if (meta) meta.warmedUp = true;
+        result.ready = await isServiceReady(port, timeoutMs);
+        if (result.ready) result.pooledSockets = await primeServicePool(port, SERVICE_WARM_SOCKETS);
+      }
+    } catch (e) {
+      result.error = e.message;
+    }
+    result.durationMs = Date.now() - t0;
+    return result;
+  }));
+
+  const warmUp = {
+    durationMs: Date.now() - started,
+    ready: services.every(s => s.ready),
+    services
+  };
+  console.log(`[service-manager] 🔥 Warm-up for ${companyContext.companyName || 'DefaultCompany'}: ${services.filter(s => s.ready).length}/${services.length} services ready in ${warmUp.durationMs}ms`);
+  return warmUp;
+}
+
 // Health monitoring function to detect and resolve port conflicts
 export async function performHealthCheck() {
   const portStatus = portManager.getStatus();
@@ -1177,9 +1497,13 @@ export function getServiceStatus() {
     availablePorts: portStatus.availablePorts,
     allocatedPorts: portStatus.allocatedPorts,
   portRange: `${portManager.minPort || 8081}-${portManager.maxPort || 8120}`,
+    isolation: SERVICE_ISOLATION,
+    serviceHosts: serviceHosts.size,
+    lifecycle: getServiceLifecycleStats(),
     services: Object.entries(childServices).map(([name, child]) => ({
       name,
       pid: child.pid,
+      threadId: child.threadId ?? null,
       port: childServiceMeta[name]?.port || 'unknown',
       company: childServiceMeta[name]?.companyName || 'unknown',
       startTime: childServiceMeta[name]?.startTime || 'unknown',
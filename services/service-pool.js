@@ -0,0 +1,83 @@
+/**
+ * Keep-alive connection pools for calls from the main server to child services
+ * One http.Agent per service port, so chained hops reuse sockets instead of
+ * doing a handshake per call and leaving one in TIME_WAIT.
+ */
+import http from 'http';
+
+export const SERVICE_MAX_SOCKETS = parseInt(process.env.SERVICE_MAX_SOCKETS || '0') || 64;
+// Idle sockets kept per port; below the burst concurrency they churn again
+export const SERVICE_MAX_FREE_SOCKETS = parseInt(process.env.SERVICE_MAX_FREE_SOCKETS || '0') || SERVICE_MAX_SOCKETS;
+
+const serviceAgents = new Map(); // port -> { agent, requests, reused }
+
+function getServiceAgent(port) {
+  port = Number(port);
+  let pool = serviceAgents.get(port);
+  if (!pool) {
+    pool = {
+      agent: new http.Agent({
+        keepAlive: true,
+        maxSockets: SERVICE_MAX_SOCKETS,
+        maxFreeSockets: SERVICE_MAX_FREE_SOCKETS,
+        scheduling: 'lifo' // keep the hot sockets busy, let the rest idle out
+      }),
+      requests: 0,
+      reused: 0
+    };
+    serviceAgents.set(port, pool);
+  }
+  return pool;
+}
+
+// Pick the port's agent and count the request (and socket reuse) against it
+export function pooledRequest(options, onResponse) {
+  const pool = getServiceAgent(options.port);
+  const req = http.request({ ...options, agent: pool.agent }, onResponse);
+  pool.requests++;
+  req.on('socket', () => { if (req.reusedSocket) pool.reused++; });
+  return req;
+}
+
+/**
+ * Open `sockets` connections to a service with parallel GET /health calls, so
+ * the first requests of a run find them idle in the pool. Resolves with the
+ * number that succeeded; a service's keep-alive timeout still applies.
+ */
+export function primeServicePool(port, sockets) {
+  const n = Math.max(0, Math.min(sockets, SERVICE_MAX_FREE_SOCKETS));
+  const probes = [];
+  for (let i = 0; i < n; i++) {
+    probes.push(new Promise(resolve => {
+      const req = pooledRequest({ hostname: '127.0.0.1', port, path: '/health', method: 'GET', timeout: 2000 }, res => {
+        res.resume();
+        res.on('end', () => resolve(true));
+      });
+      req.on('error', () => resolve(false));
+      req.on('timeout', () => { req.destroy(); resolve(false); });
+      req.end();
+    }));
+  }
+  return Promise.all(probes).then(results => results.filter(Boolean).length);
+}
+
+function countSockets(byHost) {
+  let n = 0;
+  for (const list of Object.values(byHost)) n += list.length;
+  return n;
+}
+
+export function servicePoolStats() {
+  const pools = [];
+  for (const [port, pool] of serviceAgents.entries()) {
+    pools.push({
+      port,
+      active: countSockets(pool.agent.sockets),
+      idle: countSockets(pool.agent.freeSockets),
+      queued: countSockets(pool.agent.requests),
+      requests: pool.requests,
+      reused: pool.reused
+    });
+  }
+  return pools.sort((a, b) => a.port - b.port);
+}
@@ -5,6 +5,7 @@
 const express = require('express');
 const http = require('http');
 const crypto = require('crypto');
+const { journeyContextMiddleware } = require('./journey-context.cjs');
 
 // Load enhanced error handling if available
 let errorHandlingMiddleware;
@@ -83,6 +84,8 @@ function createService(serviceName, mountFn) {
   // CRITICAL: Add body parsing middleware for JSON payloads
   app.use(express.json({ limit: '10mb' }));
   app.use(express.urlencoded({ extended: true, limit: '10mb' }));
+  // Delta-mode hops: restore the cached journey context, leave it out of responses
+  app.use(journeyContextMiddleware());
   
   // Add error handling middleware
   app.use(errorHandlingMiddleware(serviceName));
@@ -152,22 +155,42 @@ function createService(serviceName, mountFn) {
     const address = server.address();
     const actualPort = typeof address === 'string' ? address : address.port;
     console.log(`[${serviceName}] Service running on port ${actualPort} with PID ${process.pid}`);
+    // A warm-pool process (warm-service.cjs) reports back over its IPC channel
+    if (process.send) process.send({ event: 'listening', port: actualPort });
   });
   
-  // Graceful shutdown
+  // Graceful shutdown: stop accepting, run the service's hooks, then exit
+  const shutdown = () => server.close(async () => {
+    await runShutdownHooks(serviceName);
+    process.exit(0);
+  });
+
   process.on('SIGTERM', () => {
     console.log(`[${serviceName}] Received SIGTERM, shutting down...`);
-    server.close(() => {
-      process.exit(0);
-    });
+    shutdown();
   });
   
   process.on('SIGINT', () => {
     console.log(`[${serviceName}] Received SIGINT, shutting down...`);
-    server.close(() => {
-      process.exit(0);
-    });
+    shutdown();
   });
 }
 
-module.exports = { createService };
\ No newline at end of file
+// Work a service must finish before the process exits (e.g. queued writes)
+const shutdownHooks = [];
+
+function onShutdown(fn) {
+  shutdownHooks.push(fn);
+}
+
+async function runShutdownHooks(serviceName) {
+  for (const fn of shutdownHooks) {
+    try {
+      await fn();
+    } catch (e) {
+      console.error(`[${serviceName}] Shutdown hook failed: ${e.message}`);
+    }
+  }
+}
+
+module.exports = { createService, onShutdown };
\ No newline at end of file
@@ -0,0 +1,33 @@
+/**
+ * Dependency groups for journey steps
+ * A journey config may give steps a `parallelGroup` name. Consecutive steps
+ * with the same name have no data dependency on each other: they run
+ * concurrently, once every step before the group is done, and the step after
+ * the group waits for all of them. Steps without a group run in sequence as
+ * before, so a journey that declares none behaves exactly as it always has.
+ * Shared by the chained executor (dynamic-step-service.cjs), /simulate-journey
+ * and the LoadRunner script generator.
+ */
+
+function parallelGroupOf(step) {
+  const group = step && step.parallelGroup;
+  return group === undefined || group === null || group === '' ? null : String(group);
+}
+
+/** Indices of the steps that run together with steps[start]: itself, then its group's later members. */
+function groupAt(steps, start) {
+  const group = parallelGroupOf(steps[start]);
+  const members = [start];
+  if (group === null) return members;
+  for (let i = start + 1; i < steps.length && parallelGroupOf(steps[i]) === group; i++) members.push(i);
+  return members;
+}
+
+/** The journey as a sequence of groups of step indices; a step without a group is a group of one. */
+function stepGroups(steps) {
+  const groups = [];
+  for (let i = 0; i < steps.length; i += groups[groups.length - 1].length) groups.push(groupAt(steps, i));
+  return groups;
+}
+
+module.exports = { parallelGroupOf, groupAt, stepGroups };
@@ -0,0 +1,164 @@
+/**
+ * Bounded ingestion of load-test process output
+ * A fixed-size ring buffer keeps the tail of the raw output and an
+ * incremental line parser folds transaction results into live counters, so a
+ * soak test costs the server the same memory in hour one and hour ten.
+ *
+ * Recognised lines:
+ *   LoadRunner  ... Transaction "<name>" ended with a "Pass" status (Duration: 0.5430 ...
+ *   loadgen     [bizobs-loadgen] t=12.0s active_vus=4 journeys=31 ... rps=9.8
+ *   loadgen     [bizobs-loadgen] TX <name> count=31 pass=30 fail=1 avg_ms=104.2 ...
+ */
+
+export const OUTPUT_TAIL_BYTES = parseInt(process.env.LOADTEST_OUTPUT_TAIL_BYTES || '0') || 1024 * 1024;
+
+// Longest partial line held while waiting for its newline
+const MAX_LINE_BYTES = 64 * 1024;
+
+const LR_TRANSACTION = /Transaction "([^"]+)" ended with (?:a )?"(\w+)" status \(Duration: ([\d.]+)/;
+const ENGINE_PROGRESS = /^\[bizobs-loadgen\] t=([\d.]+)s (.*)$/;
+const ENGINE_TRANSACTION = /^\[bizobs-loadgen\] TX (\S+)\s+(.*)$/;
+
+function parseFields(text) {
+  const fields = {};
+  for (const pair of text.trim().split(/\s+/)) {
+    const eq = pair.indexOf('=');
+    if (eq > 0) fields[pair.slice(0, eq)] = Number(pair.slice(eq + 1));
+  }
+  return fields;
+}
+
+/**
+ * Keeps the last `capacity` bytes written, in one preallocated Buffer.
+ */
+export class OutputRingBuffer {
+  constructor(capacity = OUTPUT_TAIL_BYTES) {
+    this.buffer = Buffer.alloc(capacity);
+    this.start = 0;
+    this.length = 0;
+    this.totalBytes = 0;
+  }
+
+  write(chunk) {
+    const capacity = this.buffer.length;
+    this.totalBytes += chunk.length;
+    if (chunk.length >= capacity) {
+      chunk.copy(this.buffer, 0, chunk.length - capacity);
+      this.start = 0;
+      this.length = capacity;
+      return;
+    }
+    const end = (this.start + this.length) % capacity;
+    const first = Math.min(chunk.length, capacity - end);
+    chunk.copy(this.buffer, end, 0, first);
+    chunk.copy(this.buffer, 0, first);
+    const overflow = this.length + chunk.length - capacity;
+    if (overflow > 0) {
+      this.start = (this.start + overflow) % capacity;
+      this.length = capacity;
+    } else {
+      this.length += chunk.length;
+    }
+  }
+
+  // The retained tail; once it has wrapped, starts at the first whole line
+  toString() {
+    const end = this.start + this.length;
+    const capacity = this.buffer.length;
+    const bytes = end <= capacity
+      ? this.buffer.subarray(this.start, end)
+      : Buffer.concat([this.buffer.subarray(this.start), this.buffer.subarray(0, end - capacity)]);
+    const text = bytes.toString('utf8');
+    if (this.totalBytes <= this.length) return text;
+    const nl = text.indexOf('\n');
+    return nl >= 0 ? text.slice(nl + 1) : text;
+  }
+}
+
+/**
+ * Splits output into lines as it arrives and keeps per-transaction counters.
+ * push() returns the complete lines it consumed, each with its kind
+ * ('transaction', 'progress', 'summary' or null), so callers can decide what to
+ * log; snapshot() is independent of how much output has been seen.
+ */
+export class TestOutputParser {
+  constructor() {
+    this.partial = '';
+    this.lines = 0;
+    this.transactions = new Map(); // name -> { count, pass, fail, sumMs, minMs, maxMs } or loadgen fields
+    this.progress = null;
+    this.lastLineAt = null;
+  }
+
+  push(chunk) {
+    const text = this.partial + chunk.toString('utf8');
+    const lines = text.split('\n');
+    this.partial = lines.pop();
+    if (this.partial.length > MAX_LINE_BYTES) this.partial = this.partial.slice(-MAX_LINE_BYTES);
+    const complete = [];
+    for (const raw of lines) {
+      const line = raw.replace(/\r$/, '');
+      if (!line) continue;
+      complete.push({ line, kind: this.parseLine(line) });
+    }
+    if (complete.length) {
+      this.lines += complete.length;
+      this.lastLineAt = new Date().toISOString();
+    }
+    return complete;
+  }
+
+  // Folds one line into the counters and says what kind of line it was
+  parseLine(line) {
+    let m = LR_TRANSACTION.exec(line);
+    if (m) {
+      const [, name, status, duration] = m;
+      const ms = Number(duration) * 1000;
+      let tx = this.transactions.get(name);
+      if (!tx) {
+        tx = { count: 0, pass: 0, fail: 0, sumMs: 0, minMs: Infinity, maxMs: 0 };
+        this.transactions.set(name, tx);
+      }
+      tx.count++;
+      if (status === 'Pass') tx.pass++; else tx.fail++;
+      tx.sumMs += ms;
+      if (ms < tx.minMs) tx.minMs = ms;
+      if (ms > tx.maxMs) tx.maxMs = ms;
+      return 'transaction';
+    }
+    m = ENGINE_PROGRESS.exec(line);
+    if (m) {
+      this.progress = { elapsedSec: Number(m[1]), ...parseFields(m[2]) };
+      return 'progress';
+    }
+    m = ENGINE_TRANSACTION.exec(line);
+    if (m) {
+      // Final cumulative totals from the engine; replace rather than add
+      const f = parseFields(m[2]);
+      this.transactions.set(m[1], {
+        count: f.count, pass: f.pass, fail: f.fail,
+        avgMs: f.avg_ms, minMs: f.min_ms, maxMs: f.max_ms,
+        p50Ms: f.p50_ms, p99Ms: f.p99_ms, p999Ms: f.p999_ms
+      });
+      return 'summary';
+    }
+    return null;
+  }
+
+  snapshot() {
+    const transactions = {};
+    let pass = 0;
+    let fail = 0;
+    for (const [name, tx] of this.transactions) {
+      pass += tx.pass;
+      fail += tx.fail;
+      transactions[name] = tx.sumMs !== undefined
+        ? {
+            count: tx.count, pass: tx.pass, fail: tx.fail,
+            avgMs: +(tx.sumMs / tx.count).toFixed(1), minMs: +tx.minMs.toFixed(1), maxMs: +tx.maxMs.toFixed(1)
+          }
+        : tx;
+    }
+    return { lines: this.lines, lastLineAt: this.lastLineAt, pass, fail, progress: this.progress, transactions };
+  }
+}
@@ -0,0 +1,34 @@
+/**
+ * Pre-forked warm process for step services (SERVICE_WARM_POOL > 0)
+ * Node has started and the service runtime's dependencies are loaded before
+ * any service needs a process. The manager then hands it one: the env, argv,
+ * title and working directory a spawned child would have started with, and
+ * the entry script (the per-service wrapper around service-runner.cjs) to
+ * run. Only third-party modules are loaded ahead; the repo's service modules
+ * read their identity from the environment when first required, so they load
+ * after it is in place.
+ *
+ * IPC with service-manager.js:
+ *   parent -> warm  { cmd: 'start', script, argv, env, cwd }
+ *   warm -> parent  { event: 'listening', port }   (sent by service-runner.cjs)
+ */
+require('express');
+try { require('@dynatrace/oneagent-sdk'); } catch (e) { /* optional, as for spawned services */ }
+
+process.title = 'WarmService';
+
+process.once('message', message => {
+  if (message.cmd !== 'start') return;
+  const { script, argv = [], env = {}, cwd } = message;
+  for (const key of Object.keys(process.env)) {
+    if (!(key in env)) delete process.env[key];
+  }
+  Object.assign(process.env, env);
+  if (cwd) process.chdir(cwd);
+  process.argv = [process.argv[0], script, ...argv];
+  if (argv[0]) process.title = argv[0];
+  require(script);
+});
+
+// Parked or serving, a warm process goes with the manager
+process.on('disconnect', () => process.exit(0));